@@ -1,4 +1,8 @@
 #include "DirectPort.h"
+#include "DirectPortInternal.h"
+#include "DirectPortCopy.h"
+#include "DirectPortDirtyRects.h"
+#include "DirectPortFormats.h"
 #include <vector>
 #include <string>
 #include <stdexcept>
@@ -75,6 +79,20 @@ namespace {
                 BroadcastManifest* pView = (BroadcastManifest*)MapViewOfFile(hManifest, FILE_MAP_READ, 0, 0, sizeof(BroadcastManifest));
                 if (pView) {
                     memcpy(&manifest, pView, sizeof(BroadcastManifest));
+                    // The producer zeroes dirtyFrameValue while it rewrites the
+                    // list, so a list that changed under the copy is discarded.
+                    MemoryBarrier();
+                    if (*(volatile UINT64*)&pView->dirtyFrameValue != manifest.dirtyFrameValue) manifest.dirtyFrameValue = 0;
+                    UnmapViewOfFile(pView);
+                    CloseHandle(hManifest);
+                    return true;
+                }
+                // Producers that predate the dirty-rect fields have a smaller mapping.
+                const SIZE_T legacySize = offsetof(BroadcastManifest, dirtyFrameValue);
+                pView = (BroadcastManifest*)MapViewOfFile(hManifest, FILE_MAP_READ, 0, 0, legacySize);
+                if (pView) {
+                    ZeroMemory(&manifest, sizeof(BroadcastManifest));
+                    memcpy(&manifest, pView, legacySize);
                     UnmapViewOfFile(pView);
                     CloseHandle(hManifest);
                     return true;
@@ -86,18 +104,6 @@ namespace {
     }
 }
 
-struct Texture::Impl {
-    ComPtr<ID3D11Texture2D> d3d11Texture;
-    ComPtr<ID3D11ShaderResourceView> d3d11SRV;
-    ComPtr<ID3D11RenderTargetView> d3d11RTV;
-    ComPtr<ID3D12Resource> d3d12Resource;
-    
-    UINT32 width = 0;
-    UINT32 height = 0;
-    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
-    bool is_d3d11 = false;
-    bool is_d3d12 = false;
-};
 Texture::Texture() : pImpl(std::make_unique<Impl>()) {}
 Texture::~Texture() = default;
 uint32_t Texture::get_width() const { return pImpl->width; }
@@ -112,12 +118,25 @@ struct Consumer::Impl {
     DWORD pid = 0;
     HANDLE hProcess = nullptr;
     UINT64 lastSeenFrame = 0;
+    std::vector<DirtyRect> dirtyRects;
     std::shared_ptr<Texture> sharedTexture;
     std::shared_ptr<Texture> privateTexture;
     ComPtr<ID3D11Fence> d3d11Fence;
     ComPtr<ID3D12Fence> d3d12Fence;
     void* pDeviceContext = nullptr;
     bool is_d3d11_producer = false;
+
+    // Records latestFrame as seen. The published rects only describe the step
+    // from the frame before it, so anything else reads as a full frame.
+    void accept_frame(const BroadcastManifest& manifest, UINT64 latestFrame) {
+        const bool consecutive = lastSeenFrame != 0 && latestFrame == lastSeenFrame + 1;
+        if (consecutive && manifest.dirtyFrameValue == latestFrame && manifest.dirtyRectCount <= kMaxManifestDirtyRects) {
+            dirtyRects.assign(manifest.dirtyRects, manifest.dirtyRects + manifest.dirtyRectCount);
+        } else {
+            dirtyRects.assign(1, DirtyRects::full(manifest.width, manifest.height));
+        }
+        lastSeenFrame = latestFrame;
+    }
 };
 Consumer::Consumer() : pImpl(std::make_unique<Impl>()) {}
 Consumer::~Consumer() {
@@ -129,6 +148,7 @@ bool Consumer::is_alive() const {
 }
 std::shared_ptr<Texture> Consumer::get_texture() { return pImpl->privateTexture; }
 std::shared_ptr<Texture> Consumer::get_shared_texture() { return pImpl->sharedTexture; }
+std::vector<DirtyRect> Consumer::get_dirty_rects() const { return pImpl->dirtyRects; }
 unsigned long Consumer::get_pid() const { return pImpl->pid; }
 bool Consumer::wait_for_frame() {
     if (!pImpl || !is_alive()) return false;
@@ -140,7 +160,7 @@ bool Consumer::wait_for_frame() {
         if (pImpl->is_d3d11_producer && pImpl->d3d11Fence) {
             auto* ctx = reinterpret_cast<ID3D11DeviceContext4*>(pImpl->pDeviceContext);
             ctx->Wait(pImpl->d3d11Fence.Get(), latestFrame);
-            pImpl->lastSeenFrame = latestFrame;
+            pImpl->accept_frame(currentManifest, latestFrame);
             return true;
         } else if (!pImpl->is_d3d11_producer && pImpl->d3d12Fence) {
             UINT64 expectedFrame = pImpl->lastSeenFrame;
@@ -149,14 +169,14 @@ bool Consumer::wait_for_frame() {
                 latestFrame = currentManifest.frameValue;
 
                 if (latestFrame > pImpl->lastSeenFrame) {
-                    pImpl->lastSeenFrame = latestFrame;
+                    pImpl->accept_frame(currentManifest, latestFrame);
                     return true;
                 }
             } else {
                 if (!get_manifest_from_pid(pImpl->pid, currentManifest)) return false;
                 latestFrame = currentManifest.frameValue;
                 if (latestFrame > pImpl->lastSeenFrame) {
-                    pImpl->lastSeenFrame = latestFrame;
+                    pImpl->accept_frame(currentManifest, latestFrame);
                     return true;
                 }
             }
@@ -186,7 +206,24 @@ Producer::~Producer() {
     if (pImpl->hFenceHandle) CloseHandle(pImpl->hFenceHandle);
 }
 void Producer::signal_frame() {
+    signal_frame({ DirtyRects::full(pImpl->sourceTexture->get_width(), pImpl->sourceTexture->get_height()) });
+}
+void Producer::signal_frame(const std::vector<DirtyRect>& dirty_rects) {
     pImpl->frameValue++;
+    if (pImpl->pManifestView) {
+        BroadcastManifest* manifest = pImpl->pManifestView;
+        const uint32_t width = pImpl->sourceTexture->get_width();
+        const uint32_t height = pImpl->sourceTexture->get_height();
+        const auto rects = DirtyRects::normalize(dirty_rects, width, height);
+        InterlockedExchange64(reinterpret_cast<volatile LONGLONG*>(&manifest->dirtyFrameValue), 0);
+        if (DirtyRects::is_full(rects, width, height)) {
+            manifest->dirtyRectCount = kDirtyRectsFullFrame;
+        } else {
+            manifest->dirtyRectCount = (UINT)rects.size();
+            std::copy(rects.begin(), rects.end(), manifest->dirtyRects);
+        }
+        InterlockedExchange64(reinterpret_cast<volatile LONGLONG*>(&manifest->dirtyFrameValue), pImpl->frameValue);
+    }
     if (pImpl->is_d3d11_producer && pImpl->d3d11Fence) {
         reinterpret_cast<ID3D11DeviceContext4*>(pImpl->pDeviceContext)->Signal(pImpl->d3d11Fence.Get(), pImpl->frameValue);
     } else if (!pImpl->is_d3d11_producer && pImpl->d3d12Fence) {
@@ -262,21 +299,6 @@ uint32_t Window::get_height() const {
     return static_cast<uint32_t>(rect.bottom - rect.top);
 }
 
-struct DeviceD3D11::Impl {
-    ComPtr<ID3D11Device> device;
-    ComPtr<ID3D11Device1> device1;
-    ComPtr<ID3D11Device5> device5;
-    ComPtr<ID3D11DeviceContext> context;
-    ComPtr<ID3D11DeviceContext4> context4;
-    
-    ComPtr<ID3D11VertexShader> blitVS;
-    ComPtr<ID3D11PixelShader> blitPS;
-    ComPtr<ID3D11SamplerState> blitSampler;
-
-    std::map<std::vector<uint8_t>, ComPtr<ID3D11PixelShader>> shaderCache;
-    LUID adapterLuid = {};
-};
-
 DeviceD3D11::DeviceD3D11() : pImpl(std::make_unique<Impl>()) {}
 DeviceD3D11::~DeviceD3D11() = default;
 
@@ -301,6 +323,10 @@ std::shared_ptr<DeviceD3D11> DeviceD3D11::create() {
     self->pImpl->device.As(&self->pImpl->device5);
     self->pImpl->context.As(&self->pImpl->context4);
     if (!self->pImpl->device5 || !self->pImpl->context4) throw std::runtime_error("D3D11.5 interfaces (required for fences) not supported.");
+    // Python bindings reach the immediate context from several threads once
+    // they release the GIL. Protection serializes single calls; methods that
+    // bind pipeline state and draw also hold the lock across the sequence.
+    if (SUCCEEDED(self->pImpl->context.As(&self->pImpl->multithread))) self->pImpl->multithread->SetMultithreadProtected(TRUE);
 
     ComPtr<IDXGIDevice> dxgiDevice;
     self->pImpl->device.As(&dxgiDevice);
@@ -349,27 +375,16 @@ std::shared_ptr<Texture> DeviceD3D11::create_texture(uint32_t width, uint32_t he
     D3D11_SUBRESOURCE_DATA* initial_data_ptr = nullptr;
     D3D11_SUBRESOURCE_DATA initial_data = {};
     if (data && data_size > 0) {
-        UINT pitch = 0;
-        if (format == DXGI_FORMAT_B8G8R8A8_UNORM || format == DXGI_FORMAT_R8G8B8A8_UNORM ||
-            format == DXGI_FORMAT_R32_FLOAT || format == DXGI_FORMAT_R10G10B10A2_UNORM) {
-            pitch = width * 4;
-        } else if (format == DXGI_FORMAT_R16_FLOAT || format == DXGI_FORMAT_R8G8_UNORM) {
-            pitch = width * 2;
-        } else if (format == DXGI_FORMAT_R16G16B16A16_FLOAT) {
-            pitch = width * 8;
-        } else if (format == DXGI_FORMAT_R32G32B32A32_FLOAT) {
-            pitch = width * 16;
-        } else if (format == DXGI_FORMAT_R8_UNORM) {
-            pitch = width * 1;
-        } else {
+        if (!Formats::find(format)) {
             throw std::runtime_error("Unsupported DXGI_FORMAT for initial data with D3D11::create_texture. Cannot calculate pitch reliably.");
         }
+        const UINT pitch = (UINT)Formats::row_pitch(format, width);
 
         if (pitch == 0) {
             throw std::runtime_error("Calculated pitch is zero for D3D11::create_texture. Invalid format or dimensions.");
         }
 
-        if (data_size < (size_t)pitch * height) {
+        if (data_size < Formats::image_size(format, width, height)) {
              throw std::runtime_error("Initial data_size is too small for the specified dimensions and format for D3D11::create_texture.");
         }
         
@@ -540,6 +555,7 @@ void DeviceD3D11::apply_shader(std::shared_ptr<Texture> output, const std::vecto
     if (!output || !output->pImpl->is_d3d11 || !output->pImpl->d3d11RTV) {
         throw std::invalid_argument("Invalid D3D11 output texture for apply_shader (must be D3D11 and have RTV).");
     }
+    D3D11ContextLock lock(pImpl->multithread.Get());
 
     ComPtr<ID3D11PixelShader> ps;
     if (shader_bytes.empty() || (shader_bytes.size() == 1 && shader_bytes[0] == '\0')) {
@@ -624,6 +640,7 @@ void DeviceD3D11::blit(std::shared_ptr<Texture> source, std::shared_ptr<Window>
         !source->pImpl->d3d11SRV || !destination->pImpl->d3d11rtv) {
         throw std::invalid_argument("Invalid D3D11 source texture or window for blit. Check for null or incorrect API type.");
     }
+    D3D11ContextLock lock(pImpl->multithread.Get());
     ID3D11RenderTargetView* rtv = destination->pImpl->d3d11rtv.Get();
     pImpl->context->OMSetRenderTargets(1, &rtv, nullptr);
     RECT clientRect;
@@ -694,7 +711,7 @@ void DeviceD3D11::resize_window(std::shared_ptr<Window> window) {
     if (!window || !window->pImpl->is_d3d11 || !window->pImpl->d3d11swapChain) {
         throw std::invalid_argument("Invalid D3D11 window for resize_window. Check for null or incorrect API type.");
     }
-    
+    D3D11ContextLock lock(pImpl->multithread.Get());
     pImpl->context->OMSetRenderTargets(0, nullptr, nullptr);
     window->pImpl->d3d11rtv.Reset();
 
@@ -722,6 +739,7 @@ void DeviceD3D11::blit_texture_to_region(std::shared_ptr<Texture> source, std::s
         throw std::invalid_argument("Invalid D3D11 source or destination texture for blit_texture_to_region. Check for null or incorrect API type.");
     }
     if (dest_width == 0 || dest_height == 0) return;
+    D3D11ContextLock lock(pImpl->multithread.Get());
 
     pImpl->context->OMSetRenderTargets(1, destination->pImpl->d3d11RTV.GetAddressOf(), nullptr);
 
@@ -749,25 +767,30 @@ void DeviceD3D11::blit_texture_to_region(std::shared_ptr<Texture> source, std::s
     pImpl->context->PSSetShaderResources(0, 1, nullSRV);
 }
 
-struct DeviceD3D12::Impl {
-    ComPtr<ID3D12Device> device;
-    ComPtr<ID3D12CommandQueue> commandQueue;
-    ComPtr<ID3D12CommandAllocator> commandAllocator;
-    ComPtr<ID3D12GraphicsCommandList> commandList;
-    ComPtr<ID3D12Fence> fence;
-    HANDLE fenceEvent;
-    UINT64 fenceValue = 1;
-    UINT64 frameFenceValues[2] = {};
-    LUID adapterLuid;
-
-    ComPtr<ID3D12RootSignature> blitRootSignature;
-    ComPtr<ID3D12PipelineState> blitPSO;
-    ComPtr<ID3D12DescriptorHeap> blitSrvHeap;
-    ComPtr<ID3D12DescriptorHeap> blitRtvHeap;
-
-    std::map<std::vector<uint8_t>, ComPtr<ID3D12PipelineState>> psoCache;
-    ComPtr<ID3D12RootSignature> shaderRootSignature;
-};
+void DeviceD3D11::copy_texture_regions(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                       const std::vector<DirtyRect>& regions) {
+    if (!source || !destination || !source->pImpl->is_d3d11 || !destination->pImpl->is_d3d11 ||
+        !source->pImpl->d3d11Texture || !destination->pImpl->d3d11Texture) {
+        throw std::invalid_argument("Invalid D3D11 source or destination texture for copy_texture_regions. Check for null or incorrect API type.");
+    }
+    if (source->get_width() != destination->get_width() ||
+        source->get_height() != destination->get_height() ||
+        source->get_format() != destination->get_format()) {
+        throw std::invalid_argument("Source and destination textures must have matching dimensions and format for D3D11::copy_texture_regions.");
+    }
+
+    const uint32_t w = source->get_width(), h = source->get_height();
+    const auto areas = DirtyRects::normalize(regions, w, h);
+    D3D11ContextLock lock(pImpl->multithread.Get());
+    if (DirtyRects::is_full(areas, w, h)) {
+        pImpl->context->CopyResource(destination->pImpl->d3d11Texture.Get(), source->pImpl->d3d11Texture.Get());
+        return;
+    }
+    for (const auto& area : areas) {
+        const D3D11_BOX box = { area.x, area.y, 0, area.x + area.width, area.y + area.height, 1 };
+        pImpl->context->CopySubresourceRegion(destination->pImpl->d3d11Texture.Get(), 0, area.x, area.y, 0, source->pImpl->d3d11Texture.Get(), 0, &box);
+    }
+}
 
 void DeviceD3D12::WaitForGpu() {
     const UINT64 currentFenceValue = pImpl->fenceValue;
@@ -778,6 +801,58 @@ void DeviceD3D12::WaitForGpu() {
         WaitForSingleObject(pImpl->fenceEvent, INFINITE);
     }
     pImpl->fenceValue++;
+    pImpl->inFlight.clear();
+}
+
+void DeviceD3D12::begin_commands(ID3D12PipelineState* pso) {
+    if (pImpl->recording && !pImpl->batching) {
+        // A previous call threw while recording; drop what it left open.
+        pImpl->commandList->Close();
+        pImpl->recording = false;
+    }
+    if (pImpl->recording) {
+        if (pso) pImpl->commandList->SetPipelineState(pso);
+        return;
+    }
+    pImpl->commandAllocator->Reset();
+    pImpl->commandList->Reset(pImpl->commandAllocator.Get(), pso);
+    pImpl->recording = true;
+}
+
+void DeviceD3D12::end_commands(bool wait) {
+    if (pImpl->batching) return;
+    pImpl->recording = false;
+    pImpl->commandList->Close();
+    ID3D12CommandList* lists[] = { pImpl->commandList.Get() };
+    pImpl->commandQueue->ExecuteCommandLists(1, lists);
+    if (wait) WaitForGpu();
+}
+
+ID3D12DescriptorHeap* DeviceD3D12::transient_srv_heap(UINT count) {
+    D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+    desc.NumDescriptors = count;
+    desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    ComPtr<ID3D12DescriptorHeap> heap;
+    HRESULT hr = pImpl->device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&heap));
+    if (FAILED(hr)) { throw std::runtime_error("Failed to create transient SRV heap. HRESULT: " + std::to_string(hr)); }
+    pImpl->inFlight.push_back(heap);
+    return heap.Get();
+}
+
+void DeviceD3D12::begin_batch() {
+    if (pImpl->batching) throw std::runtime_error("D3D12::begin_batch: a batch is already open.");
+    if (pImpl->recording) {
+        pImpl->commandList->Close();
+        pImpl->recording = false;
+    }
+    pImpl->batching = true;
+}
+
+void DeviceD3D12::end_batch() {
+    if (!pImpl->batching) return;
+    pImpl->batching = false;
+    if (pImpl->recording) end_commands();
 }
 
 DeviceD3D12::DeviceD3D12() : pImpl(std::make_unique<Impl>()) {}
@@ -941,9 +1016,19 @@ std::shared_ptr<Texture> DeviceD3D12::create_texture(uint32_t width, uint32_t he
     if (FAILED(hr)) { throw std::runtime_error("Failed to create D3D12 texture. HRESULT: " + std::to_string(hr)); }
     
     if (data && data_size > 0) {
+        // data is tightly packed; the upload footprint pads rows to 256 bytes.
+        const size_t pitch = Formats::row_pitch(format, width);
+        if (pitch == 0) {
+            throw std::runtime_error("Unsupported DXGI_FORMAT for initial data with D3D12::create_texture.");
+        }
+        if (data_size < Formats::image_size(format, width, height)) {
+            throw std::runtime_error("Initial data_size is too small for the specified dimensions and format for D3D12::create_texture.");
+        }
         ComPtr<ID3D12Resource> uploadHeap;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+        UINT numRows;
         UINT64 uploadBufferSize;
-        pImpl->device->GetCopyableFootprints(&desc, 0, 1, 0, nullptr, nullptr, nullptr, &uploadBufferSize);
+        pImpl->device->GetCopyableFootprints(&desc, 0, 1, 0, &footprint, &numRows, nullptr, &uploadBufferSize);
 
         D3D12_HEAP_PROPERTIES uploadHeapProps = {D3D12_HEAP_TYPE_UPLOAD};
         D3D12_RESOURCE_DESC bufferDesc = {};
@@ -961,16 +1046,16 @@ std::shared_ptr<Texture> DeviceD3D12::create_texture(uint32_t width, uint32_t he
         void* p;
         hr = uploadHeap->Map(0, nullptr, &p);
         if (FAILED(hr)) { throw std::runtime_error("Failed to map D3D12 upload heap. HRESULT: " + std::to_string(hr)); }
-        memcpy(p, data, data_size);
+        Copy::copy_rows(static_cast<uint8_t*>(p) + footprint.Offset, footprint.Footprint.RowPitch, data, pitch, pitch, numRows);
         uploadHeap->Unmap(0, nullptr);
 
-        pImpl->commandAllocator->Reset();
-        pImpl->commandList->Reset(pImpl->commandAllocator.Get(), nullptr);
+        begin_commands();
+        pImpl->inFlight.push_back(uploadHeap);
 
         D3D12_TEXTURE_COPY_LOCATION src = {};
         src.pResource = uploadHeap.Get();
         src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-        pImpl->device->GetCopyableFootprints(&desc, 0, 1, 0, &src.PlacedFootprint, nullptr, nullptr, nullptr);
+        src.PlacedFootprint = footprint;
         
         D3D12_TEXTURE_COPY_LOCATION dst = { tex->pImpl->d3d12Resource.Get(), D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX, 0 };
 
@@ -988,11 +1073,7 @@ std::shared_ptr<Texture> DeviceD3D12::create_texture(uint32_t width, uint32_t he
         barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COMMON;
         pImpl->commandList->ResourceBarrier(1, &barrier);
 
-        pImpl->commandList->Close();
-        ID3D12CommandList* lists[] = { pImpl->commandList.Get() };
-        pImpl->commandQueue->ExecuteCommandLists(1, lists);
-        
-        WaitForGpu();
+        end_commands();
     }
     return tex;
 }
@@ -1127,8 +1208,7 @@ void DeviceD3D12::copy_texture(std::shared_ptr<Texture> source, std::shared_ptr<
         throw std::invalid_argument("Source and destination textures must have matching dimensions and format for D3D12::copy_texture.");
     }
 
-    pImpl->commandAllocator->Reset();
-    pImpl->commandList->Reset(pImpl->commandAllocator.Get(), nullptr);
+    begin_commands();
 
     D3D12_RESOURCE_BARRIER barriers[2] = {};
     barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -1143,11 +1223,50 @@ void DeviceD3D12::copy_texture(std::shared_ptr<Texture> source, std::shared_ptr<
     std::swap(barriers[1].Transition.StateBefore, barriers[1].Transition.StateAfter);
     pImpl->commandList->ResourceBarrier(2, barriers);
 
-    pImpl->commandList->Close();
-    ID3D12CommandList* ppCommandLists[] = { pImpl->commandList.Get() };
-    pImpl->commandQueue->ExecuteCommandLists(1, ppCommandLists);
-    
-    WaitForGpu();
+    end_commands();
+}
+
+void DeviceD3D12::copy_texture_regions(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                       const std::vector<DirtyRect>& regions) {
+    if (!source || !destination || !source->pImpl->is_d3d12 || !destination->pImpl->is_d3d12 ||
+        !source->pImpl->d3d12Resource || !destination->pImpl->d3d12Resource) {
+        throw std::invalid_argument("Invalid D3D12 source or destination texture for copy_texture_regions. Check for null or incorrect API type.");
+    }
+    if (source->get_width() != destination->get_width() ||
+        source->get_height() != destination->get_height() ||
+        source->get_format() != destination->get_format()) {
+        throw std::invalid_argument("Source and destination textures must have matching dimensions and format for D3D12::copy_texture_regions.");
+    }
+
+    const uint32_t w = source->get_width(), h = source->get_height();
+    const auto areas = DirtyRects::normalize(regions, w, h);
+    if (areas.empty()) return;
+    if (DirtyRects::is_full(areas, w, h)) {
+        copy_texture(source, destination);
+        return;
+    }
+
+    begin_commands();
+
+    D3D12_RESOURCE_BARRIER barriers[2] = {};
+    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barriers[0].Transition = { source->pImpl->d3d12Resource.Get(), D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_SOURCE };
+    barriers[1].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barriers[1].Transition = { destination->pImpl->d3d12Resource.Get(), D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST };
+    pImpl->commandList->ResourceBarrier(2, barriers);
+
+    D3D12_TEXTURE_COPY_LOCATION srcLoc = { source->pImpl->d3d12Resource.Get(), D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX, 0 };
+    D3D12_TEXTURE_COPY_LOCATION dstLoc = { destination->pImpl->d3d12Resource.Get(), D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX, 0 };
+    for (const auto& area : areas) {
+        const D3D12_BOX box = { area.x, area.y, 0, area.x + area.width, area.y + area.height, 1 };
+        pImpl->commandList->CopyTextureRegion(&dstLoc, area.x, area.y, 0, &srcLoc, &box);
+    }
+
+    std::swap(barriers[0].Transition.StateBefore, barriers[0].Transition.StateAfter);
+    std::swap(barriers[1].Transition.StateBefore, barriers[1].Transition.StateAfter);
+    pImpl->commandList->ResourceBarrier(2, barriers);
+
+    end_commands();
 }
 
 void DeviceD3D12::apply_shader(std::shared_ptr<Texture> output, const std::vector<uint8_t>& shader_bytes, const std::string& entry_point, const std::vector<std::shared_ptr<Texture>>& inputs, const std::vector<uint8_t>& constants) {
@@ -1220,8 +1339,7 @@ void DeviceD3D12::apply_shader(std::shared_ptr<Texture> output, const std::vecto
         }
     }
 
-    pImpl->commandAllocator->Reset();
-    pImpl->commandList->Reset(pImpl->commandAllocator.Get(), pso.Get());
+    begin_commands(pso.Get());
     pImpl->commandList->SetGraphicsRootSignature(pImpl->shaderRootSignature.Get());
 
     ComPtr<ID3D12DescriptorHeap> srvHeap;
@@ -1232,6 +1350,7 @@ void DeviceD3D12::apply_shader(std::shared_ptr<Texture> output, const std::vecto
         heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
         hr = pImpl->device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&srvHeap));
         if (FAILED(hr)) { throw std::runtime_error("Failed to create SRV descriptor heap for shader inputs. HRESULT: " + std::to_string(hr)); }
+        pImpl->inFlight.push_back(srvHeap);
 
         UINT srvSize = pImpl->device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
         D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = srvHeap->GetCPUDescriptorHandleForHeapStart();
@@ -1267,6 +1386,7 @@ void DeviceD3D12::apply_shader(std::shared_ptr<Texture> output, const std::vecto
         if (FAILED(hr)) { throw std::runtime_error("Failed to map D3D12 constant buffer. HRESULT: " + std::to_string(hr)); }
         memcpy(p, constants.data(), constants.size());
         cbUploadHeap->Unmap(0, nullptr);
+        pImpl->inFlight.push_back(cbUploadHeap);
         pImpl->commandList->SetGraphicsRootConstantBufferView(1, cbUploadHeap->GetGPUVirtualAddress());
     }
 
@@ -1306,10 +1426,7 @@ void DeviceD3D12::apply_shader(std::shared_ptr<Texture> output, const std::vecto
     barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COMMON;
     pImpl->commandList->ResourceBarrier(1, &barrier);
     
-    pImpl->commandList->Close();
-    ID3D12CommandList* lists[] = { pImpl->commandList.Get() };
-    pImpl->commandQueue->ExecuteCommandLists(1, lists);
-    WaitForGpu();
+    end_commands();
 }
 
 void DeviceD3D12::blit(std::shared_ptr<Texture> source, std::shared_ptr<Window> destination) {
@@ -1319,15 +1436,16 @@ void DeviceD3D12::blit(std::shared_ptr<Texture> source, std::shared_ptr<Window>
     }
     auto& winImpl = *destination->pImpl;
     
-    pImpl->commandAllocator->Reset();
-    pImpl->commandList->Reset(pImpl->commandAllocator.Get(), pImpl->blitPSO.Get());
+    begin_commands(pImpl->blitPSO.Get());
+    // Draws still pending in a batch keep their own descriptor.
+    ID3D12DescriptorHeap* srvHeap = pImpl->batching ? transient_srv_heap(1) : pImpl->blitSrvHeap.Get();
 
     D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     srvDesc.Format = source->get_format();
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Texture2D.MipLevels = 1;
-    pImpl->device->CreateShaderResourceView(source->pImpl->d3d12Resource.Get(), &srvDesc, pImpl->blitSrvHeap->GetCPUDescriptorHandleForHeapStart());
+    pImpl->device->CreateShaderResourceView(source->pImpl->d3d12Resource.Get(), &srvDesc, srvHeap->GetCPUDescriptorHandleForHeapStart());
 
     D3D12_RESOURCE_BARRIER barriers[2] = {};
     barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -1347,9 +1465,9 @@ void DeviceD3D12::blit(std::shared_ptr<Texture> source, std::shared_ptr<Window>
     pImpl->commandList->RSSetViewports(1, &vp);
     pImpl->commandList->RSSetScissorRects(1, &sr);
     pImpl->commandList->SetGraphicsRootSignature(pImpl->blitRootSignature.Get());
-    ID3D12DescriptorHeap* heaps[] = { pImpl->blitSrvHeap.Get() };
+    ID3D12DescriptorHeap* heaps[] = { srvHeap };
     pImpl->commandList->SetDescriptorHeaps(1, heaps);
-    pImpl->commandList->SetGraphicsRootDescriptorTable(0, pImpl->blitSrvHeap->GetGPUDescriptorHandleForHeapStart());
+    pImpl->commandList->SetGraphicsRootDescriptorTable(0, srvHeap->GetGPUDescriptorHandleForHeapStart());
     pImpl->commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     pImpl->commandList->DrawInstanced(3, 1, 0, 0);
 
@@ -1357,9 +1475,7 @@ void DeviceD3D12::blit(std::shared_ptr<Texture> source, std::shared_ptr<Window>
     std::swap(barriers[1].Transition.StateBefore, barriers[1].Transition.StateAfter);
     pImpl->commandList->ResourceBarrier(2, barriers);
     
-    pImpl->commandList->Close();
-    ID3D12CommandList* lists[] = { pImpl->commandList.Get() };
-    pImpl->commandQueue->ExecuteCommandLists(1, lists);
+    end_commands(false);
 }
 
 void DeviceD3D12::clear(std::shared_ptr<Window> window, float r, float g, float b, float a) {
@@ -1368,8 +1484,7 @@ void DeviceD3D12::clear(std::shared_ptr<Window> window, float r, float g, float
     }
     auto& winImpl = *window->pImpl;
 
-    pImpl->commandAllocator->Reset();
-    pImpl->commandList->Reset(pImpl->commandAllocator.Get(), nullptr);
+    begin_commands();
 
     D3D12_RESOURCE_BARRIER barrier = {};
     barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -1385,9 +1500,7 @@ void DeviceD3D12::clear(std::shared_ptr<Window> window, float r, float g, float
     barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
     pImpl->commandList->ResourceBarrier(1, &barrier);
     
-    pImpl->commandList->Close();
-    ID3D12CommandList* lists[] = { pImpl->commandList.Get() };
-    pImpl->commandQueue->ExecuteCommandLists(1, lists);
+    end_commands(false);
 }
 
 std::shared_ptr<Window> DeviceD3D12::create_window(uint32_t width, uint32_t height, const std::string& title) {
@@ -1480,15 +1593,16 @@ void DeviceD3D12::blit_texture_to_region(std::shared_ptr<Texture> source, std::s
     }
     if (dest_width == 0 || dest_height == 0) return;
 
-    pImpl->commandAllocator->Reset();
-    pImpl->commandList->Reset(pImpl->commandAllocator.Get(), pImpl->blitPSO.Get());
+    begin_commands(pImpl->blitPSO.Get());
+    // Draws still pending in a batch keep their own descriptor.
+    ID3D12DescriptorHeap* srvHeap = pImpl->batching ? transient_srv_heap(1) : pImpl->blitSrvHeap.Get();
 
     D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     srvDesc.Format = source->get_format();
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Texture2D.MipLevels = 1;
-    pImpl->device->CreateShaderResourceView(source->pImpl->d3d12Resource.Get(), &srvDesc, pImpl->blitSrvHeap->GetCPUDescriptorHandleForHeapStart());
+    pImpl->device->CreateShaderResourceView(source->pImpl->d3d12Resource.Get(), &srvDesc, srvHeap->GetCPUDescriptorHandleForHeapStart());
 
     D3D12_RESOURCE_BARRIER barriers[2] = {};
     barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -1519,9 +1633,9 @@ void DeviceD3D12::blit_texture_to_region(std::shared_ptr<Texture> source, std::s
     pImpl->commandList->RSSetScissorRects(1, &sr);
 
     pImpl->commandList->SetGraphicsRootSignature(pImpl->blitRootSignature.Get());
-    ID3D12DescriptorHeap* heaps[] = { pImpl->blitSrvHeap.Get() };
+    ID3D12DescriptorHeap* heaps[] = { srvHeap };
     pImpl->commandList->SetDescriptorHeaps(1, heaps);
-    pImpl->commandList->SetGraphicsRootDescriptorTable(0, pImpl->blitSrvHeap->GetGPUDescriptorHandleForHeapStart());
+    pImpl->commandList->SetGraphicsRootDescriptorTable(0, srvHeap->GetGPUDescriptorHandleForHeapStart());
     pImpl->commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     pImpl->commandList->DrawInstanced(3, 1, 0, 0);
 
@@ -1529,10 +1643,7 @@ void DeviceD3D12::blit_texture_to_region(std::shared_ptr<Texture> source, std::s
     std::swap(barriers[1].Transition.StateBefore, barriers[1].Transition.StateAfter);
     pImpl->commandList->ResourceBarrier(2, barriers);
     
-    pImpl->commandList->Close();
-    ID3D12CommandList* lists[] = { pImpl->commandList.Get() };
-    pImpl->commandQueue->ExecuteCommandLists(1, lists);
-    WaitForGpu();
+    end_commands();
 }
 
 std::vector<ProducerInfo> DirectPort::discover() {
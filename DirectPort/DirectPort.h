@@ -3,19 +3,33 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <optional>
 #include <cstdint>
 
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#include <windows.h>
+#include "DirectPortPlatform.h"
+
+#ifdef _WIN32
 #include <d3d11_4.h>
 #include <d3d12.h>
 #include <dxgi1_6.h>
 #include <wrl/client.h>
+#endif
 
 namespace DirectPort {
 
+    // A changed region of a frame, in texture pixels.
+    struct DirtyRect {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Producers publish at most this many rects per frame; anything that does
+    // not merge down to fit is published as a full frame instead.
+    constexpr uint32_t kMaxManifestDirtyRects = 32;
+    constexpr uint32_t kDirtyRectsFullFrame = 0xFFFFFFFFu;
+
     struct BroadcastManifest {
         UINT64 frameValue;
         UINT width;
@@ -24,10 +38,18 @@ namespace DirectPort {
         LUID adapterLuid;
         WCHAR textureName[256];
         WCHAR fenceName[256];
+        // Appended so older consumers keep reading the prefix. The list is only
+        // valid when dirtyFrameValue == frameValue; producers that predate it
+        // leave these unmapped and every frame reads as fully dirty.
+        UINT64 dirtyFrameValue;
+        UINT dirtyRectCount;
+        UINT dirtyReserved;
+        DirtyRect dirtyRects[kMaxManifestDirtyRects];
     };
 
     class DeviceD3D11;
     class DeviceD3D12;
+    class DeviceCPU;
     class Texture;
     class Consumer;
     class Producer;
@@ -52,10 +74,13 @@ namespace DirectPort {
         uintptr_t get_d3d11_srv_ptr();
         uintptr_t get_d3d11_rtv_ptr();
         uintptr_t get_d3d12_resource_ptr();
+        uintptr_t get_cpu_ptr();
+        size_t get_cpu_row_pitch() const;
 
     private:
         friend class DeviceD3D11;
         friend class DeviceD3D12;
+        friend class DeviceCPU;
         friend class Consumer;
         friend class Producer;
         Texture();
@@ -70,6 +95,9 @@ namespace DirectPort {
         bool is_alive() const;
         std::shared_ptr<Texture> get_texture();
         std::shared_ptr<Texture> get_shared_texture();
+        // Regions that changed since the previous frame this consumer saw. A single
+        // full-surface rect when the producer did not say, or frames were skipped.
+        std::vector<DirtyRect> get_dirty_rects() const;
         unsigned long get_pid() const;
     private:
         friend class DeviceD3D11;
@@ -83,6 +111,9 @@ namespace DirectPort {
     public:
         ~Producer();
         void signal_frame();
+        // Publishes a frame in which only these regions changed. They are merged
+        // down to kMaxManifestDirtyRects or published as a full frame.
+        void signal_frame(const std::vector<DirtyRect>& dirty_rects);
         unsigned long get_pid() const;
     private:
         friend class DeviceD3D11;
@@ -108,6 +139,32 @@ namespace DirectPort {
         std::unique_ptr<Impl> pImpl;
     };
 
+    enum class CompositeFit {
+        Stretch,    // fill the layer rect exactly
+        Letterbox,  // keep the source aspect, centred inside the rect
+        Crop        // keep the source aspect, fill the rect and trim the overflow
+    };
+
+    // One input to IDirectXDevice::composite. The rect is in destination pixels
+    // and may hang off the edges; crop is in source pixels, zero width/height
+    // meaning the whole source. Layers draw in ascending z, ties in list order.
+    struct CompositeLayer {
+        std::shared_ptr<Texture> source;
+        int32_t x = 0;
+        int32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        float opacity = 1.0f;
+        int32_t z = 0;
+        uint32_t crop_x = 0;
+        uint32_t crop_y = 0;
+        uint32_t crop_width = 0;
+        uint32_t crop_height = 0;
+        CompositeFit fit = CompositeFit::Stretch;
+        // When false the source is treated as opaque, matching blit_texture_to_region.
+        bool use_source_alpha = false;
+    };
+
     class IDirectXDevice {
     public:
         virtual ~IDirectXDevice() = default;
@@ -125,8 +182,36 @@ namespace DirectPort {
         
         virtual void blit_texture_to_region(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
                                             uint32_t dest_x, uint32_t dest_y, uint32_t dest_width, uint32_t dest_height) = 0;
+
+        // Draws every layer into destination in one pass (one submission on D3D12),
+        // optionally clearing it to (r, g, b, a) first. Without `regions` it
+        // redraws the whole destination; with them, only those parts, and an
+        // empty list draws nothing. The default issues one
+        // blit_texture_to_region per layer, so it draws only opaque, uncropped
+        // layers inside the destination, cannot clear, and redraws everything
+        // rather than just `regions`; it throws std::runtime_error otherwise.
+        virtual void composite(std::shared_ptr<Texture> destination, const std::vector<CompositeLayer>& layers,
+                               bool clear, float r, float g, float b, float a,
+                               const std::optional<std::vector<DirtyRect>>& regions = std::nullopt);
+
+        // copy_texture restricted to the given regions (same position in both).
+        // The default copies the whole texture.
+        virtual void copy_texture_regions(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                          const std::vector<DirtyRect>& regions);
+
+        // Calls made between begin_batch and end_batch may be recorded and
+        // submitted together at end_batch (one command list and one fence wait
+        // on D3D12), so their results are only guaranteed after end_batch.
+        // Batches do not nest. By default every call still runs on its own.
+        virtual void begin_batch() {}
+        virtual void end_batch() {}
     };
 
+#ifdef _WIN32
+    // Methods may be called from several threads: the immediate context is
+    // multithread-protected, and methods that bind state and draw hold its
+    // lock until they finish. Callers using get_d3d11_context() directly must
+    // take ID3D11Multithread::Enter/Leave around their own call sequences.
     class DeviceD3D11 : public IDirectXDevice, public std::enable_shared_from_this<DeviceD3D11> {
     public:
         static std::shared_ptr<DeviceD3D11> create();
@@ -144,6 +229,11 @@ namespace DirectPort {
         void clear(std::shared_ptr<Window> window, float r, float g, float b, float a) override;
         void blit_texture_to_region(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
                                     uint32_t dest_x, uint32_t dest_y, uint32_t dest_width, uint32_t dest_height) override;
+        void composite(std::shared_ptr<Texture> destination, const std::vector<CompositeLayer>& layers,
+                       bool clear, float r, float g, float b, float a,
+                       const std::optional<std::vector<DirtyRect>>& regions = std::nullopt) override;
+        void copy_texture_regions(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                  const std::vector<DirtyRect>& regions) override;
 
         ID3D11Device* get_d3d11_device();
         ID3D11DeviceContext* get_d3d11_context();
@@ -171,12 +261,28 @@ namespace DirectPort {
         void clear(std::shared_ptr<Window> window, float r, float g, float b, float a) override;
         void blit_texture_to_region(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
                                     uint32_t dest_x, uint32_t dest_y, uint32_t dest_width, uint32_t dest_height) override;
+        void composite(std::shared_ptr<Texture> destination, const std::vector<CompositeLayer>& layers,
+                       bool clear, float r, float g, float b, float a,
+                       const std::optional<std::vector<DirtyRect>>& regions = std::nullopt) override;
+        void copy_texture_regions(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                  const std::vector<DirtyRect>& regions) override;
+        void begin_batch() override;
+        void end_batch() override;
 
     private:
         DeviceD3D12();
         struct Impl;
         void WaitForGpu();
+        // Every command-list user records between these. begin_commands resets
+        // the list, or keeps recording into an open batch; end_commands closes,
+        // executes and (if wait) waits, or does nothing until end_batch.
+        void begin_commands(ID3D12PipelineState* pso = nullptr);
+        void end_commands(bool wait = true);
+        // A shader-visible heap of `count` SRVs that lives until the next wait,
+        // for draws that may still be pending in a batch.
+        ID3D12DescriptorHeap* transient_srv_heap(UINT count);
         std::unique_ptr<Impl> pImpl;
     };
+#endif
 
 }
\ No newline at end of file
@@ -0,0 +1,349 @@
+// src/DirectPort/DirectPortBlend.cpp
+// Blend modes run in 16-bit fixed point, with x / 255 computed exactly by
+// div255, so the SIMD kernels match the scalar ones bit for bit. Keys build
+// their matte in float with the same operation order in every kernel set and
+// round the way cvtps2dq does. AVX-512 machines run the AVX2 kernels.
+
+#include "DirectPortBlend.h"
+#include "DirectPortConvert.h"
+#include "DirectPortFormats.h"
+#include "DirectPortScheduler.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "DirectPortSimd.h"
+
+using namespace DirectPort;
+using Blend::Mode;
+
+namespace {
+
+    // Exactly round(x / 255) for any x up to 65535.
+    inline uint32_t div255(uint32_t x) { x += 128; return (x + (x >> 8)) >> 8; }
+
+    inline uint32_t opacity_255(float opacity) {
+        if (!(opacity > 0.0f)) return 0;
+        return opacity >= 1.0f ? 255u : (uint32_t)(opacity * 255.0f + 0.5f);
+    }
+
+    template <Mode M>
+    void blend_scalar(const uint8_t* src, uint8_t* dst, uint32_t n, uint32_t op) {
+        for (uint32_t i = 0; i < n; ++i) {
+            const uint8_t* s = src + (size_t)i * 4;
+            uint8_t* d = dst + (size_t)i * 4;
+            const uint32_t a = div255(s[3] * op);
+            const uint32_t na = 255 - a;
+            for (int c = 0; c < 3; ++c) {
+                uint32_t v;
+                if constexpr (M == Mode::Over) v = div255(s[c] * a + d[c] * na);
+                else if constexpr (M == Mode::PremultipliedOver) v = std::min(255u, div255(s[c] * op) + div255(d[c] * na));
+                else if constexpr (M == Mode::Add) v = std::min(255u, d[c] + div255(s[c] * a));
+                else v = div255(d[c] * div255(s[c] * a + 255 * na));
+                d[c] = (uint8_t)v;
+            }
+            d[3] = (uint8_t)div255(255 * a + d[3] * na);
+        }
+    }
+
+    // Everything a key kernel needs, in 0..255 units and in byte order. The
+    // matte is clamp((value - level) * scale, 0, 1), where value is the CbCr
+    // distance to the key colour or the luma; an inverted luma key negates scale.
+    struct KeyParams {
+        bool chroma;
+        float w[2][3];
+        float key_cb;
+        float key_cr;
+        float level;
+        float scale;
+    };
+
+    void key_scalar(const KeyParams& k, uint8_t* px, uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i) {
+            uint8_t* p = px + (size_t)i * 4;
+            const float p0 = p[0], p1 = p[1], p2 = p[2];
+            float value;
+            if (k.chroma) {
+                const float db = p0 * k.w[0][0] + p1 * k.w[0][1] + p2 * k.w[0][2] - k.key_cb;
+                const float dr = p0 * k.w[1][0] + p1 * k.w[1][1] + p2 * k.w[1][2] - k.key_cr;
+                value = std::sqrt(db * db + dr * dr);
+            } else {
+                value = p0 * k.w[0][0] + p1 * k.w[0][1] + p2 * k.w[0][2];
+            }
+            const float t = std::min(std::max((value - k.level) * k.scale, 0.0f), 1.0f);
+            // Round to nearest even, as cvtps2dq does, without a libm call.
+            p[3] = (uint8_t)(int)((t * (float)p[3] + 12582912.0f) - 12582912.0f);
+        }
+    }
+
+#ifdef DP_SIMD_X86
+
+    // --- SSE4.1: four pixels, two per 16-bit vector ---
+
+    DP_TARGET("sse4.1") inline __m128i div255_sse41(__m128i x) {
+        x = _mm_add_epi16(x, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+    }
+
+    template <Mode M>
+    DP_TARGET("sse4.1") inline __m128i blend_lanes_sse41(__m128i s, __m128i d, __m128i op) {
+        const __m128i c255 = _mm_set1_epi16(255);
+        const __m128i alpha_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+        const __m128i sa = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128i a = div255_sse41(_mm_mullo_epi16(sa, op));
+        const __m128i na = _mm_sub_epi16(c255, a);
+        const __m128i dna = _mm_mullo_epi16(d, na);
+        const __m128i alpha = div255_sse41(_mm_add_epi16(_mm_mullo_epi16(c255, a), dna));
+        __m128i rgb;
+        if constexpr (M == Mode::Over) rgb = div255_sse41(_mm_add_epi16(_mm_mullo_epi16(s, a), dna));
+        else if constexpr (M == Mode::PremultipliedOver) rgb = _mm_add_epi16(div255_sse41(_mm_mullo_epi16(s, op)), div255_sse41(dna));
+        else if constexpr (M == Mode::Add) rgb = _mm_add_epi16(d, div255_sse41(_mm_mullo_epi16(s, a)));
+        else rgb = div255_sse41(_mm_mullo_epi16(d, div255_sse41(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(c255, na)))));
+        // Sums above 255 saturate in the final pack.
+        return _mm_blendv_epi8(rgb, alpha, alpha_lanes);
+    }
+
+    template <Mode M>
+    DP_TARGET("sse4.1") void blend_sse41(const uint8_t* src, uint8_t* dst, uint32_t n, uint32_t op255) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i op = _mm_set1_epi16((short)op255);
+        uint32_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (size_t)i * 4));
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + (size_t)i * 4));
+            const __m128i lo = blend_lanes_sse41<M>(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), op);
+            const __m128i hi = blend_lanes_sse41<M>(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), op);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (size_t)i * 4), _mm_packus_epi16(lo, hi));
+        }
+        blend_scalar<M>(src + (size_t)i * 4, dst + (size_t)i * 4, n - i, op255);
+    }
+
+    // (p0 * w0 + p1 * w1) + p2 * w2, the order key_scalar uses.
+    DP_TARGET("sse4.1") inline __m128 dot_sse41(__m128 p0, __m128 p1, __m128 p2, const float* w) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(w[0])), _mm_mul_ps(p1, _mm_set1_ps(w[1]))), _mm_mul_ps(p2, _mm_set1_ps(w[2])));
+    }
+
+    DP_TARGET("sse4.1") void key_sse41(const KeyParams& k, uint8_t* px, uint32_t n) {
+        const __m128i byte = _mm_set1_epi32(0xff);
+        const __m128i rgb_bits = _mm_set1_epi32(0x00ffffff);
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+        const __m128 level = _mm_set1_ps(k.level), scale = _mm_set1_ps(k.scale);
+        uint32_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128i* p = reinterpret_cast<__m128i*>(px + (size_t)i * 4);
+            const __m128i v = _mm_loadu_si128(p);
+            const __m128 p0 = _mm_cvtepi32_ps(_mm_and_si128(v, byte));
+            const __m128 p1 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 8), byte));
+            const __m128 p2 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 16), byte));
+            const __m128 a = _mm_cvtepi32_ps(_mm_srli_epi32(v, 24));
+            __m128 value;
+            if (k.chroma) {
+                const __m128 db = _mm_sub_ps(dot_sse41(p0, p1, p2, k.w[0]), _mm_set1_ps(k.key_cb));
+                const __m128 dr = _mm_sub_ps(dot_sse41(p0, p1, p2, k.w[1]), _mm_set1_ps(k.key_cr));
+                value = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(db, db), _mm_mul_ps(dr, dr)));
+            } else {
+                value = dot_sse41(p0, p1, p2, k.w[0]);
+            }
+            const __m128 t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(value, level), scale), zero), one);
+            const __m128i alpha = _mm_cvtps_epi32(_mm_mul_ps(t, a));
+            _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(v, rgb_bits), _mm_slli_epi32(alpha, 24)));
+        }
+        key_scalar(k, px + (size_t)i * 4, n - i);
+    }
+
+    // --- AVX2: eight pixels, four per 16-bit vector ---
+
+    DP_TARGET("avx2") inline __m256i div255_avx2(__m256i x) {
+        x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+    }
+
+    template <Mode M>
+    DP_TARGET("avx2") inline __m256i blend_lanes_avx2(__m256i s, __m256i d, __m256i op) {
+        const __m256i c255 = _mm256_set1_epi16(255);
+        const __m256i alpha_lanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+        const __m256i sa = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        const __m256i a = div255_avx2(_mm256_mullo_epi16(sa, op));
+        const __m256i na = _mm256_sub_epi16(c255, a);
+        const __m256i dna = _mm256_mullo_epi16(d, na);
+        const __m256i alpha = div255_avx2(_mm256_add_epi16(_mm256_mullo_epi16(c255, a), dna));
+        __m256i rgb;
+        if constexpr (M == Mode::Over) rgb = div255_avx2(_mm256_add_epi16(_mm256_mullo_epi16(s, a), dna));
+        else if constexpr (M == Mode::PremultipliedOver) rgb = _mm256_add_epi16(div255_avx2(_mm256_mullo_epi16(s, op)), div255_avx2(dna));
+        else if constexpr (M == Mode::Add) rgb = _mm256_add_epi16(d, div255_avx2(_mm256_mullo_epi16(s, a)));
+        else rgb = div255_avx2(_mm256_mullo_epi16(d, div255_avx2(_mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(c255, na)))));
+        return _mm256_blendv_epi8(rgb, alpha, alpha_lanes);
+    }
+
+    template <Mode M>
+    DP_TARGET("avx2") void blend_avx2(const uint8_t* src, uint8_t* dst, uint32_t n, uint32_t op255) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i op = _mm256_set1_epi16((short)op255);
+        uint32_t i = 0;
+        // Unpacking and packing stay within 128-bit lanes, so pixel order survives.
+        for (; i + 8 <= n; i += 8) {
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (size_t)i * 4));
+            const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + (size_t)i * 4));
+            const __m256i lo = blend_lanes_avx2<M>(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), op);
+            const __m256i hi = blend_lanes_avx2<M>(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), op);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (size_t)i * 4), _mm256_packus_epi16(lo, hi));
+        }
+        blend_scalar<M>(src + (size_t)i * 4, dst + (size_t)i * 4, n - i, op255);
+    }
+
+    DP_TARGET("avx2") inline __m256 dot_avx2(__m256 p0, __m256 p1, __m256 p2, const float* w) {
+        return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p0, _mm256_set1_ps(w[0])), _mm256_mul_ps(p1, _mm256_set1_ps(w[1]))),
+                             _mm256_mul_ps(p2, _mm256_set1_ps(w[2])));
+    }
+
+    DP_TARGET("avx2") void key_avx2(const KeyParams& k, uint8_t* px, uint32_t n) {
+        const __m256i byte = _mm256_set1_epi32(0xff);
+        const __m256i rgb_bits = _mm256_set1_epi32(0x00ffffff);
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+        const __m256 level = _mm256_set1_ps(k.level), scale = _mm256_set1_ps(k.scale);
+        uint32_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i* p = reinterpret_cast<__m256i*>(px + (size_t)i * 4);
+            const __m256i v = _mm256_loadu_si256(p);
+            const __m256 p0 = _mm256_cvtepi32_ps(_mm256_and_si256(v, byte));
+            const __m256 p1 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 8), byte));
+            const __m256 p2 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 16), byte));
+            const __m256 a = _mm256_cvtepi32_ps(_mm256_srli_epi32(v, 24));
+            __m256 value;
+            if (k.chroma) {
+                const __m256 db = _mm256_sub_ps(dot_avx2(p0, p1, p2, k.w[0]), _mm256_set1_ps(k.key_cb));
+                const __m256 dr = _mm256_sub_ps(dot_avx2(p0, p1, p2, k.w[1]), _mm256_set1_ps(k.key_cr));
+                value = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(db, db), _mm256_mul_ps(dr, dr)));
+            } else {
+                value = dot_avx2(p0, p1, p2, k.w[0]);
+            }
+            const __m256 t = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(value, level), scale), zero), one);
+            const __m256i alpha = _mm256_cvtps_epi32(_mm256_mul_ps(t, a));
+            _mm256_storeu_si256(p, _mm256_or_si256(_mm256_and_si256(v, rgb_bits), _mm256_slli_epi32(alpha, 24)));
+        }
+        key_scalar(k, px + (size_t)i * 4, n - i);
+    }
+
+#endif
+
+    typedef void (*BlendFn)(const uint8_t*, uint8_t*, uint32_t, uint32_t);
+
+    struct Kernels {
+        BlendFn blend[4];
+        void (*key)(const KeyParams&, uint8_t*, uint32_t);
+    };
+
+    const Kernels kScalar = { { blend_scalar<Mode::Over>, blend_scalar<Mode::PremultipliedOver>, blend_scalar<Mode::Add>, blend_scalar<Mode::Multiply> },
+                              key_scalar };
+#ifdef DP_SIMD_X86
+    const Kernels kSSE41 = { { blend_sse41<Mode::Over>, blend_sse41<Mode::PremultipliedOver>, blend_sse41<Mode::Add>, blend_sse41<Mode::Multiply> },
+                             key_sse41 };
+    const Kernels kAVX2 = { { blend_avx2<Mode::Over>, blend_avx2<Mode::PremultipliedOver>, blend_avx2<Mode::Add>, blend_avx2<Mode::Multiply> },
+                            key_avx2 };
+#endif
+
+    const Kernels& kernels() {
+#ifdef DP_SIMD_X86
+        const Convert::Isa isa = Convert::active_isa();
+        if (isa >= Convert::Isa::AVX2) return kAVX2;
+        if (isa >= Convert::Isa::SSE41) return kSSE41;
+#endif
+        return kScalar;
+    }
+
+    BlendFn blend_fn(Mode mode, const char* what) {
+        const int index = (int)mode;
+        if (index < 0 || index > (int)Mode::Multiply) {
+            throw std::invalid_argument(std::string("Blend::") + what + ": unknown blend mode.");
+        }
+        return kernels().blend[index];
+    }
+
+    // BT.709 weights, reordered so w[c] applies to byte c of a pixel.
+    void byte_order(DXGI_FORMAT format, const float (&rgb)[3], float (&w)[3]) {
+        const bool bgra = Formats::traits(format).bgra;
+        w[0] = bgra ? rgb[2] : rgb[0];
+        w[1] = rgb[1];
+        w[2] = bgra ? rgb[0] : rgb[2];
+    }
+
+    const double kKr = 0.2126, kKb = 0.0722;
+    const float kLuma[3] = { (float)kKr, (float)(1.0 - kKr - kKb), (float)kKb };
+    const float kCb[3] = { (float)(-kKr / (2.0 * (1.0 - kKb))), (float)(-(1.0 - kKr - kKb) / (2.0 * (1.0 - kKb))), 0.5f };
+    const float kCr[3] = { 0.5f, (float)(-(1.0 - kKr - kKb) / (2.0 * (1.0 - kKr))), (float)(-kKb / (2.0 * (1.0 - kKr))) };
+
+    // A zero softness gives a hard edge.
+    float key_scale(float softness) {
+        return softness > 0.0f ? 1.0f / (softness * 255.0f) : FLT_MAX;
+    }
+
+    void run_key(const char* what, DXGI_FORMAT format, void* pixels, size_t pitch, uint32_t width, uint32_t height, const KeyParams& k) {
+        if (!Blend::is_supported(format)) {
+            throw std::invalid_argument(std::string("Blend::") + what + ": unsupported format.");
+        }
+        if (width == 0 || height == 0) return;
+        auto* p = static_cast<uint8_t*>(pixels);
+        auto key = kernels().key;
+        Scheduler::shared().for_each_band(height, (size_t)width * 4, [&](uint32_t y0, uint32_t y1) {
+            for (uint32_t y = y0; y < y1; ++y) key(k, p + (size_t)y * pitch, width);
+        });
+    }
+
+}
+
+const char* Blend::mode_name(Mode mode) {
+    switch (mode) {
+    case Mode::Over: return "Over";
+    case Mode::PremultipliedOver: return "PremultipliedOver";
+    case Mode::Add: return "Add";
+    case Mode::Multiply: return "Multiply";
+    }
+    return "Unknown";
+}
+
+bool Blend::is_supported(DXGI_FORMAT format) {
+    const Formats::Traits* t = Formats::find(format);
+    return Formats::is_convertible(format) && t->sample == Formats::Sample::U8 && t->channels == 4;
+}
+
+void Blend::blend_row(Mode mode, const uint8_t* src, uint8_t* dst, uint32_t count, float opacity) {
+    blend_fn(mode, "blend_row")(src, dst, count, opacity_255(opacity));
+}
+
+void Blend::blend(Mode mode, const void* src, size_t src_pitch, void* dst, size_t dst_pitch,
+                  uint32_t width, uint32_t height, float opacity) {
+    const BlendFn fn = blend_fn(mode, "blend");
+    if (width == 0 || height == 0) return;
+    const uint32_t op = opacity_255(opacity);
+    const auto* s = static_cast<const uint8_t*>(src);
+    auto* d = static_cast<uint8_t*>(dst);
+    Scheduler::shared().for_each_band(height, (size_t)width * 4, [&](uint32_t y0, uint32_t y1) {
+        for (uint32_t y = y0; y < y1; ++y) fn(s + (size_t)y * src_pitch, d + (size_t)y * dst_pitch, width, op);
+    });
+}
+
+void Blend::chroma_key(DXGI_FORMAT format, void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                       float key_r, float key_g, float key_b, float tolerance, float softness) {
+    KeyParams k = {};
+    k.chroma = true;
+    byte_order(format, kCb, k.w[0]);
+    byte_order(format, kCr, k.w[1]);
+    const float r = key_r * 255.0f, g = key_g * 255.0f, b = key_b * 255.0f;
+    k.key_cb = r * kCb[0] + g * kCb[1] + b * kCb[2];
+    k.key_cr = r * kCr[0] + g * kCr[1] + b * kCr[2];
+    k.level = tolerance * 255.0f;
+    k.scale = key_scale(softness);
+    run_key("chroma_key", format, pixels, pitch, width, height, k);
+}
+
+void Blend::luma_key(DXGI_FORMAT format, void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                     float threshold, float softness, bool invert) {
+    KeyParams k = {};
+    k.chroma = false;
+    byte_order(format, kLuma, k.w[0]);
+    k.level = threshold * 255.0f;
+    k.scale = invert ? -key_scale(softness) : key_scale(softness);
+    run_key("luma_key", format, pixels, pitch, width, height, k);
+}
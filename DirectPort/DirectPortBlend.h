@@ -0,0 +1,47 @@
+// DirectPortBlend.h
+#pragma once
+
+#include "DirectPort.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace DirectPort::Blend {
+
+    // How a source layer lands on the destination, with A = source alpha times
+    // opacity:
+    //   Over               dst = src * A + dst * (1 - A)        (straight alpha)
+    //   PremultipliedOver  dst = src * opacity + dst * (1 - A)  (saturating)
+    //   Add                dst = dst + src * A                  (saturating)
+    //   Multiply           dst = dst * (src * A + (1 - A))
+    // Destination alpha always accumulates as A + dst_a * (1 - A), like the
+    // composite blend state.
+    enum class Mode { Over, PremultipliedOver, Add, Multiply };
+
+    const char* mode_name(Mode mode);
+
+    // The 8-bit four-channel formats the kernels handle: B8G8R8A8_UNORM and
+    // R8G8B8A8_UNORM. Blending is channel-order agnostic; keying is not.
+    bool is_supported(DXGI_FORMAT format);
+
+    // One row of `count` pixels with the active Convert kernel set. Every set
+    // produces the same bits as the scalar one, which is the reference.
+    void blend_row(Mode mode, const uint8_t* src, uint8_t* dst, uint32_t count, float opacity = 1.0f);
+
+    // A width x height region: src and dst point at its top-left pixels. Rows
+    // are split across Scheduler::shared().
+    void blend(Mode mode, const void* src, size_t src_pitch, void* dst, size_t dst_pitch,
+               uint32_t width, uint32_t height, float opacity = 1.0f);
+
+    // Keys rewrite alpha in place, multiplying it by a matte that is 0 inside
+    // the key, 1 beyond tolerance + softness and linear in between. Colours,
+    // tolerances and thresholds are in [0, 1].
+    //
+    // chroma_key measures the BT.709 CbCr distance to the key colour, so shading
+    // on a green screen stays keyed; luma_key keys out pixels darker than
+    // threshold, or brighter when invert is set.
+    void chroma_key(DXGI_FORMAT format, void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                    float key_r, float key_g, float key_b, float tolerance, float softness);
+    void luma_key(DXGI_FORMAT format, void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                  float threshold, float softness, bool invert = false);
+
+}
@@ -0,0 +1,65 @@
+#include "DirectPortBlend.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <array>
+#include <string>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    // A (height, width, 4) uint8 view whose rows may be strided, so a NumPy
+    // slice such as frame[y0:y1, x0:x1] addresses a region in place.
+    struct Pixels {
+        uint8_t* data;
+        size_t pitch;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    Pixels pixels_of(const char* what, const char* name, const py::array& array, bool writable) {
+        py::buffer_info info = array.request(writable);
+        if (info.format != py::format_descriptor<uint8_t>::format() || info.ndim != 3 || info.shape[2] != 4 ||
+            info.strides[2] != 1 || info.strides[1] != 4 || info.strides[0] < info.shape[1] * 4) {
+            throw py::value_error(std::string(what) + ": " + name + " must be a (height, width, 4) uint8 array with packed pixels.");
+        }
+        return { static_cast<uint8_t*>(info.ptr), (size_t)info.strides[0], (uint32_t)info.shape[1], (uint32_t)info.shape[0] };
+    }
+
+}
+
+void bind_blend(py::module_& m) {
+    py::enum_<Blend::Mode>(m, "BlendMode", "How blend_pixels and DeviceCPU.blend_texture combine a layer with what is below it.")
+        .value("Over", Blend::Mode::Over, "Straight-alpha source-over.")
+        .value("PremultipliedOver", Blend::Mode::PremultipliedOver, "Source-over for premultiplied colour.")
+        .value("Add", Blend::Mode::Add, "")
+        .value("Multiply", Blend::Mode::Multiply, "");
+
+    m.def("blend_pixels", [](const py::array& src, const py::array& dst, Blend::Mode mode, float opacity) {
+        const Pixels s = pixels_of("blend_pixels", "src", src, false);
+        const Pixels d = pixels_of("blend_pixels", "dst", dst, true);
+        if (s.width != d.width || s.height != d.height) {
+            throw py::value_error("blend_pixels: src and dst must have the same shape.");
+        }
+        py::gil_scoped_release release;
+        Blend::blend(mode, s.data, s.pitch, d.data, d.pitch, d.width, d.height, opacity);
+    }, py::arg("src"), py::arg("dst"), py::arg("mode") = Blend::Mode::Over, py::arg("opacity") = 1.0f,
+       "Blends src onto dst in place. Either may be a sliced region of a larger frame.");
+
+    m.def("chroma_key_pixels", [](const py::array& pixels, DXGI_FORMAT format, std::array<float, 3> key, float tolerance, float softness) {
+        const Pixels p = pixels_of("chroma_key_pixels", "pixels", pixels, true);
+        py::gil_scoped_release release;
+        Blend::chroma_key(format, p.data, p.pitch, p.width, p.height, key[0], key[1], key[2], tolerance, softness);
+    }, py::arg("pixels"), py::arg("format"), py::arg("key") = std::array<float, 3>{ 0.0f, 1.0f, 0.0f },
+       py::arg("tolerance") = 0.15f, py::arg("softness") = 0.1f,
+       "Scales alpha in place by a matte from the CbCr distance to the (r, g, b) key colour.");
+
+    m.def("luma_key_pixels", [](const py::array& pixels, DXGI_FORMAT format, float threshold, float softness, bool invert) {
+        const Pixels p = pixels_of("luma_key_pixels", "pixels", pixels, true);
+        py::gil_scoped_release release;
+        Blend::luma_key(format, p.data, p.pitch, p.width, p.height, threshold, softness, invert);
+    }, py::arg("pixels"), py::arg("format"), py::arg("threshold") = 0.1f, py::arg("softness") = 0.05f, py::arg("invert") = false,
+       "Scales alpha in place, keying out pixels darker than threshold (brighter when invert is set).");
+}
@@ -0,0 +1,809 @@
+// src/DirectPort/DirectPortCPU.cpp
+// The headless reference device. Pixel work is split into row bands that run on the
+// work-stealing Scheduler; copies go through DirectPortCopy, the hot 8-bit paths
+// (clear, bilinear blit) use SSE2 fixed-point kernels, and everything else goes
+// through float RGBA rows decoded and encoded by DirectPortConvert.
+
+#include "DirectPortCPU.h"
+#include "DirectPortInternal.h"
+#include "DirectPortComposite.h"
+#include "DirectPortCopy.h"
+#include "DirectPortDirtyRects.h"
+#include "DirectPortScheduler.h"
+#include "DirectPortConvert.h"
+#include "DirectPortFormats.h"
+#include "DirectPortResample.h"
+#include "DirectPortBlend.h"
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DP_CPU_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using namespace DirectPort;
+
+namespace {
+
+    bool is_rgba8(DXGI_FORMAT format) {
+        const Formats::Traits* t = Formats::find(format);
+        return Formats::is_convertible(format) && t->sample == Formats::Sample::U8 && t->channels == 4;
+    }
+
+    // Bilinear taps for one axis, matching a D3D linear/clamp sampler stretched
+    // over `dst_len` pixels: texel centre at (i + 0.5) / dst_len * src_len - 0.5.
+    struct Taps {
+        std::vector<uint32_t> i0;
+        std::vector<uint32_t> i1;
+        std::vector<float> f;
+        std::vector<int16_t> w7;
+    };
+
+    // A crop window maps the same way onto [crop_offset, crop_offset + crop_len);
+    // neighbours outside it are still read, as the GPU sampler would.
+    Taps build_taps(uint32_t dst_len, uint32_t src_len, double crop_offset = 0.0, double crop_len = 0.0) {
+        Taps t;
+        t.i0.resize(dst_len); t.i1.resize(dst_len); t.f.resize(dst_len); t.w7.resize(dst_len);
+        if (crop_len <= 0.0) crop_len = src_len;
+        const double scale = crop_len / (double)dst_len;
+        for (uint32_t i = 0; i < dst_len; ++i) {
+            double s = crop_offset + (i + 0.5) * scale - 0.5;
+            double fl = std::floor(s);
+            double frac = s - fl;
+            int64_t a = (int64_t)fl;
+            int64_t b = a + 1;
+            a = std::min<int64_t>(std::max<int64_t>(a, 0), src_len - 1);
+            b = std::min<int64_t>(std::max<int64_t>(b, 0), src_len - 1);
+            t.i0[i] = (uint32_t)a;
+            t.i1[i] = (uint32_t)b;
+            t.f[i] = (float)frac;
+            t.w7[i] = (int16_t)std::lround(frac * 128.0);
+        }
+        return t;
+    }
+
+    // Horizontal pass of the 8-bit bilinear kernel: 7-bit weights keep every
+    // intermediate under 2^15 so both passes can use pmaddwd.
+    void filter_row_rgba8(const uint8_t* row, const Taps& tx, uint32_t x_begin, uint32_t x_end, int16_t* out) {
+        uint32_t x = x_begin;
+        int16_t* o = out;
+#ifdef DP_CPU_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 2 <= x_end; x += 2, o += 8) {
+            uint32_t a0, b0, a1, b1;
+            memcpy(&a0, row + (size_t)tx.i0[x] * 4, 4);
+            memcpy(&b0, row + (size_t)tx.i1[x] * 4, 4);
+            memcpy(&a1, row + (size_t)tx.i0[x + 1] * 4, 4);
+            memcpy(&b1, row + (size_t)tx.i1[x + 1] * 4, 4);
+            __m128i ab0 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)a0), _mm_cvtsi32_si128((int)b0));
+            __m128i ab1 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)a1), _mm_cvtsi32_si128((int)b1));
+            __m128i w0 = _mm_set1_epi32(((int)tx.w7[x] << 16) | (128 - tx.w7[x]));
+            __m128i w1 = _mm_set1_epi32(((int)tx.w7[x + 1] << 16) | (128 - tx.w7[x + 1]));
+            __m128i r0 = _mm_madd_epi16(_mm_unpacklo_epi8(ab0, zero), w0);
+            __m128i r1 = _mm_madd_epi16(_mm_unpacklo_epi8(ab1, zero), w1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(o), _mm_packs_epi32(r0, r1));
+        }
+#endif
+        for (; x < x_end; ++x, o += 4) {
+            const uint8_t* a = row + (size_t)tx.i0[x] * 4;
+            const uint8_t* b = row + (size_t)tx.i1[x] * 4;
+            int w = tx.w7[x];
+            for (int c = 0; c < 4; ++c) o[c] = (int16_t)(a[c] * (128 - w) + b[c] * w);
+        }
+    }
+
+    // Vertical pass: (h0 * (128 - w) + h1 * w + 2^13) >> 14, optionally swapping R and B.
+    void blend_rows_rgba8(const int16_t* h0, const int16_t* h1, int w, uint32_t pixels, bool swap_rb, uint8_t* dst) {
+        uint32_t i = 0;
+#ifdef DP_CPU_SSE2
+        const __m128i wv = _mm_set1_epi32((w << 16) | (128 - w));
+        const __m128i round = _mm_set1_epi32(1 << 13);
+        for (; i + 2 <= pixels; i += 2) {
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h0 + i * 4));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h1 + i * 4));
+            __m128i lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(v0, v1), wv), round), 14);
+            __m128i hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(v0, v1), wv), round), 14);
+            __m128i px = _mm_packs_epi32(lo, hi);
+            if (swap_rb) {
+                px = _mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 0, 1, 2));
+                px = _mm_shufflehi_epi16(px, _MM_SHUFFLE(3, 0, 1, 2));
+            }
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i * 4), _mm_packus_epi16(px, px));
+        }
+#endif
+        for (; i < pixels; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                int v = (h0[i * 4 + c] * (128 - w) + h1[i * 4 + c] * w + (1 << 13)) >> 14;
+                int dc = swap_rb && c != 1 && c != 3 ? 2 - c : c;
+                dst[i * 4 + dc] = (uint8_t)std::min(std::max(v, 0), 255);
+            }
+        }
+    }
+
+    // Read-only view of a CPU texture's pixels, handed to the kernels below.
+    struct Surface {
+        const uint8_t* pixels;
+        size_t row_pitch;
+        uint32_t width;
+        uint32_t height;
+        DXGI_FORMAT format;
+    };
+
+    // Float bilinear sample of one destination row into RGBA floats.
+    void sample_row_float(const Surface& src, const Taps& tx, uint32_t x_begin, uint32_t x_end,
+                          uint32_t sy0, uint32_t sy1, float fy,
+                          std::vector<float>& row0, std::vector<float>& row1, float* out) {
+        row0.resize((size_t)src.width * 4);
+        row1.resize((size_t)src.width * 4);
+        Convert::decode_rgba32f(src.format, src.pixels + sy0 * src.row_pitch, row0.data(), src.width);
+        if (sy1 != sy0) {
+            Convert::decode_rgba32f(src.format, src.pixels + sy1 * src.row_pitch, row1.data(), src.width);
+        }
+        const float* r1 = sy1 != sy0 ? row1.data() : row0.data();
+        for (uint32_t x = x_begin; x < x_end; ++x) {
+            const float fx = tx.f[x];
+            const float* a0 = row0.data() + (size_t)tx.i0[x] * 4;
+            const float* b0 = row0.data() + (size_t)tx.i1[x] * 4;
+            const float* a1 = r1 + (size_t)tx.i0[x] * 4;
+            const float* b1 = r1 + (size_t)tx.i1[x] * 4;
+            float* o = out + (size_t)(x - x_begin) * 4;
+            for (int c = 0; c < 4; ++c) {
+                float top = a0[c] + (b0[c] - a0[c]) * fx;
+                float bottom = a1[c] + (b1[c] - a1[c]) * fx;
+                o[c] = top + (bottom - top) * fy;
+            }
+        }
+    }
+
+    inline uint16_t div255(uint32_t x) { x += 128; return (uint16_t)((x + (x >> 8)) >> 8); }
+
+    // Source-over for 8-bit RGBA rows already in the destination's channel order.
+    // The layer alpha is opacity, times the source alpha when use_source_alpha is set;
+    // the destination alpha accumulates as A + dst_a * (1 - A), like the GPU blend state.
+    void blend_over_rgba8(const uint8_t* src, uint8_t* dst, uint32_t pixels, uint32_t opacity255, bool use_source_alpha) {
+        uint32_t i = 0;
+#ifdef DP_CPU_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i c128 = _mm_set1_epi16(128);
+        const __m128i c255 = _mm_set1_epi16(255);
+        const __m128i op = _mm_set1_epi16((short)opacity255);
+        const __m128i alpha_lanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+        const __m128i rgb_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+        auto div255v = [&](__m128i x) {
+            x = _mm_add_epi16(x, c128);
+            return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+        };
+        for (; i + 2 <= pixels; i += 2) {
+            __m128i s = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i * 4)), zero);
+            __m128i d = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(dst + i * 4)), zero);
+            __m128i a = op;
+            if (use_source_alpha) {
+                __m128i sa = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                a = div255v(_mm_mullo_epi16(sa, op));
+            }
+            s = _mm_or_si128(_mm_and_si128(s, rgb_mask), alpha_lanes);
+            __m128i out = div255v(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(c255, a))));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i * 4), _mm_packus_epi16(out, out));
+        }
+#endif
+        for (; i < pixels; ++i) {
+            const uint8_t* s = src + i * 4;
+            uint8_t* d = dst + i * 4;
+            uint32_t a = use_source_alpha ? div255(s[3] * opacity255) : opacity255;
+            for (int c = 0; c < 3; ++c) d[c] = (uint8_t)div255(s[c] * a + d[c] * (255 - a));
+            d[3] = (uint8_t)div255(255 * a + d[3] * (255 - a));
+        }
+    }
+
+    // --- Built-in ops standing in for pixel shaders ---
+
+    typedef void (*OpFn)(float* out, const float* const* in, uint32_t count, const float* k);
+
+    struct BuiltinOp {
+        const char* name;
+        uint32_t inputs;
+        float defaults[4];
+        OpFn fn;
+    };
+
+    inline float luma(const float* p) { return 0.2126f * p[0] + 0.7152f * p[1] + 0.0722f * p[2]; }
+
+    const BuiltinOp g_builtinOps[] = {
+        { "black", 0, {0, 0, 0, 0}, [](float* out, const float* const*, uint32_t n, const float*) {
+            for (uint32_t i = 0; i < n; ++i) { out[i * 4] = 0; out[i * 4 + 1] = 0; out[i * 4 + 2] = 0; out[i * 4 + 3] = 1; }
+        } },
+        { "solid", 0, {0, 0, 0, 1}, [](float* out, const float* const*, uint32_t n, const float* k) {
+            for (uint32_t i = 0; i < n; ++i) for (int c = 0; c < 4; ++c) out[i * 4 + c] = k[c];
+        } },
+        { "copy", 1, {0, 0, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float*) {
+            memcpy(out, in[0], (size_t)n * 16);
+        } },
+        { "invert", 1, {0, 0, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float*) {
+            for (uint32_t i = 0; i < n * 4; i += 4) {
+                out[i] = 1.0f - in[0][i]; out[i + 1] = 1.0f - in[0][i + 1]; out[i + 2] = 1.0f - in[0][i + 2]; out[i + 3] = in[0][i + 3];
+            }
+        } },
+        { "grayscale", 1, {0, 0, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float*) {
+            for (uint32_t i = 0; i < n * 4; i += 4) {
+                float y = luma(in[0] + i);
+                out[i] = y; out[i + 1] = y; out[i + 2] = y; out[i + 3] = in[0][i + 3];
+            }
+        } },
+        { "brightness_contrast", 1, {0, 1, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float* k) {
+            for (uint32_t i = 0; i < n * 4; i += 4) {
+                for (int c = 0; c < 3; ++c) out[i + c] = (in[0][i + c] - 0.5f) * k[1] + 0.5f + k[0];
+                out[i + 3] = in[0][i + 3];
+            }
+        } },
+        { "threshold", 1, {0.5f, 0, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float* k) {
+            for (uint32_t i = 0; i < n * 4; i += 4) {
+                float v = luma(in[0] + i) >= k[0] ? 1.0f : 0.0f;
+                out[i] = v; out[i + 1] = v; out[i + 2] = v; out[i + 3] = in[0][i + 3];
+            }
+        } },
+        { "mix", 2, {0.5f, 0, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float* k) {
+            for (uint32_t i = 0; i < n * 4; ++i) out[i] = in[0][i] + (in[1][i] - in[0][i]) * k[0];
+        } },
+        { "add", 2, {0, 0, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float*) {
+            for (uint32_t i = 0; i < n * 4; i += 4) {
+                for (int c = 0; c < 3; ++c) out[i + c] = in[0][i + c] + in[1][i + c];
+                out[i + 3] = in[0][i + 3];
+            }
+        } },
+        { "multiply", 2, {0, 0, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float*) {
+            for (uint32_t i = 0; i < n * 4; ++i) out[i] = in[0][i] * in[1][i];
+        } },
+        { "difference", 2, {0, 0, 0, 0}, [](float* out, const float* const* in, uint32_t n, const float*) {
+            for (uint32_t i = 0; i < n * 4; i += 4) {
+                for (int c = 0; c < 3; ++c) out[i + c] = std::fabs(in[0][i + c] - in[1][i + c]);
+                out[i + 3] = in[0][i + 3];
+            }
+        } },
+    };
+
+    const BuiltinOp* find_builtin_op(const std::string& name) {
+        for (const auto& op : g_builtinOps) {
+            if (name == op.name) return &op;
+        }
+        return nullptr;
+    }
+}
+
+#ifndef _WIN32
+// DirectPort.cpp (and with it the D3D backends) only builds on Windows. Headless
+// builds get the Texture shell from here instead.
+Texture::Texture() : pImpl(std::make_unique<Impl>()) {}
+Texture::~Texture() = default;
+uint32_t Texture::get_width() const { return pImpl->width; }
+uint32_t Texture::get_height() const { return pImpl->height; }
+DXGI_FORMAT Texture::get_format() const { return pImpl->format; }
+uintptr_t Texture::get_d3d11_texture_ptr() { return 0; }
+uintptr_t Texture::get_d3d11_srv_ptr() { return 0; }
+uintptr_t Texture::get_d3d11_rtv_ptr() { return 0; }
+uintptr_t Texture::get_d3d12_resource_ptr() { return 0; }
+#endif
+
+uintptr_t Texture::get_cpu_ptr() { return pImpl->is_cpu ? reinterpret_cast<uintptr_t>(pImpl->cpuPixels.data()) : 0; }
+size_t Texture::get_cpu_row_pitch() const { return pImpl->cpuRowPitch; }
+
+struct DeviceCPU::Impl {
+    Scheduler* scheduler = nullptr;
+    std::unique_ptr<Scheduler> owned_scheduler;
+    std::unique_ptr<Readback::Queue> readback = std::make_unique<Readback::Queue>();
+
+    Texture::Impl& texture(const std::shared_ptr<Texture>& tex, const char* what) {
+        if (!tex || !tex->pImpl->is_cpu) {
+            throw std::invalid_argument(std::string("Invalid CPU texture for DeviceCPU::") + what + ". Check for null or incorrect API type.");
+        }
+        return *tex->pImpl;
+    }
+
+    static Surface surface(const Texture::Impl& t) {
+        return { t.cpuPixels.data(), t.cpuRowPitch, t.width, t.height, t.format };
+    }
+
+    // Splits [0, rows) into bands of at least `min_rows`, a few per lane so uneven
+    // bands still balance, and runs fn(first_row, end_row) on each.
+    void for_each_band(uint32_t rows, uint32_t min_rows, const std::function<void(uint32_t, uint32_t)>& fn) {
+        const uint32_t target_bands = scheduler->lanes() * 4;
+        const uint32_t band = std::max(min_rows, (rows + target_bands - 1) / target_bands);
+        const uint32_t bands = (rows + band - 1) / band;
+        scheduler->parallel_for(bands, [&](uint32_t b) {
+            const uint32_t y0 = b * band;
+            fn(y0, std::min(rows, y0 + band));
+        });
+    }
+};
+
+DeviceCPU::DeviceCPU() : pImpl(std::make_unique<Impl>()) {}
+DeviceCPU::~DeviceCPU() = default;
+
+std::shared_ptr<DeviceCPU> DeviceCPU::create(uint32_t thread_count) {
+    auto self = std::shared_ptr<DeviceCPU>(new DeviceCPU());
+    if (thread_count == 0) {
+        self->pImpl->scheduler = &Scheduler::shared();
+    } else {
+        self->pImpl->owned_scheduler = std::make_unique<Scheduler>(thread_count);
+        self->pImpl->scheduler = self->pImpl->owned_scheduler.get();
+    }
+    return self;
+}
+
+uint32_t DeviceCPU::get_thread_count() const {
+    return pImpl->scheduler->lanes();
+}
+
+Scheduler& DeviceCPU::get_scheduler() const {
+    return *pImpl->scheduler;
+}
+
+std::vector<std::string> DeviceCPU::get_builtin_ops() {
+    std::vector<std::string> names;
+    for (const auto& op : g_builtinOps) names.push_back(op.name);
+    return names;
+}
+
+std::shared_ptr<Texture> DeviceCPU::create_texture(uint32_t width, uint32_t height, DXGI_FORMAT format, const void* data, size_t data_size) {
+    const size_t bpp = Convert::bytes_per_pixel(format);
+    if (bpp == 0) {
+        throw std::runtime_error("Unsupported DXGI_FORMAT for DeviceCPU::create_texture.");
+    }
+    if (width == 0 || height == 0) {
+        throw std::invalid_argument("DeviceCPU::create_texture requires non-zero dimensions.");
+    }
+
+    auto tex = std::shared_ptr<Texture>(new Texture());
+    tex->pImpl->is_cpu = true;
+    tex->pImpl->width = width;
+    tex->pImpl->height = height;
+    tex->pImpl->format = format;
+    tex->pImpl->cpuRowPitch = width * bpp;
+    tex->pImpl->cpuPixels.assign(tex->pImpl->cpuRowPitch * height, 0);
+
+    if (data && data_size > 0) {
+        if (data_size < tex->pImpl->cpuPixels.size()) {
+            throw std::runtime_error("Initial data_size is too small for the specified dimensions and format for DeviceCPU::create_texture.");
+        }
+        Copy::copy(tex->pImpl->cpuPixels.data(), data, tex->pImpl->cpuPixels.size(), *pImpl->scheduler);
+    }
+    return tex;
+}
+
+std::shared_ptr<Producer> DeviceCPU::create_producer(const std::string&, std::shared_ptr<Texture>) {
+    throw std::runtime_error("DeviceCPU is headless and cannot share textures across processes.");
+}
+
+std::shared_ptr<Consumer> DeviceCPU::connect_to_producer(unsigned long) {
+    throw std::runtime_error("DeviceCPU is headless and cannot connect to producers.");
+}
+
+std::shared_ptr<Window> DeviceCPU::create_window(uint32_t, uint32_t, const std::string&) {
+    throw std::runtime_error("DeviceCPU is headless and cannot create windows.");
+}
+
+void DeviceCPU::resize_window(std::shared_ptr<Window>) {
+    throw std::runtime_error("DeviceCPU is headless and has no windows to resize.");
+}
+
+void DeviceCPU::blit(std::shared_ptr<Texture>, std::shared_ptr<Window>) {
+    throw std::runtime_error("DeviceCPU is headless and has no windows to blit to. Use blit_texture_to_region.");
+}
+
+void DeviceCPU::clear(std::shared_ptr<Window>, float, float, float, float) {
+    throw std::runtime_error("DeviceCPU is headless and has no windows to clear. Use clear_texture.");
+}
+
+void DeviceCPU::copy_texture(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination) {
+    auto& src = pImpl->texture(source, "copy_texture");
+    auto& dst = pImpl->texture(destination, "copy_texture");
+    if (src.width != dst.width || src.height != dst.height || src.format != dst.format) {
+        throw std::invalid_argument("Source and destination textures must have matching dimensions and format for DeviceCPU::copy_texture.");
+    }
+    if (&src == &dst) return;
+
+    Copy::copy(dst.cpuPixels.data(), src.cpuPixels.data(), src.cpuPixels.size(), *pImpl->scheduler);
+}
+
+void DeviceCPU::copy_texture_regions(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                     const std::vector<DirtyRect>& regions) {
+    auto& src = pImpl->texture(source, "copy_texture_regions");
+    auto& dst = pImpl->texture(destination, "copy_texture_regions");
+    if (src.width != dst.width || src.height != dst.height || src.format != dst.format) {
+        throw std::invalid_argument("Source and destination textures must have matching dimensions and format for DeviceCPU::copy_texture_regions.");
+    }
+    if (&src == &dst) return;
+
+    const size_t bpp = Convert::bytes_per_pixel(src.format);
+    for (const auto& area : DirtyRects::normalize(regions, src.width, src.height)) {
+        const size_t offset = (size_t)area.y * src.cpuRowPitch + (size_t)area.x * bpp;
+        Copy::copy_pixels(bpp, dst.cpuPixels.data() + offset, dst.cpuRowPitch, src.cpuPixels.data() + offset, src.cpuRowPitch,
+                          area.width, area.height, *pImpl->scheduler);
+    }
+}
+
+void DeviceCPU::clear_texture(std::shared_ptr<Texture> texture, float r, float g, float b, float a) {
+    auto& dst = pImpl->texture(texture, "clear_texture");
+    const float color[4] = { r, g, b, a };
+    const size_t bpp = Convert::bytes_per_pixel(dst.format);
+
+    // Build one full row once, then stamp it down every band.
+    std::vector<uint8_t> row(dst.cpuRowPitch);
+    Convert::encode_rgba32f(dst.format, color, row.data(), 1);
+    for (size_t filled = bpp; filled < row.size(); filled *= 2) {
+        memcpy(row.data() + filled, row.data(), std::min(filled, row.size() - filled));
+    }
+    pImpl->for_each_band(dst.height, 32, [&](uint32_t y0, uint32_t y1) {
+        for (uint32_t y = y0; y < y1; ++y) {
+            memcpy(dst.cpuPixels.data() + y * dst.cpuRowPitch, row.data(), row.size());
+        }
+    });
+}
+
+void DeviceCPU::resize_texture(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination, Resample::Filter filter) {
+    auto& src = pImpl->texture(source, "resize_texture");
+    auto& dst = pImpl->texture(destination, "resize_texture");
+    if (&src == &dst) {
+        throw std::invalid_argument("DeviceCPU::resize_texture cannot read and write the same texture.");
+    }
+    if (src.format == dst.format) {
+        Resample::resize(src.format, src.cpuPixels.data(), src.cpuRowPitch, src.width, src.height,
+                         dst.cpuPixels.data(), dst.cpuRowPitch, dst.width, dst.height, filter);
+        return;
+    }
+    // Filtered in the source format, then converted.
+    const size_t pitch = (size_t)dst.width * Convert::bytes_per_pixel(src.format);
+    std::vector<uint8_t> scaled(pitch * dst.height);
+    Resample::resize(src.format, src.cpuPixels.data(), src.cpuRowPitch, src.width, src.height,
+                     scaled.data(), pitch, dst.width, dst.height, filter);
+    Convert::convert(src.format, scaled.data(), pitch, dst.format, dst.cpuPixels.data(), dst.cpuRowPitch, dst.width, dst.height);
+}
+
+void DeviceCPU::blend_texture(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination, int32_t dest_x, int32_t dest_y,
+                              Blend::Mode mode, float opacity) {
+    auto& src = pImpl->texture(source, "blend_texture");
+    auto& dst = pImpl->texture(destination, "blend_texture");
+    if (&src == &dst) {
+        throw std::invalid_argument("DeviceCPU::blend_texture cannot read and write the same texture.");
+    }
+    if (!Blend::is_supported(src.format) || !Blend::is_supported(dst.format)) {
+        throw std::invalid_argument("DeviceCPU::blend_texture needs B8G8R8A8_UNORM or R8G8B8A8_UNORM textures.");
+    }
+    const int64_t x0 = std::max<int64_t>(dest_x, 0);
+    const int64_t y0 = std::max<int64_t>(dest_y, 0);
+    const int64_t x1 = std::min<int64_t>((int64_t)dest_x + src.width, dst.width);
+    const int64_t y1 = std::min<int64_t>((int64_t)dest_y + src.height, dst.height);
+    if (x0 >= x1 || y0 >= y1) return;
+    const uint32_t width = (uint32_t)(x1 - x0), height = (uint32_t)(y1 - y0);
+    const uint8_t* s = src.cpuPixels.data() + (size_t)(y0 - dest_y) * src.cpuRowPitch + (size_t)(x0 - dest_x) * 4;
+    uint8_t* d = dst.cpuPixels.data() + (size_t)y0 * dst.cpuRowPitch + (size_t)x0 * 4;
+    if (src.format == dst.format) {
+        Blend::blend(mode, s, src.cpuRowPitch, d, dst.cpuRowPitch, width, height, opacity);
+        return;
+    }
+    // Swizzled into the destination's channel order first.
+    std::vector<uint8_t> swizzled((size_t)width * height * 4);
+    Convert::convert(src.format, s, src.cpuRowPitch, dst.format, swizzled.data(), (size_t)width * 4, width, height);
+    Blend::blend(mode, swizzled.data(), (size_t)width * 4, d, dst.cpuRowPitch, width, height, opacity);
+}
+
+Stats::Result DeviceCPU::texture_stats(std::shared_ptr<Texture> texture) {
+    auto& tex = pImpl->texture(texture, "texture_stats");
+    return Stats::compute(tex.format, tex.cpuPixels.data(), tex.cpuRowPitch, tex.width, tex.height, *pImpl->scheduler);
+}
+
+FrameDiff::Result DeviceCPU::diff_texture(std::shared_ptr<Texture> texture, FrameDiff::Detector& detector) {
+    auto& tex = pImpl->texture(texture, "diff_texture");
+    return detector.update(tex.format, tex.cpuPixels.data(), tex.cpuRowPitch, tex.width, tex.height, *pImpl->scheduler);
+}
+
+namespace {
+
+    // A packed copy of a CPU texture taken at submission.
+    class SnapshotTransfer : public Readback::Transfer {
+    public:
+        SnapshotTransfer(std::vector<uint8_t> pixels, size_t pitch) : pixels_(std::move(pixels)), pitch_(pitch) {}
+        bool ready() override { return true; }
+        void read(const std::function<void(const void*, size_t)>& fn) override { fn(pixels_.data(), pitch_); }
+
+    private:
+        std::vector<uint8_t> pixels_;
+        size_t pitch_;
+    };
+
+}
+
+Readback::Future DeviceCPU::read_texture_async(std::shared_ptr<Texture> texture, DXGI_FORMAT format) {
+    auto& tex = pImpl->texture(texture, "read_texture_async");
+    const size_t pitch = Formats::row_pitch(tex.format, tex.width);
+    std::vector<uint8_t> pixels(pitch * tex.height);
+    Copy::copy_texels(tex.format, pixels.data(), pitch, tex.cpuPixels.data(), tex.cpuRowPitch, tex.width, tex.height, *pImpl->scheduler);
+    return pImpl->readback->push(std::make_unique<SnapshotTransfer>(std::move(pixels), pitch), tex.format, tex.width, tex.height, format);
+}
+
+Readback::Queue& DeviceCPU::get_readback_queue() const {
+    return *pImpl->readback;
+}
+
+void DeviceCPU::blit_texture_to_region(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                       uint32_t dest_x, uint32_t dest_y, uint32_t dest_width, uint32_t dest_height) {
+    auto& src = pImpl->texture(source, "blit_texture_to_region");
+    auto& dst = pImpl->texture(destination, "blit_texture_to_region");
+    if (dest_width == 0 || dest_height == 0) return;
+    if (dest_x >= dst.width || dest_y >= dst.height) return;
+    if (&src == &dst) {
+        throw std::invalid_argument("DeviceCPU::blit_texture_to_region cannot read and write the same texture.");
+    }
+
+    // The viewport may hang off the render target; only the visible part is written.
+    const uint32_t x_end = std::min<uint64_t>(dst.width - dest_x, dest_width);
+    const uint32_t y_end = std::min<uint64_t>(dst.height - dest_y, dest_height);
+
+    if (src.width == dest_width && src.height == dest_height) {
+        // Unscaled: rows are copied, or converted when the formats differ.
+        const size_t dst_bpp = Convert::bytes_per_pixel(dst.format);
+        pImpl->for_each_band(y_end, 32, [&](uint32_t y0, uint32_t y1) {
+            for (uint32_t y = y0; y < y1; ++y) {
+                Convert::convert_row(src.format, src.cpuPixels.data() + y * src.cpuRowPitch,
+                                     dst.format, dst.cpuPixels.data() + (dest_y + y) * dst.cpuRowPitch + dest_x * dst_bpp, x_end);
+            }
+        });
+        return;
+    }
+
+    const Taps tx = build_taps(dest_width, src.width);
+    const Taps ty = build_taps(dest_height, src.height);
+
+    if (is_rgba8(src.format) && is_rgba8(dst.format)) {
+        const bool swap_rb = Formats::traits(src.format).bgra != Formats::traits(dst.format).bgra;
+        pImpl->for_each_band(y_end, 16, [&](uint32_t y0, uint32_t y1) {
+            std::vector<int16_t> h0((size_t)x_end * 4), h1((size_t)x_end * 4);
+            int64_t cached0 = -1, cached1 = -1;
+            for (uint32_t y = y0; y < y1; ++y) {
+                const uint32_t sy0 = ty.i0[y], sy1 = ty.i1[y];
+                if (cached0 != sy0) {
+                    if (cached1 == sy0) { std::swap(h0, h1); std::swap(cached0, cached1); }
+                    else { filter_row_rgba8(src.cpuPixels.data() + sy0 * src.cpuRowPitch, tx, 0, x_end, h0.data()); cached0 = sy0; }
+                }
+                if (cached1 != sy1) {
+                    filter_row_rgba8(src.cpuPixels.data() + sy1 * src.cpuRowPitch, tx, 0, x_end, h1.data());
+                    cached1 = sy1;
+                }
+                uint8_t* out = dst.cpuPixels.data() + (dest_y + y) * dst.cpuRowPitch + (size_t)dest_x * 4;
+                blend_rows_rgba8(h0.data(), h1.data(), ty.w7[y], x_end, swap_rb, out);
+            }
+        });
+        return;
+    }
+
+    const size_t dst_bpp = Convert::bytes_per_pixel(dst.format);
+    const Surface src_view = Impl::surface(src);
+    pImpl->for_each_band(y_end, 8, [&](uint32_t y0, uint32_t y1) {
+        std::vector<float> row0, row1, out((size_t)x_end * 4);
+        for (uint32_t y = y0; y < y1; ++y) {
+            sample_row_float(src_view, tx, 0, x_end, ty.i0[y], ty.i1[y], ty.f[y], row0, row1, out.data());
+            Convert::encode_rgba32f(dst.format, out.data(), dst.cpuPixels.data() + (dest_y + y) * dst.cpuRowPitch + dest_x * dst_bpp, x_end);
+        }
+    });
+}
+
+void DeviceCPU::composite(std::shared_ptr<Texture> destination, const std::vector<CompositeLayer>& layers,
+                          bool clear, float r, float g, float b, float a, const std::optional<std::vector<DirtyRect>>& regions) {
+    auto& dst = pImpl->texture(destination, "composite");
+    const auto resolved = Composite::resolve_layers(dst.width, dst.height, layers);
+    const auto areas = Composite::resolve_regions(dst.width, dst.height, regions);
+    if (areas.empty()) return;
+    const bool dst_rgba8 = is_rgba8(dst.format);
+    const size_t dst_bpp = Convert::bytes_per_pixel(dst.format);
+
+    // Everything about a layer that does not depend on the row being drawn.
+    struct Plan {
+        Surface src;
+        Taps tx, ty;
+        int32_t x, y;
+        uint32_t col_begin, col_end, row_begin, row_end;
+        uint32_t opacity255;
+        float opacity;
+        bool blend;
+        bool use_source_alpha;
+        bool fast8;
+        bool swap_rb;
+        bool direct;
+        uint32_t direct_x, direct_y;
+    };
+    std::vector<Plan> plans;
+    plans.reserve(resolved.size());
+    for (const auto& rl : resolved) {
+        auto& src = pImpl->texture(rl.layer->source, "composite");
+        if (&src == &dst) {
+            throw std::invalid_argument("DeviceCPU::composite cannot read and write the same texture.");
+        }
+        Plan p;
+        p.src = Impl::surface(src);
+        p.x = rl.x;
+        p.y = rl.y;
+        // Columns and rows of the layer rect that land inside the destination.
+        p.col_begin = rl.x < 0 ? (uint32_t)-rl.x : 0;
+        p.row_begin = rl.y < 0 ? (uint32_t)-rl.y : 0;
+        p.col_end = (uint32_t)std::min<int64_t>(rl.width, (int64_t)dst.width - rl.x);
+        p.row_end = (uint32_t)std::min<int64_t>(rl.height, (int64_t)dst.height - rl.y);
+        p.opacity = std::min(rl.layer->opacity, 1.0f);
+        p.opacity255 = (uint32_t)(p.opacity * 255.0f + 0.5f);
+        p.use_source_alpha = rl.layer->use_source_alpha;
+        p.blend = p.use_source_alpha || p.opacity255 < 255;
+        p.fast8 = dst_rgba8 && is_rgba8(src.format);
+        p.swap_rb = p.fast8 && Formats::traits(src.format).bgra != Formats::traits(dst.format).bgra;
+        // Unscaled, pixel-aligned and same format: rows come straight from the source.
+        p.direct = src.format == dst.format && rl.crop_width == (float)rl.width && rl.crop_height == (float)rl.height &&
+                   rl.crop_x == std::floor(rl.crop_x) && rl.crop_y == std::floor(rl.crop_y);
+        p.direct_x = (uint32_t)rl.crop_x;
+        p.direct_y = (uint32_t)rl.crop_y;
+        if (!p.direct) {
+            p.tx = build_taps(rl.width, src.width, rl.crop_x, rl.crop_width);
+            p.ty = build_taps(rl.height, src.height, rl.crop_y, rl.crop_height);
+        }
+        plans.push_back(std::move(p));
+    }
+
+    std::vector<uint8_t> clear_row;
+    if (clear) {
+        const float color[4] = { r, g, b, a };
+        clear_row.resize(dst.cpuRowPitch);
+        Convert::encode_rgba32f(dst.format, color, clear_row.data(), 1);
+        for (size_t filled = dst_bpp; filled < clear_row.size(); filled *= 2) {
+            memcpy(clear_row.data() + filled, clear_row.data(), std::min(filled, clear_row.size() - filled));
+        }
+    }
+
+    // One pass over each region: each band of rows is cleared and receives
+    // every layer while it is still in cache. Regions never overlap.
+    for (const auto& area : areas) {
+        const uint32_t ax0 = area.x, ax1 = area.x + area.width;
+        pImpl->for_each_band(area.height, 16, [&](uint32_t band0, uint32_t band1) {
+            const uint32_t y0 = area.y + band0, y1 = area.y + band1;
+            struct Cache {
+                std::vector<int16_t> h0, h1;
+                int64_t row0 = -1, row1 = -1;
+            };
+            std::vector<Cache> caches(plans.size());
+            std::vector<uint8_t> span;
+            std::vector<float> acc, layer_row, scratch0, scratch1;
+
+            for (uint32_t y = y0; y < y1; ++y) {
+                uint8_t* out_row = dst.cpuPixels.data() + (size_t)y * dst.cpuRowPitch;
+                if (clear) memcpy(out_row + (size_t)ax0 * dst_bpp, clear_row.data(), (size_t)(ax1 - ax0) * dst_bpp);
+                bool acc_loaded = false;
+
+                for (size_t li = 0; li < plans.size(); ++li) {
+                    const Plan& p = plans[li];
+                    const int64_t ly = (int64_t)y - p.y;
+                    if (ly < p.row_begin || ly >= p.row_end) continue;
+                    // The layer's columns that fall inside this region.
+                    const int64_t first = std::max<int64_t>(p.col_begin, (int64_t)ax0 - p.x);
+                    const int64_t last = std::min<int64_t>(p.col_end, (int64_t)ax1 - p.x);
+                    if (first >= last) continue;
+                    const uint32_t col_begin = (uint32_t)first, col_end = (uint32_t)last;
+                    const uint32_t n = col_end - col_begin;
+                    const uint32_t dx = (uint32_t)(p.x + (int32_t)col_begin);
+
+                    if (dst_rgba8 && p.direct) {
+                        const uint8_t* src_px = p.src.pixels + (size_t)(p.direct_y + ly) * p.src.row_pitch + (size_t)(p.direct_x + col_begin) * 4;
+                        if (p.blend) blend_over_rgba8(src_px, out_row + (size_t)dx * 4, n, p.opacity255, p.use_source_alpha);
+                        else memcpy(out_row + (size_t)dx * 4, src_px, (size_t)n * 4);
+                        continue;
+                    }
+
+                    if (p.fast8) {
+                        Cache& c = caches[li];
+                        c.h0.resize((size_t)n * 4);
+                        c.h1.resize((size_t)n * 4);
+                        const uint32_t sy0 = p.ty.i0[ly], sy1 = p.ty.i1[ly];
+                        if (c.row0 != sy0) {
+                            if (c.row1 == sy0) { std::swap(c.h0, c.h1); std::swap(c.row0, c.row1); }
+                            else { filter_row_rgba8(p.src.pixels + (size_t)sy0 * p.src.row_pitch, p.tx, col_begin, col_end, c.h0.data()); c.row0 = sy0; }
+                        }
+                        if (c.row1 != sy1) {
+                            filter_row_rgba8(p.src.pixels + (size_t)sy1 * p.src.row_pitch, p.tx, col_begin, col_end, c.h1.data());
+                            c.row1 = sy1;
+                        }
+                        if (!p.blend) {
+                            blend_rows_rgba8(c.h0.data(), c.h1.data(), p.ty.w7[ly], n, p.swap_rb, out_row + (size_t)dx * 4);
+                        } else {
+                            span.resize((size_t)n * 4);
+                            blend_rows_rgba8(c.h0.data(), c.h1.data(), p.ty.w7[ly], n, p.swap_rb, span.data());
+                            blend_over_rgba8(span.data(), out_row + (size_t)dx * 4, n, p.opacity255, p.use_source_alpha);
+                        }
+                        continue;
+                    }
+
+                    // Everything else is blended in float RGBA. An 8-bit destination row is
+                    // re-read for each such layer because the fast paths above write it directly.
+                    if (dst_rgba8 || !acc_loaded) {
+                        acc.resize((size_t)dst.width * 4);
+                        Convert::decode_rgba32f(dst.format, out_row, acc.data(), dst.width);
+                        acc_loaded = true;
+                    }
+                    layer_row.resize((size_t)n * 4);
+                    if (p.direct) {
+                        const size_t src_bpp = Convert::bytes_per_pixel(p.src.format);
+                        Convert::decode_rgba32f(p.src.format, p.src.pixels + (size_t)(p.direct_y + ly) * p.src.row_pitch + (size_t)(p.direct_x + col_begin) * src_bpp, layer_row.data(), n);
+                    } else {
+                        sample_row_float(p.src, p.tx, col_begin, col_end, p.ty.i0[ly], p.ty.i1[ly], p.ty.f[ly], scratch0, scratch1, layer_row.data());
+                    }
+                    float* d = acc.data() + (size_t)dx * 4;
+                    for (uint32_t i = 0; i < n; ++i) {
+                        const float* s = layer_row.data() + (size_t)i * 4;
+                        const float al = (p.use_source_alpha ? s[3] : 1.0f) * p.opacity;
+                        for (int ch = 0; ch < 3; ++ch) d[i * 4 + ch] = s[ch] * al + d[i * 4 + ch] * (1.0f - al);
+                        d[i * 4 + 3] = al + d[i * 4 + 3] * (1.0f - al);
+                    }
+                    Convert::encode_rgba32f(dst.format, d, out_row + (size_t)dx * dst_bpp, n);
+                }
+            }
+        });
+    }
+}
+
+void DeviceCPU::apply_shader(std::shared_ptr<Texture> output, const std::vector<uint8_t>& shader_bytes, const std::string& entry_point, const std::vector<std::shared_ptr<Texture>>& inputs, const std::vector<uint8_t>& constants) {
+    auto& out = pImpl->texture(output, "apply_shader");
+
+    std::string name(shader_bytes.begin(), shader_bytes.end());
+    while (!name.empty() && (name.back() == '\0' || isspace((unsigned char)name.back()))) name.pop_back();
+    if (name.empty()) name = "black";
+
+    const BuiltinOp* op = find_builtin_op(name);
+    if (!op) {
+        std::string known;
+        for (const auto& o : g_builtinOps) known += std::string(known.empty() ? "" : ", ") + o.name;
+        throw std::invalid_argument("DeviceCPU cannot compile shaders; '" + name + "' is not a built-in op (" + known + ").");
+    }
+    if (inputs.size() < op->inputs) {
+        throw std::invalid_argument("DeviceCPU op '" + name + "' needs " + std::to_string(op->inputs) + " input texture(s).");
+    }
+
+    std::vector<Surface> srcs;
+    for (uint32_t i = 0; i < op->inputs; ++i) {
+        auto& in = pImpl->texture(inputs[i], "apply_shader");
+        if (&in == &out) {
+            throw std::invalid_argument("DeviceCPU::apply_shader cannot read and write the same texture.");
+        }
+        srcs.push_back(Impl::surface(in));
+    }
+
+    float k[16] = {};
+    memcpy(k, op->defaults, sizeof(op->defaults));
+    if (!constants.empty()) memcpy(k, constants.data(), std::min(constants.size() / sizeof(float) * sizeof(float), sizeof(k)));
+
+    // Inputs are sampled with the same linear/clamp filter the D3D devices bind,
+    // so inputs that differ in size from the output are stretched to fit.
+    std::vector<Taps> tx, ty;
+    for (const auto& in : srcs) {
+        tx.push_back(build_taps(out.width, in.width));
+        ty.push_back(build_taps(out.height, in.height));
+    }
+
+    pImpl->for_each_band(out.height, 8, [&](uint32_t y0, uint32_t y1) {
+        std::vector<std::vector<float>> rows(srcs.size(), std::vector<float>((size_t)out.width * 4));
+        std::vector<const float*> in_rows(srcs.size());
+        std::vector<float> scratch0, scratch1, result((size_t)out.width * 4);
+        for (uint32_t y = y0; y < y1; ++y) {
+            for (size_t i = 0; i < srcs.size(); ++i) {
+                const Surface& in = srcs[i];
+                if (in.width == out.width && in.height == out.height) {
+                    Convert::decode_rgba32f(in.format, in.pixels + y * in.row_pitch, rows[i].data(), in.width);
+                } else {
+                    sample_row_float(in, tx[i], 0, out.width, ty[i].i0[y], ty[i].i1[y], ty[i].f[y], scratch0, scratch1, rows[i].data());
+                }
+                in_rows[i] = rows[i].data();
+            }
+            op->fn(result.data(), in_rows.data(), out.width, k);
+            Convert::encode_rgba32f(out.format, result.data(), out.cpuPixels.data() + y * out.cpuRowPitch, out.width);
+        }
+    });
+    (void)entry_point;
+}
@@ -0,0 +1,84 @@
+// DirectPortCPU.h
+#pragma once
+
+#include "DirectPort.h"
+#include "DirectPortBlend.h"
+#include "DirectPortFrameDiff.h"
+#include "DirectPortReadback.h"
+#include "DirectPortResample.h"
+#include "DirectPortScheduler.h"
+#include "DirectPortStats.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace DirectPort {
+
+    // A headless reference device. Textures live in system memory in their native
+    // DXGI layout, and every operation runs on the CPU across a pool of worker
+    // threads, so pipelines built on IDirectXDevice can run (and be benchmarked)
+    // on machines without a GPU or without Windows at all.
+    //
+    // apply_shader cannot run HLSL here. Instead the shader argument names one of
+    // the built-in ops listed by get_builtin_ops(); constants are read as floats in
+    // cbuffer order. An empty shader produces opaque black, as on the D3D devices.
+    //
+    // There are no windows or cross-process streams on this device: create_window,
+    // blit, clear, create_producer and connect_to_producer throw. Use clear_texture
+    // to fill a texture.
+    class DeviceCPU : public IDirectXDevice, public std::enable_shared_from_this<DeviceCPU> {
+    public:
+        // thread_count == 0 shares Scheduler::shared() with the rest of the
+        // process; otherwise the device gets a private pool of that many lanes.
+        static std::shared_ptr<DeviceCPU> create(uint32_t thread_count = 0);
+        ~DeviceCPU() override;
+
+        std::shared_ptr<Texture> create_texture(uint32_t width, uint32_t height, DXGI_FORMAT format, const void* data = nullptr, size_t data_size = 0) override;
+        std::shared_ptr<Producer> create_producer(const std::string& stream_name, std::shared_ptr<Texture> texture) override;
+        std::shared_ptr<Consumer> connect_to_producer(unsigned long pid) override;
+        std::shared_ptr<Window> create_window(uint32_t width, uint32_t height, const std::string& title) override;
+        void resize_window(std::shared_ptr<Window> window) override;
+
+        void apply_shader(std::shared_ptr<Texture> output, const std::vector<uint8_t>& shader_bytes, const std::string& entry_point, const std::vector<std::shared_ptr<Texture>>& inputs, const std::vector<uint8_t>& constants) override;
+        void copy_texture(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination) override;
+        void blit(std::shared_ptr<Texture> source, std::shared_ptr<Window> destination) override;
+        void clear(std::shared_ptr<Window> window, float r, float g, float b, float a) override;
+        void blit_texture_to_region(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                    uint32_t dest_x, uint32_t dest_y, uint32_t dest_width, uint32_t dest_height) override;
+        void composite(std::shared_ptr<Texture> destination, const std::vector<CompositeLayer>& layers,
+                       bool clear, float r, float g, float b, float a,
+                       const std::optional<std::vector<DirtyRect>>& regions = std::nullopt) override;
+        void copy_texture_regions(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                  const std::vector<DirtyRect>& regions) override;
+
+        void clear_texture(std::shared_ptr<Texture> texture, float r, float g, float b, float a);
+        // Scales all of source onto all of destination with a Resample filter bank.
+        // blit_texture_to_region matches the GPU's bilinear sampler instead, which
+        // skips source pixels when shrinking by more than 2x.
+        void resize_texture(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                            Resample::Filter filter = Resample::Filter::Bilinear);
+        // Blends all of source, unscaled, onto destination with its top-left at
+        // (dest_x, dest_y), clipped to the destination. Both textures must be
+        // B8G8R8A8_UNORM or R8G8B8A8_UNORM.
+        void blend_texture(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination, int32_t dest_x, int32_t dest_y,
+                           Blend::Mode mode = Blend::Mode::Over, float opacity = 1.0f);
+        // Histograms and moments of the whole texture, reduced on this device's lanes.
+        Stats::Result texture_stats(std::shared_ptr<Texture> texture);
+        // Feeds the texture's current contents to `detector` as its next frame.
+        FrameDiff::Result diff_texture(std::shared_ptr<Texture> texture, FrameDiff::Detector& detector);
+        // Snapshots the texture now, as a GPU device would copy it, and reads
+        // it back through this device's Readback::Queue, converting to
+        // `format` if given. The snapshot is the copy, so it is always ready.
+        Readback::Future read_texture_async(std::shared_ptr<Texture> texture, DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN);
+        Readback::Queue& get_readback_queue() const;
+        uint32_t get_thread_count() const;
+        Scheduler& get_scheduler() const;
+        static std::vector<std::string> get_builtin_ops();
+
+    private:
+        DeviceCPU();
+        struct Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+}
@@ -0,0 +1,189 @@
+#include "DirectPortCPU.h"
+#include "DirectPortNumpyPixels.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+std::vector<CompositeLayer> composite_layers_from_python(const py::iterable& items);
+std::vector<DirtyRect> dirty_rects_from_python(const py::object& items);
+
+void bind_cpu(py::module_& m) {
+#ifndef _WIN32
+    // Without Windows there is no bind_prime, so the shared types are registered here.
+    py::enum_<DXGI_FORMAT>(m, "DXGI_FORMAT", "")
+        .value("B8G8R8A8_UNORM", DXGI_FORMAT_B8G8R8A8_UNORM, "")
+        .value("R32G32B32A32_FLOAT", DXGI_FORMAT_R32G32B32A32_FLOAT, "")
+        .value("R16G16B16A16_FLOAT", DXGI_FORMAT_R16G16B16A16_FLOAT, "")
+        .value("R10G10B10A2_UNORM", DXGI_FORMAT_R10G10B10A2_UNORM, "")
+        .value("R8G8B8A8_UNORM", DXGI_FORMAT_R8G8B8A8_UNORM, "")
+        .value("R32_FLOAT", DXGI_FORMAT_R32_FLOAT, "")
+        .value("R16_FLOAT", DXGI_FORMAT_R16_FLOAT, "")
+        .value("R8_UNORM", DXGI_FORMAT_R8_UNORM, "")
+        .value("R8G8_UNORM", DXGI_FORMAT_R8G8_UNORM, "")
+        .export_values();
+
+    py::class_<Texture, std::shared_ptr<Texture>>(m, "Texture", "")
+        .def_property_readonly("width", &Texture::get_width, "")
+        .def_property_readonly("height", &Texture::get_height, "")
+        .def_property_readonly("format", &Texture::get_format, "")
+        .def("get_cpu_ptr", &Texture::get_cpu_ptr, "")
+        .def_property_readonly("cpu_row_pitch", &Texture::get_cpu_row_pitch, "")
+        .def("__dlpack__", &Numpy::texture_dlpack, "CPU textures share their pixels as a DLPack tensor.")
+        .def("__dlpack_device__", &Numpy::texture_dlpack_device, "");
+#endif
+
+    auto create_texture_cpu = [](DeviceCPU& self, uint32_t w, uint32_t h, DXGI_FORMAT f, py::object data) {
+        if (data.is_none()) {
+            return self.create_texture(w, h, f, nullptr, 0);
+        }
+        py::buffer_info info = py::buffer(data).request();
+        return self.create_texture(w, h, f, info.ptr, (size_t)(info.size * info.itemsize));
+    };
+
+    // Python objects are unpacked while the GIL is held; only the pixel work runs without it.
+    auto apply_shader_lambda_cpu = [](DeviceCPU& self, std::shared_ptr<Texture> output, const py::object& shader, const std::string& entry_point, const py::list& inputs, const py::bytes& constants) {
+        std::vector<uint8_t> shader_bytes;
+        if (py::isinstance<py::str>(shader) || py::isinstance<py::bytes>(shader)) {
+            std::string op = shader.cast<std::string>();
+            shader_bytes.assign(op.begin(), op.end());
+        } else if (!shader.is_none()) {
+            throw py::type_error("Shader must be str or bytes naming a built-in op.");
+        }
+        std::vector<std::shared_ptr<Texture>> cpp_inputs;
+        for (const auto& item : inputs) {
+            cpp_inputs.push_back(item.cast<std::shared_ptr<Texture>>());
+        }
+        std::string_view const_sv(constants);
+        std::vector<uint8_t> const_bytes(const_sv.begin(), const_sv.end());
+        py::gil_scoped_release release;
+        self.apply_shader(output, shader_bytes, entry_point, cpp_inputs, const_bytes);
+    };
+
+    auto composite_cpu = [](DeviceCPU& self, std::shared_ptr<Texture> destination, const py::iterable& layers, bool clear, std::tuple<float, float, float, float> background, const py::object& regions) {
+        auto cpp_layers = composite_layers_from_python(layers);
+        // None redraws everything; an empty list means nothing changed.
+        std::optional<std::vector<DirtyRect>> cpp_regions;
+        if (!regions.is_none()) cpp_regions = dirty_rects_from_python(regions);
+        py::gil_scoped_release release;
+        self.composite(destination, cpp_layers, clear, std::get<0>(background), std::get<1>(background), std::get<2>(background), std::get<3>(background), cpp_regions);
+    };
+
+    auto copy_texture_regions_cpu = [](DeviceCPU& self, std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination, const py::object& regions) {
+        auto cpp_regions = dirty_rects_from_python(regions);
+        py::gil_scoped_release release;
+        self.copy_texture_regions(source, destination, cpp_regions);
+    };
+
+    // The same array rules as directport.numpy on the D3D devices; CPU textures are read in place.
+    auto format_or_unknown = [](const py::object& format) {
+        return format.is_none() ? DXGI_FORMAT_UNKNOWN : format.cast<DXGI_FORMAT>();
+    };
+
+    auto read_texture_cpu = [format_or_unknown](DeviceCPU&, std::shared_ptr<Texture> texture, const py::object& format, const py::object& dtype,
+                                                const py::object& out, const py::object& rect) {
+        if (!texture || !texture->get_cpu_ptr()) {
+            throw py::value_error("read_texture: not a DeviceCPU texture.");
+        }
+        const DirtyRect box = Numpy::region(rect, texture->get_width(), texture->get_height());
+        const size_t pitch = texture->get_cpu_row_pitch();
+        const auto* src = reinterpret_cast<const uint8_t*>(texture->get_cpu_ptr()) + Numpy::texel_offset(texture->get_format(), pitch, box.x, box.y);
+        return Numpy::read_pixels(texture->get_format(), src, pitch, box.width, box.height, format_or_unknown(format), dtype, out);
+    };
+
+    auto write_texture_cpu = [format_or_unknown](DeviceCPU&, std::shared_ptr<Texture> texture, const py::object& pixels, const py::object& format,
+                                                 const py::object& dest) {
+        if (!texture || !texture->get_cpu_ptr()) {
+            throw py::value_error("write_texture: not a DeviceCPU texture.");
+        }
+        const py::array array = Numpy::as_array(pixels);
+        const DirtyRect box = Numpy::placement(dest, array, texture->get_width(), texture->get_height());
+        const size_t pitch = texture->get_cpu_row_pitch();
+        auto* dst = reinterpret_cast<uint8_t*>(texture->get_cpu_ptr()) + Numpy::texel_offset(texture->get_format(), pitch, box.x, box.y);
+        Numpy::write_pixels(texture->get_format(), dst, pitch, box.width, box.height, array, format_or_unknown(format));
+    };
+
+    auto read_textures_cpu = [format_or_unknown](DeviceCPU&, const py::iterable& textures, const py::object& format, const py::object& dtype,
+                                                 const py::object& size, Resample::Filter filter, const py::object& out) {
+        std::vector<Numpy::Source> sources;
+        for (const auto& item : textures) {
+            auto texture = item.cast<std::shared_ptr<Texture>>();
+            if (!texture || !texture->get_cpu_ptr()) {
+                throw py::value_error("read_textures: not a DeviceCPU texture.");
+            }
+            sources.push_back({ texture->get_format(), reinterpret_cast<const void*>(texture->get_cpu_ptr()), texture->get_cpu_row_pitch(),
+                                texture->get_width(), texture->get_height() });
+        }
+        return Numpy::read_batch(sources, format_or_unknown(format), dtype, size, filter, out);
+    };
+
+    auto read_texture_async_cpu = [format_or_unknown](DeviceCPU& self, std::shared_ptr<Texture> texture, const py::object& format,
+                                                      const py::object& dtype, const py::object& callback) {
+        if (!texture || !texture->get_cpu_ptr()) {
+            throw py::value_error("read_texture_async: not a DeviceCPU texture.");
+        }
+        const DXGI_FORMAT out_format = Numpy::readback_format(texture->get_format(), format_or_unknown(format), dtype);
+        Readback::Future future;
+        {
+            py::gil_scoped_release release;
+            future = self.read_texture_async(texture, out_format);
+        }
+        Numpy::then_array(future, callback);
+        return future;
+    };
+
+    // CPU textures are already in memory: the view is over the texture itself.
+    auto map_texture_cpu = [](DeviceCPU&, std::shared_ptr<Texture> texture, bool writable) {
+        if (!texture || !texture->get_cpu_ptr()) {
+            throw py::value_error("map_texture: not a DeviceCPU texture.");
+        }
+        void* data = reinterpret_cast<void*>(texture->get_cpu_ptr());
+        return Numpy::Mapping(texture->get_format(), data, texture->get_cpu_row_pitch(), texture->get_width(), texture->get_height(),
+                              texture, writable);
+    };
+
+    py::class_<DeviceCPU, std::shared_ptr<DeviceCPU>>(m, "DeviceCPU", "A headless device that runs every operation on CPU worker threads.")
+        .def_static("create", &DeviceCPU::create, py::arg("thread_count") = 0, "")
+        .def_static("builtin_ops", &DeviceCPU::get_builtin_ops, "Names accepted as the shader argument of apply_shader.")
+        .def_property_readonly("thread_count", &DeviceCPU::get_thread_count, "")
+        .def_property_readonly("scheduler_stats", [](const DeviceCPU& self) { return self.get_scheduler().get_stats(); }, "")
+        .def("reset_scheduler_stats", [](const DeviceCPU& self) { self.get_scheduler().reset_stats(); }, "")
+        .def("create_texture", create_texture_cpu, py::arg("width"), py::arg("height"), py::arg("format"), py::arg("data") = py::none(), "")
+        .def("apply_shader", apply_shader_lambda_cpu, py::arg("output"), py::arg("shader"), py::arg("entry_point") = "PSMain", py::arg("inputs") = py::list(), py::arg("constants") = py::bytes(""), "")
+        .def("read_texture", read_texture_cpu, py::arg("texture"), py::arg("format") = py::none(), py::arg("dtype") = py::none(),
+             py::arg("out") = py::none(), py::arg("rect") = py::none(),
+             "A new array of the texture, or of `rect`, converted to `format` and `dtype` if given, or `out` filled.")
+        .def("read_textures", read_textures_cpu, py::arg("textures"), py::arg("format") = py::none(), py::arg("dtype") = py::none(),
+             py::arg("size") = py::none(), py::arg("filter") = Resample::Filter::Bilinear, py::arg("out") = py::none(),
+             "Reads several textures into one (N, H, W, C) array, resized to `size` (width, height) if given.")
+        .def("write_texture", write_texture_cpu, py::arg("texture"), py::arg("numpy_array"), py::arg("format") = py::none(),
+             py::arg("dest") = py::none(), "Writes an array or DLPack tensor into the texture, at `dest` (x, y) if given, converting from the format its dtype implies.")
+        .def("map_texture", map_texture_cpu, py::arg("texture"), py::arg("writable") = true,
+             "A TextureMapping viewing the texture's pixels without a copy; writes land in the texture.")
+        .def("read_texture_async", read_texture_async_cpu, py::arg("texture"), py::arg("format") = py::none(), py::arg("dtype") = py::none(),
+             py::arg("callback") = py::none(), "Snapshots the texture and returns a ReadbackFuture for its array.")
+        .def_property("readback_depth", [](const DeviceCPU& self) { return self.get_readback_queue().depth(); },
+                      [](DeviceCPU& self, uint32_t depth) { self.get_readback_queue().set_depth(depth); },
+                      "Readbacks kept in flight before the oldest is resolved.")
+        .def_property_readonly("readback_stats", [](const DeviceCPU& self) { return self.get_readback_queue().get_stats(); }, "")
+        .def("reset_readback_stats", [](const DeviceCPU& self) { self.get_readback_queue().reset_stats(); }, "")
+        .def("poll_readbacks", [](const DeviceCPU& self) { return self.get_readback_queue().poll(); },
+             "Resolves finished readbacks without waiting; returns how many.", py::call_guard<py::gil_scoped_release>())
+        .def("flush_readbacks", [](const DeviceCPU& self) { self.get_readback_queue().flush(); },
+             "Resolves every readback in flight.", py::call_guard<py::gil_scoped_release>())
+        .def("copy_texture", &DeviceCPU::copy_texture, py::arg("source"), py::arg("destination"), "", py::call_guard<py::gil_scoped_release>())
+        .def("copy_texture_regions", copy_texture_regions_cpu, py::arg("source"), py::arg("destination"), py::arg("regions"), "")
+        .def("clear_texture", &DeviceCPU::clear_texture, py::arg("texture"), py::arg("r"), py::arg("g"), py::arg("b"), py::arg("a"), "", py::call_guard<py::gil_scoped_release>())
+        .def("resize_texture", &DeviceCPU::resize_texture, py::arg("source"), py::arg("destination"),
+             py::arg("filter") = Resample::Filter::Bilinear, "", py::call_guard<py::gil_scoped_release>())
+        .def("blend_texture", &DeviceCPU::blend_texture, py::arg("source"), py::arg("destination"), py::arg("dest_x"), py::arg("dest_y"),
+             py::arg("mode") = Blend::Mode::Over, py::arg("opacity") = 1.0f, "", py::call_guard<py::gil_scoped_release>())
+        .def("texture_stats", &DeviceCPU::texture_stats, py::arg("texture"), "", py::call_guard<py::gil_scoped_release>())
+        .def("diff_texture", &DeviceCPU::diff_texture, py::arg("texture"), py::arg("detector"), "", py::call_guard<py::gil_scoped_release>())
+        .def("blit_texture_to_region", &DeviceCPU::blit_texture_to_region, py::arg("source"), py::arg("destination"),
+             py::arg("dest_x"), py::arg("dest_y"), py::arg("dest_width"), py::arg("dest_height"),
+             "", py::call_guard<py::gil_scoped_release>())
+        .def("composite", composite_cpu, py::arg("destination"), py::arg("layers"), py::arg("clear") = true,
+             py::arg("background") = std::make_tuple(0.0f, 0.0f, 0.0f, 1.0f), py::arg("regions") = py::none(), "");
+}
@@ -1,4 +1,5 @@
 #include "DirectPortCamera.h"
+#include "DirectPortCopy.h"
 #include <d3dcompiler.h>
 
 #pragma comment(lib, "user32.lib")
@@ -37,13 +38,13 @@ DirectPortCamera::~DirectPortCamera() {
     CoUninitialize();
 }
 
-void DirectPortCamera::init() {
-    createSourceReader();
+void DirectPortCamera::init(bool native_yuv) {
+    createSourceReader(native_yuv);
 }
 
 // --- Original Methods Implementation ---
 
-void DirectPortCamera::createSourceReader() {
+void DirectPortCamera::createSourceReader(bool native_yuv) {
     ComPtr<IMFAttributes> attributes;
     CHK(MFCreateAttributes(&attributes, 1));
     CHK(attributes->SetGUID(MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE, MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE_VIDCAP_GUID));
@@ -69,6 +70,11 @@ void DirectPortCamera::createSourceReader() {
     CHK(configAttributes->SetUINT32(MF_SOURCE_READER_ENABLE_VIDEO_PROCESSING, TRUE));
     CHK(MFCreateSourceReaderFromMediaSource(mediaSource.Get(), configAttributes.Get(), &m_sourceReader));
 
+    m_nativeYuv = false;
+    if (native_yuv && selectNativeYuv()) {
+        return;
+    }
+
     // --- THIS IS THE VERBATIM CORRECT LOGIC FROM YOUR WORKING FILE ---
     ComPtr<IMFMediaType> outputType;
     CHK(MFCreateMediaType(&outputType));
@@ -100,6 +106,49 @@ void DirectPortCamera::createSourceReader() {
 }
 
 
+// Picks the first native type the YUV converter reads, along with the matrix
+// and range the camera reports for it.
+bool DirectPortCamera::selectNativeYuv() {
+    using namespace DirectPort;
+    for (DWORD i = 0; ; ++i) {
+        ComPtr<IMFMediaType> nativeType;
+        HRESULT hr = m_sourceReader->GetNativeMediaType((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, i, &nativeType);
+        if (hr == MF_E_NO_MORE_TYPES) {
+            return false;
+        }
+        CHK(hr);
+
+        GUID subtype = GUID_NULL;
+        if (FAILED(nativeType->GetGUID(MF_MT_SUBTYPE, &subtype))) continue;
+        YUV::Format format;
+        if (subtype == MFVideoFormat_NV12) format = YUV::Format::NV12;
+        else if (subtype == MFVideoFormat_YUY2) format = YUV::Format::YUY2;
+        else if (subtype == MFVideoFormat_UYVY) format = YUV::Format::UYVY;
+        else if (subtype == MFVideoFormat_I420 || subtype == MFVideoFormat_IYUV) format = YUV::Format::I420;
+        else if (subtype == MFVideoFormat_P010) format = YUV::Format::P010;
+        else continue;
+
+        if (FAILED(m_sourceReader->SetCurrentMediaType((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, NULL, nativeType.Get()))) continue;
+
+        UINT32 width = 0, height = 0;
+        MFGetAttributeSize(nativeType.Get(), MF_MT_FRAME_SIZE, &width, &height);
+        switch (MFGetAttributeUINT32(nativeType.Get(), MF_MT_YUV_MATRIX, MFVideoTransferMatrix_Unknown)) {
+        case MFVideoTransferMatrix_BT601: m_yuvMatrix = YUV::Matrix::BT601; break;
+        case MFVideoTransferMatrix_BT709:
+        case MFVideoTransferMatrix_SMPTE240M: m_yuvMatrix = YUV::Matrix::BT709; break;
+        case MFVideoTransferMatrix_BT2020_10:
+        case MFVideoTransferMatrix_BT2020_12: m_yuvMatrix = YUV::Matrix::BT2020; break;
+        // Unspecified: the usual convention is 601 for SD and 709 above it.
+        default: m_yuvMatrix = height < 720 ? YUV::Matrix::BT601 : YUV::Matrix::BT709; break;
+        }
+        m_yuvRange = MFGetAttributeUINT32(nativeType.Get(), MF_MT_VIDEO_NOMINAL_RANGE, MFNominalRange_16_235) == MFNominalRange_0_255
+            ? YUV::Range::Full : YUV::Range::Limited;
+        m_yuvFormat = format;
+        m_nativeYuv = true;
+        return true;
+    }
+}
+
 void DirectPortCamera::startCapture() { m_isCapturing = true; }
 void DirectPortCamera::stopCapture() { m_isCapturing = false; }
 bool DirectPortCamera::isRunning() const { return m_isCapturing; }
@@ -112,6 +161,11 @@ FrameData DirectPortCamera::getFrame() {
     HRESULT hr = m_sourceReader->ReadSample((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, NULL, &streamFlags, &timestamp, &pSample);
     if (FAILED(hr) || !pSample) return {};
 
+    ComPtr<IMFMediaType> pType;
+    CHK(m_sourceReader->GetCurrentMediaType((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, &pType));
+    UINT32 width, height;
+    CHK(MFGetAttributeSize(pType.Get(), MF_MT_FRAME_SIZE, &width, &height));
+
     ComPtr<IMFMediaBuffer> pBuffer;
     CHK(pSample->ConvertToContiguousBuffer(&pBuffer));
 
@@ -120,14 +174,33 @@ FrameData DirectPortCamera::getFrame() {
     CHK(pBuffer->Lock(&pData, NULL, &currentLength));
 
     FrameData frame;
-    frame.data.assign(pData, pData + currentLength);
+    if (m_nativeYuv) {
+        // Converted once, straight out of the locked sample into the frame.
+        // Contiguous buffers normally use the minimum stride; trust the type's
+        // default stride only when the buffer is large enough to hold it.
+        size_t pitch = MFGetAttributeUINT32(pType.Get(), MF_MT_DEFAULT_STRIDE, 0);
+        if (currentLength < DirectPort::YUV::frame_size(m_yuvFormat, width, height, pitch)) pitch = 0;
+        if (currentLength >= DirectPort::YUV::frame_size(m_yuvFormat, width, height, pitch)) {
+            frame.data.resize((size_t)width * height * 4);
+            DirectPort::YUV::to_rgb(DirectPort::YUV::describe(m_yuvFormat, pData, width, height, pitch),
+                                    DirectPort::YUV::Output::BGRA8, frame.data.data(), width, height, m_yuvMatrix, m_yuvRange);
+        }
+    } else {
+        // RGB32 leaves the fourth byte undefined; make it opaque on the way out
+        // of the sample when the buffer holds exactly the packed frame.
+        frame.data.resize(currentLength);
+        if (currentLength == (size_t)width * height * 4) {
+            DirectPort::Copy::Swizzle swizzle;
+            swizzle.fill_alpha = true;
+            DirectPort::Copy::transfer(swizzle, frame.data.data(), (size_t)width * 4, pData, (size_t)width * 4, width, height);
+        } else {
+            DirectPort::Copy::copy(frame.data.data(), pData, currentLength);
+        }
+    }
 
     CHK(pBuffer->Unlock());
 
-    ComPtr<IMFMediaType> pType;
-    CHK(m_sourceReader->GetCurrentMediaType((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, &pType));
-    UINT32 width, height;
-    CHK(MFGetAttributeSize(pType.Get(), MF_MT_FRAME_SIZE, &width, &height));
+    if (frame.data.empty()) return {};
     frame.width = width; frame.height = height; frame.channels = 4;
     return frame;
 }
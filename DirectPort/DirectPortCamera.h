@@ -17,6 +17,8 @@
 #include <mfreadwrite.h>
 #include <wrl/client.h>
 
+#include "DirectPortYUV.h"
+
 #define CHK(hr) if (FAILED(hr)) { std::stringstream ss; ss << "HRESULT failed: 0x" << std::hex << hr; throw std::runtime_error(ss.str()); }
 
 // Forward-declare the Window class
@@ -35,7 +37,10 @@ public:
     ~DirectPortCamera();
 
     // --- Original Methods (for NumPy/OpenCV) ---
-    void init();
+    // native_yuv keeps the camera's own NV12/YUY2/UYVY/I420/P010 output and
+    // converts each frame to BGRA once on the CPU, instead of going through the
+    // Media Foundation video processor. Falls back to RGB32 if no YUV type is offered.
+    void init(bool native_yuv = false);
     void startCapture();
     void stopCapture();
     bool isRunning() const;
@@ -48,12 +53,19 @@ public:
     void present(std::shared_ptr<Window> window);
 
 private:
-    void createSourceReader();
+    void createSourceReader(bool native_yuv);
+    bool selectNativeYuv();
     void init_d3d11(); // To initialize rendering device
 
     Microsoft::WRL::ComPtr<IMFSourceReader> m_sourceReader;
     std::atomic<bool> m_isCapturing = false;
 
+    // Set when frames arrive as YUV and are converted in getFrame().
+    bool m_nativeYuv = false;
+    DirectPort::YUV::Format m_yuvFormat = DirectPort::YUV::Format::NV12;
+    DirectPort::YUV::Matrix m_yuvMatrix = DirectPort::YUV::Matrix::BT709;
+    DirectPort::YUV::Range m_yuvRange = DirectPort::YUV::Range::Limited;
+
     // --- NEW D3D11 Member Variables for Rendering ---
     Microsoft::WRL::ComPtr<ID3D11Device> m_d3d_device;
     Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_d3d_context;
@@ -1,4 +1,5 @@
 #include "DirectPortCamera.h"
+#include "DirectPortCopy.h"
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
@@ -10,7 +11,7 @@ py::array frame_to_numpy(const FrameData& frame) {
         return py::array();
     }
     py::array_t<uint8_t> result({(py::ssize_t)frame.height, (py::ssize_t)frame.width, (py::ssize_t)frame.channels});
-    std::memcpy(result.mutable_data(), frame.data.data(), frame.data.size());
+    DirectPort::Copy::copy(result.mutable_data(), frame.data.data(), frame.data.size());
     return result;
 }
 
@@ -23,7 +24,8 @@ void bind_camera(py::module_& m) {
     py::class_<DirectPortCamera>(m, "DirectPortCamera")
         .def(py::init<>())
         // Original methods
-        .def("init", &DirectPortCamera::init, "Initializes the camera source.")
+        .def("init", &DirectPortCamera::init, py::arg("native_yuv") = false,
+            "Initializes the camera source. native_yuv converts the camera's YUV frames on the CPU.")
         .def("start_capture", &DirectPortCamera::startCapture, "Starts the capture process.")
         .def("stop_capture", &DirectPortCamera::stopCapture, "Stops the capture process.")
         .def("is_running", &DirectPortCamera::isRunning, "Checks if the camera is capturing.")
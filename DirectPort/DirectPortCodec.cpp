@@ -0,0 +1,880 @@
+// src/DirectPort/DirectPortCodec.cpp
+// Each tile is one task on both sides. Encoding computes residuals in pixel
+// order, splits them into byte planes padded to whole 32-byte blocks, and
+// packs every plane. Decoding
+// unpacks the planes, interleaves them back and undoes the prediction in
+// place. Tiles are encoded into their own buffers and then copied into the
+// frame in parallel, so a frame costs one pass over the pixels per side.
+
+#include "DirectPortCodec.h"
+#include "DirectPortConvert.h"
+#include "DirectPortCopy.h"
+#include "DirectPortFormats.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "DirectPortSimd.h"
+
+using namespace DirectPort;
+using Codec::TileMode;
+
+namespace {
+
+    constexpr size_t kBlock = 32;
+
+    // --- Byte order helpers (the format is little-endian, like every target) ---
+
+    inline void put16(uint8_t* p, uint16_t v) { memcpy(p, &v, 2); }
+    inline void put32(uint8_t* p, uint32_t v) { memcpy(p, &v, 4); }
+    inline void put64(uint8_t* p, uint64_t v) { memcpy(p, &v, 8); }
+    inline uint16_t get16(const uint8_t* p) { uint16_t v; memcpy(&v, p, 2); return v; }
+    inline uint32_t get32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+    inline uint64_t get64(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+
+    inline size_t round_up(size_t n) {
+        return (n + kBlock - 1) / kBlock * kBlock;
+    }
+
+    // Bytes pack_plane may write for an n-byte plane: the width nibbles and
+    // eight bit planes per block.
+    inline size_t packed_bound(size_t n) {
+        const size_t blocks = round_up(n) / kBlock;
+        return (blocks + 1) / 2 + blocks * kBlock;
+    }
+
+    // --- Plane kernels ---
+
+    // Packs an n-byte plane of residuals, padded with zeros to whole blocks,
+    // and returns the bytes written.
+    using PackFn = size_t (*)(const uint8_t* residual, size_t n, uint8_t* out);
+    // Unpacks a plane packed by PackFn into round_up(n) residual bytes and
+    // returns the bytes read; throws when the input runs out.
+    using UnpackFn = size_t (*)(const uint8_t* in, size_t available, size_t n, uint8_t* residual);
+
+    // Width nibbles first, then the payload they describe; returns the payload
+    // size after checking every width.
+    size_t payload_bytes(const uint8_t* in, size_t available, size_t blocks) {
+        const size_t header = (blocks + 1) / 2;
+        if (header > available) {
+            throw std::runtime_error("Codec::decode: truncated tile.");
+        }
+        size_t total = 0;
+        for (size_t b = 0; b < blocks; ++b) {
+            const uint32_t width = (in[b / 2] >> (4 * (b & 1))) & 0xF;
+            if (width > 8) {
+                throw std::runtime_error("Codec::decode: corrupt tile.");
+            }
+            total += width * 4;
+        }
+        if (total > available - header) {
+            throw std::runtime_error("Codec::decode: truncated tile.");
+        }
+        return total;
+    }
+
+    inline uint8_t zigzag(uint8_t r) {
+        return (uint8_t)((r << 1) ^ ((int8_t)r >> 7));
+    }
+
+    inline uint8_t unzigzag(uint8_t z) {
+        return (uint8_t)((z >> 1) ^ (0u - (z & 1)));
+    }
+
+    size_t pack_scalar(const uint8_t* residual, size_t n, uint8_t* out) {
+        const size_t blocks = round_up(n) / kBlock;
+        uint8_t* widths = out;
+        uint8_t* payload = out + (blocks + 1) / 2;
+        memset(widths, 0, (blocks + 1) / 2);
+        for (size_t b = 0; b < blocks; ++b) {
+            uint8_t z[kBlock];
+            uint8_t any = 0;
+            for (size_t i = 0; i < kBlock; ++i) {
+                z[i] = zigzag(residual[b * kBlock + i]);
+                any |= z[i];
+            }
+            uint32_t width = 0;
+            while (any >> width) ++width;
+            for (uint32_t j = 0; j < width; ++j) {
+                uint32_t mask = 0;
+                for (size_t i = 0; i < kBlock; ++i) mask |= (uint32_t)((z[i] >> j) & 1) << i;
+                put32(payload, mask);
+                payload += 4;
+            }
+            widths[b / 2] |= (uint8_t)(width << (4 * (b & 1)));
+        }
+        return (size_t)(payload - out);
+    }
+
+    size_t unpack_scalar(const uint8_t* in, size_t available, size_t n, uint8_t* residual) {
+        const size_t blocks = round_up(n) / kBlock;
+        const size_t total = payload_bytes(in, available, blocks);
+        const uint8_t* payload = in + (blocks + 1) / 2;
+        for (size_t b = 0; b < blocks; ++b) {
+            const uint32_t width = (in[b / 2] >> (4 * (b & 1))) & 0xF;
+            uint8_t z[kBlock] = {};
+            for (uint32_t j = 0; j < width; ++j) {
+                const uint32_t mask = get32(payload);
+                payload += 4;
+                for (size_t i = 0; i < kBlock; ++i) z[i] |= (uint8_t)(((mask >> i) & 1) << j);
+            }
+            for (size_t i = 0; i < kBlock; ++i) residual[b * kBlock + i] = unzigzag(z[i]);
+        }
+        return (blocks + 1) / 2 + total;
+    }
+
+    // Residual rows. diff returns the OR of everything it wrote, so a tile
+    // identical to the previous frame is known without a second pass.
+    using DiffFn = uint8_t (*)(const uint8_t* a, const uint8_t* b, uint8_t* d, size_t n);
+    using AddFn = void (*)(uint8_t* d, const uint8_t* e, size_t n);
+    // d[i] = a[i] - a[i - bpp] and its inverse d[i] = e[i] + d[i - bpp], for
+    // bpp <= i < n.
+    using LeftFn = void (*)(const uint8_t* a, uint8_t* d, size_t n, size_t bpp);
+    using UnleftFn = void (*)(uint8_t* d, const uint8_t* e, size_t n, size_t bpp);
+    // Four-byte pixels to and from four planes `stride` bytes apart.
+    using Split4Fn = void (*)(const uint8_t* px, size_t n, uint8_t* planes, size_t stride);
+    using Merge4Fn = void (*)(const uint8_t* planes, size_t stride, size_t n, uint8_t* px);
+
+    uint8_t diff_scalar(const uint8_t* a, const uint8_t* b, uint8_t* d, size_t n) {
+        uint8_t any = 0;
+        for (size_t i = 0; i < n; ++i) {
+            d[i] = (uint8_t)(a[i] - b[i]);
+            any |= d[i];
+        }
+        return any;
+    }
+
+    void add_scalar(uint8_t* d, const uint8_t* e, size_t n) {
+        for (size_t i = 0; i < n; ++i) d[i] = (uint8_t)(d[i] + e[i]);
+    }
+
+    void left_scalar(const uint8_t* a, uint8_t* d, size_t n, size_t bpp) {
+        for (size_t i = bpp; i < n; ++i) d[i] = (uint8_t)(a[i] - a[i - bpp]);
+    }
+
+    void unleft_scalar(uint8_t* d, const uint8_t* e, size_t n, size_t bpp) {
+        for (size_t i = bpp; i < n; ++i) d[i] = (uint8_t)(e[i] + d[i - bpp]);
+    }
+
+    void split4_scalar(const uint8_t* px, size_t n, uint8_t* planes, size_t stride) {
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t k = 0; k < 4; ++k) planes[k * stride + p] = px[p * 4 + k];
+        }
+    }
+
+    void merge4_scalar(const uint8_t* planes, size_t stride, size_t n, uint8_t* px) {
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t k = 0; k < 4; ++k) px[p * 4 + k] = planes[k * stride + p];
+        }
+    }
+
+#if DP_SIMD_X86
+    DP_TARGET("sse4.1")
+    uint8_t diff_sse41(const uint8_t* a, const uint8_t* b, uint8_t* d, size_t n) {
+        __m128i any = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+            _mm_storeu_si128((__m128i*)(d + i), v);
+            any = _mm_or_si128(any, v);
+        }
+        // The tail must be written even when the vector part already differs.
+        const uint8_t tail = diff_scalar(a + i, b + i, d + i, n - i);
+        return (uint8_t)((_mm_testz_si128(any, any) == 0) || tail != 0);
+    }
+
+    DP_TARGET("sse4.1")
+    void add_sse41(uint8_t* d, const uint8_t* e, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v = _mm_add_epi8(_mm_loadu_si128((const __m128i*)(d + i)), _mm_loadu_si128((const __m128i*)(e + i)));
+            _mm_storeu_si128((__m128i*)(d + i), v);
+        }
+        add_scalar(d + i, e + i, n - i);
+    }
+
+    DP_TARGET("sse4.1")
+    void left_sse41(const uint8_t* a, uint8_t* d, size_t n, size_t bpp) {
+        size_t i = bpp;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(a + i - bpp)));
+            _mm_storeu_si128((__m128i*)(d + i), v);
+        }
+        for (; i < n; ++i) d[i] = (uint8_t)(a[i] - a[i - bpp]);
+    }
+
+    // A prefix sum over pixels: log2(16 / bpp) shifted adds sum each vector,
+    // then the last pixel of the previous vector is broadcast and added. Pixels
+    // of 16 bytes or more have no dependency inside a vector.
+    DP_TARGET("sse4.1")
+    void unleft_sse41(uint8_t* d, const uint8_t* e, size_t n, size_t bpp) {
+        if (bpp >= 16) {
+            size_t i = bpp;
+            for (; i + 16 <= n; i += 16) {
+                const __m128i v = _mm_add_epi8(_mm_loadu_si128((const __m128i*)(e + i)), _mm_loadu_si128((const __m128i*)(d + i - bpp)));
+                _mm_storeu_si128((__m128i*)(d + i), v);
+            }
+            unleft_scalar(d + i - bpp, e + i - bpp, n - (i - bpp), bpp);
+            return;
+        }
+        if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8) {
+            unleft_scalar(d, e, n, bpp);
+            return;
+        }
+        // The first pixel is already in d; carry holds it in every slot.
+        __m128i carry;
+        switch (bpp) {
+        case 1: carry = _mm_set1_epi8((char)d[0]); break;
+        case 2: { uint16_t v; memcpy(&v, d, 2); carry = _mm_set1_epi16((short)v); break; }
+        case 4: carry = _mm_set1_epi32((int)get32(d)); break;
+        default: carry = _mm_set1_epi64x((long long)get64(d)); break;
+        }
+        const __m128i last = bpp == 1 ? _mm_set1_epi8(15) : bpp == 2 ? _mm_setr_epi8(14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15)
+                           : bpp == 4 ? _mm_setr_epi8(12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15)
+                                      : _mm_setr_epi8(8, 9, 10, 11, 12, 13, 14, 15, 8, 9, 10, 11, 12, 13, 14, 15);
+        size_t i = bpp;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(e + i));
+            if (bpp <= 1) v = _mm_add_epi8(v, _mm_slli_si128(v, 1));
+            if (bpp <= 2) v = _mm_add_epi8(v, _mm_slli_si128(v, 2));
+            if (bpp <= 4) v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+            v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+            v = _mm_add_epi8(v, carry);
+            _mm_storeu_si128((__m128i*)(d + i), v);
+            carry = _mm_shuffle_epi8(v, last);
+        }
+        for (; i < n; ++i) d[i] = (uint8_t)(e[i] + d[i - bpp]);
+    }
+
+    // Sixteen pixels: gather each channel's bytes within a vector, then a 4x4
+    // transpose of 32-bit groups leaves one channel per vector.
+    DP_TARGET("sse4.1")
+    void split4_sse41(const uint8_t* px, size_t n, uint8_t* planes, size_t stride) {
+        const __m128i gather = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+        size_t p = 0;
+        for (; p + 16 <= n; p += 16) {
+            __m128i v[4];
+            for (int k = 0; k < 4; ++k) v[k] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(px + p * 4 + 16 * k)), gather);
+            const __m128i t0 = _mm_unpacklo_epi32(v[0], v[1]), t1 = _mm_unpackhi_epi32(v[0], v[1]);
+            const __m128i t2 = _mm_unpacklo_epi32(v[2], v[3]), t3 = _mm_unpackhi_epi32(v[2], v[3]);
+            _mm_storeu_si128((__m128i*)(planes + p), _mm_unpacklo_epi64(t0, t2));
+            _mm_storeu_si128((__m128i*)(planes + stride + p), _mm_unpackhi_epi64(t0, t2));
+            _mm_storeu_si128((__m128i*)(planes + 2 * stride + p), _mm_unpacklo_epi64(t1, t3));
+            _mm_storeu_si128((__m128i*)(planes + 3 * stride + p), _mm_unpackhi_epi64(t1, t3));
+        }
+        for (; p < n; ++p) {
+            for (size_t k = 0; k < 4; ++k) planes[k * stride + p] = px[p * 4 + k];
+        }
+    }
+
+    DP_TARGET("sse4.1")
+    void merge4_sse41(const uint8_t* planes, size_t stride, size_t n, uint8_t* px) {
+        size_t p = 0;
+        for (; p + 16 <= n; p += 16) {
+            const __m128i c0 = _mm_loadu_si128((const __m128i*)(planes + p));
+            const __m128i c1 = _mm_loadu_si128((const __m128i*)(planes + stride + p));
+            const __m128i c2 = _mm_loadu_si128((const __m128i*)(planes + 2 * stride + p));
+            const __m128i c3 = _mm_loadu_si128((const __m128i*)(planes + 3 * stride + p));
+            const __m128i t0 = _mm_unpacklo_epi8(c0, c1), t1 = _mm_unpackhi_epi8(c0, c1);
+            const __m128i t2 = _mm_unpacklo_epi8(c2, c3), t3 = _mm_unpackhi_epi8(c2, c3);
+            _mm_storeu_si128((__m128i*)(px + p * 4), _mm_unpacklo_epi16(t0, t2));
+            _mm_storeu_si128((__m128i*)(px + p * 4 + 16), _mm_unpackhi_epi16(t0, t2));
+            _mm_storeu_si128((__m128i*)(px + p * 4 + 32), _mm_unpacklo_epi16(t1, t3));
+            _mm_storeu_si128((__m128i*)(px + p * 4 + 48), _mm_unpackhi_epi16(t1, t3));
+        }
+        for (; p < n; ++p) {
+            for (size_t k = 0; k < 4; ++k) px[p * 4 + k] = planes[k * stride + p];
+        }
+    }
+
+    // Shifting 16-bit lanes left by 7 - j puts bit j of every byte in its top
+    // bit, where movemask collects it; bits carried in from the low byte never
+    // reach the top of the high one.
+    DP_TARGET("sse4.1")
+    size_t pack_sse41(const uint8_t* residual, size_t n, uint8_t* out) {
+        const size_t blocks = round_up(n) / kBlock;
+        uint8_t* widths = out;
+        uint8_t* payload = out + (blocks + 1) / 2;
+        memset(widths, 0, (blocks + 1) / 2);
+        const __m128i zero = _mm_setzero_si128();
+        for (size_t b = 0; b < blocks; ++b) {
+            __m128i r[2] = { _mm_loadu_si128((const __m128i*)(residual + b * kBlock)),
+                             _mm_loadu_si128((const __m128i*)(residual + b * kBlock + 16)) };
+            for (auto& v : r) v = _mm_xor_si128(_mm_add_epi8(v, v), _mm_cmpgt_epi8(zero, v));
+            uint32_t masks[8];
+            uint32_t width = 0;
+            for (int j = 0; j < 8; ++j) {
+                const int shift = 7 - j;
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                masks[j] = (uint32_t)_mm_movemask_epi8(_mm_sll_epi16(r[0], count)) |
+                           (uint32_t)_mm_movemask_epi8(_mm_sll_epi16(r[1], count)) << 16;
+                if (masks[j]) width = j + 1;
+            }
+            memcpy(payload, masks, width * 4);
+            payload += width * 4;
+            widths[b / 2] |= (uint8_t)(width << (4 * (b & 1)));
+        }
+        return (size_t)(payload - out);
+    }
+
+    // Each mask bit becomes a byte again: copy the mask byte covering eight
+    // output bytes into all of them, isolate one bit per byte and compare.
+    DP_TARGET("sse4.1")
+    size_t unpack_sse41(const uint8_t* in, size_t available, size_t n, uint8_t* residual) {
+        const size_t blocks = round_up(n) / kBlock;
+        const size_t total = payload_bytes(in, available, blocks);
+        const uint8_t* payload = in + (blocks + 1) / 2;
+        const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+        const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        const __m128i one = _mm_set1_epi8(1);
+        const __m128i low7 = _mm_set1_epi8(0x7F);
+        for (size_t b = 0; b < blocks; ++b) {
+            const uint32_t width = (in[b / 2] >> (4 * (b & 1))) & 0xF;
+            __m128i z0 = _mm_setzero_si128(), z1 = _mm_setzero_si128();
+            for (uint32_t j = 0; j < width; ++j) {
+                const uint32_t mask = get32(payload);
+                payload += 4;
+                const __m128i bit = _mm_set1_epi8((char)(1 << j));
+                const __m128i lo = _mm_shuffle_epi8(_mm_cvtsi32_si128((int)(mask & 0xFFFF)), spread);
+                const __m128i hi = _mm_shuffle_epi8(_mm_cvtsi32_si128((int)(mask >> 16)), spread);
+                z0 = _mm_or_si128(z0, _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(lo, bits), bits), bit));
+                z1 = _mm_or_si128(z1, _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(hi, bits), bits), bit));
+            }
+            for (int h = 0; h < 2; ++h) {
+                const __m128i z = h ? z1 : z0;
+                const __m128i r = _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(z, 1), low7),
+                                                _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(z, one)));
+                _mm_storeu_si128((__m128i*)(residual + b * kBlock + 16 * h), r);
+            }
+        }
+        return (blocks + 1) / 2 + total;
+    }
+
+    DP_TARGET("avx2")
+    size_t pack_avx2(const uint8_t* residual, size_t n, uint8_t* out) {
+        const size_t blocks = round_up(n) / kBlock;
+        uint8_t* widths = out;
+        uint8_t* payload = out + (blocks + 1) / 2;
+        memset(widths, 0, (blocks + 1) / 2);
+        const __m256i zero = _mm256_setzero_si256();
+        for (size_t b = 0; b < blocks; ++b) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(residual + b * kBlock));
+            v = _mm256_xor_si256(_mm256_add_epi8(v, v), _mm256_cmpgt_epi8(zero, v));
+            uint32_t masks[8];
+            masks[7] = (uint32_t)_mm256_movemask_epi8(v);
+            masks[6] = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(v, 1));
+            masks[5] = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(v, 2));
+            masks[4] = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(v, 3));
+            masks[3] = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(v, 4));
+            masks[2] = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(v, 5));
+            masks[1] = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(v, 6));
+            masks[0] = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(v, 7));
+            uint32_t width = 8;
+            while (width > 0 && masks[width - 1] == 0) --width;
+            memcpy(payload, masks, width * 4);
+            payload += width * 4;
+            widths[b / 2] |= (uint8_t)(width << (4 * (b & 1)));
+        }
+        return (size_t)(payload - out);
+    }
+
+    DP_TARGET("avx2")
+    size_t unpack_avx2(const uint8_t* in, size_t available, size_t n, uint8_t* residual) {
+        const size_t blocks = round_up(n) / kBlock;
+        const size_t total = payload_bytes(in, available, blocks);
+        const uint8_t* payload = in + (blocks + 1) / 2;
+        const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+        const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                              1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        const __m256i one = _mm256_set1_epi8(1);
+        const __m256i low7 = _mm256_set1_epi8(0x7F);
+        for (size_t b = 0; b < blocks; ++b) {
+            const uint32_t width = (in[b / 2] >> (4 * (b & 1))) & 0xF;
+            __m256i z = _mm256_setzero_si256();
+            for (uint32_t j = 0; j < width; ++j) {
+                const __m256i m = _mm256_shuffle_epi8(_mm256_set1_epi32((int)get32(payload)), spread);
+                payload += 4;
+                const __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(m, bits), bits);
+                z = _mm256_or_si256(z, _mm256_and_si256(set, _mm256_set1_epi8((char)(1 << j))));
+            }
+            const __m256i r = _mm256_xor_si256(_mm256_and_si256(_mm256_srli_epi16(z, 1), low7),
+                                               _mm256_sub_epi8(_mm256_setzero_si256(), _mm256_and_si256(z, one)));
+            _mm256_storeu_si256((__m256i*)(residual + b * kBlock), r);
+        }
+        return (blocks + 1) / 2 + total;
+    }
+#endif
+
+    struct Kernels {
+        PackFn pack;
+        UnpackFn unpack;
+        DiffFn diff;
+        AddFn add;
+        LeftFn left;
+        UnleftFn unleft;
+        Split4Fn split4;
+        Merge4Fn merge4;
+    };
+
+    const Kernels kScalar = { pack_scalar, unpack_scalar, diff_scalar, add_scalar, left_scalar, unleft_scalar,
+                              split4_scalar, merge4_scalar };
+#if DP_SIMD_X86
+    const Kernels kSSE41 = { pack_sse41, unpack_sse41, diff_sse41, add_sse41, left_sse41, unleft_sse41,
+                             split4_sse41, merge4_sse41 };
+    // The row kernels are load/store bound, so AVX2 keeps the SSE4.1 ones.
+    const Kernels kAVX2 = { pack_avx2, unpack_avx2, diff_sse41, add_sse41, left_sse41, unleft_sse41,
+                            split4_sse41, merge4_sse41 };
+#endif
+
+    const Kernels& kernels() {
+#if DP_SIMD_X86
+        const Convert::Isa isa = Convert::active_isa();
+        if (isa >= Convert::Isa::AVX2) return kAVX2;
+        if (isa >= Convert::Isa::SSE41) return kSSE41;
+#endif
+        return kScalar;
+    }
+
+    // --- Byte planes ---
+
+    template <size_t B>
+    void split_fixed(const uint8_t* px, size_t n, uint8_t* planes, size_t stride) {
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t k = 0; k < B; ++k) planes[k * stride + p] = px[p * B + k];
+        }
+    }
+
+    template <size_t B>
+    void merge_fixed(const uint8_t* planes, size_t stride, size_t n, uint8_t* px) {
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t k = 0; k < B; ++k) px[p * B + k] = planes[k * stride + p];
+        }
+    }
+
+    void split(size_t bpp, const uint8_t* px, size_t n, uint8_t* planes, size_t stride) {
+        switch (bpp) {
+        case 1: memcpy(planes, px, n); return;
+        case 2: split_fixed<2>(px, n, planes, stride); return;
+        case 4: kernels().split4(px, n, planes, stride); return;
+        case 8: split_fixed<8>(px, n, planes, stride); return;
+        case 16: split_fixed<16>(px, n, planes, stride); return;
+        }
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t k = 0; k < bpp; ++k) planes[k * stride + p] = px[p * bpp + k];
+        }
+    }
+
+    void merge(size_t bpp, const uint8_t* planes, size_t stride, size_t n, uint8_t* px) {
+        switch (bpp) {
+        case 1: memcpy(px, planes, n); return;
+        case 2: merge_fixed<2>(planes, stride, n, px); return;
+        case 4: kernels().merge4(planes, stride, n, px); return;
+        case 8: merge_fixed<8>(planes, stride, n, px); return;
+        case 16: merge_fixed<16>(planes, stride, n, px); return;
+        }
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t k = 0; k < bpp; ++k) px[p * bpp + k] = planes[k * stride + p];
+        }
+    }
+
+    // --- Tiles ---
+
+    struct Geometry {
+        size_t bpp;
+        uint32_t width;
+        uint32_t height;
+        uint32_t tile_size;
+        uint32_t tiles_x;
+        uint32_t tiles_y;
+    };
+
+    struct TileRect {
+        uint32_t x0;
+        uint32_t y0;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    TileRect tile_rect(const Geometry& g, uint32_t t) {
+        const uint32_t x0 = (t % g.tiles_x) * g.tile_size;
+        const uint32_t y0 = (t / g.tiles_x) * g.tile_size;
+        return { x0, y0, std::min(g.tile_size, g.width - x0), std::min(g.tile_size, g.height - y0) };
+    }
+
+    Geometry geometry(DXGI_FORMAT format, uint32_t width, uint32_t height, uint32_t tile_size) {
+        return { Formats::bytes_per_pixel(format), width, height, tile_size,
+                 (width + tile_size - 1) / tile_size, (height + tile_size - 1) / tile_size };
+    }
+
+    // Per-thread scratch: residuals in pixel order, then as padded planes.
+    // Tiles are all the same size but the edges, so the buffers are sized once
+    // per worker rather than once per tile.
+    struct Scratch {
+        std::vector<uint8_t> residual;
+        std::vector<uint8_t> planes;
+        std::vector<uint8_t> packed;
+        std::vector<uint8_t> kept;
+    };
+
+    Scratch& scratch(const Geometry& g, size_t n) {
+        thread_local Scratch s;
+        const size_t bytes = n * g.bpp;
+        if (s.residual.size() < bytes) s.residual.resize(bytes);
+        if (s.planes.size() < round_up(n) * g.bpp) s.planes.resize(round_up(n) * g.bpp);
+        if (s.packed.size() < packed_bound(n) * g.bpp) s.packed.resize(packed_bound(n) * g.bpp);
+        return s;
+    }
+
+    // Packs `residual` (n pixels) into scratch.packed and returns its size.
+    size_t pack_tile(const Geometry& g, size_t n, Scratch& s) {
+        const size_t stride = round_up(n);
+        split(g.bpp, s.residual.data(), n, s.planes.data(), stride);
+        for (size_t k = 0; k < g.bpp; ++k) memset(s.planes.data() + k * stride + n, 0, stride - n);
+        const PackFn pack = kernels().pack;
+        size_t size = 0;
+        for (size_t k = 0; k < g.bpp; ++k) size += pack(s.planes.data() + k * stride, n, s.packed.data() + size);
+        return size;
+    }
+
+    void encode_tile(const Geometry& g, const uint8_t* pixels, size_t pitch, const uint8_t* previous, size_t previous_pitch,
+                     uint32_t t, std::vector<uint8_t>& out) {
+        const TileRect r = tile_rect(g, t);
+        const size_t row_bytes = (size_t)r.width * g.bpp;
+        const size_t n = (size_t)r.width * r.height;
+        const size_t raw = row_bytes * r.height;
+        const Kernels& k = kernels();
+        Scratch& s = scratch(g, n);
+        const uint8_t* src = pixels + (size_t)r.y0 * pitch + (size_t)r.x0 * g.bpp;
+
+        TileMode mode = TileMode::Raw;
+        size_t best = raw;
+        if (previous) {
+            const uint8_t* prev = previous + (size_t)r.y0 * previous_pitch + (size_t)r.x0 * g.bpp;
+            uint8_t any = 0;
+            for (uint32_t y = 0; y < r.height; ++y) {
+                any |= k.diff(src + (size_t)y * pitch, prev + (size_t)y * previous_pitch, s.residual.data() + (size_t)y * row_bytes, row_bytes);
+            }
+            if (!any) {
+                out.assign(1, (uint8_t)TileMode::Same);
+                return;
+            }
+            const size_t size = pack_tile(g, n, s);
+            if (size < best) {
+                mode = TileMode::Temporal;
+                best = size;
+            }
+            // A tile that still costs half its raw size has probably moved or
+            // been replaced; see whether it predicts better from itself.
+            if (best * 2 <= raw) {
+                out.resize(1 + best);
+                out[0] = (uint8_t)mode;
+                memcpy(out.data() + 1, s.packed.data(), best);
+                return;
+            }
+            if (mode == TileMode::Temporal) s.kept.assign(s.packed.begin(), s.packed.begin() + best);
+        }
+
+        for (uint32_t y = 0; y < r.height; ++y) {
+            const uint8_t* a = src + (size_t)y * pitch;
+            uint8_t* d = s.residual.data() + (size_t)y * row_bytes;
+            const uint8_t* above = y ? a - pitch : nullptr;
+            for (size_t i = 0; i < std::min(g.bpp, row_bytes); ++i) d[i] = (uint8_t)(a[i] - (above ? above[i] : 0));
+            k.left(a, d, row_bytes, g.bpp);
+        }
+        const size_t size = pack_tile(g, n, s);
+        if (size < best) {
+            out.resize(1 + size);
+            out[0] = (uint8_t)TileMode::Spatial;
+            memcpy(out.data() + 1, s.packed.data(), size);
+        } else if (mode == TileMode::Temporal) {
+            out.resize(1 + best);
+            out[0] = (uint8_t)mode;
+            memcpy(out.data() + 1, s.kept.data(), best);
+        } else {
+            out.resize(1 + raw);
+            out[0] = (uint8_t)TileMode::Raw;
+            for (uint32_t y = 0; y < r.height; ++y) memcpy(out.data() + 1 + (size_t)y * row_bytes, src + (size_t)y * pitch, row_bytes);
+        }
+    }
+
+    void decode_tile(const Geometry& g, bool delta, const uint8_t* in, size_t size, uint8_t* pixels, size_t pitch, uint32_t t) {
+        const TileRect r = tile_rect(g, t);
+        const size_t row_bytes = (size_t)r.width * g.bpp;
+        const size_t n = (size_t)r.width * r.height;
+        uint8_t* dst = pixels + (size_t)r.y0 * pitch + (size_t)r.x0 * g.bpp;
+        const TileMode mode = (TileMode)in[0];
+        ++in;
+        --size;
+
+        switch (mode) {
+        case TileMode::Same:
+            if (!delta || size != 0) {
+                throw std::runtime_error("Codec::decode: corrupt tile.");
+            }
+            return;
+        case TileMode::Raw:
+            if (size != row_bytes * r.height) {
+                throw std::runtime_error("Codec::decode: corrupt tile.");
+            }
+            for (uint32_t y = 0; y < r.height; ++y) memcpy(dst + (size_t)y * pitch, in + (size_t)y * row_bytes, row_bytes);
+            return;
+        case TileMode::Temporal:
+            if (!delta) {
+                throw std::runtime_error("Codec::decode: corrupt tile.");
+            }
+            break;
+        case TileMode::Spatial:
+            break;
+        default:
+            throw std::runtime_error("Codec::decode: unknown tile mode.");
+        }
+
+        const size_t stride = round_up(n);
+        const Kernels& k = kernels();
+        Scratch& s = scratch(g, n);
+        size_t used = 0;
+        for (size_t c = 0; c < g.bpp; ++c) used += k.unpack(in + used, size - used, n, s.planes.data() + c * stride);
+        if (used != size) {
+            throw std::runtime_error("Codec::decode: corrupt tile.");
+        }
+        merge(g.bpp, s.planes.data(), stride, n, s.residual.data());
+
+        for (uint32_t y = 0; y < r.height; ++y) {
+            uint8_t* d = dst + (size_t)y * pitch;
+            const uint8_t* e = s.residual.data() + (size_t)y * row_bytes;
+            if (mode == TileMode::Temporal) {
+                k.add(d, e, row_bytes);
+                continue;
+            }
+            const uint8_t* above = y ? d - pitch : nullptr;
+            for (size_t i = 0; i < std::min(g.bpp, row_bytes); ++i) d[i] = (uint8_t)(e[i] + (above ? above[i] : 0));
+            k.unleft(d, e, row_bytes, g.bpp);
+        }
+    }
+
+    void check_format(const char* what, DXGI_FORMAT format) {
+        if (!Codec::is_supported(format)) {
+            throw std::invalid_argument(std::string(what) + ": unsupported format.");
+        }
+    }
+
+}
+
+bool Codec::is_supported(DXGI_FORMAT format) {
+    return Formats::bytes_per_pixel(format) != 0;
+}
+
+Codec::FrameInfo Codec::peek(const void* data, size_t size) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    if (size < kHeaderBytes || get32(p) != kMagic) {
+        throw std::runtime_error("Codec::peek: not an encoded frame.");
+    }
+    if (get16(p + 4) != kVersion) {
+        throw std::runtime_error("Codec::peek: unsupported version " + std::to_string(get16(p + 4)) + ".");
+    }
+    FrameInfo info;
+    info.delta = (get16(p + 6) & 1) != 0;
+    info.format = (DXGI_FORMAT)get32(p + 8);
+    info.width = get32(p + 12);
+    info.height = get32(p + 16);
+    info.tile_size = get32(p + 20);
+    info.tile_count = get32(p + 24);
+    info.frame_index = get64(p + 28);
+    if (!is_supported(info.format) || info.tile_size == 0) {
+        throw std::runtime_error("Codec::peek: corrupt header.");
+    }
+    const Geometry g = geometry(info.format, info.width, info.height, info.tile_size);
+    if ((uint64_t)g.tiles_x * g.tiles_y != info.tile_count || (size - kHeaderBytes) / 4 < info.tile_count) {
+        throw std::runtime_error("Codec::peek: corrupt tile table.");
+    }
+    uint64_t total = kHeaderBytes + (uint64_t)info.tile_count * 4;
+    for (uint32_t t = 0; t < info.tile_count; ++t) {
+        const uint32_t tile = get32(p + kHeaderBytes + (size_t)t * 4);
+        if (tile == 0) {
+            throw std::runtime_error("Codec::peek: corrupt tile table.");
+        }
+        total += tile;
+    }
+    if (total != size) {
+        throw std::runtime_error("Codec::peek: frame is " + std::to_string(size) + " bytes, tile table says " + std::to_string(total) + ".");
+    }
+    return info;
+}
+
+std::vector<uint8_t> Codec::encode(DXGI_FORMAT format, const void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                                   const void* previous, size_t previous_pitch, uint64_t frame_index, uint32_t tile_size,
+                                   Scheduler& scheduler) {
+    check_format("Codec::encode", format);
+    if (tile_size == 0) {
+        throw std::invalid_argument("Codec::encode: tile_size must be non-zero.");
+    }
+    const Geometry g = geometry(format, width, height, tile_size);
+    const uint32_t count = g.tiles_x * g.tiles_y;
+    std::vector<std::vector<uint8_t>> tiles(count);
+    const auto* src = static_cast<const uint8_t*>(pixels);
+    const auto* prev = static_cast<const uint8_t*>(previous);
+    scheduler.parallel_for(count, [&](uint32_t t) {
+        encode_tile(g, src, pitch, prev, previous_pitch, t, tiles[t]);
+    });
+
+    std::vector<size_t> offsets(count);
+    size_t total = kHeaderBytes + (size_t)count * 4;
+    for (uint32_t t = 0; t < count; ++t) {
+        offsets[t] = total;
+        total += tiles[t].size();
+    }
+    std::vector<uint8_t> out(total);
+    uint8_t* p = out.data();
+    put32(p, kMagic);
+    put16(p + 4, kVersion);
+    put16(p + 6, previous ? 1 : 0);
+    put32(p + 8, (uint32_t)format);
+    put32(p + 12, width);
+    put32(p + 16, height);
+    put32(p + 20, tile_size);
+    put32(p + 24, count);
+    put64(p + 28, frame_index);
+    put32(p + 36, 0);
+    for (uint32_t t = 0; t < count; ++t) put32(p + kHeaderBytes + (size_t)t * 4, (uint32_t)tiles[t].size());
+    scheduler.parallel_for(count, [&](uint32_t t) {
+        memcpy(p + offsets[t], tiles[t].data(), tiles[t].size());
+    });
+    return out;
+}
+
+Codec::FrameInfo Codec::decode(const void* data, size_t size, void* pixels, size_t pitch, Scheduler& scheduler) {
+    const FrameInfo info = peek(data, size);
+    const Geometry g = geometry(info.format, info.width, info.height, info.tile_size);
+    const auto* p = static_cast<const uint8_t*>(data);
+    std::vector<size_t> offsets(info.tile_count);
+    size_t offset = kHeaderBytes + (size_t)info.tile_count * 4;
+    for (uint32_t t = 0; t < info.tile_count; ++t) {
+        offsets[t] = offset;
+        offset += get32(p + kHeaderBytes + (size_t)t * 4);
+    }
+    auto* dst = static_cast<uint8_t*>(pixels);
+    scheduler.parallel_for(info.tile_count, [&](uint32_t t) {
+        decode_tile(g, info.delta, p + offsets[t], get32(p + kHeaderBytes + (size_t)t * 4), dst, pitch, t);
+    });
+    return info;
+}
+
+std::vector<uint32_t> Codec::tile_modes(const void* data, size_t size) {
+    const FrameInfo info = peek(data, size);
+    const auto* p = static_cast<const uint8_t*>(data);
+    std::vector<uint32_t> counts(4, 0);
+    size_t offset = kHeaderBytes + (size_t)info.tile_count * 4;
+    for (uint32_t t = 0; t < info.tile_count; ++t) {
+        const uint8_t mode = p[offset];
+        if (mode < counts.size()) ++counts[mode];
+        offset += get32(p + kHeaderBytes + (size_t)t * 4);
+    }
+    return counts;
+}
+
+// --- Encoder ---
+
+struct Codec::Encoder::Impl {
+    uint32_t tile_size;
+    uint32_t key_interval;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> previous;
+    uint64_t frames = 0;
+    bool key_requested = true;
+};
+
+Codec::Encoder::Encoder(uint32_t tile_size, uint32_t key_interval) : pImpl(std::make_unique<Impl>()) {
+    if (tile_size == 0) {
+        throw std::invalid_argument("Codec::Encoder: tile_size must be non-zero.");
+    }
+    pImpl->tile_size = tile_size;
+    pImpl->key_interval = key_interval;
+}
+
+Codec::Encoder::~Encoder() = default;
+
+std::vector<uint8_t> Codec::Encoder::encode(DXGI_FORMAT format, const void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                                            Scheduler& scheduler) {
+    check_format("Codec::Encoder::encode", format);
+    auto& s = *pImpl;
+    const size_t row_bytes = (size_t)width * Formats::bytes_per_pixel(format);
+    const bool key = s.key_requested || format != s.format || width != s.width || height != s.height ||
+                     (s.key_interval && s.frames % s.key_interval == 0);
+    std::vector<uint8_t> out = Codec::encode(format, pixels, pitch, width, height, key ? nullptr : s.previous.data(), row_bytes,
+                                             s.frames, s.tile_size, scheduler);
+    s.previous.resize(row_bytes * height);
+    Copy::copy_rows(s.previous.data(), row_bytes, pixels, pitch, row_bytes, height, scheduler);
+    s.format = format;
+    s.width = width;
+    s.height = height;
+    s.key_requested = false;
+    ++s.frames;
+    return out;
+}
+
+void Codec::Encoder::request_key_frame() {
+    pImpl->key_requested = true;
+}
+
+uint32_t Codec::Encoder::tile_size() const {
+    return pImpl->tile_size;
+}
+
+uint32_t Codec::Encoder::key_interval() const {
+    return pImpl->key_interval;
+}
+
+uint64_t Codec::Encoder::frames() const {
+    return pImpl->frames;
+}
+
+// --- Decoder ---
+
+struct Codec::Decoder::Impl {
+    FrameInfo info;
+    std::vector<uint8_t> pixels;
+    bool valid = false;
+};
+
+Codec::Decoder::Decoder() : pImpl(std::make_unique<Impl>()) {}
+
+Codec::Decoder::~Decoder() = default;
+
+Codec::FrameInfo Codec::Decoder::decode(const void* data, size_t size, Scheduler& scheduler) {
+    auto& s = *pImpl;
+    const FrameInfo info = peek(data, size);
+    const size_t row_bytes = (size_t)info.width * Formats::bytes_per_pixel(info.format);
+    if (info.delta) {
+        const bool follows = s.valid && info.frame_index == s.info.frame_index + 1 && info.format == s.info.format &&
+                             info.width == s.info.width && info.height == s.info.height;
+        if (!follows) {
+            throw std::runtime_error("Codec::Decoder: delta frame " + std::to_string(info.frame_index) +
+                                     " does not follow the last decoded frame; waiting for a key frame.");
+        }
+    } else {
+        s.pixels.resize(row_bytes * info.height);
+    }
+    s.valid = false;
+    Codec::decode(data, size, s.pixels.data(), row_bytes, scheduler);
+    s.info = info;
+    s.valid = true;
+    return info;
+}
+
+void Codec::Decoder::reset() {
+    pImpl->info = FrameInfo();
+    pImpl->pixels.clear();
+    pImpl->valid = false;
+}
+
+const std::vector<uint8_t>& Codec::Decoder::pixels() const {
+    return pImpl->pixels;
+}
+
+const Codec::FrameInfo& Codec::Decoder::info() const {
+    return pImpl->info;
+}
@@ -0,0 +1,113 @@
+// DirectPortCodec.h
+#pragma once
+
+#include "DirectPortPlatform.h"
+#include "DirectPortScheduler.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DirectPort::Codec {
+
+    // A lossless frame codec for sending pixels out of process. Frames are cut
+    // into tile_size x tile_size tiles that encode and decode independently,
+    // one scheduler task each. A tile is stored as one of:
+    //   Same      identical to the previous frame, no payload;
+    //   Temporal  byte-wise difference from the previous frame;
+    //   Spatial   byte-wise difference from the pixel to the left (above, in
+    //             the first column);
+    //   Raw       the bytes as they are, when nothing else is smaller.
+    // Residuals are split into byte planes (every pixel's byte k together), so
+    // exponents, alpha and colour channels each get their own statistics, then
+    // zigzag-mapped and packed in blocks of 32 at the bit width of the largest
+    // value in the block: a 4-bit width per block, then one 32-bit mask per bit
+    // plane. Zero blocks cost half a byte, and packing is a movemask per bit
+    // plane on SSE4.1 and AVX2. Every kernel set writes the same bytes.
+    //
+    // A frame is a 40-byte header (all fields little-endian), a uint32 byte
+    // count per tile, then the tiles in row-major order:
+    //   uint32 magic 'DPFC', uint16 version, uint16 flags (bit 0: delta frame),
+    //   uint32 DXGI format, width, height, tile size, tile count,
+    //   uint64 frame index, uint32 reserved.
+    // A delta frame decodes only on top of frame index - 1.
+
+    constexpr uint32_t kDefaultTileSize = 64;
+    constexpr uint32_t kMagic = 0x43465044;  // "DPFC"
+    constexpr uint16_t kVersion = 1;
+    constexpr size_t kHeaderBytes = 40;
+
+    enum class TileMode : uint8_t { Same, Temporal, Spatial, Raw };
+
+    struct FrameInfo {
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t tile_size = 0;
+        uint32_t tile_count = 0;
+        uint64_t frame_index = 0;
+        bool delta = false;
+    };
+
+    // Any uncompressed format; the codec only sees bytes per pixel.
+    bool is_supported(DXGI_FORMAT format);
+
+    // Reads and checks the header and tile table. Throws std::runtime_error on
+    // anything malformed.
+    FrameInfo peek(const void* data, size_t size);
+
+    // One frame. With `previous` (same size and format) the frame is a delta
+    // frame and each tile picks its cheapest mode; without, it is a key frame.
+    std::vector<uint8_t> encode(DXGI_FORMAT format, const void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                                const void* previous, size_t previous_pitch, uint64_t frame_index = 0,
+                                uint32_t tile_size = kDefaultTileSize, Scheduler& scheduler = Scheduler::shared());
+
+    // Decodes into `pixels`, which for a delta frame must already hold the
+    // previous frame; tiles marked Same are left as they are.
+    FrameInfo decode(const void* data, size_t size, void* pixels, size_t pitch, Scheduler& scheduler = Scheduler::shared());
+
+    // Counts of tiles by mode in an encoded frame, indexed by TileMode.
+    std::vector<uint32_t> tile_modes(const void* data, size_t size);
+
+    // The sending side of one stream: remembers the last frame and emits delta
+    // frames against it, with a key frame first, after a size or format
+    // change, every key_interval frames (0 for never) and on request.
+    class Encoder {
+    public:
+        explicit Encoder(uint32_t tile_size = kDefaultTileSize, uint32_t key_interval = 0);
+        ~Encoder();
+
+        std::vector<uint8_t> encode(DXGI_FORMAT format, const void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                                    Scheduler& scheduler = Scheduler::shared());
+        void request_key_frame();
+
+        uint32_t tile_size() const;
+        uint32_t key_interval() const;
+        uint64_t frames() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+    // The receiving side: keeps the last decoded frame for delta frames to
+    // build on. A delta frame that does not follow the last decoded frame
+    // throws std::runtime_error; the stream resumes at the next key frame.
+    class Decoder {
+    public:
+        Decoder();
+        ~Decoder();
+
+        FrameInfo decode(const void* data, size_t size, Scheduler& scheduler = Scheduler::shared());
+        void reset();
+
+        // The last decoded frame, packed (pitch = width * bytes per pixel).
+        const std::vector<uint8_t>& pixels() const;
+        const FrameInfo& info() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+}
@@ -0,0 +1,159 @@
+#include "DirectPortCodec.h"
+#include "DirectPortFormats.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <cstring>
+#include <string>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    struct Frame {
+        const uint8_t* data;
+        size_t pitch;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // A 2D or 3D array whose pixels match `format`; the rows may be strided.
+    Frame frame_of(const char* what, const py::array& pixels, DXGI_FORMAT format) {
+        py::buffer_info info = pixels.request();
+        const size_t channels = info.ndim == 3 ? (size_t)info.shape[2] : 1;
+        const bool packed = (info.ndim == 2 || info.strides[2] == info.itemsize) &&
+                            info.strides[1] == (py::ssize_t)(channels * info.itemsize);
+        if ((info.ndim != 2 && info.ndim != 3) || !packed || info.strides[0] < info.shape[1] * info.strides[1]) {
+            throw py::value_error(std::string(what) + ": pixels must be a 2D or 3D array with packed rows.");
+        }
+        if (!Codec::is_supported(format)) {
+            throw py::value_error(std::string(what) + ": unsupported format.");
+        }
+        if (channels * info.itemsize != Formats::bytes_per_pixel(format)) {
+            throw py::value_error(std::string(what) + ": pixel size does not match the format.");
+        }
+        return { static_cast<const uint8_t*>(info.ptr), (size_t)info.strides[0], (uint32_t)info.shape[1], (uint32_t)info.shape[0] };
+    }
+
+    py::bytes to_bytes(const std::vector<uint8_t>& data) {
+        return py::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    // (height, width, channels) in the format's NumPy dtype, or (height, width,
+    // bytes per pixel) uint8 for formats NumPy has no type for.
+    py::array pixel_array(DXGI_FORMAT format, uint32_t width, uint32_t height) {
+        const Formats::Traits* t = Formats::find(format);
+        if (t && t->numpy_dtype) {
+            return py::array(py::dtype(t->numpy_dtype), { (py::ssize_t)height, (py::ssize_t)width, (py::ssize_t)t->numpy_channels });
+        }
+        return py::array_t<uint8_t>({ (py::ssize_t)height, (py::ssize_t)width, (py::ssize_t)Formats::bytes_per_pixel(format) });
+    }
+
+}
+
+void bind_codec(py::module_& m) {
+    m.attr("CODEC_DEFAULT_TILE_SIZE") = Codec::kDefaultTileSize;
+
+    py::enum_<Codec::TileMode>(m, "CodecTileMode", "How one tile of an encoded frame is stored.")
+        .value("Same", Codec::TileMode::Same, "")
+        .value("Temporal", Codec::TileMode::Temporal, "")
+        .value("Spatial", Codec::TileMode::Spatial, "")
+        .value("Raw", Codec::TileMode::Raw, "");
+
+    py::class_<Codec::FrameInfo>(m, "CodecFrameInfo", "The header of an encoded frame.")
+        .def_readonly("format", &Codec::FrameInfo::format)
+        .def_readonly("width", &Codec::FrameInfo::width)
+        .def_readonly("height", &Codec::FrameInfo::height)
+        .def_readonly("tile_size", &Codec::FrameInfo::tile_size)
+        .def_readonly("tile_count", &Codec::FrameInfo::tile_count)
+        .def_readonly("frame_index", &Codec::FrameInfo::frame_index)
+        .def_readonly("delta", &Codec::FrameInfo::delta)
+        .def("__repr__", [](const Codec::FrameInfo& i) {
+            return "<CodecFrameInfo " + std::string(i.delta ? "delta" : "key") + " frame " + std::to_string(i.frame_index) + ", " +
+                   std::to_string(i.width) + "x" + std::to_string(i.height) + ">";
+        });
+
+    py::class_<Codec::Encoder>(m, "FrameEncoder",
+        "Encodes a stream of frames losslessly, each as a delta against the last.")
+        .def(py::init<uint32_t, uint32_t>(), py::arg("tile_size") = Codec::kDefaultTileSize, py::arg("key_interval") = 0,
+             "key_interval > 0 forces a key frame every key_interval frames.")
+        .def("encode", [](Codec::Encoder& encoder, const py::array& pixels, DXGI_FORMAT format) {
+            const Frame f = frame_of("FrameEncoder.encode", pixels, format);
+            std::vector<uint8_t> data;
+            {
+                py::gil_scoped_release release;
+                data = encoder.encode(format, f.data, f.pitch, f.width, f.height);
+            }
+            return to_bytes(data);
+        }, py::arg("pixels"), py::arg("format"))
+        .def("request_key_frame", &Codec::Encoder::request_key_frame, "The next frame is encoded without a reference.")
+        .def_property_readonly("tile_size", &Codec::Encoder::tile_size)
+        .def_property_readonly("key_interval", &Codec::Encoder::key_interval)
+        .def_property_readonly("frames", &Codec::Encoder::frames);
+
+    py::class_<Codec::Decoder>(m, "FrameDecoder", "Decodes the frames of one FrameEncoder stream.")
+        .def(py::init<>())
+        .def("decode", [](Codec::Decoder& decoder, const py::buffer& data) {
+            py::buffer_info in = data.request();
+            {
+                py::gil_scoped_release release;
+                decoder.decode(in.ptr, (size_t)(in.size * in.itemsize));
+            }
+            const Codec::FrameInfo& info = decoder.info();
+            py::array out = pixel_array(info.format, info.width, info.height);
+            memcpy(out.mutable_data(), decoder.pixels().data(), decoder.pixels().size());
+            return out;
+        }, py::arg("data"), "Returns the decoded frame as a new array.")
+        .def("reset", &Codec::Decoder::reset, "Forgets the last frame; the stream resumes at the next key frame.")
+        .def_property_readonly("info", &Codec::Decoder::info);
+
+    m.def("peek_frame", [](const py::buffer& data) {
+        py::buffer_info in = data.request();
+        return Codec::peek(in.ptr, (size_t)(in.size * in.itemsize));
+    }, py::arg("data"), "Reads the header of an encoded frame.");
+    m.def("encode_frame", [](const py::array& pixels, DXGI_FORMAT format, const py::object& previous, uint64_t frame_index, uint32_t tile_size) {
+        const Frame f = frame_of("encode_frame", pixels, format);
+        Frame p = { nullptr, 0, f.width, f.height };
+        py::array previous_array;
+        if (!previous.is_none()) {
+            previous_array = previous.cast<py::array>();
+            p = frame_of("encode_frame", previous_array, format);
+            if (p.width != f.width || p.height != f.height) {
+                throw py::value_error("encode_frame: previous must be the same size as pixels.");
+            }
+        }
+        std::vector<uint8_t> data;
+        {
+            py::gil_scoped_release release;
+            data = Codec::encode(format, f.data, f.pitch, f.width, f.height, p.data, p.pitch, frame_index, tile_size);
+        }
+        return to_bytes(data);
+    }, py::arg("pixels"), py::arg("format"), py::arg("previous") = py::none(), py::arg("frame_index") = 0,
+       py::arg("tile_size") = Codec::kDefaultTileSize, "Encodes one frame; with previous, as a delta frame against it.");
+    m.def("decode_frame", [](const py::buffer& data, const py::object& previous) {
+        py::buffer_info in = data.request();
+        const Codec::FrameInfo info = Codec::peek(in.ptr, (size_t)(in.size * in.itemsize));
+        py::array out = pixel_array(info.format, info.width, info.height);
+        if (info.delta) {
+            if (previous.is_none()) {
+                throw py::value_error("decode_frame: a delta frame needs the previous frame.");
+            }
+            py::array prev = py::array::ensure(previous, py::array::c_style);
+            if (!prev || (size_t)prev.nbytes() != (size_t)out.nbytes()) {
+                throw py::value_error("decode_frame: previous does not match the frame.");
+            }
+            memcpy(out.mutable_data(), prev.data(), (size_t)out.nbytes());
+        }
+        uint8_t* dst = static_cast<uint8_t*>(out.mutable_data());
+        {
+            py::gil_scoped_release release;
+            Codec::decode(in.ptr, (size_t)(in.size * in.itemsize), dst, (size_t)info.width * Formats::bytes_per_pixel(info.format));
+        }
+        return out;
+    }, py::arg("data"), py::arg("previous") = py::none(), "Decodes one frame; a delta frame needs the frame before it.");
+    m.def("codec_tile_modes", [](const py::buffer& data) {
+        py::buffer_info in = data.request();
+        return Codec::tile_modes(in.ptr, (size_t)(in.size * in.itemsize));
+    }, py::arg("data"), "Tile counts by CodecTileMode in an encoded frame.");
+}
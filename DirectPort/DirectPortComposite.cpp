@@ -0,0 +1,139 @@
+// src/DirectPort/DirectPortComposite.cpp
+
+#include "DirectPortComposite.h"
+#include "DirectPortDirtyRects.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectPort;
+
+std::vector<Composite::ResolvedLayer> Composite::resolve_layers(uint32_t dest_width, uint32_t dest_height, const std::vector<CompositeLayer>& layers) {
+    std::vector<ResolvedLayer> resolved;
+    resolved.reserve(layers.size());
+
+    for (const auto& layer : layers) {
+        if (!layer.source) {
+            throw std::invalid_argument("Composite layer has no source texture.");
+        }
+        if (!(layer.opacity > 0.0f) || layer.width == 0 || layer.height == 0) continue;
+
+        const uint32_t src_w = layer.source->get_width();
+        const uint32_t src_h = layer.source->get_height();
+        if (layer.crop_x >= src_w || layer.crop_y >= src_h) {
+            throw std::invalid_argument("Composite layer crop starts outside its source texture.");
+        }
+        float cx = (float)layer.crop_x;
+        float cy = (float)layer.crop_y;
+        float cw = (float)(layer.crop_width ? std::min(layer.crop_width, src_w - layer.crop_x) : src_w - layer.crop_x);
+        float ch = (float)(layer.crop_height ? std::min(layer.crop_height, src_h - layer.crop_y) : src_h - layer.crop_y);
+
+        ResolvedLayer r = { &layer, layer.x, layer.y, layer.width, layer.height, cx, cy, cw, ch };
+
+        if (layer.fit == CompositeFit::Letterbox) {
+            const double scale = std::min(layer.width / (double)cw, layer.height / (double)ch);
+            r.width = std::max<uint32_t>(1, (uint32_t)std::lround(cw * scale));
+            r.height = std::max<uint32_t>(1, (uint32_t)std::lround(ch * scale));
+            r.x = layer.x + (int32_t)((layer.width - r.width) / 2);
+            r.y = layer.y + (int32_t)((layer.height - r.height) / 2);
+        } else if (layer.fit == CompositeFit::Crop) {
+            const double scale = std::max(layer.width / (double)cw, layer.height / (double)ch);
+            const float vw = (float)(layer.width / scale);
+            const float vh = (float)(layer.height / scale);
+            r.crop_x = cx + (cw - vw) * 0.5f;
+            r.crop_y = cy + (ch - vh) * 0.5f;
+            r.crop_width = vw;
+            r.crop_height = vh;
+        }
+
+        const int64_t right = (int64_t)r.x + r.width;
+        const int64_t bottom = (int64_t)r.y + r.height;
+        if (right <= 0 || bottom <= 0 || r.x >= (int64_t)dest_width || r.y >= (int64_t)dest_height) continue;
+        resolved.push_back(r);
+    }
+
+    std::stable_sort(resolved.begin(), resolved.end(), [](const ResolvedLayer& a, const ResolvedLayer& b) {
+        return a.layer->z < b.layer->z;
+    });
+    return resolved;
+}
+
+std::vector<DirtyRect> Composite::resolve_regions(uint32_t dest_width, uint32_t dest_height, const std::optional<std::vector<DirtyRect>>& regions) {
+    if (!regions) return { DirtyRects::full(dest_width, dest_height) };
+    return DirtyRects::normalize(*regions, dest_width, dest_height);
+}
+
+bool Composite::touches(const ResolvedLayer& layer, const DirtyRect& region) {
+    return layer.x < (int64_t)region.x + region.width && (int64_t)layer.x + layer.width > (int64_t)region.x &&
+           layer.y < (int64_t)region.y + region.height && (int64_t)layer.y + layer.height > (int64_t)region.y;
+}
+
+// The fallback for devices that only implement blit_texture_to_region.
+void IDirectXDevice::composite(std::shared_ptr<Texture> destination, const std::vector<CompositeLayer>& layers,
+                               bool clear, float, float, float, float, const std::optional<std::vector<DirtyRect>>& regions) {
+    if (!destination) {
+        throw std::invalid_argument("composite: destination texture is null.");
+    }
+    if (regions && regions->empty()) return;
+    if (clear) {
+        throw std::runtime_error("composite: this device cannot clear a texture; composite without clear or override composite().");
+    }
+    const uint32_t dw = destination->get_width(), dh = destination->get_height();
+    const auto resolved = Composite::resolve_layers(dw, dh, layers);
+    for (const auto& rl : resolved) {
+        const Texture& src = *rl.layer->source;
+        const bool whole = rl.crop_x == 0.0f && rl.crop_y == 0.0f && rl.crop_width == (float)src.get_width() &&
+                           rl.crop_height == (float)src.get_height();
+        const bool inside = rl.x >= 0 && rl.y >= 0 && (int64_t)rl.x + rl.width <= (int64_t)dw && (int64_t)rl.y + rl.height <= (int64_t)dh;
+        if (!whole || !inside || rl.layer->opacity < 1.0f || rl.layer->use_source_alpha) {
+            throw std::runtime_error("composite: this device only draws opaque, uncropped layers that lie inside the destination.");
+        }
+    }
+    for (const auto& rl : resolved) {
+        blit_texture_to_region(rl.layer->source, destination, (uint32_t)rl.x, (uint32_t)rl.y, rl.width, rl.height);
+    }
+}
+
+std::vector<CompositeLayer> Composite::grid_layout(const std::vector<std::shared_ptr<Texture>>& sources, uint32_t dest_width, uint32_t dest_height,
+                                                   uint32_t columns, uint32_t gap, CompositeFit fit) {
+    std::vector<CompositeLayer> layers;
+    if (sources.empty()) return layers;
+
+    const uint32_t count = (uint32_t)sources.size();
+    const uint32_t cols = columns ? columns : (uint32_t)std::ceil(std::sqrt((double)count));
+    const uint32_t rows = (count + cols - 1) / cols;
+    if (dest_width <= gap * (cols - 1) || dest_height <= gap * (rows - 1)) {
+        throw std::invalid_argument("grid_layout: the gaps leave no room for the cells.");
+    }
+    const uint32_t cell_w = (dest_width - gap * (cols - 1)) / cols;
+    const uint32_t cell_h = (dest_height - gap * (rows - 1)) / rows;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        CompositeLayer layer;
+        layer.source = sources[i];
+        layer.x = (int32_t)((i % cols) * (cell_w + gap));
+        layer.y = (int32_t)((i / cols) * (cell_h + gap));
+        layer.width = cell_w;
+        layer.height = cell_h;
+        layer.fit = fit;
+        layers.push_back(layer);
+    }
+    return layers;
+}
+
+CompositeLayer Composite::picture_in_picture(std::shared_ptr<Texture> source, uint32_t dest_width, uint32_t dest_height,
+                                             float scale, uint32_t margin, int corner, float opacity) {
+    if (!(scale > 0.0f) || scale > 1.0f) {
+        throw std::invalid_argument("picture_in_picture: scale must be in (0, 1].");
+    }
+    CompositeLayer layer;
+    layer.source = std::move(source);
+    layer.width = std::max<uint32_t>(1, (uint32_t)std::lround(dest_width * scale));
+    layer.height = std::max<uint32_t>(1, (uint32_t)std::lround(dest_height * scale));
+    layer.x = (corner & 1) ? (int32_t)dest_width - (int32_t)(layer.width + margin) : (int32_t)margin;
+    layer.y = (corner & 2) ? (int32_t)dest_height - (int32_t)(layer.height + margin) : (int32_t)margin;
+    layer.z = 1;
+    layer.opacity = opacity;
+    layer.fit = CompositeFit::Letterbox;
+    return layer;
+}
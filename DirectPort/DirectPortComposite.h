@@ -0,0 +1,48 @@
+// DirectPortComposite.h
+#pragma once
+
+#include "DirectPort.h"
+#include <vector>
+#include <memory>
+#include <optional>
+
+namespace DirectPort::Composite {
+
+    // A layer with fit and crop applied: where it lands in the destination and
+    // which part of the source it shows. The rect may still hang off the edges.
+    struct ResolvedLayer {
+        const CompositeLayer* layer;
+        int32_t x;
+        int32_t y;
+        uint32_t width;
+        uint32_t height;
+        float crop_x;
+        float crop_y;
+        float crop_width;
+        float crop_height;
+    };
+
+    // Validates the layers, drops the ones that cannot be seen and returns the
+    // rest in draw order. Every device backend goes through this so layouts
+    // match pixel for pixel.
+    std::vector<ResolvedLayer> resolve_layers(uint32_t dest_width, uint32_t dest_height, const std::vector<CompositeLayer>& layers);
+
+    // The parts of the destination a composite redraws: all of it when no
+    // regions are given, otherwise the regions made disjoint (none for an
+    // empty list, which means nothing changed).
+    std::vector<DirtyRect> resolve_regions(uint32_t dest_width, uint32_t dest_height, const std::optional<std::vector<DirtyRect>>& regions);
+
+    bool touches(const ResolvedLayer& layer, const DirtyRect& region);
+
+    // The multiplexer layout: ceil(sqrt(n)) columns unless given, equal cells,
+    // `gap` pixels between them.
+    std::vector<CompositeLayer> grid_layout(const std::vector<std::shared_ptr<Texture>>& sources, uint32_t dest_width, uint32_t dest_height,
+                                            uint32_t columns = 0, uint32_t gap = 0, CompositeFit fit = CompositeFit::Letterbox);
+
+    // An inset of `scale` times the destination size, `margin` pixels in from
+    // a corner (0 top-left, 1 top-right, 2 bottom-left, 3 bottom-right), above
+    // everything at z = 0.
+    CompositeLayer picture_in_picture(std::shared_ptr<Texture> source, uint32_t dest_width, uint32_t dest_height,
+                                      float scale = 0.25f, uint32_t margin = 16, int corner = 3, float opacity = 1.0f);
+
+}
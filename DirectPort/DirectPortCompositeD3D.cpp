@@ -0,0 +1,354 @@
+// src/DirectPort/DirectPortCompositeD3D.cpp
+// The D3D11 and D3D12 paths of IDirectXDevice::composite. Layout comes from
+// Composite::resolve_layers, so they place layers exactly as DeviceCPU does.
+
+#include "DirectPortInternal.h"
+#include "DirectPortComposite.h"
+#include "DirectPortDirtyRects.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <d3dcompiler.h>
+
+using namespace Microsoft::WRL;
+using namespace DirectPort;
+
+namespace {
+    // One quad per layer: the vertex shader places it from the layer constants,
+    // so a whole composite is one shader, one blend state and N tiny draws.
+    const char* g_compositeShaderHLSL = R"(
+        cbuffer LayerConstants : register(b0) {
+            float4 g_destRect;
+            float4 g_srcRect;
+            float  g_opacity;
+            float  g_useSourceAlpha;
+            float2 g_pad;
+        };
+        Texture2D    g_texture : register(t0);
+        SamplerState g_sampler : register(s0);
+        struct PSInput { float4 pos : SV_POSITION; float2 uv : TEXCOORD; };
+        PSInput VSMain(uint id : SV_VertexID) {
+            float2 t = float2(id & 1, id >> 1);
+            PSInput result;
+            result.pos = float4(lerp(g_destRect.xy, g_destRect.zw, t), 0, 1);
+            result.uv = lerp(g_srcRect.xy, g_srcRect.zw, t);
+            return result;
+        }
+        float4 PSMain(PSInput input) : SV_TARGET {
+            float4 c = g_texture.Sample(g_sampler, input.uv);
+            c.a = (g_useSourceAlpha > 0.5 ? c.a : 1.0) * g_opacity;
+            return c;
+        }
+    )";
+
+    struct CompositeConstants {
+        float destRect[4];
+        float srcRect[4];
+        float opacity;
+        float useSourceAlpha;
+        float pad[2];
+    };
+
+    CompositeConstants make_composite_constants(const Composite::ResolvedLayer& layer, uint32_t dest_width, uint32_t dest_height) {
+        const float sw = (float)layer.layer->source->get_width();
+        const float sh = (float)layer.layer->source->get_height();
+        CompositeConstants c = {};
+        c.destRect[0] = (float)layer.x / dest_width * 2.0f - 1.0f;
+        c.destRect[1] = 1.0f - (float)layer.y / dest_height * 2.0f;
+        c.destRect[2] = (float)((int64_t)layer.x + layer.width) / dest_width * 2.0f - 1.0f;
+        c.destRect[3] = 1.0f - (float)((int64_t)layer.y + layer.height) / dest_height * 2.0f;
+        c.srcRect[0] = layer.crop_x / sw;
+        c.srcRect[1] = layer.crop_y / sh;
+        c.srcRect[2] = (layer.crop_x + layer.crop_width) / sw;
+        c.srcRect[3] = (layer.crop_y + layer.crop_height) / sh;
+        c.opacity = std::min(layer.layer->opacity, 1.0f);
+        c.useSourceAlpha = layer.layer->use_source_alpha ? 1.0f : 0.0f;
+        return c;
+    }
+
+}
+
+void DeviceD3D11::composite(std::shared_ptr<Texture> destination, const std::vector<CompositeLayer>& layers,
+                            bool clear, float r, float g, float b, float a, const std::optional<std::vector<DirtyRect>>& regions) {
+    if (!destination || !destination->pImpl->is_d3d11 || !destination->pImpl->d3d11RTV) {
+        throw std::invalid_argument("Invalid D3D11 destination texture for composite. Check for null or incorrect API type.");
+    }
+    const uint32_t dw = destination->get_width(), dh = destination->get_height();
+    const auto resolved = Composite::resolve_layers(dw, dh, layers);
+    for (const auto& rl : resolved) {
+        const auto& src = rl.layer->source;
+        if (!src->pImpl->is_d3d11 || !src->pImpl->d3d11SRV) {
+            throw std::invalid_argument("Invalid D3D11 source texture for composite (must be D3D11 and have SRV).");
+        }
+        if (src == destination) {
+            throw std::invalid_argument("D3D11::composite cannot read and write the same texture.");
+        }
+    }
+    D3D11ContextLock lock(pImpl->multithread.Get());
+
+    if (!pImpl->compositeVS) {
+        ComPtr<ID3DBlob> vsBlob, psBlob, errorBlob;
+        HRESULT hr = D3DCompile(g_compositeShaderHLSL, strlen(g_compositeShaderHLSL), nullptr, nullptr, nullptr, "VSMain", "vs_5_0", 0, 0, &vsBlob, &errorBlob);
+        if (FAILED(hr)) throw std::runtime_error("Failed to compile internal composite VS. HRESULT: " + std::to_string(hr));
+        hr = D3DCompile(g_compositeShaderHLSL, strlen(g_compositeShaderHLSL), nullptr, nullptr, nullptr, "PSMain", "ps_5_0", 0, 0, &psBlob, &errorBlob);
+        if (FAILED(hr)) throw std::runtime_error("Failed to compile internal composite PS. HRESULT: " + std::to_string(hr));
+        pImpl->device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &pImpl->compositeVS);
+        pImpl->device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &pImpl->compositePS);
+
+        D3D11_BUFFER_DESC cbDesc = {};
+        cbDesc.ByteWidth = sizeof(CompositeConstants);
+        cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        hr = pImpl->device->CreateBuffer(&cbDesc, nullptr, &pImpl->compositeCB);
+        if (FAILED(hr)) throw std::runtime_error("Failed to create composite constant buffer. HRESULT: " + std::to_string(hr));
+
+        D3D11_BLEND_DESC blendDesc = {};
+        blendDesc.RenderTarget[0].BlendEnable = TRUE;
+        blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+        blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+        blendDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+        blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+        blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+        blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+        blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+        hr = pImpl->device->CreateBlendState(&blendDesc, &pImpl->compositeBlend);
+        if (FAILED(hr)) throw std::runtime_error("Failed to create composite blend state. HRESULT: " + std::to_string(hr));
+
+        D3D11_RASTERIZER_DESC rsDesc = {};
+        rsDesc.FillMode = D3D11_FILL_SOLID;
+        rsDesc.CullMode = D3D11_CULL_NONE;
+        rsDesc.DepthClipEnable = TRUE;
+        rsDesc.ScissorEnable = TRUE;
+        hr = pImpl->device->CreateRasterizerState(&rsDesc, &pImpl->compositeScissorRS);
+        if (FAILED(hr)) throw std::runtime_error("Failed to create composite rasterizer state. HRESULT: " + std::to_string(hr));
+    }
+
+    auto areas = Composite::resolve_regions(dw, dh, regions);
+    if (areas.empty()) return;
+    // Clearing only part of a target needs ClearView from the 11.1 context.
+    if (!pImpl->context4 && clear && !DirtyRects::is_full(areas, dw, dh)) areas = { DirtyRects::full(dw, dh) };
+    std::vector<D3D11_RECT> scissors;
+    for (const auto& area : areas) {
+        scissors.push_back({ (LONG)area.x, (LONG)area.y, (LONG)(area.x + area.width), (LONG)(area.y + area.height) });
+    }
+
+    auto* ctx = pImpl->context.Get();
+    if (clear) {
+        const float color[4] = { r, g, b, a };
+        if (DirtyRects::is_full(areas, dw, dh)) ctx->ClearRenderTargetView(destination->pImpl->d3d11RTV.Get(), color);
+        else pImpl->context4->ClearView(destination->pImpl->d3d11RTV.Get(), color, scissors.data(), (UINT)scissors.size());
+    }
+    if (resolved.empty()) return;
+
+    ctx->OMSetRenderTargets(1, destination->pImpl->d3d11RTV.GetAddressOf(), nullptr);
+    ctx->OMSetBlendState(pImpl->compositeBlend.Get(), nullptr, 0xFFFFFFFF);
+    D3D11_VIEWPORT vp = { 0.0f, 0.0f, (float)dw, (float)dh, 0.0f, 1.0f };
+    ctx->RSSetViewports(1, &vp);
+    ctx->VSSetShader(pImpl->compositeVS.Get(), nullptr, 0);
+    ctx->PSSetShader(pImpl->compositePS.Get(), nullptr, 0);
+    ctx->VSSetConstantBuffers(0, 1, pImpl->compositeCB.GetAddressOf());
+    ctx->PSSetConstantBuffers(0, 1, pImpl->compositeCB.GetAddressOf());
+    ctx->PSSetSamplers(0, 1, pImpl->blitSampler.GetAddressOf());
+    ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    ctx->RSSetState(pImpl->compositeScissorRS.Get());
+
+    // Regions never overlap, so drawing each layer once per region it touches
+    // keeps the z order intact.
+    for (const auto& rl : resolved) {
+        const CompositeConstants constants = make_composite_constants(rl, dw, dh);
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        HRESULT hr = ctx->Map(pImpl->compositeCB.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+        if (FAILED(hr)) throw std::runtime_error("Failed to map composite constant buffer. HRESULT: " + std::to_string(hr));
+        memcpy(mapped.pData, &constants, sizeof(constants));
+        ctx->Unmap(pImpl->compositeCB.Get(), 0);
+
+        ID3D11ShaderResourceView* srv = rl.layer->source->pImpl->d3d11SRV.Get();
+        ctx->PSSetShaderResources(0, 1, &srv);
+        for (size_t i = 0; i < areas.size(); ++i) {
+            if (!Composite::touches(rl, areas[i])) continue;
+            ctx->RSSetScissorRects(1, &scissors[i]);
+            ctx->Draw(4, 0);
+        }
+    }
+
+    ID3D11ShaderResourceView* nullSRV[] = { nullptr };
+    ctx->PSSetShaderResources(0, 1, nullSRV);
+    ctx->OMSetBlendState(nullptr, nullptr, 0xFFFFFFFF);
+    ctx->RSSetState(nullptr);
+}
+
+void DeviceD3D12::composite(std::shared_ptr<Texture> destination, const std::vector<CompositeLayer>& layers,
+                            bool clear, float r, float g, float b, float a, const std::optional<std::vector<DirtyRect>>& regions) {
+    if (!destination || !destination->pImpl->is_d3d12 || !destination->pImpl->d3d12Resource) {
+        throw std::invalid_argument("Invalid D3D12 destination texture for composite. Check for null or incorrect API type.");
+    }
+    const uint32_t dw = destination->get_width(), dh = destination->get_height();
+    const auto resolved = Composite::resolve_layers(dw, dh, layers);
+    std::vector<ID3D12Resource*> sources;
+    for (const auto& rl : resolved) {
+        const auto& src = rl.layer->source;
+        if (!src->pImpl->is_d3d12 || !src->pImpl->d3d12Resource) {
+            throw std::invalid_argument("Invalid D3D12 source texture for composite (must be D3D12).");
+        }
+        if (src == destination) {
+            throw std::invalid_argument("D3D12::composite cannot read and write the same texture.");
+        }
+        if (std::find(sources.begin(), sources.end(), src->pImpl->d3d12Resource.Get()) == sources.end()) {
+            sources.push_back(src->pImpl->d3d12Resource.Get());
+        }
+    }
+    if (resolved.empty() && !clear) return;
+    const auto areas = Composite::resolve_regions(dw, dh, regions);
+    if (areas.empty()) return;
+    std::vector<D3D12_RECT> scissors;
+    for (const auto& area : areas) {
+        scissors.push_back({ (LONG)area.x, (LONG)area.y, (LONG)(area.x + area.width), (LONG)(area.y + area.height) });
+    }
+
+    HRESULT hr;
+    if (!pImpl->compositeRootSignature) {
+        D3D12_DESCRIPTOR_RANGE srvRange = { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND };
+        D3D12_ROOT_PARAMETER rootParameters[2] = {};
+        rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        rootParameters[0].DescriptorTable = { 1, &srvRange };
+        rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+        rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        rootParameters[1].Constants = { 0, 0, sizeof(CompositeConstants) / 4 };
+        rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+        D3D12_STATIC_SAMPLER_DESC sampler = {};
+        sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+        sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+        sampler.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+        sampler.MinLOD = 0.0f;
+        sampler.MaxLOD = D3D12_FLOAT32_MAX;
+        sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+        D3D12_ROOT_SIGNATURE_DESC rootSigDesc = { _countof(rootParameters), rootParameters, 1, &sampler, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT };
+        ComPtr<ID3DBlob> signatureBlob, errorBlob;
+        hr = D3D12SerializeRootSignature(&rootSigDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
+        if (FAILED(hr)) { if(errorBlob) throw std::runtime_error("Failed to serialize composite root signature: " + std::string((char*)errorBlob->GetBufferPointer())); else throw std::runtime_error("Failed to serialize composite root signature. HRESULT: " + std::to_string(hr)); }
+        hr = pImpl->device->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&pImpl->compositeRootSignature));
+        if (FAILED(hr)) throw std::runtime_error("Failed to create composite root signature. HRESULT: " + std::to_string(hr));
+    }
+
+    // Render target format is baked into a D3D12 PSO, so keep one per destination format.
+    auto& pso = pImpl->compositePSOs[destination->get_format()];
+    if (!pso) {
+        ComPtr<ID3DBlob> vsBlob, psBlob;
+        hr = D3DCompile(g_compositeShaderHLSL, strlen(g_compositeShaderHLSL), nullptr, nullptr, nullptr, "VSMain", "vs_5_0", 0, 0, &vsBlob, nullptr);
+        if (FAILED(hr)) throw std::runtime_error("Failed to compile internal composite VS. HRESULT: " + std::to_string(hr));
+        hr = D3DCompile(g_compositeShaderHLSL, strlen(g_compositeShaderHLSL), nullptr, nullptr, nullptr, "PSMain", "ps_5_0", 0, 0, &psBlob, nullptr);
+        if (FAILED(hr)) throw std::runtime_error("Failed to compile internal composite PS. HRESULT: " + std::to_string(hr));
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+        psoDesc.InputLayout = { nullptr, 0 };
+        psoDesc.pRootSignature = pImpl->compositeRootSignature.Get();
+        psoDesc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
+        psoDesc.PS = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
+        psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+        psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+        psoDesc.RasterizerState.DepthClipEnable = TRUE;
+        D3D12_RENDER_TARGET_BLEND_DESC& rtBlend = psoDesc.BlendState.RenderTarget[0];
+        rtBlend.BlendEnable = TRUE;
+        rtBlend.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+        rtBlend.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+        rtBlend.BlendOp = D3D12_BLEND_OP_ADD;
+        rtBlend.SrcBlendAlpha = D3D12_BLEND_ONE;
+        rtBlend.DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+        rtBlend.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+        rtBlend.LogicOp = D3D12_LOGIC_OP_NOOP;
+        rtBlend.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+        psoDesc.DepthStencilState.DepthEnable = FALSE;
+        psoDesc.DepthStencilState.StencilEnable = FALSE;
+        psoDesc.SampleMask = UINT_MAX;
+        psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+        psoDesc.NumRenderTargets = 1;
+        psoDesc.RTVFormats[0] = destination->get_format();
+        psoDesc.SampleDesc.Count = 1;
+        hr = pImpl->device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
+        if (FAILED(hr)) throw std::runtime_error("Failed to create composite PSO. HRESULT: " + std::to_string(hr));
+    }
+
+    // A batch may still hold earlier composites' draws, so it gets its own heap.
+    ID3D12DescriptorHeap* srvHeap = nullptr;
+    if (pImpl->batching && !resolved.empty()) {
+        srvHeap = transient_srv_heap((UINT)resolved.size());
+    } else if (pImpl->compositeSrvCapacity < resolved.size()) {
+        D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+        heapDesc.NumDescriptors = std::max<UINT>(16, (UINT)resolved.size());
+        heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        hr = pImpl->device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&pImpl->compositeSrvHeap));
+        if (FAILED(hr)) throw std::runtime_error("Failed to create composite SRV heap. HRESULT: " + std::to_string(hr));
+        pImpl->compositeSrvCapacity = heapDesc.NumDescriptors;
+    }
+    if (!srvHeap) srvHeap = pImpl->compositeSrvHeap.Get();
+
+    const UINT srvSize = pImpl->device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    D3D12_CPU_DESCRIPTOR_HANDLE srvCpu = srvHeap ? srvHeap->GetCPUDescriptorHandleForHeapStart() : D3D12_CPU_DESCRIPTOR_HANDLE{};
+    for (const auto& rl : resolved) {
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Format = rl.layer->source->get_format();
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels = 1;
+        pImpl->device->CreateShaderResourceView(rl.layer->source->pImpl->d3d12Resource.Get(), &srvDesc, srvCpu);
+        srvCpu.ptr += srvSize;
+    }
+
+    begin_commands(pso.Get());
+
+    std::vector<D3D12_RESOURCE_BARRIER> barriers(sources.size() + 1);
+    barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barriers[0].Transition = { destination->pImpl->d3d12Resource.Get(), D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET };
+    for (size_t i = 0; i < sources.size(); ++i) {
+        barriers[i + 1].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barriers[i + 1].Transition = { sources[i], D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE };
+    }
+    pImpl->commandList->ResourceBarrier((UINT)barriers.size(), barriers.data());
+
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = pImpl->blitRtvHeap->GetCPUDescriptorHandleForHeapStart();
+    pImpl->device->CreateRenderTargetView(destination->pImpl->d3d12Resource.Get(), nullptr, rtvHandle);
+    pImpl->commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    if (clear) {
+        const float color[4] = { r, g, b, a };
+        if (DirtyRects::is_full(areas, dw, dh)) pImpl->commandList->ClearRenderTargetView(rtvHandle, color, 0, nullptr);
+        else pImpl->commandList->ClearRenderTargetView(rtvHandle, color, (UINT)scissors.size(), scissors.data());
+    }
+
+    if (!resolved.empty()) {
+        D3D12_VIEWPORT vp = { 0.0f, 0.0f, (float)dw, (float)dh, 0.0f, 1.0f };
+        pImpl->commandList->RSSetViewports(1, &vp);
+        pImpl->commandList->SetGraphicsRootSignature(pImpl->compositeRootSignature.Get());
+        ID3D12DescriptorHeap* heaps[] = { srvHeap };
+        pImpl->commandList->SetDescriptorHeaps(1, heaps);
+        pImpl->commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+
+        D3D12_GPU_DESCRIPTOR_HANDLE srvGpu = srvHeap->GetGPUDescriptorHandleForHeapStart();
+        for (const auto& rl : resolved) {
+            const CompositeConstants constants = make_composite_constants(rl, dw, dh);
+            pImpl->commandList->SetGraphicsRootDescriptorTable(0, srvGpu);
+            pImpl->commandList->SetGraphicsRoot32BitConstants(1, sizeof(constants) / 4, &constants, 0);
+            for (size_t i = 0; i < areas.size(); ++i) {
+                if (!Composite::touches(rl, areas[i])) continue;
+                pImpl->commandList->RSSetScissorRects(1, &scissors[i]);
+                pImpl->commandList->DrawInstanced(4, 1, 0, 0);
+            }
+            srvGpu.ptr += srvSize;
+        }
+    }
+
+    for (auto& barrier : barriers) {
+        std::swap(barrier.Transition.StateBefore, barrier.Transition.StateAfter);
+    }
+    pImpl->commandList->ResourceBarrier((UINT)barriers.size(), barriers.data());
+
+    end_commands();
+}
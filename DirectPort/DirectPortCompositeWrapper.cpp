@@ -0,0 +1,83 @@
+#include "DirectPortComposite.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+// Accepts CompositeLayer objects or the short form (source, (x, y, w, h)[, opacity[, z]]).
+// Shared with the device wrappers, which call it before releasing the GIL.
+std::vector<CompositeLayer> composite_layers_from_python(const py::iterable& items) {
+    std::vector<CompositeLayer> layers;
+    for (const auto& item : items) {
+        if (py::isinstance<CompositeLayer>(item)) {
+            layers.push_back(item.cast<CompositeLayer>());
+            continue;
+        }
+        py::tuple t = py::reinterpret_borrow<py::object>(item).cast<py::tuple>();
+        if (t.size() < 2 || t.size() > 4) {
+            throw py::value_error("Composite layers must be CompositeLayer or (source, (x, y, w, h), opacity, z).");
+        }
+        py::tuple rect = t[1].cast<py::tuple>();
+        if (rect.size() != 4) {
+            throw py::value_error("Composite layer rect must be (x, y, width, height).");
+        }
+        CompositeLayer layer;
+        layer.source = t[0].cast<std::shared_ptr<Texture>>();
+        layer.x = rect[0].cast<int32_t>();
+        layer.y = rect[1].cast<int32_t>();
+        layer.width = rect[2].cast<uint32_t>();
+        layer.height = rect[3].cast<uint32_t>();
+        if (t.size() > 2) layer.opacity = t[2].cast<float>();
+        if (t.size() > 3) layer.z = t[3].cast<int32_t>();
+        layers.push_back(layer);
+    }
+    return layers;
+}
+
+void bind_composite(py::module_& m) {
+    py::enum_<CompositeFit>(m, "CompositeFit", "")
+        .value("Stretch", CompositeFit::Stretch, "")
+        .value("Letterbox", CompositeFit::Letterbox, "")
+        .value("Crop", CompositeFit::Crop, "");
+
+    py::class_<CompositeLayer>(m, "CompositeLayer", "One input to a device's composite().")
+        .def(py::init([](std::shared_ptr<Texture> source, int32_t x, int32_t y, uint32_t width, uint32_t height, float opacity, int32_t z,
+                         py::object crop, CompositeFit fit, bool use_source_alpha) {
+            CompositeLayer layer;
+            layer.source = std::move(source);
+            layer.x = x; layer.y = y; layer.width = width; layer.height = height;
+            layer.opacity = opacity;
+            layer.z = z;
+            if (!crop.is_none()) {
+                auto c = crop.cast<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>>();
+                layer.crop_x = std::get<0>(c); layer.crop_y = std::get<1>(c);
+                layer.crop_width = std::get<2>(c); layer.crop_height = std::get<3>(c);
+            }
+            layer.fit = fit;
+            layer.use_source_alpha = use_source_alpha;
+            return layer;
+        }), py::arg("source"), py::arg("x") = 0, py::arg("y") = 0, py::arg("width") = 0, py::arg("height") = 0,
+            py::arg("opacity") = 1.0f, py::arg("z") = 0, py::arg("crop") = py::none(),
+            py::arg("fit") = CompositeFit::Stretch, py::arg("use_source_alpha") = false, "")
+        .def_readwrite("source", &CompositeLayer::source, "")
+        .def_readwrite("x", &CompositeLayer::x, "")
+        .def_readwrite("y", &CompositeLayer::y, "")
+        .def_readwrite("width", &CompositeLayer::width, "")
+        .def_readwrite("height", &CompositeLayer::height, "")
+        .def_readwrite("opacity", &CompositeLayer::opacity, "")
+        .def_readwrite("z", &CompositeLayer::z, "")
+        .def_readwrite("crop_x", &CompositeLayer::crop_x, "")
+        .def_readwrite("crop_y", &CompositeLayer::crop_y, "")
+        .def_readwrite("crop_width", &CompositeLayer::crop_width, "")
+        .def_readwrite("crop_height", &CompositeLayer::crop_height, "")
+        .def_readwrite("fit", &CompositeLayer::fit, "")
+        .def_readwrite("use_source_alpha", &CompositeLayer::use_source_alpha, "");
+
+    m.def("grid_layout", &Composite::grid_layout, py::arg("sources"), py::arg("dest_width"), py::arg("dest_height"),
+          py::arg("columns") = 0, py::arg("gap") = 0, py::arg("fit") = CompositeFit::Letterbox,
+          "Lays sources out in an even grid, ready for composite().");
+    m.def("picture_in_picture", &Composite::picture_in_picture, py::arg("source"), py::arg("dest_width"), py::arg("dest_height"),
+          py::arg("scale") = 0.25f, py::arg("margin") = 16, py::arg("corner") = 3, py::arg("opacity") = 1.0f,
+          "An inset layer in one corner (0 top-left, 1 top-right, 2 bottom-left, 3 bottom-right).");
+}
@@ -0,0 +1,838 @@
+// src/DirectPort/DirectPortConvert.cpp
+// Every conversion is assembled from a few primitives: 8-bit and fp16 channel
+// conversion, an R/B byte swap, 10:10:10:2 pack/unpack and a streaming copy.
+// Each primitive has a scalar reference plus SSE4.1, AVX2 and AVX-512 versions
+// chosen at runtime; pixels move through them in L1-sized chunks.
+
+#include "DirectPortConvert.h"
+#include "DirectPortFormats.h"
+#include "DirectPortScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "DirectPortSimd.h"
+
+#ifdef DP_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+using namespace DirectPort;
+using Convert::Isa;
+
+namespace {
+
+    // Pixels per pass: a chunk's RGBA floats and staging bytes fit in L1 together.
+    constexpr uint32_t kChunk = 256;
+    // Outputs larger than this bypass the cache on the way out.
+    constexpr size_t kStreamBytes = 8u << 20;
+
+    using Channel = Formats::Sample;
+
+    struct Layout {
+        Channel type;
+        uint32_t channels;
+        bool bgra;
+        size_t bpp;
+    };
+
+    bool layout_of(DXGI_FORMAT format, Layout& layout) {
+        if (!Formats::is_convertible(format)) return false;
+        const Formats::Traits& t = *Formats::find(format);
+        layout = { t.sample, t.channels, t.bgra, t.block_bytes };
+        return true;
+    }
+
+    Layout require_layout(DXGI_FORMAT format) {
+        Layout layout;
+        if (!layout_of(format, layout)) {
+            throw std::invalid_argument("Convert: unsupported DXGI_FORMAT " + std::to_string((int)format) + ".");
+        }
+        return layout;
+    }
+
+    // --- Scalar reference ---
+
+    uint32_t bits_of(float f) { uint32_t u; memcpy(&u, &f, 4); return u; }
+    float float_of(uint32_t u) { float f; memcpy(&f, &u, 4); return f; }
+
+    // NaN goes to 0, matching maxps/minps with the constant as second operand.
+    float saturate(float v) { return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f; }
+    uint32_t to_unorm(float v, float scale) { return (uint32_t)std::lrint(saturate(v) * scale); }
+
+    float half_to_float(uint16_t h) {
+        uint32_t o = (uint32_t)(h & 0x7FFFu) << 13;
+        const uint32_t exp = o & 0x0F800000u;
+        o += 0x38000000u;
+        if (exp == 0x0F800000u) {
+            o += 0x38000000u;
+            if (o & 0x007FFFFFu) o |= 0x00400000u;
+        } else if (exp == 0) {
+            o = bits_of(float_of(o + 0x00800000u) - float_of(0x38800000u));
+        }
+        return float_of(o | (uint32_t)(h & 0x8000u) << 16);
+    }
+
+    uint16_t float_to_half(float value) {
+        uint32_t u = bits_of(value);
+        const uint32_t sign = u & 0x80000000u;
+        u ^= sign;
+        uint32_t h;
+        if (u >= 0x47800000u) {
+            h = u > 0x7F800000u ? 0x7E00u | ((u >> 13) & 0x3FFu) : 0x7C00u;
+        } else if (u < 0x38800000u) {
+            // Subnormal or zero: adding 0.5 lines the mantissa up and lets the FPU round it.
+            h = bits_of(float_of(u) + 0.5f) - 0x3F000000u;
+        } else {
+            h = (u + 0xC8000FFFu + ((u >> 13) & 1u)) >> 13;
+        }
+        return (uint16_t)(h | sign >> 16);
+    }
+
+    void u8_to_f32_scalar(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < n; ++i) {
+            const float f = s[i] / 255.0f;
+            memcpy(d + i * 4, &f, 4);
+        }
+    }
+
+    void f32_to_u8_scalar(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < n; ++i) {
+            float f;
+            memcpy(&f, s + i * 4, 4);
+            d[i] = (uint8_t)to_unorm(f, 255.0f);
+        }
+    }
+
+    void f16_to_f32_scalar(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < n; ++i) {
+            uint16_t h;
+            memcpy(&h, s + i * 2, 2);
+            const float f = half_to_float(h);
+            memcpy(d + i * 4, &f, 4);
+        }
+    }
+
+    void f32_to_f16_scalar(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < n; ++i) {
+            float f;
+            memcpy(&f, s + i * 4, 4);
+            const uint16_t h = float_to_half(f);
+            memcpy(d + i * 2, &h, 2);
+        }
+    }
+
+    // Safe in place.
+    void swap_rb8_scalar(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < pixels; ++i) {
+            const uint8_t r = s[i * 4], g = s[i * 4 + 1], b = s[i * 4 + 2], a = s[i * 4 + 3];
+            d[i * 4] = b; d[i * 4 + 1] = g; d[i * 4 + 2] = r; d[i * 4 + 3] = a;
+        }
+    }
+
+    void unpack_rgb10a2_scalar(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < pixels; ++i) {
+            uint32_t v;
+            memcpy(&v, s + i * 4, 4);
+            const float rgba[4] = { (v & 0x3FFu) / 1023.0f, ((v >> 10) & 0x3FFu) / 1023.0f,
+                                    ((v >> 20) & 0x3FFu) / 1023.0f, (v >> 30) / 3.0f };
+            memcpy(d + i * 16, rgba, 16);
+        }
+    }
+
+    void pack_rgb10a2_scalar(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < pixels; ++i) {
+            float rgba[4];
+            memcpy(rgba, s + i * 16, 16);
+            const uint32_t v = to_unorm(rgba[0], 1023.0f) | to_unorm(rgba[1], 1023.0f) << 10 |
+                               to_unorm(rgba[2], 1023.0f) << 20 | to_unorm(rgba[3], 3.0f) << 30;
+            memcpy(d + i * 4, &v, 4);
+        }
+    }
+
+    void copy_scalar(void* dst, const void* src, size_t bytes) {
+        memcpy(dst, src, bytes);
+    }
+
+    struct Kernels {
+        void (*u8_to_f32)(const void*, void*, size_t);
+        void (*f32_to_u8)(const void*, void*, size_t);
+        void (*f16_to_f32)(const void*, void*, size_t);
+        void (*f32_to_f16)(const void*, void*, size_t);
+        void (*swap_rb8)(const void*, void*, size_t);
+        void (*unpack_rgb10a2)(const void*, void*, size_t);
+        void (*pack_rgb10a2)(const void*, void*, size_t);
+        // Non-temporal where the set has it; callers fence once per row.
+        void (*stream)(void*, const void*, size_t);
+    };
+
+    const Kernels kScalar = {
+        u8_to_f32_scalar, f32_to_u8_scalar, f16_to_f32_scalar, f32_to_f16_scalar,
+        swap_rb8_scalar, unpack_rgb10a2_scalar, pack_rgb10a2_scalar, copy_scalar,
+    };
+
+#ifdef DP_SIMD_X86
+
+    // --- SSE4.1 ---
+
+    DP_TARGET("sse4.1") inline __m128 half4_to_float_sse41(__m128i h) {
+        const __m128i o0 = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+        const __m128i exp = _mm_and_si128(o0, _mm_set1_epi32(0x0F800000));
+        const __m128i o = _mm_add_epi32(o0, _mm_set1_epi32(0x38000000));
+        const __m128i inf_nan = _mm_cmpeq_epi32(exp, _mm_set1_epi32(0x0F800000));
+        const __m128i tiny = _mm_cmpeq_epi32(exp, _mm_setzero_si128());
+        const __m128i mant_zero = _mm_cmpeq_epi32(_mm_and_si128(o0, _mm_set1_epi32(0x007FFFFF)), _mm_setzero_si128());
+        const __m128i quiet = _mm_andnot_si128(mant_zero, _mm_set1_epi32(0x00400000));
+        const __m128i big = _mm_or_si128(_mm_add_epi32(o, _mm_set1_epi32(0x38000000)), quiet);
+        const __m128i sub = _mm_castps_si128(_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(o, _mm_set1_epi32(0x00800000))),
+                                                        _mm_castsi128_ps(_mm_set1_epi32(0x38800000))));
+        __m128i r = _mm_blendv_epi8(o, big, inf_nan);
+        r = _mm_blendv_epi8(r, sub, tiny);
+        return _mm_castsi128_ps(_mm_or_si128(r, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16)));
+    }
+
+    // Halves in the low 16 bits of each lane.
+    DP_TARGET("sse4.1") inline __m128i float4_to_half_sse41(__m128 v) {
+        __m128i u = _mm_castps_si128(v);
+        const __m128i sign = _mm_and_si128(u, _mm_set1_epi32((int)0x80000000u));
+        u = _mm_xor_si128(u, sign);
+        const __m128i big = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x477FFFFF));
+        const __m128i nan = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x7F800000));
+        const __m128i tiny = _mm_cmplt_epi32(u, _mm_set1_epi32(0x38800000));
+        const __m128i payload = _mm_or_si128(_mm_set1_epi32(0x7E00), _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(0x3FF)));
+        const __m128i inf_nan = _mm_blendv_epi8(_mm_set1_epi32(0x7C00), payload, nan);
+        const __m128i sub = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(u), _mm_set1_ps(0.5f))), _mm_set1_epi32(0x3F000000));
+        const __m128i odd = _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(1));
+        const __m128i norm = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(u, _mm_set1_epi32((int)0xC8000FFFu)), odd), 13);
+        __m128i h = _mm_blendv_epi8(norm, sub, tiny);
+        h = _mm_blendv_epi8(h, inf_nan, big);
+        return _mm_or_si128(h, _mm_srli_epi32(sign, 16));
+    }
+
+    DP_TARGET("sse4.1") void u8_to_f32_sse41(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            _mm_storeu_ps(d + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(v)), scale));
+            _mm_storeu_ps(d + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4))), scale));
+            _mm_storeu_ps(d + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8))), scale));
+            _mm_storeu_ps(d + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12))), scale));
+        }
+        u8_to_f32_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET("sse4.1") void f32_to_u8_sse41(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const float*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), scale = _mm_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i q[4];
+            for (int k = 0; k < 4; ++k) {
+                const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + i + k * 4), zero), one);
+                q[k] = _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+            }
+            const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), packed);
+        }
+        f32_to_u8_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET("sse4.1") void f16_to_f32_sse41(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint16_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            _mm_storeu_ps(d + i, half4_to_float_sse41(_mm_cvtepu16_epi32(h)));
+            _mm_storeu_ps(d + i + 4, half4_to_float_sse41(_mm_cvtepu16_epi32(_mm_srli_si128(h, 8))));
+        }
+        f16_to_f32_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET("sse4.1") void f32_to_f16_sse41(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const float*>(src);
+        auto* d = static_cast<uint16_t*>(dst);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const __m128i lo = float4_to_half_sse41(_mm_loadu_ps(s + i));
+            const __m128i hi = float4_to_half_sse41(_mm_loadu_ps(s + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_packus_epi32(lo, hi));
+        }
+        f32_to_f16_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET("sse4.1") void swap_rb8_sse41(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        size_t i = 0;
+        for (; i + 4 <= pixels; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i * 4), _mm_shuffle_epi8(v, mask));
+        }
+        swap_rb8_scalar(s + i * 4, d + i * 4, pixels - i);
+    }
+
+    DP_TARGET("sse4.1") void unpack_rgb10a2_sse41(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        const __m128i mask10 = _mm_set1_epi32(0x3FF);
+        const __m128 max10 = _mm_set1_ps(1023.0f), max2 = _mm_set1_ps(3.0f);
+        size_t i = 0;
+        for (; i + 4 <= pixels; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i * 4));
+            __m128 r = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(v, mask10)), max10);
+            __m128 g = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 10), mask10)), max10);
+            __m128 b = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 20), mask10)), max10);
+            __m128 a = _mm_div_ps(_mm_cvtepi32_ps(_mm_srli_epi32(v, 30)), max2);
+            _MM_TRANSPOSE4_PS(r, g, b, a);
+            _mm_storeu_ps(d + i * 4, r);
+            _mm_storeu_ps(d + i * 4 + 4, g);
+            _mm_storeu_ps(d + i * 4 + 8, b);
+            _mm_storeu_ps(d + i * 4 + 12, a);
+        }
+        unpack_rgb10a2_scalar(s + i * 4, d + i * 4, pixels - i);
+    }
+
+    // Channels are shifted into place with a multiply and summed with horizontal
+    // adds; the fields never overlap, so the sum is the OR.
+    DP_TARGET("sse4.1") void pack_rgb10a2_sse41(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const float*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_setr_ps(1023.0f, 1023.0f, 1023.0f, 3.0f);
+        const __m128i shift = _mm_setr_epi32(1, 1 << 10, 1 << 20, 1 << 30);
+        size_t i = 0;
+        for (; i + 4 <= pixels; i += 4) {
+            __m128i q[4];
+            for (int k = 0; k < 4; ++k) {
+                const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + (i + k) * 4), zero), one);
+                q[k] = _mm_mullo_epi32(_mm_cvtps_epi32(_mm_mul_ps(v, scale)), shift);
+            }
+            const __m128i packed = _mm_hadd_epi32(_mm_hadd_epi32(q[0], q[1]), _mm_hadd_epi32(q[2], q[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i * 4), packed);
+        }
+        pack_rgb10a2_scalar(s + i * 4, d + i * 4, pixels - i);
+    }
+
+    DP_TARGET("sse4.1") void stream_sse41(void* dst, const void* src, size_t bytes) {
+        auto* d = static_cast<uint8_t*>(dst);
+        const auto* s = static_cast<const uint8_t*>(src);
+        const size_t head = std::min(bytes, (size_t)((16 - ((uintptr_t)d & 15)) & 15));
+        memcpy(d, s, head);
+        size_t i = head;
+        for (; i + 16 <= bytes; i += 16) {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)));
+        }
+        memcpy(d + i, s + i, bytes - i);
+    }
+
+    const Kernels kSSE41 = {
+        u8_to_f32_sse41, f32_to_u8_sse41, f16_to_f32_sse41, f32_to_f16_sse41,
+        swap_rb8_sse41, unpack_rgb10a2_sse41, pack_rgb10a2_sse41, stream_sse41,
+    };
+
+    // --- AVX2 + F16C ---
+
+    DP_TARGET("avx2,f16c") void u8_to_f32_avx2(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        const __m256 scale = _mm256_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            _mm256_storeu_ps(d + i, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v)), scale));
+            _mm256_storeu_ps(d + i + 8, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8))), scale));
+        }
+        u8_to_f32_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET("avx2,f16c") void f32_to_u8_avx2(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const float*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), scale = _mm256_set1_ps(255.0f);
+        // Undoes the per-lane interleave of the two packs.
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i q[4];
+            for (int k = 0; k < 4; ++k) {
+                const __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(s + i + k * 8), zero), one);
+                q[k] = _mm256_cvtps_epi32(_mm256_mul_ps(v, scale));
+            }
+            const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(q[0], q[1]), _mm256_packs_epi32(q[2], q[3]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_permutevar8x32_epi32(packed, order));
+        }
+        f32_to_u8_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET("avx2,f16c") void f16_to_f32_avx2(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint16_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(d + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i))));
+        }
+        f16_to_f32_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET("avx2,f16c") void f32_to_f16_avx2(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const float*>(src);
+        auto* d = static_cast<uint16_t*>(dst);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm256_cvtps_ph(_mm256_loadu_ps(s + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+        f32_to_f16_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET("avx2,f16c") void swap_rb8_avx2(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        const __m256i mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                              2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        size_t i = 0;
+        for (; i + 8 <= pixels; i += 8) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i * 4), _mm256_shuffle_epi8(v, mask));
+        }
+        swap_rb8_scalar(s + i * 4, d + i * 4, pixels - i);
+    }
+
+    // Each pixel is broadcast across four lanes and shifted by a per-lane amount.
+    DP_TARGET("avx2,f16c") void unpack_rgb10a2_avx2(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        const __m256i shifts = _mm256_setr_epi32(0, 10, 20, 30, 0, 10, 20, 30);
+        const __m256i masks = _mm256_setr_epi32(0x3FF, 0x3FF, 0x3FF, 3, 0x3FF, 0x3FF, 0x3FF, 3);
+        const __m256 scale = _mm256_setr_ps(1023.0f, 1023.0f, 1023.0f, 3.0f, 1023.0f, 1023.0f, 1023.0f, 3.0f);
+        size_t i = 0;
+        for (; i + 8 <= pixels; i += 8) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i * 4));
+            for (int k = 0; k < 4; ++k) {
+                const __m256i pair = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(2 * k, 2 * k, 2 * k, 2 * k, 2 * k + 1, 2 * k + 1, 2 * k + 1, 2 * k + 1));
+                const __m256i c = _mm256_and_si256(_mm256_srlv_epi32(pair, shifts), masks);
+                _mm256_storeu_ps(d + (i + 2 * k) * 4, _mm256_div_ps(_mm256_cvtepi32_ps(c), scale));
+            }
+        }
+        unpack_rgb10a2_scalar(s + i * 4, d + i * 4, pixels - i);
+    }
+
+    DP_TARGET("avx2,f16c") void pack_rgb10a2_avx2(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const float*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+        const __m256 scale = _mm256_setr_ps(1023.0f, 1023.0f, 1023.0f, 3.0f, 1023.0f, 1023.0f, 1023.0f, 3.0f);
+        const __m256i shifts = _mm256_setr_epi32(0, 10, 20, 30, 0, 10, 20, 30);
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        size_t i = 0;
+        for (; i + 8 <= pixels; i += 8) {
+            __m256i q[4];
+            for (int k = 0; k < 4; ++k) {
+                const __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(s + (i + 2 * k) * 4), zero), one);
+                q[k] = _mm256_sllv_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(v, scale)), shifts);
+            }
+            const __m256i packed = _mm256_hadd_epi32(_mm256_hadd_epi32(q[0], q[1]), _mm256_hadd_epi32(q[2], q[3]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i * 4), _mm256_permutevar8x32_epi32(packed, order));
+        }
+        pack_rgb10a2_scalar(s + i * 4, d + i * 4, pixels - i);
+    }
+
+    DP_TARGET("avx2,f16c") void stream_avx2(void* dst, const void* src, size_t bytes) {
+        auto* d = static_cast<uint8_t*>(dst);
+        const auto* s = static_cast<const uint8_t*>(src);
+        const size_t head = std::min(bytes, (size_t)((32 - ((uintptr_t)d & 31)) & 31));
+        memcpy(d, s, head);
+        size_t i = head;
+        for (; i + 32 <= bytes; i += 32) {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d + i), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)));
+        }
+        memcpy(d + i, s + i, bytes - i);
+    }
+
+    const Kernels kAVX2 = {
+        u8_to_f32_avx2, f32_to_u8_avx2, f16_to_f32_avx2, f32_to_f16_avx2,
+        swap_rb8_avx2, unpack_rgb10a2_avx2, pack_rgb10a2_avx2, stream_avx2,
+    };
+
+    // --- AVX-512 F + BW ---
+
+#define DP_AVX512 "avx512f,avx512bw,avx2,f16c"
+
+    DP_TARGET(DP_AVX512) void u8_to_f32_avx512(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        const __m512 scale = _mm512_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m512i v = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)));
+            _mm512_storeu_ps(d + i, _mm512_div_ps(_mm512_cvtepi32_ps(v), scale));
+        }
+        u8_to_f32_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET(DP_AVX512) void f32_to_u8_avx512(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const float*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.0f), scale = _mm512_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m512 v = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(s + i), zero), one);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm512_cvtepi32_epi8(_mm512_cvtps_epi32(_mm512_mul_ps(v, scale))));
+        }
+        f32_to_u8_scalar(s + i, d + i, n - i);
+    }
+
+    DP_TARGET(DP_AVX512) void f16_to_f32_avx512(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const uint16_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            _mm512_storeu_ps(d + i, _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i))));
+        }
+        f16_to_f32_avx2(s + i, d + i, n - i);
+    }
+
+    DP_TARGET(DP_AVX512) void f32_to_f16_avx512(const void* src, void* dst, size_t n) {
+        const auto* s = static_cast<const float*>(src);
+        auto* d = static_cast<uint16_t*>(dst);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm512_cvtps_ph(_mm512_loadu_ps(s + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+        f32_to_f16_avx2(s + i, d + i, n - i);
+    }
+
+    DP_TARGET(DP_AVX512) void swap_rb8_avx512(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<uint8_t*>(dst);
+        const __m512i mask = _mm512_set4_epi32(0x0F0C0D0E, 0x0B08090A, 0x07040506, 0x03000102);
+        size_t i = 0;
+        for (; i + 16 <= pixels; i += 16) {
+            const __m512i v = _mm512_loadu_si512(s + i * 4);
+            _mm512_storeu_si512(d + i * 4, _mm512_shuffle_epi8(v, mask));
+        }
+        swap_rb8_avx2(s + i * 4, d + i * 4, pixels - i);
+    }
+
+    DP_TARGET(DP_AVX512) void unpack_rgb10a2_avx512(const void* src, void* dst, size_t pixels) {
+        const auto* s = static_cast<const uint8_t*>(src);
+        auto* d = static_cast<float*>(dst);
+        const __m512i shifts = _mm512_set4_epi32(30, 20, 10, 0);
+        const __m512i masks = _mm512_set4_epi32(3, 0x3FF, 0x3FF, 0x3FF);
+        const __m512 scale = _mm512_set4_ps(3.0f, 1023.0f, 1023.0f, 1023.0f);
+        const __m512i spread = _mm512_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+        size_t i = 0;
+        for (; i + 16 <= pixels; i += 16) {
+            const __m512i v = _mm512_loadu_si512(s + i * 4);
+            for (int k = 0; k < 4; ++k) {
+                const __m512i quad = _mm512_permutexvar_epi32(_mm512_add_epi32(spread, _mm512_set1_epi32(4 * k)), v);
+                const __m512i c = _mm512_and_si512(_mm512_srlv_epi32(quad, shifts), masks);
+                _mm512_storeu_ps(d + (i + 4 * k) * 4, _mm512_div_ps(_mm512_cvtepi32_ps(c), scale));
+            }
+        }
+        unpack_rgb10a2_avx2(s + i * 4, d + i * 4, pixels - i);
+    }
+
+    DP_TARGET(DP_AVX512) void stream_avx512(void* dst, const void* src, size_t bytes) {
+        auto* d = static_cast<uint8_t*>(dst);
+        const auto* s = static_cast<const uint8_t*>(src);
+        const size_t head = std::min(bytes, (size_t)((64 - ((uintptr_t)d & 63)) & 63));
+        memcpy(d, s, head);
+        size_t i = head;
+        for (; i + 64 <= bytes; i += 64) {
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(d + i), _mm512_loadu_si512(s + i));
+        }
+        memcpy(d + i, s + i, bytes - i);
+    }
+
+    // Packing needs a horizontal OR that AVX-512 has no cheaper form of, so it
+    // keeps the AVX2 kernel.
+    const Kernels kAVX512 = {
+        u8_to_f32_avx512, f32_to_u8_avx512, f16_to_f32_avx512, f32_to_f16_avx512,
+        swap_rb8_avx512, unpack_rgb10a2_avx512, pack_rgb10a2_avx2, stream_avx512,
+    };
+
+    void cpuid(uint32_t leaf, uint32_t sub, uint32_t regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int r[4];
+        __cpuidex(r, (int)leaf, (int)sub);
+        for (int i = 0; i < 4; ++i) regs[i] = (uint32_t)r[i];
+#else
+        if (!__get_cpuid_count(leaf, sub, &regs[0], &regs[1], &regs[2], &regs[3])) regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#endif
+    }
+
+    uint64_t xcr0() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+#else
+        uint32_t lo, hi;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return ((uint64_t)hi << 32) | lo;
+#endif
+    }
+
+    void store_fence() { _mm_sfence(); }
+
+#else
+
+    void store_fence() {}
+
+#endif
+
+    Isa detect_isa() {
+#ifdef DP_SIMD_X86
+        uint32_t r[4];
+        cpuid(0, 0, r);
+        const uint32_t max_leaf = r[0];
+        cpuid(1, 0, r);
+        const bool sse41 = (r[2] >> 19) & 1, osxsave = (r[2] >> 27) & 1, avx = (r[2] >> 28) & 1, f16c = (r[2] >> 29) & 1;
+        if (!sse41) return Isa::Scalar;
+        if (!osxsave || !avx || !f16c || max_leaf < 7) return Isa::SSE41;
+        // The OS must save YMM (and for AVX-512, opmask and ZMM) state.
+        const uint64_t xcr = xcr0();
+        if ((xcr & 0x6) != 0x6) return Isa::SSE41;
+        cpuid(7, 0, r);
+        const bool avx2 = (r[1] >> 5) & 1, avx512f = (r[1] >> 16) & 1, avx512bw = (r[1] >> 30) & 1;
+        if (!avx2) return Isa::SSE41;
+        if (avx512f && avx512bw && (xcr & 0xE6) == 0xE6) return Isa::AVX512;
+        return Isa::AVX2;
+#else
+        return Isa::Scalar;
+#endif
+    }
+
+    std::atomic<int> g_forced_isa{ -1 };
+
+    const Kernels& kernels_for(Isa isa) {
+        switch (isa) {
+#ifdef DP_SIMD_X86
+            case Isa::AVX512: return kAVX512;
+            case Isa::AVX2: return kAVX2;
+            case Isa::SSE41: return kSSE41;
+#endif
+            default: return kScalar;
+        }
+    }
+
+    // `count` elements of one channel type to another; `scratch` holds
+    // kChunk * 4 floats for the two-step cases.
+    void convert_channels(const Kernels& k, Channel from, const void* src, Channel to, void* dst, size_t count, float* scratch) {
+        if (from == Channel::U8 && to == Channel::F32) k.u8_to_f32(src, dst, count);
+        else if (from == Channel::F32 && to == Channel::U8) k.f32_to_u8(src, dst, count);
+        else if (from == Channel::F16 && to == Channel::F32) k.f16_to_f32(src, dst, count);
+        else if (from == Channel::F32 && to == Channel::F16) k.f32_to_f16(src, dst, count);
+        else if (from == Channel::U8 && to == Channel::F16) { k.u8_to_f32(src, scratch, count); k.f32_to_f16(scratch, dst, count); }
+        else if (from == Channel::F16 && to == Channel::U8) { k.f16_to_f32(src, scratch, count); k.f32_to_u8(scratch, dst, count); }
+    }
+
+    // n <= kChunk pixels to RGBA floats.
+    void decode_chunk(const Kernels& k, const Layout& layout, const uint8_t* src, float* rgba, uint32_t n) {
+        alignas(64) float narrow[kChunk * 2];
+        const uint32_t c = layout.channels;
+        switch (layout.type) {
+            case Channel::U8:
+                if (c == 4) {
+                    if (layout.bgra) {
+                        alignas(64) uint8_t swapped[kChunk * 4];
+                        k.swap_rb8(src, swapped, n);
+                        k.u8_to_f32(swapped, rgba, (size_t)n * 4);
+                    } else {
+                        k.u8_to_f32(src, rgba, (size_t)n * 4);
+                    }
+                    return;
+                }
+                k.u8_to_f32(src, narrow, (size_t)n * c);
+                break;
+            case Channel::F16:
+                if (c == 4) { k.f16_to_f32(src, rgba, (size_t)n * 4); return; }
+                k.f16_to_f32(src, narrow, (size_t)n * c);
+                break;
+            case Channel::F32:
+                if (c == 4) { memcpy(rgba, src, (size_t)n * 16); return; }
+                memcpy(narrow, src, (size_t)n * c * 4);
+                break;
+            case Channel::RGB10A2:
+                k.unpack_rgb10a2(src, rgba, n);
+                return;
+            case Channel::None:  // compressed; layout_of never returns it
+                return;
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            for (uint32_t j = 0; j < 4; ++j) {
+                rgba[i * 4 + j] = j < c ? narrow[i * c + j] : (j == 3 ? 1.0f : 0.0f);
+            }
+        }
+    }
+
+    void encode_chunk(const Kernels& k, const Layout& layout, const float* rgba, uint8_t* dst, uint32_t n) {
+        alignas(64) float narrow[kChunk * 2];
+        const uint32_t c = layout.channels;
+        const float* src = rgba;
+        if (c < 4) {
+            for (uint32_t i = 0; i < n; ++i) {
+                for (uint32_t j = 0; j < c; ++j) narrow[i * c + j] = rgba[i * 4 + j];
+            }
+            src = narrow;
+        }
+        switch (layout.type) {
+            case Channel::U8:
+                k.f32_to_u8(src, dst, (size_t)n * c);
+                if (layout.bgra) k.swap_rb8(dst, dst, n);
+                break;
+            case Channel::F16:
+                k.f32_to_f16(src, dst, (size_t)n * c);
+                break;
+            case Channel::F32:
+                memcpy(dst, src, (size_t)n * c * 4);
+                break;
+            case Channel::RGB10A2:
+                k.pack_rgb10a2(rgba, dst, n);
+                break;
+            case Channel::None:
+                break;
+        }
+    }
+
+    void convert_row_with(const Kernels& k, DXGI_FORMAT src_format, const Layout& in, const uint8_t* src,
+                          DXGI_FORMAT dst_format, const Layout& out, uint8_t* dst, uint32_t count, bool stream) {
+        if (src_format == dst_format) {
+            if (stream) k.stream(dst, src, (size_t)count * out.bpp);
+            else memcpy(dst, src, (size_t)count * out.bpp);
+            return;
+        }
+        // Same channels in the same order: convert the channel values directly.
+        const bool same_layout = in.channels == out.channels && in.bgra == out.bgra &&
+                                 in.type != Channel::RGB10A2 && out.type != Channel::RGB10A2;
+        const bool swizzle_only = in.type == Channel::U8 && out.type == Channel::U8 && in.channels == 4 && out.channels == 4;
+
+        alignas(64) float rgba[kChunk * 4];
+        alignas(64) uint8_t staged[kChunk * 16];
+        for (uint32_t i = 0; i < count; i += kChunk) {
+            const uint32_t n = std::min(kChunk, count - i);
+            const uint8_t* s = src + (size_t)i * in.bpp;
+            uint8_t* d = stream ? staged : dst + (size_t)i * out.bpp;
+            if (same_layout) {
+                convert_channels(k, in.type, s, out.type, d, (size_t)n * in.channels, rgba);
+            } else if (swizzle_only) {
+                k.swap_rb8(s, d, n);
+            } else {
+                decode_chunk(k, in, s, rgba, n);
+                encode_chunk(k, out, rgba, d, n);
+            }
+            if (stream) k.stream(dst + (size_t)i * out.bpp, staged, (size_t)n * out.bpp);
+        }
+    }
+
+}
+
+Isa Convert::best_isa() {
+    static const Isa isa = detect_isa();
+    return isa;
+}
+
+Isa Convert::active_isa() {
+    const int forced = g_forced_isa.load(std::memory_order_relaxed);
+    return forced < 0 ? best_isa() : (Isa)forced;
+}
+
+void Convert::set_isa(Isa isa) {
+    if ((int)isa > (int)best_isa()) {
+        throw std::invalid_argument(std::string("Convert: ") + isa_name(isa) + " kernels are not available on this CPU (best is " + isa_name(best_isa()) + ").");
+    }
+    g_forced_isa.store((int)isa, std::memory_order_relaxed);
+}
+
+const char* Convert::isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::SSE41: return "SSE4.1";
+        case Isa::AVX2: return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+        default: return "scalar";
+    }
+}
+
+bool Convert::is_supported(DXGI_FORMAT format) {
+    Layout layout;
+    return layout_of(format, layout);
+}
+
+size_t Convert::bytes_per_pixel(DXGI_FORMAT format) {
+    Layout layout;
+    return layout_of(format, layout) ? layout.bpp : 0;
+}
+
+void Convert::decode_rgba32f(DXGI_FORMAT format, const void* src, float* rgba, uint32_t count) {
+    const Layout layout = require_layout(format);
+    const Kernels& k = kernels_for(active_isa());
+    const auto* s = static_cast<const uint8_t*>(src);
+    for (uint32_t i = 0; i < count; i += kChunk) {
+        decode_chunk(k, layout, s + (size_t)i * layout.bpp, rgba + (size_t)i * 4, std::min(kChunk, count - i));
+    }
+}
+
+void Convert::encode_rgba32f(DXGI_FORMAT format, const float* rgba, void* dst, uint32_t count) {
+    const Layout layout = require_layout(format);
+    const Kernels& k = kernels_for(active_isa());
+    auto* d = static_cast<uint8_t*>(dst);
+    for (uint32_t i = 0; i < count; i += kChunk) {
+        encode_chunk(k, layout, rgba + (size_t)i * 4, d + (size_t)i * layout.bpp, std::min(kChunk, count - i));
+    }
+}
+
+void Convert::convert_row(DXGI_FORMAT src_format, const void* src, DXGI_FORMAT dst_format, void* dst, uint32_t count) {
+    convert_row_with(kernels_for(active_isa()), src_format, require_layout(src_format), static_cast<const uint8_t*>(src),
+                     dst_format, require_layout(dst_format), static_cast<uint8_t*>(dst), count, false);
+}
+
+void Convert::convert_row_reference(DXGI_FORMAT src_format, const void* src, DXGI_FORMAT dst_format, void* dst, uint32_t count) {
+    convert_row_with(kScalar, src_format, require_layout(src_format), static_cast<const uint8_t*>(src),
+                     dst_format, require_layout(dst_format), static_cast<uint8_t*>(dst), count, false);
+}
+
+void Convert::convert(DXGI_FORMAT src_format, const void* src, size_t src_pitch,
+                      DXGI_FORMAT dst_format, void* dst, size_t dst_pitch,
+                      uint32_t width, uint32_t height) {
+    const Layout in = require_layout(src_format);
+    const Layout out = require_layout(dst_format);
+    if (src_pitch < width * in.bpp || dst_pitch < width * out.bpp) {
+        throw std::invalid_argument("Convert: row pitch is smaller than a row of pixels.");
+    }
+    const Isa isa = active_isa();
+    const Kernels& k = kernels_for(isa);
+    const bool stream = isa != Isa::Scalar && (size_t)height * width * out.bpp >= kStreamBytes;
+    const auto* s = static_cast<const uint8_t*>(src);
+    auto* d = static_cast<uint8_t*>(dst);
+    Scheduler::shared().for_each_band(height, std::max(width * in.bpp, width * out.bpp), [&](uint32_t y0, uint32_t y1) {
+        for (uint32_t y = y0; y < y1; ++y) {
+            convert_row_with(k, src_format, in, s + y * src_pitch, dst_format, out, d + y * dst_pitch, width, stream);
+            if (stream) store_fence();
+        }
+    });
+}
@@ -0,0 +1,47 @@
+// DirectPortConvert.h
+#pragma once
+
+#include "DirectPort.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace DirectPort::Convert {
+
+    // Kernel sets in increasing order. Scalar is the reference: every other set
+    // produces the same bits for every input, NaNs included.
+    enum class Isa { Scalar, SSE41, AVX2, AVX512 };
+
+    // The widest set both compiled in and supported by this CPU and OS.
+    Isa best_isa();
+    Isa active_isa();
+    // Forces a kernel set for every later conversion; throws std::invalid_argument
+    // above best_isa(). Meant for validation and benchmarks.
+    void set_isa(Isa isa);
+    const char* isa_name(Isa isa);
+
+    // The typed, linear, uncompressed formats of Formats::kTable, which are
+    // the ones the Python DXGI_FORMAT enum exposes.
+    bool is_supported(DXGI_FORMAT format);
+    size_t bytes_per_pixel(DXGI_FORMAT format);
+
+    // Conversion rules, following D3D: UNORM to float divides by 2^n - 1; float to
+    // UNORM clamps to [0, 1] (NaN to 0), scales and rounds to nearest even; fp16
+    // rounds to nearest even, overflows to infinity and keeps the top NaN payload
+    // bits, quieted. Missing channels read as 0 and missing alpha as 1; channels
+    // the destination lacks are dropped.
+
+    // Expands `count` pixels to RGBA floats, or packs RGBA floats back.
+    void decode_rgba32f(DXGI_FORMAT format, const void* src, float* rgba, uint32_t count);
+    void encode_rgba32f(DXGI_FORMAT format, const float* rgba, void* dst, uint32_t count);
+
+    // One row of `count` pixels with the active kernel set, or with the scalar reference.
+    void convert_row(DXGI_FORMAT src_format, const void* src, DXGI_FORMAT dst_format, void* dst, uint32_t count);
+    void convert_row_reference(DXGI_FORMAT src_format, const void* src, DXGI_FORMAT dst_format, void* dst, uint32_t count);
+
+    // A pitched image. Rows are split across Scheduler::shared(), and destinations
+    // too large to stay in cache are written with non-temporal stores.
+    void convert(DXGI_FORMAT src_format, const void* src, size_t src_pitch,
+                 DXGI_FORMAT dst_format, void* dst, size_t dst_pitch,
+                 uint32_t width, uint32_t height);
+
+}
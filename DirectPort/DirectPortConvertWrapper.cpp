@@ -0,0 +1,75 @@
+#include "DirectPortConvert.h"
+#include "DirectPortFormats.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+void bind_convert(py::module_& m) {
+    py::enum_<Convert::Isa>(m, "ConvertIsa", "Kernel sets for CPU pixel-format conversion.")
+        .value("Scalar", Convert::Isa::Scalar, "")
+        .value("SSE41", Convert::Isa::SSE41, "")
+        .value("AVX2", Convert::Isa::AVX2, "")
+        .value("AVX512", Convert::Isa::AVX512, "");
+
+    m.def("best_convert_isa", &Convert::best_isa, "The widest conversion kernel set this CPU supports.");
+    m.def("convert_isa", &Convert::active_isa, "The kernel set conversions currently run on.");
+    m.def("set_convert_isa", &Convert::set_isa, py::arg("isa"), "Forces a kernel set, for validation and benchmarks.");
+    m.def("format_bytes_per_pixel", &Convert::bytes_per_pixel, py::arg("format"), "");
+
+    // Accepts a DXGI_FORMAT or a raw DXGI value, since the enum only lists the convertible formats.
+    m.def("format_traits", [](const py::object& format) -> py::object {
+        const Formats::Traits* t = Formats::find((DXGI_FORMAT)py::int_(format).cast<uint32_t>());
+        if (!t) return py::none();
+        py::dict d;
+        d["name"] = t->name;
+        d["block_bytes"] = t->block_bytes;
+        d["block_size"] = t->block_size;
+        d["channels"] = t->channels;
+        d["bgra"] = t->bgra;
+        d["srgb"] = t->srgb;
+        d["typeless"] = t->typeless;
+        d["convertible"] = Formats::is_convertible(t->format);
+        d["numpy_dtype"] = t->numpy_dtype ? py::object(py::str(t->numpy_dtype)) : py::object(py::none());
+        d["numpy_channels"] = t->numpy_channels;
+        d["gl_internal_format"] = t->gl_internal_format;
+        d["gl_format"] = t->gl_format;
+        d["gl_type"] = t->gl_type;
+        d["typeless_format"] = (uint32_t)t->typeless_format;
+        d["srgb_format"] = (uint32_t)t->srgb_format;
+        d["linear_format"] = (uint32_t)t->linear_format;
+        return std::move(d);
+    }, py::arg("format"), "The format traits table row for a DXGI format as a dict, or None if DirectPort does not know it.");
+    m.def("format_row_pitch", [](const py::object& format, uint32_t width) {
+        return Formats::row_pitch((DXGI_FORMAT)py::int_(format).cast<uint32_t>(), width);
+    }, py::arg("format"), py::arg("width"), "Bytes in one tightly packed row (of blocks, when compressed); 0 for unknown formats.");
+
+    // Tightly packed rows in and out; the result is (height, width * bytes per pixel) uint8.
+    m.def("convert_pixels", [](const py::buffer& src, uint32_t width, uint32_t height, DXGI_FORMAT src_format, DXGI_FORMAT dst_format, const py::object& out) {
+        const size_t src_bpp = Convert::bytes_per_pixel(src_format);
+        const size_t dst_bpp = Convert::bytes_per_pixel(dst_format);
+        if (src_bpp == 0 || dst_bpp == 0) {
+            throw py::value_error("convert_pixels: unsupported format.");
+        }
+        py::buffer_info in = src.request();
+        if ((size_t)(in.size * in.itemsize) < (size_t)width * height * src_bpp) {
+            throw py::value_error("convert_pixels: source buffer is smaller than width * height pixels.");
+        }
+        using Bytes = py::array_t<uint8_t, py::array::c_style>;
+        if (!out.is_none() && !py::isinstance<Bytes>(out)) {
+            throw py::type_error("convert_pixels: out must be a C-contiguous uint8 array.");
+        }
+        Bytes result = out.is_none() ? Bytes({ (py::ssize_t)height, (py::ssize_t)(width * dst_bpp) }) : out.cast<Bytes>();
+        py::buffer_info dst = result.request(true);
+        if ((size_t)dst.size < (size_t)width * height * dst_bpp) {
+            throw py::value_error("convert_pixels: out is smaller than width * height pixels.");
+        }
+        {
+            py::gil_scoped_release release;
+            Convert::convert(src_format, in.ptr, width * src_bpp, dst_format, dst.ptr, width * dst_bpp, width, height);
+        }
+        return result;
+    }, py::arg("src"), py::arg("width"), py::arg("height"), py::arg("src_format"), py::arg("dst_format"), py::arg("out") = py::none(),
+       "Converts packed pixels between DXGI formats on the CPU.");
+}
@@ -0,0 +1,483 @@
+// src/DirectPort/DirectPortCopy.cpp
+// Pitched copies and 8-bit channel fix-ups. The size class is decided once
+// per transfer; bands then run one row kernel without further branching.
+// Streaming bands end with an sfence on the lane that wrote them, so the
+// non-temporal stores are visible before the scheduler reports the job done.
+// AVX-512 machines run the AVX2 kernels.
+
+#include "DirectPortCopy.h"
+#include "DirectPortConvert.h"
+#include "DirectPortFormats.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "DirectPortSimd.h"
+
+using namespace DirectPort;
+using Copy::SizeClass;
+
+namespace {
+
+    constexpr size_t kDefaultCacheBytes = 8u << 20;
+
+    size_t detect_last_level_cache() {
+#if defined(_WIN32)
+        DWORD length = 0;
+        GetLogicalProcessorInformation(nullptr, &length);
+        std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length)) {
+            size_t best = 0;
+            BYTE level = 0;
+            for (const auto& entry : info) {
+                if (entry.Relationship != RelationCache || entry.Cache.Level < level) continue;
+                if (entry.Cache.Level > level) best = 0;
+                level = entry.Cache.Level;
+                best = std::max<size_t>(best, entry.Cache.Size);
+            }
+            if (best) return best;
+        }
+#elif defined(_SC_LEVEL3_CACHE_SIZE)
+        for (int name : { _SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE }) {
+            const long bytes = sysconf(name);
+            if (bytes > 0) return (size_t)bytes;
+        }
+#endif
+        return kDefaultCacheBytes;
+    }
+
+    std::atomic<size_t> g_threshold{ 0 };
+
+    // --- Row kernels ---
+
+    using StreamFn = void (*)(uint8_t* d, const uint8_t* s, size_t n);
+
+    void stream_scalar(uint8_t* d, const uint8_t* s, size_t n) { memcpy(d, s, n); }
+
+    // Below 8 bytes a pixel the moves are widened to 8 bytes; a row of a
+    // Small transfer is at most kSmallRowBytes, so this is a handful of moves.
+    template <size_t Bpp>
+    inline void copy_small(uint8_t* d, const uint8_t* s, size_t n) {
+        size_t i = 0;
+        if constexpr (Bpp < 8) {
+            for (; i + 8 <= n; i += 8) memcpy(d + i, s + i, 8);
+        }
+        for (; i < n; i += Bpp) memcpy(d + i, s + i, Bpp);
+    }
+
+    // Each destination byte of a pixel names its source byte; alpha is either
+    // copied or forced to 255.
+    struct Shuffle {
+        uint32_t src_bpp;
+        bool fill;
+        uint8_t index[4];
+        alignas(16) uint8_t mask[16];
+        alignas(16) uint8_t alpha[16];
+    };
+
+    // `offset` is where each source channel sits in a pixel of src_bpp bytes.
+    Shuffle make_shuffle(const Copy::Swizzle& swizzle, uint32_t src_bpp, const uint8_t offset[4]) {
+        if (swizzle.src_channels != 3 && swizzle.src_channels != 4) {
+            throw std::invalid_argument("Copy: source pixels must have 3 or 4 channels.");
+        }
+        Shuffle sh = {};
+        sh.src_bpp = src_bpp;
+        sh.fill = swizzle.fill_alpha || swizzle.src_channels == 3;
+        sh.index[0] = offset[swizzle.swap_rb ? 2 : 0];
+        sh.index[1] = offset[1];
+        sh.index[2] = offset[swizzle.swap_rb ? 0 : 2];
+        sh.index[3] = sh.fill ? 0 : offset[3];
+        for (int px = 0; px < 4; ++px) {
+            for (int c = 0; c < 4; ++c) {
+                const bool filled = c == 3 && sh.fill;
+                sh.mask[px * 4 + c] = filled ? 0x80 : (uint8_t)(px * sh.src_bpp + sh.index[c]);
+                sh.alpha[px * 4 + c] = filled ? 0xFF : 0x00;
+            }
+        }
+        return sh;
+    }
+
+    Shuffle make_shuffle(const Copy::Swizzle& swizzle) {
+        static const uint8_t packed[4] = { 0, 1, 2, 3 };
+        return make_shuffle(swizzle, swizzle.src_channels, packed);
+    }
+
+    inline void transfer_scalar_px(const Shuffle& sh, const uint8_t* p, uint8_t* d) {
+        const uint8_t r = p[sh.index[0]], g = p[sh.index[1]], b = p[sh.index[2]];
+        const uint8_t a = sh.fill ? 255 : p[sh.index[3]];
+        d[0] = r; d[1] = g; d[2] = b; d[3] = a;
+    }
+
+    using TransferFn = void (*)(const Shuffle& sh, const uint8_t* src, uint8_t* dst, uint32_t n, bool stream);
+
+    void transfer_scalar(const Shuffle& sh, const uint8_t* src, uint8_t* dst, uint32_t n, bool) {
+        for (uint32_t i = 0; i < n; ++i) transfer_scalar_px(sh, src + (size_t)i * sh.src_bpp, dst + (size_t)i * 4);
+    }
+
+    using GatherFn = void (*)(const uint8_t* src, ptrdiff_t stride, uint8_t* dst, uint32_t n);
+
+    void gather4_scalar(const uint8_t* src, ptrdiff_t stride, uint8_t* dst, uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i) memcpy(dst + (size_t)i * 4, src + (ptrdiff_t)i * stride, 4);
+    }
+
+    template <size_t Item>
+    void gather_items(const uint8_t* src, ptrdiff_t pixel, ptrdiff_t channel, uint32_t channels, uint8_t* dst, uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i) {
+            const uint8_t* p = src + (ptrdiff_t)i * pixel;
+            for (uint32_t c = 0; c < channels; ++c, dst += Item) memcpy(dst, p + (ptrdiff_t)c * channel, Item);
+        }
+    }
+
+    // Pixels to handle one at a time before dst reaches `align` bytes, or all
+    // of them when dst is not even pixel aligned and cannot stream.
+    inline uint32_t stream_head(const uint8_t* dst, uint32_t n, size_t align) {
+        const size_t misalign = (align - ((uintptr_t)dst & (align - 1))) & (align - 1);
+        if (misalign % 4) return n;
+        return std::min<uint32_t>(n, (uint32_t)(misalign / 4));
+    }
+
+#if DP_SIMD_X86
+    void fence() { _mm_sfence(); }
+
+    DP_TARGET("sse4.1")
+    void stream_sse41(uint8_t* d, const uint8_t* s, size_t n) {
+        const size_t head = std::min(n, (size_t)((16 - ((uintptr_t)d & 15)) & 15));
+        memcpy(d, s, head);
+        size_t i = head;
+        for (; i + 64 <= n; i += 64) {
+            const __m128i a = _mm_loadu_si128((const __m128i*)(s + i));
+            const __m128i b = _mm_loadu_si128((const __m128i*)(s + i + 16));
+            const __m128i c = _mm_loadu_si128((const __m128i*)(s + i + 32));
+            const __m128i e = _mm_loadu_si128((const __m128i*)(s + i + 48));
+            _mm_stream_si128((__m128i*)(d + i), a);
+            _mm_stream_si128((__m128i*)(d + i + 16), b);
+            _mm_stream_si128((__m128i*)(d + i + 32), c);
+            _mm_stream_si128((__m128i*)(d + i + 48), e);
+        }
+        for (; i + 16 <= n; i += 16) _mm_stream_si128((__m128i*)(d + i), _mm_loadu_si128((const __m128i*)(s + i)));
+        memcpy(d + i, s + i, n - i);
+    }
+
+    DP_TARGET("avx2")
+    void stream_avx2(uint8_t* d, const uint8_t* s, size_t n) {
+        const size_t head = std::min(n, (size_t)((32 - ((uintptr_t)d & 31)) & 31));
+        memcpy(d, s, head);
+        size_t i = head;
+        for (; i + 128 <= n; i += 128) {
+            const __m256i a = _mm256_loadu_si256((const __m256i*)(s + i));
+            const __m256i b = _mm256_loadu_si256((const __m256i*)(s + i + 32));
+            const __m256i c = _mm256_loadu_si256((const __m256i*)(s + i + 64));
+            const __m256i e = _mm256_loadu_si256((const __m256i*)(s + i + 96));
+            _mm256_stream_si256((__m256i*)(d + i), a);
+            _mm256_stream_si256((__m256i*)(d + i + 32), b);
+            _mm256_stream_si256((__m256i*)(d + i + 64), c);
+            _mm256_stream_si256((__m256i*)(d + i + 96), e);
+        }
+        for (; i + 32 <= n; i += 32) _mm256_stream_si256((__m256i*)(d + i), _mm256_loadu_si256((const __m256i*)(s + i)));
+        memcpy(d + i, s + i, n - i);
+    }
+
+    // Four pixels per 16 bytes. A three-channel source reads 16 bytes for 12,
+    // so that loop stops while the over-read stays inside the row.
+    DP_TARGET("sse4.1")
+    void transfer_sse41(const Shuffle& sh, const uint8_t* src, uint8_t* dst, uint32_t n, bool stream) {
+        const __m128i mask = _mm_load_si128((const __m128i*)sh.mask);
+        const __m128i alpha = _mm_load_si128((const __m128i*)sh.alpha);
+        const uint32_t bpp = sh.src_bpp;
+        const uint32_t end = bpp == 4 ? n : (n >= 6 ? n - 2 : 0);
+        uint32_t i = stream ? stream_head(dst, n, 16) : 0;
+        if (i == n) {
+            stream = false;
+            i = 0;
+        }
+        for (uint32_t k = 0; k < i; ++k) transfer_scalar_px(sh, src + (size_t)k * bpp, dst + (size_t)k * 4);
+        for (; i + 4 <= end; i += 4) {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(src + (size_t)i * bpp));
+            const __m128i out = _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha);
+            if (stream) _mm_stream_si128((__m128i*)(dst + (size_t)i * 4), out);
+            else _mm_storeu_si128((__m128i*)(dst + (size_t)i * 4), out);
+        }
+        for (; i < n; ++i) transfer_scalar_px(sh, src + (size_t)i * bpp, dst + (size_t)i * 4);
+    }
+
+    // Eight pixels per 32 bytes; a three-channel source loads each lane's
+    // 12 bytes separately, since vpshufb cannot cross lanes.
+    DP_TARGET("avx2")
+    void transfer_avx2(const Shuffle& sh, const uint8_t* src, uint8_t* dst, uint32_t n, bool stream) {
+        const __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)sh.mask));
+        const __m256i alpha = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)sh.alpha));
+        const uint32_t bpp = sh.src_bpp;
+        const uint32_t end = bpp == 4 ? n : (n >= 10 ? n - 2 : 0);
+        uint32_t i = stream ? stream_head(dst, n, 32) : 0;
+        if (i == n) {
+            stream = false;
+            i = 0;
+        }
+        for (uint32_t k = 0; k < i; ++k) transfer_scalar_px(sh, src + (size_t)k * bpp, dst + (size_t)k * 4);
+        for (; i + 8 <= end; i += 8) {
+            const uint8_t* p = src + (size_t)i * bpp;
+            const __m256i v = bpp == 4
+                ? _mm256_loadu_si256((const __m256i*)p)
+                : _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                                          _mm_loadu_si128((const __m128i*)(p + 12)), 1);
+            const __m256i out = _mm256_or_si256(_mm256_shuffle_epi8(v, mask), alpha);
+            if (stream) _mm256_stream_si256((__m256i*)(dst + (size_t)i * 4), out);
+            else _mm256_storeu_si256((__m256i*)(dst + (size_t)i * 4), out);
+        }
+        for (; i < n; ++i) transfer_scalar_px(sh, src + (size_t)i * bpp, dst + (size_t)i * 4);
+    }
+
+    // Eight four-byte pixels per gather; the offsets are 32-bit, so very
+    // wide strides fall back to scalar loads.
+    DP_TARGET("avx2")
+    void gather4_avx2(const uint8_t* src, ptrdiff_t stride, uint8_t* dst, uint32_t n) {
+        uint32_t i = 0;
+        if (stride > -((ptrdiff_t)1 << 28) && stride < ((ptrdiff_t)1 << 28)) {
+            const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((int)stride));
+            for (; i + 8 <= n; i += 8) {
+                const __m256i v = _mm256_i32gather_epi32((const int*)(src + (ptrdiff_t)i * stride), offsets, 1);
+                _mm256_storeu_si256((__m256i*)(dst + (size_t)i * 4), v);
+            }
+        }
+        gather4_scalar(src + (ptrdiff_t)i * stride, stride, dst + (size_t)i * 4, n - i);
+    }
+#else
+    void fence() {}
+#endif
+
+    struct Kernels {
+        StreamFn stream;
+        TransferFn transfer;
+        GatherFn gather4;
+    };
+
+    const Kernels kScalar = { stream_scalar, transfer_scalar, gather4_scalar };
+#if DP_SIMD_X86
+    const Kernels kSSE41 = { stream_sse41, transfer_sse41, gather4_scalar };
+    const Kernels kAVX2 = { stream_avx2, transfer_avx2, gather4_avx2 };
+#endif
+
+    const Kernels& kernels() {
+#if DP_SIMD_X86
+        const Convert::Isa isa = Convert::active_isa();
+        if (isa >= Convert::Isa::AVX2) return kAVX2;
+        if (isa >= Convert::Isa::SSE41) return kSSE41;
+#endif
+        return kScalar;
+    }
+
+    template <size_t Bpp>
+    void copy_rows_of(uint8_t* d, size_t dst_pitch, const uint8_t* s, size_t src_pitch, size_t row_bytes, uint32_t rows,
+                      Scheduler& scheduler) {
+        const SizeClass size = Copy::size_class(row_bytes, rows);
+        const StreamFn stream = kernels().stream;
+        scheduler.for_each_band(rows, row_bytes, [&](uint32_t y0, uint32_t y1) {
+            switch (size) {
+            case SizeClass::Small:
+                for (uint32_t y = y0; y < y1; ++y) copy_small<Bpp>(d + y * dst_pitch, s + y * src_pitch, row_bytes);
+                break;
+            case SizeClass::Cached:
+                for (uint32_t y = y0; y < y1; ++y) memcpy(d + y * dst_pitch, s + y * src_pitch, row_bytes);
+                break;
+            case SizeClass::Streaming:
+                for (uint32_t y = y0; y < y1; ++y) stream(d + y * dst_pitch, s + y * src_pitch, row_bytes);
+                fence();
+                break;
+            }
+        });
+    }
+
+}
+
+SizeClass Copy::size_class(size_t row_bytes, uint32_t rows) {
+    if (row_bytes < kSmallRowBytes) return SizeClass::Small;
+    const bool stream = row_bytes >= kStreamingRowBytes && row_bytes * rows > streaming_threshold();
+    return stream ? SizeClass::Streaming : SizeClass::Cached;
+}
+
+size_t Copy::last_level_cache_bytes() {
+    static const size_t bytes = detect_last_level_cache();
+    return bytes;
+}
+
+size_t Copy::streaming_threshold() {
+    const size_t bytes = g_threshold.load(std::memory_order_relaxed);
+    return bytes ? bytes : last_level_cache_bytes();
+}
+
+void Copy::set_streaming_threshold(size_t bytes) {
+    g_threshold.store(bytes, std::memory_order_relaxed);
+}
+
+void Copy::copy_rows(void* dst, size_t dst_pitch, const void* src, size_t src_pitch, size_t row_bytes, uint32_t rows,
+                     Scheduler& scheduler) {
+    if (row_bytes == 0 || rows == 0) return;
+    if (dst_pitch == row_bytes && src_pitch == row_bytes) {
+        copy(dst, src, row_bytes * rows, scheduler);
+        return;
+    }
+    copy_rows_of<1>(static_cast<uint8_t*>(dst), dst_pitch, static_cast<const uint8_t*>(src), src_pitch, row_bytes, rows, scheduler);
+}
+
+void Copy::copy_pixels(size_t bytes_per_pixel, void* dst, size_t dst_pitch, const void* src, size_t src_pitch,
+                       uint32_t width, uint32_t height, Scheduler& scheduler) {
+    const size_t row_bytes = (size_t)width * bytes_per_pixel;
+    if (row_bytes == 0 || height == 0) return;
+    if (dst_pitch == row_bytes && src_pitch == row_bytes) {
+        copy(dst, src, row_bytes * height, scheduler);
+        return;
+    }
+    auto* d = static_cast<uint8_t*>(dst);
+    const auto* s = static_cast<const uint8_t*>(src);
+    switch (bytes_per_pixel) {
+    case 2: copy_rows_of<2>(d, dst_pitch, s, src_pitch, row_bytes, height, scheduler); break;
+    case 4: copy_rows_of<4>(d, dst_pitch, s, src_pitch, row_bytes, height, scheduler); break;
+    case 8: copy_rows_of<8>(d, dst_pitch, s, src_pitch, row_bytes, height, scheduler); break;
+    case 16: copy_rows_of<16>(d, dst_pitch, s, src_pitch, row_bytes, height, scheduler); break;
+    default: copy_rows_of<1>(d, dst_pitch, s, src_pitch, row_bytes, height, scheduler); break;
+    }
+}
+
+void Copy::copy_texels(DXGI_FORMAT format, void* dst, size_t dst_pitch, const void* src, size_t src_pitch,
+                       uint32_t width, uint32_t height, Scheduler& scheduler) {
+    const size_t bpp = Formats::bytes_per_pixel(format);
+    if (bpp == 0) {
+        throw std::invalid_argument("Copy::copy_texels: unsupported format.");
+    }
+    copy_pixels(bpp, dst, dst_pitch, src, src_pitch, width, height, scheduler);
+}
+
+void Copy::copy(void* dst, const void* src, size_t bytes, Scheduler& scheduler) {
+    if (bytes <= Scheduler::kTileBytes) {
+        memcpy(dst, src, bytes);
+        return;
+    }
+    auto* d = static_cast<uint8_t*>(dst);
+    const auto* s = static_cast<const uint8_t*>(src);
+    const StreamFn stream = bytes > streaming_threshold() ? kernels().stream : nullptr;
+    const uint32_t chunks = (uint32_t)((bytes + Scheduler::kTileBytes - 1) / Scheduler::kTileBytes);
+    scheduler.parallel_for(chunks, [&](uint32_t c) {
+        const size_t offset = (size_t)c * Scheduler::kTileBytes;
+        const size_t n = std::min(Scheduler::kTileBytes, bytes - offset);
+        if (stream) {
+            stream(d + offset, s + offset, n);
+            fence();
+        } else {
+            memcpy(d + offset, s + offset, n);
+        }
+    });
+}
+
+void Copy::transfer_row(const Swizzle& swizzle, const uint8_t* src, uint8_t* dst, uint32_t count) {
+    const Shuffle sh = make_shuffle(swizzle);
+    kernels().transfer(sh, src, dst, count, false);
+}
+
+void Copy::transfer(const Swizzle& swizzle, void* dst, size_t dst_pitch, const void* src, size_t src_pitch,
+                    uint32_t width, uint32_t height, Scheduler& scheduler) {
+    const Shuffle sh = make_shuffle(swizzle);
+    if (width == 0 || height == 0) return;
+    if (sh.src_bpp == 4 && !swizzle.swap_rb && !sh.fill) {
+        copy_pixels(4, dst, dst_pitch, src, src_pitch, width, height, scheduler);
+        return;
+    }
+    auto* d = static_cast<uint8_t*>(dst);
+    const auto* s = static_cast<const uint8_t*>(src);
+    const TransferFn fn = kernels().transfer;
+    const bool stream = size_class((size_t)width * 4, height) == SizeClass::Streaming;
+    scheduler.for_each_band(height, (size_t)width * 4, [&](uint32_t y0, uint32_t y1) {
+        for (uint32_t y = y0; y < y1; ++y) fn(sh, s + (size_t)y * src_pitch, d + (size_t)y * dst_pitch, width, stream);
+        if (stream) fence();
+    });
+}
+
+
+void Copy::gather_row(size_t item_bytes, uint32_t channels, const uint8_t* src, const Strides& strides, uint8_t* dst, uint32_t count) {
+    if (item_bytes * channels == 4 && (channels == 1 || strides.channel == (ptrdiff_t)item_bytes)) {
+        kernels().gather4(src, strides.pixel, dst, count);
+        return;
+    }
+    switch (item_bytes) {
+    case 1: gather_items<1>(src, strides.pixel, strides.channel, channels, dst, count); break;
+    case 2: gather_items<2>(src, strides.pixel, strides.channel, channels, dst, count); break;
+    case 4: gather_items<4>(src, strides.pixel, strides.channel, channels, dst, count); break;
+    case 8: gather_items<8>(src, strides.pixel, strides.channel, channels, dst, count); break;
+    default: throw std::invalid_argument("Copy::gather_row: items must be 1, 2, 4 or 8 bytes.");
+    }
+}
+
+void Copy::gather(size_t item_bytes, uint32_t channels, void* dst, size_t dst_pitch, const void* src, const Strides& strides,
+                  uint32_t width, uint32_t height, Scheduler& scheduler) {
+    const size_t pixel_bytes = item_bytes * channels;
+    const size_t row_bytes = pixel_bytes * width;
+    if (row_bytes == 0 || height == 0) return;
+    const bool packed = strides.pixel == (ptrdiff_t)pixel_bytes && (channels == 1 || strides.channel == (ptrdiff_t)item_bytes);
+    if (packed && strides.row >= 0) {
+        copy_pixels(pixel_bytes, dst, dst_pitch, src, (size_t)strides.row, width, height, scheduler);
+        return;
+    }
+    auto* d = static_cast<uint8_t*>(dst);
+    const auto* s = static_cast<const uint8_t*>(src);
+    scheduler.for_each_band(height, row_bytes, [&](uint32_t y0, uint32_t y1) {
+        for (uint32_t y = y0; y < y1; ++y) {
+            const uint8_t* row = s + (ptrdiff_t)y * strides.row;
+            if (packed) memcpy(d + (size_t)y * dst_pitch, row, row_bytes);
+            else gather_row(item_bytes, channels, row, strides, d + (size_t)y * dst_pitch, width);
+        }
+    });
+}
+
+void Copy::transfer(const Swizzle& swizzle, void* dst, size_t dst_pitch, const void* src, const Strides& strides,
+                    uint32_t width, uint32_t height, Scheduler& scheduler) {
+    const uint32_t channels = swizzle.src_channels;
+    const Shuffle packed = make_shuffle(swizzle);
+    if (width == 0 || height == 0) return;
+    if (strides.row >= 0 && strides.pixel == (ptrdiff_t)channels && strides.channel == 1) {
+        transfer(swizzle, dst, dst_pitch, src, (size_t)strides.row, width, height, scheduler);
+        return;
+    }
+
+    // Channel c sits c * strides.channel bytes from channel 0; when every
+    // channel falls inside one 3- or 4-byte pixel, the shuffle reads them in
+    // place from the pixel's lowest byte.
+    const ptrdiff_t last = (ptrdiff_t)(channels - 1) * strides.channel;
+    const ptrdiff_t low = std::min<ptrdiff_t>(0, last);
+    const ptrdiff_t span = std::max<ptrdiff_t>(0, last) - low + 1;
+    const bool in_place = (strides.pixel == 3 || strides.pixel == 4) && strides.channel != 0 && span <= strides.pixel;
+    Shuffle sh = packed;
+    if (in_place) {
+        uint8_t offset[4] = {};
+        for (uint32_t c = 0; c < channels; ++c) offset[c] = (uint8_t)((ptrdiff_t)c * strides.channel - low);
+        sh = make_shuffle(swizzle, (uint32_t)strides.pixel, offset);
+    }
+    // Bytes of the last pixel past its channels may lie outside the array,
+    // so it skips the vector loads.
+    const uint32_t vector_width = in_place && span < strides.pixel ? width - 1 : width;
+
+    auto* d = static_cast<uint8_t*>(dst);
+    const auto* s = static_cast<const uint8_t*>(src) + (in_place ? low : 0);
+    const TransferFn fn = kernels().transfer;
+    const bool stream = size_class((size_t)width * 4, height) == SizeClass::Streaming;
+    scheduler.for_each_band(height, (size_t)width * 4, [&](uint32_t y0, uint32_t y1) {
+        std::vector<uint8_t> scratch(in_place ? 0 : (size_t)width * channels);
+        for (uint32_t y = y0; y < y1; ++y) {
+            const uint8_t* row = s + (ptrdiff_t)y * strides.row;
+            uint8_t* out = d + (size_t)y * dst_pitch;
+            if (in_place) {
+                fn(sh, row, out, vector_width, stream);
+                if (vector_width < width) {
+                    transfer_scalar_px(sh, row + (ptrdiff_t)vector_width * strides.pixel, out + (size_t)vector_width * 4);
+                }
+            } else {
+                gather_row(1, channels, row, strides, scratch.data(), width);
+                fn(sh, scratch.data(), out, width, stream);
+            }
+        }
+        if (stream) fence();
+    });
+}
\ No newline at end of file
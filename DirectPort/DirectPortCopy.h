@@ -0,0 +1,89 @@
+// DirectPortCopy.h
+#pragma once
+
+#include "DirectPortPlatform.h"
+#include "DirectPortScheduler.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace DirectPort::Copy {
+
+    // Pitched copies pick a row kernel once per transfer:
+    //   Small      rows under kSmallRowBytes, copied a pixel at a time with
+    //              moves sized at compile time instead of a memcpy call per row;
+    //   Cached     ordinary rows, memcpy;
+    //   Streaming  transfers bigger than streaming_threshold() with rows of at
+    //              least kStreamingRowBytes, written with non-temporal stores so
+    //              a frame that cannot stay in the last level cache does not
+    //              evict everything else on the way through. Shorter rows leave
+    //              too many partly written lines for streaming to pay off.
+    enum class SizeClass { Small, Cached, Streaming };
+
+    constexpr size_t kSmallRowBytes = 64;
+    constexpr size_t kStreamingRowBytes = 1024;
+
+    SizeClass size_class(size_t row_bytes, uint32_t rows);
+
+    // Defaults to the last level cache size, or 8 MB when it cannot be read.
+    // Setting 0 restores the default; benchmarks use this to force a class.
+    size_t last_level_cache_bytes();
+    size_t streaming_threshold();
+    void set_streaming_threshold(size_t bytes);
+
+    // Copies `rows` rows of row_bytes each, split across `scheduler`.
+    void copy_rows(void* dst, size_t dst_pitch, const void* src, size_t src_pitch, size_t row_bytes, uint32_t rows,
+                   Scheduler& scheduler = Scheduler::shared());
+
+    // The same with the kernel specialised on bytes_per_pixel (1, 2, 4, 8 and
+    // 16 have their own; other sizes copy as bytes).
+    void copy_pixels(size_t bytes_per_pixel, void* dst, size_t dst_pitch, const void* src, size_t src_pitch,
+                     uint32_t width, uint32_t height, Scheduler& scheduler = Scheduler::shared());
+
+    // Bytes per pixel from the format; throws std::invalid_argument for
+    // block-compressed and unknown formats.
+    void copy_texels(DXGI_FORMAT format, void* dst, size_t dst_pitch, const void* src, size_t src_pitch,
+                     uint32_t width, uint32_t height, Scheduler& scheduler = Scheduler::shared());
+
+    void copy(void* dst, const void* src, size_t bytes, Scheduler& scheduler = Scheduler::shared());
+
+    // 8-bit copies into four-channel pixels that fix up channels on the way:
+    // swap_rb exchanges bytes 0 and 2, fill_alpha writes 255 to byte 3, and a
+    // three-channel source expands to four with alpha filled. Kernels come from
+    // Convert::active_isa() and all produce the same bytes.
+    struct Swizzle {
+        uint32_t src_channels = 4;
+        bool swap_rb = false;
+        bool fill_alpha = false;
+    };
+
+    void transfer_row(const Swizzle& swizzle, const uint8_t* src, uint8_t* dst, uint32_t count);
+    void transfer(const Swizzle& swizzle, void* dst, size_t dst_pitch, const void* src, size_t src_pitch,
+                  uint32_t width, uint32_t height, Scheduler& scheduler = Scheduler::shared());
+
+    // Byte strides of a source laid out the way NumPy views are: rows and
+    // pixels may run backwards (flipped views), skip (sliced views) or
+    // repeat (broadcasts), and channels need not be adjacent.
+    struct Strides {
+        ptrdiff_t row = 0;
+        ptrdiff_t pixel = 0;
+        ptrdiff_t channel = 0;
+    };
+
+    // Packs `count` pixels of `channels` elements of item_bytes (1, 2, 4 or
+    // 8) each. Four-byte pixels gather with AVX2; throws
+    // std::invalid_argument for other item sizes.
+    void gather_row(size_t item_bytes, uint32_t channels, const uint8_t* src, const Strides& strides, uint8_t* dst, uint32_t count);
+    // A strided image into packed rows `dst_pitch` apart. Packed pixels copy
+    // a row at a time whatever the row stride.
+    void gather(size_t item_bytes, uint32_t channels, void* dst, size_t dst_pitch, const void* src, const Strides& strides,
+                uint32_t width, uint32_t height, Scheduler& scheduler = Scheduler::shared());
+
+    // transfer() from an 8-bit source of swizzle.src_channels channels with
+    // any strides. Pixels 3 or 4 bytes apart whose channels lie inside them,
+    // such as packed RGB, rgba[..., :3] and rgb[..., ::-1], are shuffled in
+    // place by the SIMD kernels; other layouts are gathered a row at a time
+    // first.
+    void transfer(const Swizzle& swizzle, void* dst, size_t dst_pitch, const void* src, const Strides& strides,
+                  uint32_t width, uint32_t height, Scheduler& scheduler = Scheduler::shared());
+
+}
@@ -0,0 +1,75 @@
+#include "DirectPortCopy.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <string>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    // Rows of a 2D or 3D array: the row stride may be anything, the pixels in
+    // a row must be packed, so NumPy slices of a larger frame work in place.
+    struct Rows {
+        uint8_t* data;
+        size_t pitch;
+        size_t pixel_bytes;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    Rows rows_of(const char* what, const char* name, const py::array& array, bool writable) {
+        py::buffer_info info = array.request(writable);
+        const size_t channels = info.ndim == 3 ? (size_t)info.shape[2] : 1;
+        const bool packed = (info.ndim == 2 || info.strides[2] == info.itemsize) &&
+                            info.strides[1] == (py::ssize_t)(channels * info.itemsize);
+        if ((info.ndim != 2 && info.ndim != 3) || !packed || info.strides[0] < info.shape[1] * info.strides[1]) {
+            throw py::value_error(std::string(what) + ": " + name + " must be a 2D or 3D array with packed rows.");
+        }
+        return { static_cast<uint8_t*>(info.ptr), (size_t)info.strides[0], channels * info.itemsize,
+                 (uint32_t)info.shape[1], (uint32_t)info.shape[0] };
+    }
+
+}
+
+void bind_copy(py::module_& m) {
+    py::enum_<Copy::SizeClass>(m, "CopySizeClass", "The row kernel a pitched copy runs.")
+        .value("Small", Copy::SizeClass::Small, "Rows under 64 bytes, copied with fixed-size moves.")
+        .value("Cached", Copy::SizeClass::Cached, "")
+        .value("Streaming", Copy::SizeClass::Streaming, "Transfers above the streaming threshold, written with non-temporal stores.");
+
+    m.def("copy_size_class", &Copy::size_class, py::arg("row_bytes"), py::arg("rows"));
+    m.def("last_level_cache_bytes", &Copy::last_level_cache_bytes, "");
+    m.def("copy_streaming_threshold", &Copy::streaming_threshold, "");
+    m.def("set_copy_streaming_threshold", &Copy::set_streaming_threshold, py::arg("bytes"),
+          "Transfers larger than this use streaming stores; 0 restores the last level cache size.");
+
+    m.def("copy_pixels", [](const py::array& src, const py::array& dst) {
+        const Rows s = rows_of("copy_pixels", "src", src, false);
+        const Rows d = rows_of("copy_pixels", "dst", dst, true);
+        if (s.width != d.width || s.height != d.height || s.pixel_bytes != d.pixel_bytes) {
+            throw py::value_error("copy_pixels: src and dst must have the same shape and item size.");
+        }
+        py::gil_scoped_release release;
+        Copy::copy_pixels(s.pixel_bytes, d.data, d.pitch, s.data, s.pitch, s.width, s.height);
+    }, py::arg("src"), py::arg("dst"), "Copies src into dst. Either may be a sliced region of a larger frame.");
+
+    m.def("swizzle_pixels", [](const py::array& src, const py::array& dst, bool swap_rb, bool fill_alpha) {
+        const Rows s = rows_of("swizzle_pixels", "src", src, false);
+        const Rows d = rows_of("swizzle_pixels", "dst", dst, true);
+        if (src.itemsize() != 1 || dst.itemsize() != 1 || (s.pixel_bytes != 3 && s.pixel_bytes != 4) || d.pixel_bytes != 4) {
+            throw py::value_error("swizzle_pixels: src must be (height, width, 3 or 4) and dst (height, width, 4) uint8.");
+        }
+        if (s.width != d.width || s.height != d.height) {
+            throw py::value_error("swizzle_pixels: src and dst must have the same height and width.");
+        }
+        Copy::Swizzle swizzle;
+        swizzle.src_channels = (uint32_t)s.pixel_bytes;
+        swizzle.swap_rb = swap_rb;
+        swizzle.fill_alpha = fill_alpha;
+        py::gil_scoped_release release;
+        Copy::transfer(swizzle, d.data, d.pitch, s.data, s.pitch, s.width, s.height);
+    }, py::arg("src"), py::arg("dst"), py::arg("swap_rb") = false, py::arg("fill_alpha") = false,
+       "Copies 8-bit pixels into dst, swapping red and blue and/or forcing alpha to 255. "
+       "A three-channel src expands to four channels with opaque alpha.");
+}
@@ -0,0 +1,76 @@
+// src/DirectPort/DirectPortDLPack.cpp
+
+#include "DirectPortDLPack.h"
+#include "DirectPortFormats.h"
+#include <cstring>
+#include <stdexcept>
+
+using namespace DirectPort::DLPack;
+
+namespace {
+
+    // Shape and strides live next to what keeps the memory alive, so one
+    // delete in the deleter releases everything.
+    struct Exported {
+        DLManagedTensor tensor;
+        int64_t shape[3];
+        int64_t strides[3];
+        std::shared_ptr<void> keep;
+    };
+
+}
+
+DLDataType DirectPort::DLPack::data_type(const char* numpy_dtype) {
+    if (numpy_dtype) {
+        if (std::strcmp(numpy_dtype, "uint8") == 0) return { kDLUInt, 8, 1 };
+        if (std::strcmp(numpy_dtype, "uint32") == 0) return { kDLUInt, 32, 1 };
+        if (std::strcmp(numpy_dtype, "float16") == 0) return { kDLFloat, 16, 1 };
+        if (std::strcmp(numpy_dtype, "float32") == 0) return { kDLFloat, 32, 1 };
+    }
+    throw std::invalid_argument("DLPack: no DLPack type for this dtype.");
+}
+
+std::string DirectPort::DLPack::numpy_typestr(DLDataType type) {
+    const char kind = type.code == kDLUInt ? 'u' : type.code == kDLInt ? 'i' : type.code == kDLFloat ? 'f' : 0;
+    const bool sized = type.bits == 8 || type.bits == 16 || type.bits == 32 || type.bits == 64;
+    if (!kind || !sized || type.lanes != 1 || (kind == 'f' && type.bits == 8)) {
+        throw std::invalid_argument("DLPack: unsupported tensor dtype (code " + std::to_string(type.code) + ", " +
+                                    std::to_string(type.bits) + " bits, " + std::to_string(type.lanes) + " lanes).");
+    }
+    return std::string(1, kind) + std::to_string(type.bits / 8);
+}
+
+DLManagedTensor* DirectPort::DLPack::export_pixels(DXGI_FORMAT format, void* data, size_t pitch, uint32_t width, uint32_t height,
+                                                   std::shared_ptr<void> keep) {
+    const Formats::Traits* traits = Formats::find(format);
+    if (!traits || !traits->numpy_dtype) {
+        throw std::invalid_argument("DLPack: the texture format has no tensor layout.");
+    }
+    const DLDataType type = data_type(traits->numpy_dtype);
+    const size_t item = type.bits / 8;
+    if (pitch % item != 0) {
+        throw std::invalid_argument("DLPack: the row pitch is not a whole number of elements.");
+    }
+
+    auto exported = std::make_unique<Exported>();
+    const int32_t ndim = traits->numpy_channels > 1 ? 3 : 2;
+    exported->shape[0] = height;
+    exported->shape[1] = width;
+    exported->shape[2] = traits->numpy_channels;
+    exported->strides[0] = (int64_t)(pitch / item);
+    exported->strides[1] = traits->numpy_channels;
+    exported->strides[2] = 1;
+    exported->keep = std::move(keep);
+
+    DLTensor& t = exported->tensor.dl_tensor;
+    t.data = data;
+    t.device = { kDLCPU, 0 };
+    t.ndim = ndim;
+    t.dtype = type;
+    t.shape = exported->shape;
+    t.strides = exported->strides;
+    t.byte_offset = 0;
+    exported->tensor.manager_ctx = exported.get();
+    exported->tensor.deleter = [](DLManagedTensor* self) { delete static_cast<Exported*>(self->manager_ctx); };
+    return &exported.release()->tensor;
+}
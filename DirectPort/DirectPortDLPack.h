@@ -0,0 +1,65 @@
+// DirectPortDLPack.h
+// The DLPack exchange ABI (v0.8, unversioned DLManagedTensor), declared here
+// rather than vendored: the layout is frozen and four structs are all we use.
+#pragma once
+
+#include "DirectPortPlatform.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace DirectPort::DLPack {
+
+    enum DeviceType : int32_t { kDLCPU = 1, kDLCUDA = 2, kDLCUDAHost = 3 };
+    enum DataTypeCode : uint8_t { kDLInt = 0, kDLUInt = 1, kDLFloat = 2 };
+
+    struct DLDevice {
+        int32_t device_type;
+        int32_t device_id;
+    };
+
+    struct DLDataType {
+        uint8_t code;
+        uint8_t bits;
+        uint16_t lanes;
+    };
+
+    struct DLTensor {
+        void* data;
+        DLDevice device;
+        int32_t ndim;
+        DLDataType dtype;
+        int64_t* shape;
+        // In elements; null means C-contiguous.
+        int64_t* strides;
+        uint64_t byte_offset;
+    };
+
+    struct DLManagedTensor {
+        DLTensor dl_tensor;
+        void* manager_ctx;
+        void (*deleter)(DLManagedTensor* self);
+    };
+
+    // Capsule names from the Python protocol: producers hand out "dltensor",
+    // consumers rename it once they own the tensor.
+    constexpr const char* kCapsuleName = "dltensor";
+    constexpr const char* kUsedCapsuleName = "used_dltensor";
+
+    // The DLPack type of a Formats NumPy dtype name ("uint8", "float16", ...).
+    // Throws std::invalid_argument for names it does not know.
+    DLDataType data_type(const char* numpy_dtype);
+
+    // The NumPy type string ("u1", "f2", ...) of a DLPack type. Throws
+    // std::invalid_argument for vector lanes and types NumPy cannot hold.
+    std::string numpy_typestr(DLDataType type);
+
+    // Pixels as an (height, width[, channels]) CPU tensor with the NumPy
+    // layout of `format`, strided by `pitch`. The tensor holds `keep` until
+    // its consumer calls the deleter. Throws std::invalid_argument for
+    // formats without a NumPy layout and pitches that are not a whole number
+    // of elements.
+    DLManagedTensor* export_pixels(DXGI_FORMAT format, void* data, size_t pitch, uint32_t width, uint32_t height, std::shared_ptr<void> keep);
+
+}
@@ -0,0 +1,234 @@
+// src/DirectPort/DirectPortDirtyRects.cpp
+
+#include "DirectPortDirtyRects.h"
+#include "DirectPortComposite.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectPort;
+
+namespace {
+
+    // Half-open box in signed coordinates so clipping and padding cannot wrap.
+    struct Box {
+        int64_t x0, y0, x1, y1;
+    };
+
+    uint64_t box_area(const Box& b) {
+        return (uint64_t)(b.x1 - b.x0) * (uint64_t)(b.y1 - b.y0);
+    }
+
+    bool overlaps(const Box& a, const Box& b) {
+        return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+    }
+
+    Box unite(const Box& a, const Box& b) {
+        return { std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1) };
+    }
+
+    bool clip(Box& b, uint32_t width, uint32_t height) {
+        b.x0 = std::max<int64_t>(b.x0, 0);
+        b.y0 = std::max<int64_t>(b.y0, 0);
+        b.x1 = std::min<int64_t>(b.x1, width);
+        b.y1 = std::min<int64_t>(b.y1, height);
+        return b.x0 < b.x1 && b.y0 < b.y1;
+    }
+
+    Box to_box(const DirtyRect& r) {
+        return { (int64_t)r.x, (int64_t)r.y, (int64_t)r.x + r.width, (int64_t)r.y + r.height };
+    }
+
+    DirtyRect to_rect(const Box& b) {
+        return { (uint32_t)b.x0, (uint32_t)b.y0, (uint32_t)(b.x1 - b.x0), (uint32_t)(b.y1 - b.y0) };
+    }
+
+    // Merges pairs that overlap, and pairs that tile a rectangle exactly (free
+    // to merge), until neither kind is left.
+    void merge_touching(std::vector<Box>& boxes) {
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (size_t i = 0; i < boxes.size(); ++i) {
+                for (size_t j = i + 1; j < boxes.size();) {
+                    const Box u = unite(boxes[i], boxes[j]);
+                    if (overlaps(boxes[i], boxes[j]) || box_area(u) == box_area(boxes[i]) + box_area(boxes[j])) {
+                        boxes[i] = u;
+                        boxes[j] = boxes.back();
+                        boxes.pop_back();
+                        merged = true;
+                    } else {
+                        ++j;
+                    }
+                }
+            }
+        }
+    }
+
+}
+
+DirtyRect DirtyRects::full(uint32_t width, uint32_t height) {
+    return { 0, 0, width, height };
+}
+
+bool DirtyRects::is_full(const std::vector<DirtyRect>& rects, uint32_t width, uint32_t height) {
+    return rects.size() == 1 && rects[0].x == 0 && rects[0].y == 0 && rects[0].width >= width && rects[0].height >= height;
+}
+
+uint64_t DirtyRects::area(const std::vector<DirtyRect>& rects) {
+    uint64_t total = 0;
+    for (const auto& r : rects) total += (uint64_t)r.width * r.height;
+    return total;
+}
+
+std::vector<DirtyRect> DirtyRects::normalize(const std::vector<DirtyRect>& rects, uint32_t width, uint32_t height,
+                                             size_t max_rects, float full_coverage) {
+    if (width == 0 || height == 0) return {};
+
+    // Very long lists are coarsened onto a grid first so merging stays cheap.
+    std::vector<DirtyRect> coarse;
+    if (rects.size() > max_rects * 8) coarse = snap_to_tiles(rects, 64, width, height);
+    const std::vector<DirtyRect>& input = coarse.empty() ? rects : coarse;
+
+    std::vector<Box> boxes;
+    boxes.reserve(input.size());
+    for (const auto& r : input) {
+        Box b = to_box(r);
+        if (clip(b, width, height)) boxes.push_back(b);
+    }
+    merge_touching(boxes);
+
+    while (boxes.size() > max_rects && boxes.size() > 1) {
+        size_t best_i = 0, best_j = 1;
+        uint64_t best_waste = UINT64_MAX;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            for (size_t j = i + 1; j < boxes.size(); ++j) {
+                const uint64_t waste = box_area(unite(boxes[i], boxes[j])) - box_area(boxes[i]) - box_area(boxes[j]);
+                if (waste < best_waste) {
+                    best_waste = waste;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+        boxes[best_i] = unite(boxes[best_i], boxes[best_j]);
+        boxes[best_j] = boxes.back();
+        boxes.pop_back();
+        // The union can now reach into its neighbours.
+        merge_touching(boxes);
+    }
+
+    uint64_t covered = 0;
+    for (const auto& b : boxes) covered += box_area(b);
+    if (boxes.size() > max_rects || covered > (uint64_t)((double)width * height * full_coverage)) {
+        return { full(width, height) };
+    }
+
+    // Top-to-bottom, left-to-right keeps copies walking memory forward.
+    std::sort(boxes.begin(), boxes.end(), [](const Box& a, const Box& b) {
+        return a.y0 != b.y0 ? a.y0 < b.y0 : a.x0 < b.x0;
+    });
+    std::vector<DirtyRect> out;
+    out.reserve(boxes.size());
+    for (const auto& b : boxes) out.push_back(to_rect(b));
+    return out;
+}
+
+std::vector<DirtyRect> DirtyRects::snap_to_tiles(const std::vector<DirtyRect>& rects, uint32_t tile_size, uint32_t width, uint32_t height) {
+    if (tile_size == 0) {
+        throw std::invalid_argument("snap_to_tiles: tile_size must be non-zero.");
+    }
+    if (width == 0 || height == 0) return {};
+
+    const uint32_t tiles_x = (width + tile_size - 1) / tile_size;
+    const uint32_t tiles_y = (height + tile_size - 1) / tile_size;
+    std::vector<uint8_t> touched((size_t)tiles_x * tiles_y, 0);
+    for (const auto& r : rects) {
+        Box b = to_box(r);
+        if (!clip(b, width, height)) continue;
+        const uint32_t tx1 = (uint32_t)((b.x1 + tile_size - 1) / tile_size);
+        const uint32_t ty1 = (uint32_t)((b.y1 + tile_size - 1) / tile_size);
+        for (uint32_t ty = (uint32_t)(b.y0 / tile_size); ty < ty1; ++ty) {
+            for (uint32_t tx = (uint32_t)(b.x0 / tile_size); tx < tx1; ++tx) touched[(size_t)ty * tiles_x + tx] = 1;
+        }
+    }
+
+    // Runs of touched tiles per tile row; a run with the same span as one in the
+    // row above extends it instead of starting a new rect.
+    std::vector<Box> boxes;
+    std::vector<std::pair<Box, size_t>> open, next;
+    for (uint32_t ty = 0; ty < tiles_y; ++ty) {
+        next.clear();
+        for (uint32_t tx = 0; tx < tiles_x;) {
+            if (!touched[(size_t)ty * tiles_x + tx]) { ++tx; continue; }
+            const uint32_t start = tx;
+            while (tx < tiles_x && touched[(size_t)ty * tiles_x + tx]) ++tx;
+            const Box run = { (int64_t)start, (int64_t)ty, (int64_t)tx, (int64_t)ty + 1 };
+            auto it = std::find_if(open.begin(), open.end(), [&](const std::pair<Box, size_t>& o) {
+                return o.first.x0 == run.x0 && o.first.x1 == run.x1;
+            });
+            if (it != open.end()) {
+                boxes[it->second].y1 = ty + 1;
+                next.push_back({ run, it->second });
+            } else {
+                boxes.push_back(run);
+                next.push_back({ run, boxes.size() - 1 });
+            }
+        }
+        open.swap(next);
+    }
+
+    std::vector<DirtyRect> out;
+    out.reserve(boxes.size());
+    for (auto b : boxes) {
+        b.x0 *= tile_size;
+        b.y0 *= tile_size;
+        b.x1 *= tile_size;
+        b.y1 *= tile_size;
+        clip(b, width, height);
+        out.push_back(to_rect(b));
+    }
+    return out;
+}
+
+std::vector<DirtyRect> DirtyRects::propagate(const std::vector<CompositeLayer>& layers, const std::vector<std::vector<DirtyRect>>& source_dirty,
+                                             uint32_t dest_width, uint32_t dest_height, size_t max_rects) {
+    if (source_dirty.size() != layers.size()) {
+        throw std::invalid_argument("propagate: source_dirty needs one rect list per layer.");
+    }
+
+    std::vector<DirtyRect> mapped;
+    for (const auto& rl : Composite::resolve_layers(dest_width, dest_height, layers)) {
+        const size_t index = (size_t)(rl.layer - layers.data());
+        const double sx = rl.width / (double)rl.crop_width;
+        const double sy = rl.height / (double)rl.crop_height;
+        const Box layer_box = { rl.x, rl.y, (int64_t)rl.x + rl.width, (int64_t)rl.y + rl.height };
+
+        for (const auto& r : source_dirty[index]) {
+            // A source pixel feeds every destination sample within one source
+            // pixel of it, so pad before scaling.
+            const double x0 = std::max<double>((double)r.x - 1.0, rl.crop_x);
+            const double y0 = std::max<double>((double)r.y - 1.0, rl.crop_y);
+            const double x1 = std::min<double>((double)r.x + r.width + 1.0, rl.crop_x + rl.crop_width);
+            const double y1 = std::min<double>((double)r.y + r.height + 1.0, rl.crop_y + rl.crop_height);
+            if (x0 >= x1 || y0 >= y1) continue;
+
+            Box b = {
+                rl.x + (int64_t)std::floor((x0 - rl.crop_x) * sx),
+                rl.y + (int64_t)std::floor((y0 - rl.crop_y) * sy),
+                rl.x + (int64_t)std::ceil((x1 - rl.crop_x) * sx),
+                rl.y + (int64_t)std::ceil((y1 - rl.crop_y) * sy),
+            };
+            b = { std::max(b.x0, layer_box.x0), std::max(b.y0, layer_box.y0), std::min(b.x1, layer_box.x1), std::min(b.y1, layer_box.y1) };
+            if (clip(b, dest_width, dest_height)) mapped.push_back(to_rect(b));
+        }
+    }
+    return normalize(mapped, dest_width, dest_height, max_rects);
+}
+
+// The fallback for devices without partial copies: copying everything is a
+// superset of copying the regions.
+void IDirectXDevice::copy_texture_regions(std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination,
+                                          const std::vector<DirtyRect>& regions) {
+    if (!regions.empty()) copy_texture(std::move(source), std::move(destination));
+}
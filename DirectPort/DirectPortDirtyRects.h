@@ -0,0 +1,34 @@
+// DirectPortDirtyRects.h
+#pragma once
+
+#include "DirectPort.h"
+#include <vector>
+
+namespace DirectPort::DirtyRects {
+
+    // Rect lists here never overlap once they have been through normalize(), so
+    // a region can be copied or recomposited without touching a pixel twice.
+    // A list holding exactly the full surface means "everything changed".
+
+    DirtyRect full(uint32_t width, uint32_t height);
+    bool is_full(const std::vector<DirtyRect>& rects, uint32_t width, uint32_t height);
+    uint64_t area(const std::vector<DirtyRect>& rects);
+
+    // Clips to the surface, drops empty rects and merges overlapping ones. If
+    // more than max_rects remain, the pair whose union wastes the least area is
+    // merged until they fit. Returns the full surface when the result would
+    // cover more than full_coverage of it anyway.
+    std::vector<DirtyRect> normalize(const std::vector<DirtyRect>& rects, uint32_t width, uint32_t height,
+                                     size_t max_rects = kMaxManifestDirtyRects, float full_coverage = 0.75f);
+
+    // Expands every rect to whole tiles of tile_size pixels and returns the
+    // touched tiles as horizontal runs, joined vertically where they line up.
+    std::vector<DirtyRect> snap_to_tiles(const std::vector<DirtyRect>& rects, uint32_t tile_size, uint32_t width, uint32_t height);
+
+    // Maps each layer's source dirty rects (source_dirty[i] belongs to layers[i])
+    // into destination pixels, padded by a pixel for the bilinear footprint.
+    // Recompositing the result with clear == true reproduces a full composite.
+    std::vector<DirtyRect> propagate(const std::vector<CompositeLayer>& layers, const std::vector<std::vector<DirtyRect>>& source_dirty,
+                                     uint32_t dest_width, uint32_t dest_height, size_t max_rects = kMaxManifestDirtyRects);
+
+}
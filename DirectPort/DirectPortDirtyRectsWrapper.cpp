@@ -0,0 +1,62 @@
+#include "DirectPortDirtyRects.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+std::vector<CompositeLayer> composite_layers_from_python(const py::iterable& items);
+
+// Accepts DirtyRect objects or (x, y, width, height) tuples; None is an empty list.
+// Shared with the device and IPC wrappers.
+std::vector<DirtyRect> dirty_rects_from_python(const py::object& items) {
+    std::vector<DirtyRect> rects;
+    if (items.is_none()) return rects;
+    for (const auto& item : py::reinterpret_borrow<py::iterable>(items)) {
+        if (py::isinstance<DirtyRect>(item)) {
+            rects.push_back(item.cast<DirtyRect>());
+            continue;
+        }
+        py::tuple t = py::reinterpret_borrow<py::object>(item).cast<py::tuple>();
+        if (t.size() != 4) {
+            throw py::value_error("Dirty rects must be DirtyRect or (x, y, width, height).");
+        }
+        rects.push_back({ t[0].cast<uint32_t>(), t[1].cast<uint32_t>(), t[2].cast<uint32_t>(), t[3].cast<uint32_t>() });
+    }
+    return rects;
+}
+
+void bind_dirty_rects(py::module_& m) {
+    py::class_<DirtyRect>(m, "DirtyRect", "A changed region of a frame, in texture pixels.")
+        .def(py::init([](uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+            return DirtyRect{ x, y, width, height };
+        }), py::arg("x") = 0, py::arg("y") = 0, py::arg("width") = 0, py::arg("height") = 0, "")
+        .def_readwrite("x", &DirtyRect::x, "")
+        .def_readwrite("y", &DirtyRect::y, "")
+        .def_readwrite("width", &DirtyRect::width, "")
+        .def_readwrite("height", &DirtyRect::height, "")
+        .def("__repr__", [](const DirtyRect& r) {
+            return "DirtyRect(" + std::to_string(r.x) + ", " + std::to_string(r.y) + ", " + std::to_string(r.width) + ", " + std::to_string(r.height) + ")";
+        });
+
+    m.attr("MAX_MANIFEST_DIRTY_RECTS") = kMaxManifestDirtyRects;
+
+    m.def("normalize_dirty_rects", [](const py::object& rects, uint32_t width, uint32_t height, size_t max_rects, float full_coverage) {
+        return DirtyRects::normalize(dirty_rects_from_python(rects), width, height, max_rects, full_coverage);
+    }, py::arg("rects"), py::arg("width"), py::arg("height"), py::arg("max_rects") = kMaxManifestDirtyRects, py::arg("full_coverage") = 0.75f,
+       "Clips, merges and caps a rect list; returns the full surface when that is cheaper.");
+    m.def("snap_dirty_rects_to_tiles", [](const py::object& rects, uint32_t tile_size, uint32_t width, uint32_t height) {
+        return DirtyRects::snap_to_tiles(dirty_rects_from_python(rects), tile_size, width, height);
+    }, py::arg("rects"), py::arg("tile_size"), py::arg("width"), py::arg("height"), "Expands rects to whole tiles.");
+    m.def("propagate_dirty_rects", [](const py::iterable& layers, const py::iterable& source_dirty, uint32_t dest_width, uint32_t dest_height) {
+        std::vector<std::vector<DirtyRect>> cpp_dirty;
+        for (const auto& item : source_dirty) {
+            cpp_dirty.push_back(dirty_rects_from_python(py::reinterpret_borrow<py::object>(item)));
+        }
+        return DirtyRects::propagate(composite_layers_from_python(layers), cpp_dirty, dest_width, dest_height);
+    }, py::arg("layers"), py::arg("source_dirty"), py::arg("dest_width"), py::arg("dest_height"),
+       "Maps each layer's source dirty rects into the composite destination.");
+    m.def("dirty_rects_area", [](const py::object& rects) {
+        return DirtyRects::area(dirty_rects_from_python(rects));
+    }, py::arg("rects"), "Total pixels covered by a normalized rect list.");
+}
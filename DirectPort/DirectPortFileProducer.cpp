@@ -0,0 +1,676 @@
+// src/DirectPort/DirectPortFileProducer.cpp
+// One mutex and condition variable coordinate three parties: the publisher
+// thread, the prefetch thread, which follows the publisher's cursor, and
+// consumers in wait_for_frame, who release the texture back to an unpaced
+// publisher. The mapped file itself is read without the lock.
+
+#include "DirectPortFileProducer.h"
+#include "DirectPortConvert.h"
+#include "DirectPortCopy.h"
+#include "DirectPortFormats.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace DirectPort;
+
+namespace {
+
+    size_t page_size() {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    }
+
+    // A read-only mapping of a whole file.
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+            std::wstring wide(MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0), L'\0');
+            MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wide.data(), (int)wide.size());
+            file_ = CreateFileW(wide.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) {
+                throw std::runtime_error("FileProducer: cannot open " + path + " (error " + std::to_string(GetLastError()) + ").");
+            }
+            LARGE_INTEGER size;
+            GetFileSizeEx(file_, &size);
+            size_ = (size_t)size.QuadPart;
+            mapping_ = size_ ? CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+            data_ = mapping_ ? static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+            fd_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd_ < 0) {
+                throw std::runtime_error("FileProducer: cannot open " + path + ".");
+            }
+            struct stat info;
+            size_ = fstat(fd_, &info) == 0 ? (size_t)info.st_size : 0;
+            void* data = size_ ? mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0) : MAP_FAILED;
+            data_ = data == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(data);
+#if defined(POSIX_FADV_SEQUENTIAL)
+            posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+            if (!data_) {
+                close_all();
+                throw std::runtime_error("FileProducer: cannot map " + path + (size_ ? "." : ": the file is empty."));
+            }
+        }
+
+        ~MappedFile() { close_all(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+
+        // Brings the range into the page cache; blocks until it is there.
+        void prefetch(size_t offset, size_t bytes) const {
+#if defined(__linux__)
+            readahead(fd_, (off64_t)offset, bytes);
+#else
+            uint8_t sum = 0;
+            for (size_t i = 0; i < bytes; i += kTouchStride) sum += data_[offset + i];
+            volatile uint8_t sink = sum;
+            (void)sink;
+#endif
+        }
+
+        // Drops the range from this mapping; the page cache keeps it, so a
+        // later read faults it back in cheaply.
+        void release(size_t offset, size_t bytes) const {
+#ifndef _WIN32
+            const size_t page = page_size();
+            const size_t begin = (offset + page - 1) / page * page;
+            const size_t end = (offset + bytes) / page * page;
+            if (end > begin) madvise(const_cast<uint8_t*>(data_) + begin, end - begin, MADV_DONTNEED);
+#else
+            (void)offset;
+            (void)bytes;
+#endif
+        }
+
+    private:
+        static constexpr size_t kTouchStride = 4096;
+
+        void close_all() {
+#ifdef _WIN32
+            if (data_) UnmapViewOfFile(data_);
+            if (mapping_) CloseHandle(mapping_);
+            if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+            mapping_ = nullptr;
+#else
+            if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+            if (fd_ >= 0) close(fd_);
+            fd_ = -1;
+#endif
+            data_ = nullptr;
+        }
+
+#ifdef _WIN32
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#else
+        int fd_ = -1;
+#endif
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    template <typename T>
+    T le(const uint8_t* p) {
+        T value;
+        memcpy(&value, p, sizeof(T));
+        return value;
+    }
+
+    struct NpyLayout {
+        std::string dtype;
+        uint64_t count = 1;
+        uint32_t height = 0;
+        uint32_t width = 0;
+        uint32_t channels = 1;
+        size_t data_offset = 0;
+    };
+
+    std::string dtype_of(const std::string& descr) {
+        if (descr.size() < 3 || (descr[0] == '>' && descr.substr(1) != "u1")) {
+            throw std::invalid_argument("FileProducer: unsupported .npy dtype '" + descr + "'.");
+        }
+        const std::string type = descr.substr(1);
+        if (type == "u1") return "uint8";
+        if (type == "u2") return "uint16";
+        if (type == "u4") return "uint32";
+        if (type == "f2") return "float16";
+        if (type == "f4") return "float32";
+        throw std::invalid_argument("FileProducer: unsupported .npy dtype '" + descr + "'.");
+    }
+
+    // The header is a Python dict literal, e.g.
+    // {'descr': '<u1', 'fortran_order': False, 'shape': (300, 1080, 1920, 3), }
+    NpyLayout parse_npy(const uint8_t* p, size_t size, size_t base) {
+        static const char kMagic[] = "\x93NUMPY";
+        if (size < 10 || memcmp(p, kMagic, 6) != 0) {
+            throw std::invalid_argument("FileProducer: not a .npy file.");
+        }
+        const uint8_t major = p[6];
+        const size_t prefix = major == 1 ? 10 : 12;
+        const size_t header_bytes = major == 1 ? le<uint16_t>(p + 8) : (size >= 12 ? le<uint32_t>(p + 8) : 0);
+        if ((major < 1 || major > 3) || prefix + header_bytes > size) {
+            throw std::invalid_argument("FileProducer: unsupported or truncated .npy header.");
+        }
+        const std::string header(reinterpret_cast<const char*>(p + prefix), header_bytes);
+        auto value = [&](const char* key) {
+            const size_t at = header.find(std::string("'") + key + "'");
+            const size_t colon = at == std::string::npos ? at : header.find(':', at);
+            if (colon == std::string::npos) {
+                throw std::invalid_argument(std::string("FileProducer: the .npy header has no ") + key + ".");
+            }
+            return header.substr(header.find_first_not_of(' ', colon + 1));
+        };
+
+        const std::string descr = value("descr");
+        if (descr.empty() || descr[0] != '\'') {
+            throw std::invalid_argument("FileProducer: structured .npy dtypes are not frames.");
+        }
+        NpyLayout layout;
+        layout.dtype = dtype_of(descr.substr(1, descr.find('\'', 1) - 1));
+        if (value("fortran_order").rfind("True", 0) == 0) {
+            throw std::invalid_argument("FileProducer: Fortran-ordered .npy files cannot be replayed; save a C-ordered array.");
+        }
+        const std::string shape_text = value("shape");
+        std::vector<uint64_t> shape;
+        for (size_t i = 1; i < shape_text.size() && shape_text[i] != ')'; ++i) {
+            if (shape_text[i] >= '0' && shape_text[i] <= '9') {
+                size_t used = 0;
+                shape.push_back(std::stoull(shape_text.substr(i), &used));
+                i += used - 1;
+            }
+        }
+
+        // (H, W), (H, W, C) with C <= 4, (N, H, W) or (N, H, W, C).
+        const bool channel_axis = shape.size() == 4 || (shape.size() == 3 && shape[2] <= 4);
+        const size_t frame_axis = shape.size() - (channel_axis ? 3 : 2);
+        if (shape.size() < 2 || shape.size() > 4 || frame_axis > 1) {
+            throw std::invalid_argument("FileProducer: .npy frames must be (N, H, W[, C]) or (H, W[, C]).");
+        }
+        for (size_t i = frame_axis; i < shape.size(); ++i) {
+            if (shape[i] > std::numeric_limits<uint32_t>::max()) {
+                throw std::invalid_argument("FileProducer: .npy frame dimensions must fit in 32 bits.");
+            }
+        }
+        layout.count = frame_axis ? shape[0] : 1;
+        layout.height = (uint32_t)shape[frame_axis];
+        layout.width = (uint32_t)shape[frame_axis + 1];
+        layout.channels = channel_axis ? (uint32_t)shape.back() : 1;
+        layout.data_offset = base + prefix + header_bytes;
+        if (layout.channels == 0 || layout.channels > 4 || layout.width == 0 || layout.height == 0) {
+            throw std::invalid_argument("FileProducer: .npy frames need 1 to 4 channels and a non-empty size.");
+        }
+        return layout;
+    }
+
+    // The stored .npy member of an .npz named `key` (the first one when
+    // empty), as an offset and size in the archive. Reads the central
+    // directory, with its Zip64 extensions, since np.savez writes them for
+    // large arrays. Offsets and sizes come from the file and may be anything
+    // up to 2^64, so bounds compare against what is left rather than adding.
+    std::pair<size_t, size_t> find_npz_member(const uint8_t* p, size_t size, const std::string& key) {
+        // The end record is the last 22 bytes plus a comment of up to 64 KB.
+        size_t eocd = std::string::npos;
+        const size_t stop = size > 65557 ? size - 65557 : 0;
+        for (size_t i = size >= 22 ? size - 22 : 0; size >= 22; --i) {
+            if (le<uint32_t>(p + i) == 0x06054b50) { eocd = i; break; }
+            if (i == stop) break;
+        }
+        if (eocd == std::string::npos) {
+            throw std::invalid_argument("FileProducer: not a .npy or .npz file.");
+        }
+        uint64_t entries = le<uint16_t>(p + eocd + 10);
+        uint64_t directory = le<uint32_t>(p + eocd + 16);
+        if ((entries == 0xFFFF || directory == 0xFFFFFFFF) && eocd >= 20 && le<uint32_t>(p + eocd - 20) == 0x07064b50) {
+            const uint64_t record = le<uint64_t>(p + eocd - 12);
+            if (record > size || size - record < 56 || le<uint32_t>(p + record) != 0x06064b50) {
+                throw std::invalid_argument("FileProducer: corrupt Zip64 directory.");
+            }
+            entries = le<uint64_t>(p + record + 32);
+            directory = le<uint64_t>(p + record + 48);
+        }
+
+        const std::string wanted = key.empty() ? "" : key + ".npy";
+        size_t at = (size_t)directory;
+        for (uint64_t e = 0; e < entries; ++e) {
+            if (at > size || size - at < 46 || le<uint32_t>(p + at) != 0x02014b50) {
+                throw std::invalid_argument("FileProducer: corrupt .npz directory.");
+            }
+            const uint16_t flags = le<uint16_t>(p + at + 8);
+            const uint16_t method = le<uint16_t>(p + at + 10);
+            uint64_t compressed = le<uint32_t>(p + at + 20);
+            uint64_t uncompressed = le<uint32_t>(p + at + 24);
+            const uint16_t name_bytes = le<uint16_t>(p + at + 28);
+            const uint16_t extra_bytes = le<uint16_t>(p + at + 30);
+            const uint16_t comment_bytes = le<uint16_t>(p + at + 32);
+            uint64_t local = le<uint32_t>(p + at + 42);
+            if (size - at - 46 < name_bytes) {
+                throw std::invalid_argument("FileProducer: corrupt .npz directory.");
+            }
+            const std::string name(reinterpret_cast<const char*>(p + at + 46), name_bytes);
+            for (size_t x = at + 46 + name_bytes, end = x + extra_bytes; x + 4 <= end && end <= size;) {
+                const uint16_t id = le<uint16_t>(p + x);
+                const uint16_t bytes = le<uint16_t>(p + x + 2);
+                if (id == 0x0001) {
+                    // Only the sizes saturated in the fixed record are present, in this order.
+                    size_t field = x + 4;
+                    const size_t field_end = field + bytes;
+                    auto next = [&]() {
+                        if (field + 8 > field_end || field_end > end) {
+                            throw std::invalid_argument("FileProducer: corrupt .npz directory.");
+                        }
+                        field += 8;
+                        return le<uint64_t>(p + field - 8);
+                    };
+                    if (uncompressed == 0xFFFFFFFF) uncompressed = next();
+                    if (compressed == 0xFFFFFFFF) compressed = next();
+                    if (local == 0xFFFFFFFF) local = next();
+                }
+                x += 4 + bytes;
+            }
+            at += 46 + name_bytes + extra_bytes + comment_bytes;
+
+            const bool npy = name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0;
+            if (!(wanted.empty() ? npy : name == wanted)) continue;
+            if (method != 0 || (flags & 1)) {
+                throw std::invalid_argument("FileProducer: " + name + " is compressed and cannot be memory-mapped; write it with np.savez.");
+            }
+            if (local > size || size - local < 30 || le<uint32_t>(p + local) != 0x04034b50) {
+                throw std::invalid_argument("FileProducer: corrupt .npz member " + name + ".");
+            }
+            const size_t data = (size_t)local + 30 + le<uint16_t>(p + local + 26) + le<uint16_t>(p + local + 28);
+            if (data > size || size - data < uncompressed) {
+                throw std::invalid_argument("FileProducer: truncated .npz member " + name + ".");
+            }
+            return { data, (size_t)uncompressed };
+        }
+        throw std::invalid_argument(key.empty() ? "FileProducer: the .npz holds no .npy member."
+                                                : "FileProducer: the .npz has no member '" + key + "'.");
+    }
+
+    size_t dtype_bytes(const std::string& dtype) {
+        return dtype == "uint8" ? 1 : (dtype == "uint16" || dtype == "float16") ? 2 : 4;
+    }
+
+    // How frames reach a texture of `target` format, by write_texture's rules.
+    struct Plan {
+        DXGI_FORMAT source = DXGI_FORMAT_UNKNOWN;
+        bool swizzle = false;
+        Copy::Swizzle channels;
+    };
+
+    Plan plan_for(DXGI_FORMAT format, const std::string& dtype, uint32_t channels, DXGI_FORMAT target_format) {
+        const Formats::Traits* target = Formats::find(target_format);
+        if (!target) {
+            throw std::invalid_argument("FileProducer: unsupported texture format.");
+        }
+        Plan plan;
+        if (channels == 3 && dtype == "uint8") {
+            const Formats::Traits* source = format == DXGI_FORMAT_UNKNOWN ? target : Formats::find(format);
+            if (target->sample != Formats::Sample::U8 || target->channels != 4 || !source || source->sample != Formats::Sample::U8 ||
+                source->channels != 4) {
+                throw std::invalid_argument("FileProducer: three-channel frames need an 8-bit RGBA or BGRA texture.");
+            }
+            plan.swizzle = true;
+            plan.channels.src_channels = 3;
+            plan.channels.swap_rb = source->bgra != target->bgra;
+            return plan;
+        }
+        plan.source = format;
+        if (plan.source == DXGI_FORMAT_UNKNOWN) {
+            plan.source = Formats::with_numpy_dtype(target_format, dtype.c_str());
+            const Formats::Traits* source = Formats::find(plan.source);
+            if (!source || source->numpy_channels != channels) {
+                throw std::invalid_argument("FileProducer: no format holds " + std::to_string(channels) + "-channel " + dtype +
+                                            " frames for a " + target->name + " texture.");
+            }
+        }
+        if (plan.source != target_format && (!Convert::is_supported(plan.source) || !Convert::is_supported(target_format))) {
+            throw std::invalid_argument("FileProducer: the frames cannot be converted to the texture's format.");
+        }
+        return plan;
+    }
+
+}
+
+struct FileProducer::Impl {
+    std::unique_ptr<MappedFile> file;
+    uint64_t count = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 0;
+    std::string dtype;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    size_t data_offset = 0;
+    size_t frame_bytes = 0;
+    size_t row_pitch = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::thread publisher;
+    std::thread prefetcher;
+    std::shared_ptr<Texture> texture;
+    Plan plan;
+    double fps = 0.0;
+    bool loop = false;
+    uint64_t first = 0;
+    bool running = false;
+    bool stopping = false;
+    bool finished = false;
+    std::exception_ptr error;
+    // Frames of this run published, returned by wait_for_frame, and handed
+    // back by the consumer's next wait.
+    uint64_t published = 0;
+    uint64_t seen = 0;
+    uint64_t released = 0;
+    uint64_t frame_index = 0;
+    uint32_t prefetch_frames = kDefaultPrefetchFrames;
+    Stats stats;
+
+    // Frames in a run, and the file frame the run's s-th one is.
+    uint64_t run_length() const { return loop ? std::numeric_limits<uint64_t>::max() : count - first; }
+    uint64_t frame_at(uint64_t s) const { return loop ? (first + s) % count : first + s; }
+    size_t offset_of(uint64_t index) const { return data_offset + (size_t)index * frame_bytes; }
+
+    void copy_frame(const Plan& how, uint64_t index, Texture& target) const {
+        const uint8_t* src = file->data() + offset_of(index);
+        void* dst = reinterpret_cast<void*>(target.get_cpu_ptr());
+        const size_t pitch = target.get_cpu_row_pitch();
+        if (how.swizzle) {
+            Copy::transfer(how.channels, dst, pitch, src, row_pitch, width, height);
+        } else if (how.source == target.get_format()) {
+            Copy::copy_texels(how.source, dst, pitch, src, row_pitch, width, height);
+        } else {
+            Convert::convert(how.source, src, row_pitch, target.get_format(), dst, pitch, width, height);
+        }
+    }
+
+    Plan check_target(const std::shared_ptr<Texture>& target) const {
+        if (!target || !target->get_cpu_ptr()) {
+            throw std::invalid_argument("FileProducer: frames are published into DeviceCPU textures.");
+        }
+        if (target->get_width() != width || target->get_height() != height) {
+            throw std::invalid_argument("FileProducer: the texture is " + std::to_string(target->get_width()) + "x" +
+                                        std::to_string(target->get_height()) + ", the frames are " + std::to_string(width) + "x" +
+                                        std::to_string(height) + ".");
+        }
+        return plan_for(format, dtype, channels, target->get_format());
+    }
+
+    void publish_loop() {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+        const auto period = fps > 0.0 ? std::chrono::duration<double>(1.0 / fps) : std::chrono::duration<double>(0.0);
+        // Frames are dropped from the mapping once published, unless the
+        // whole loop fits in the prefetch window and stays resident anyway.
+        const bool drop_behind = !loop || count > (uint64_t)prefetch_frames + 1;
+        const uint64_t length = run_length();
+        for (uint64_t s = 0; s < length; ++s) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (fps > 0.0) {
+                    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(period * (double)s);
+                    cv.wait_until(lock, deadline, [&] { return stopping; });
+                    if (Clock::now() - deadline > period) ++stats.late;
+                } else {
+                    cv.wait(lock, [&] { return stopping || released >= s; });
+                }
+                if (stopping) break;
+            }
+            const uint64_t index = frame_at(s);
+            try {
+                copy_frame(plan, index, *texture);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+                break;
+            }
+            uint64_t previous;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                previous = frame_index;
+                published = s + 1;
+                frame_index = index;
+                ++stats.published;
+            }
+            cv.notify_all();
+            if (s > 0 && drop_behind && previous != index) file->release(offset_of(previous), frame_bytes);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+        }
+        cv.notify_all();
+    }
+
+    void prefetch_loop() {
+        const uint64_t length = run_length();
+        uint64_t next = 0;
+        for (;;) {
+            uint64_t target;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                auto window = [&] { return std::min(length, published + prefetch_frames); };
+                cv.wait(lock, [&] { return stopping || finished || next < window(); });
+                if (stopping || finished) return;
+                target = window();
+            }
+            for (; next < target; ++next) {
+                file->prefetch(offset_of(frame_at(next)), frame_bytes);
+                std::lock_guard<std::mutex> lock(mutex);
+                stats.prefetched_bytes += frame_bytes;
+                if (stopping) return;
+            }
+        }
+    }
+};
+
+FileProducer::FileProducer() : pImpl(std::make_unique<Impl>()) {}
+
+FileProducer::~FileProducer() {
+    stop();
+}
+
+std::shared_ptr<FileProducer> FileProducer::open_npy(const std::string& path, const std::string& key, DXGI_FORMAT format) {
+    auto self = std::shared_ptr<FileProducer>(new FileProducer());
+    Impl& f = *self->pImpl;
+    f.file = std::make_unique<MappedFile>(path);
+    const uint8_t* data = f.file->data();
+    const size_t size = f.file->size();
+
+    NpyLayout layout;
+    // Frames must lie within the .npy itself, not just within the archive.
+    size_t end = size;
+    if (size >= 4 && le<uint32_t>(data) == 0x04034b50) {
+        const auto member = find_npz_member(data, size, key);
+        layout = parse_npy(data + member.first, member.second, member.first);
+        end = member.first + member.second;
+    } else {
+        layout = parse_npy(data, size, 0);
+    }
+
+    f.count = layout.count;
+    f.width = layout.width;
+    f.height = layout.height;
+    f.channels = layout.channels;
+    f.dtype = layout.dtype;
+    f.data_offset = layout.data_offset;
+    f.row_pitch = (size_t)f.width * f.channels * dtype_bytes(f.dtype);
+    f.frame_bytes = f.row_pitch * f.height;
+    // Divide rather than multiply: a crafted header can make count * frame_bytes wrap.
+    if (f.count == 0 || f.data_offset > end || f.row_pitch > (end - f.data_offset) / f.height ||
+        f.frame_bytes == 0 || f.count > (end - f.data_offset) / f.frame_bytes) {
+        throw std::invalid_argument("FileProducer: " + path + " holds no frames or is truncated.");
+    }
+    if (format != DXGI_FORMAT_UNKNOWN && !(f.channels == 3 && f.dtype == "uint8")) {
+        const Formats::Traits* traits = Formats::find(format);
+        if (!traits || !traits->numpy_dtype || f.dtype != traits->numpy_dtype || f.channels != traits->numpy_channels) {
+            throw std::invalid_argument("FileProducer: the frames' dtype and channels do not match the given format.");
+        }
+    }
+    f.format = format;
+    return self;
+}
+
+std::shared_ptr<FileProducer> FileProducer::open_raw(const std::string& path, uint32_t width, uint32_t height, DXGI_FORMAT format,
+                                                     size_t header_bytes, size_t frame_bytes) {
+    const Formats::Traits* traits = Formats::find(format);
+    if (!traits || !traits->numpy_dtype || width == 0 || height == 0) {
+        throw std::invalid_argument("FileProducer: raw frames need a size and an uncompressed format.");
+    }
+    auto self = std::shared_ptr<FileProducer>(new FileProducer());
+    Impl& f = *self->pImpl;
+    f.file = std::make_unique<MappedFile>(path);
+    f.width = width;
+    f.height = height;
+    f.format = format;
+    f.dtype = traits->numpy_dtype;
+    f.channels = traits->numpy_channels;
+    f.row_pitch = Formats::row_pitch(format, width);
+    f.data_offset = header_bytes;
+    f.frame_bytes = frame_bytes ? frame_bytes : Formats::image_size(format, width, height);
+    if (f.frame_bytes < Formats::image_size(format, width, height)) {
+        throw std::invalid_argument("FileProducer: frame_bytes is smaller than one frame.");
+    }
+    const size_t size = f.file->size();
+    f.count = size > header_bytes ? (size - header_bytes) / f.frame_bytes : 0;
+    // The last frame only needs its pixels, not the padding after them.
+    if (size > header_bytes && (size - header_bytes) % f.frame_bytes >= Formats::image_size(format, width, height)) ++f.count;
+    if (f.count == 0) {
+        throw std::invalid_argument("FileProducer: " + path + " is shorter than one frame.");
+    }
+    return self;
+}
+
+uint64_t FileProducer::get_frame_count() const { return pImpl->count; }
+uint32_t FileProducer::get_width() const { return pImpl->width; }
+uint32_t FileProducer::get_height() const { return pImpl->height; }
+DXGI_FORMAT FileProducer::get_format() const { return pImpl->format; }
+const char* FileProducer::get_dtype() const { return pImpl->dtype.c_str(); }
+uint32_t FileProducer::get_channels() const { return pImpl->channels; }
+size_t FileProducer::get_row_pitch() const { return pImpl->row_pitch; }
+
+const uint8_t* FileProducer::frame_data(uint64_t index) const {
+    if (index >= pImpl->count) {
+        throw std::out_of_range("FileProducer: frame " + std::to_string(index) + " of " + std::to_string(pImpl->count) + ".");
+    }
+    return pImpl->file->data() + pImpl->offset_of(index);
+}
+
+void FileProducer::read_frame(uint64_t index, std::shared_ptr<Texture> texture) const {
+    frame_data(index);
+    pImpl->copy_frame(pImpl->check_target(texture), index, *texture);
+}
+
+void FileProducer::start(std::shared_ptr<Texture> texture, double fps, bool loop, uint64_t first) {
+    const Plan plan = pImpl->check_target(texture);
+    if (first >= pImpl->count) {
+        throw std::out_of_range("FileProducer: cannot start at frame " + std::to_string(first) + " of " + std::to_string(pImpl->count) + ".");
+    }
+    stop();
+    Impl& f = *pImpl;
+    {
+        std::lock_guard<std::mutex> lock(f.mutex);
+        f.texture = std::move(texture);
+        f.plan = plan;
+        f.fps = fps;
+        f.loop = loop;
+        f.first = first;
+        f.running = true;
+        f.stopping = false;
+        f.finished = false;
+        f.error = nullptr;
+        f.published = f.seen = f.released = 0;
+        f.frame_index = first;
+    }
+    f.prefetcher = std::thread([&f] { f.prefetch_loop(); });
+    f.publisher = std::thread([&f] { f.publish_loop(); });
+}
+
+void FileProducer::stop() {
+    Impl& f = *pImpl;
+    {
+        std::lock_guard<std::mutex> lock(f.mutex);
+        if (!f.running) return;
+        f.stopping = true;
+    }
+    f.cv.notify_all();
+    if (f.publisher.joinable()) f.publisher.join();
+    if (f.prefetcher.joinable()) f.prefetcher.join();
+    std::lock_guard<std::mutex> lock(f.mutex);
+    f.running = false;
+    f.finished = true;
+}
+
+bool FileProducer::is_running() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->running && !pImpl->finished;
+}
+
+bool FileProducer::wait_for_frame(uint32_t timeout_ms) {
+    Impl& f = *pImpl;
+    std::unique_lock<std::mutex> lock(f.mutex);
+    // Everything returned so far is done with; an unpaced publisher may
+    // overwrite the texture again.
+    f.released = f.seen;
+    f.cv.notify_all();
+    f.cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] { return f.published > f.seen || f.finished || f.error; });
+    if (f.error) std::rethrow_exception(f.error);
+    if (f.published == f.seen) return false;
+    f.seen = f.published;
+    return true;
+}
+
+uint64_t FileProducer::get_frame_index() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->frame_index;
+}
+
+std::shared_ptr<Texture> FileProducer::get_texture() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->texture;
+}
+
+uint32_t FileProducer::get_prefetch_frames() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->prefetch_frames;
+}
+
+void FileProducer::set_prefetch_frames(uint32_t frames) {
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->prefetch_frames = frames;
+    }
+    pImpl->cv.notify_all();
+}
+
+FileProducer::Stats FileProducer::get_stats() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->stats;
+}
@@ -0,0 +1,91 @@
+// DirectPortFileProducer.h
+#pragma once
+
+#include "DirectPort.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace DirectPort {
+
+    // Replays recorded frames from disk into a texture without Python in the
+    // loop. The file is memory-mapped, never decoded: a .npy stack of
+    // (N, H, W[, C]) or a single (H, W[, C]) frame, an uncompressed member of
+    // an .npz (np.savez, not savez_compressed), or a raw file of fixed-size
+    // frames. A prefetch thread reads `prefetch_frames` ahead of the cursor
+    // into the page cache (readahead on Linux, page touches elsewhere) and
+    // pages already published are dropped from the mapping, so a multi-GB
+    // replay runs at disk speed with a flat footprint.
+    //
+    // start() publishes frames into a CPU texture from a thread of its own,
+    // converting as write_texture does. With fps > 0 frames are paced on a
+    // steady clock and a slow consumer misses some; with fps == 0 each frame
+    // waits until the consumer's next wait_for_frame, so offline jobs see
+    // every frame exactly once. Like a Consumer's texture, the target is
+    // overwritten by the next frame: use it between wait_for_frame calls.
+    class FileProducer {
+    public:
+        struct Stats {
+            uint64_t published = 0;
+            // Paced frames published after their deadline.
+            uint64_t late = 0;
+            uint64_t prefetched_bytes = 0;
+        };
+
+        static constexpr uint32_t kDefaultPrefetchFrames = 8;
+
+        // A .npy file, or the `key` member of an .npz (the first .npy member
+        // when empty). `format` names the pixels' channel order, as for
+        // write_texture; UNKNOWN takes the target texture's. Throws
+        // std::runtime_error when the file cannot be mapped and
+        // std::invalid_argument for layouts it cannot replay.
+        static std::shared_ptr<FileProducer> open_npy(const std::string& path, const std::string& key = "",
+                                                      DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN);
+        // Frames of `format` with packed rows, one every `frame_bytes` (the
+        // image size when 0) after `header_bytes`. A partial last frame is ignored.
+        static std::shared_ptr<FileProducer> open_raw(const std::string& path, uint32_t width, uint32_t height, DXGI_FORMAT format,
+                                                      size_t header_bytes = 0, size_t frame_bytes = 0);
+        ~FileProducer();
+
+        uint64_t get_frame_count() const;
+        uint32_t get_width() const;
+        uint32_t get_height() const;
+        // The pixels' format, UNKNOWN for .npy files opened without one.
+        DXGI_FORMAT get_format() const;
+        // NumPy element type ("uint8", "float16", ...) and channels per pixel.
+        const char* get_dtype() const;
+        uint32_t get_channels() const;
+
+        // Frame `index` in the mapping, rows get_row_pitch() apart; valid for
+        // the producer's lifetime. Throws std::out_of_range past the end.
+        const uint8_t* frame_data(uint64_t index) const;
+        size_t get_row_pitch() const;
+        // Copies frame `index` into a CPU texture of the same size now.
+        void read_frame(uint64_t index, std::shared_ptr<Texture> texture) const;
+
+        // Publishes frames from `first` on; loops back to 0 at the end with
+        // `loop`. Throws std::invalid_argument for textures without CPU
+        // memory, of another size, or of a format the frames cannot convert to.
+        void start(std::shared_ptr<Texture> texture, double fps = 0.0, bool loop = false, uint64_t first = 0);
+        void stop();
+        bool is_running() const;
+        // True once a frame newer than the last one returned is in the
+        // texture; false on timeout or after the last frame. Rethrows an
+        // error that stopped publishing.
+        bool wait_for_frame(uint32_t timeout_ms = 1000);
+        // The frame now in the texture.
+        uint64_t get_frame_index() const;
+        std::shared_ptr<Texture> get_texture() const;
+
+        uint32_t get_prefetch_frames() const;
+        void set_prefetch_frames(uint32_t frames);
+        Stats get_stats() const;
+
+    private:
+        FileProducer();
+        struct Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+}
@@ -0,0 +1,70 @@
+#include "DirectPortFileProducer.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+void bind_file_producer(py::module_& m) {
+    py::class_<FileProducer::Stats>(m, "FileProducerStats", "")
+        .def_readonly("published", &FileProducer::Stats::published)
+        .def_readonly("late", &FileProducer::Stats::late, "Paced frames published more than a frame after their deadline.")
+        .def_readonly("prefetched_bytes", &FileProducer::Stats::prefetched_bytes)
+        .def("__repr__", [](const FileProducer::Stats& s) {
+            return "<FileProducerStats " + std::to_string(s.published) + " published, " + std::to_string(s.late) + " late, " +
+                   std::to_string(s.prefetched_bytes >> 20) + " MB prefetched>";
+        });
+
+    py::class_<FileProducer, std::shared_ptr<FileProducer>>(m, "FileProducer",
+                                                            "Replays frames memory-mapped from .npy, .npz or raw files into a texture.")
+        .def_static("open", &FileProducer::open_npy, py::arg("path"), py::arg("key") = "", py::arg("format") = DXGI_FORMAT_UNKNOWN,
+                    "A .npy stack of (N, H, W[, C]) frames, or member `key` of an uncompressed .npz.")
+        .def_static("open_raw", &FileProducer::open_raw, py::arg("path"), py::arg("width"), py::arg("height"), py::arg("format"),
+                    py::arg("header_bytes") = 0, py::arg("frame_bytes") = 0,
+                    "Fixed-size frames of `format` one every `frame_bytes` after `header_bytes`.")
+        .def_property_readonly("frame_count", &FileProducer::get_frame_count)
+        .def_property_readonly("width", &FileProducer::get_width)
+        .def_property_readonly("height", &FileProducer::get_height)
+        .def_property_readonly("format", &FileProducer::get_format)
+        .def_property_readonly("dtype", &FileProducer::get_dtype)
+        .def_property_readonly("channels", &FileProducer::get_channels)
+        .def("__len__", &FileProducer::get_frame_count)
+        // A read-only view of the mapping; it keeps the producer, and so the file, open.
+        .def("frame", [](const std::shared_ptr<FileProducer>& self, uint64_t index) {
+            const uint8_t* data = self->frame_data(index);
+            const py::dtype dtype(self->get_dtype());
+            const py::ssize_t item = dtype.itemsize();
+            std::vector<py::ssize_t> shape = { (py::ssize_t)self->get_height(), (py::ssize_t)self->get_width() };
+            std::vector<py::ssize_t> strides = { (py::ssize_t)self->get_row_pitch(), item * (py::ssize_t)self->get_channels() };
+            if (self->get_channels() > 1) {
+                shape.push_back(self->get_channels());
+                strides.push_back(item);
+            }
+            py::capsule owner(new std::shared_ptr<FileProducer>(self),
+                              [](void* p) { delete static_cast<std::shared_ptr<FileProducer>*>(p); });
+            py::array result(dtype, shape, strides, data, owner);
+            result.attr("flags").attr("writeable") = false;
+            return result;
+        }, py::arg("index"), "Frame `index` as a read-only NumPy view of the file, without a copy.")
+        .def("read_frame", &FileProducer::read_frame, py::arg("index"), py::arg("texture"), py::call_guard<py::gil_scoped_release>(),
+             "Copies frame `index` into a DeviceCPU texture of the same size.")
+        .def("start", &FileProducer::start, py::arg("texture"), py::arg("fps") = 0.0, py::arg("loop") = false, py::arg("first") = 0,
+             py::call_guard<py::gil_scoped_release>(),
+             "Publishes frames into a DeviceCPU texture from a native thread: paced at `fps`, or one per wait_for_frame when 0.")
+        .def("stop", &FileProducer::stop, py::call_guard<py::gil_scoped_release>())
+        .def("is_running", &FileProducer::is_running)
+        .def("wait_for_frame", &FileProducer::wait_for_frame, py::arg("timeout_ms") = 1000, py::call_guard<py::gil_scoped_release>(),
+             "True once a new frame is in the texture; False on timeout or after the last frame.")
+        .def_property_readonly("frame_index", &FileProducer::get_frame_index, "The frame now in the texture.")
+        .def_property_readonly("texture", &FileProducer::get_texture)
+        .def_property("prefetch_frames", &FileProducer::get_prefetch_frames, &FileProducer::set_prefetch_frames)
+        .def_property_readonly("stats", &FileProducer::get_stats)
+        .def("__enter__", [](const std::shared_ptr<FileProducer>& self) { return self; })
+        .def("__exit__", [](FileProducer& self, const py::args&) {
+            py::gil_scoped_release release;
+            self.stop();
+        });
+}
@@ -0,0 +1,254 @@
+// DirectPortFormats.h
+// One constexpr table describing every DXGI format DirectPort knows about.
+// Pitches, NumPy layouts, GL mappings and the CPU kernels' channel logic are
+// all lookups into it, so adding a format is one row here.
+#pragma once
+
+#include "DirectPortPlatform.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace DirectPort::Formats {
+
+    // How one channel is stored. None marks block-compressed formats.
+    enum class Sample : uint8_t { None, U8, F16, F32, RGB10A2 };
+
+    // GL enums by value, so this header does not need the GL headers.
+    namespace GL {
+        constexpr uint32_t RED = 0x1903, RG = 0x8227, RGBA = 0x1908, BGRA = 0x80E1;
+        constexpr uint32_t UNSIGNED_BYTE = 0x1401, HALF_FLOAT = 0x140B, FLOAT = 0x1406, UNSIGNED_INT_2_10_10_10_REV = 0x8368;
+        constexpr uint32_t R8 = 0x8229, RG8 = 0x822B, RGBA8 = 0x8058, SRGB8_ALPHA8 = 0x8C43, RGB10_A2 = 0x8059;
+        constexpr uint32_t R16F = 0x822D, RGBA16F = 0x881A, R32F = 0x822E, RGBA32F = 0x8814;
+        constexpr uint32_t COMPRESSED_RGBA_S3TC_DXT1 = 0x83F1, COMPRESSED_SRGB_ALPHA_S3TC_DXT1 = 0x8C4D;
+        constexpr uint32_t COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3, COMPRESSED_SRGB_ALPHA_S3TC_DXT5 = 0x8C4F;
+        constexpr uint32_t COMPRESSED_RGBA_BPTC_UNORM = 0x8E8C, COMPRESSED_SRGB_ALPHA_BPTC_UNORM = 0x8E8D;
+    }
+
+    struct Traits {
+        DXGI_FORMAT format;
+        const char* name;
+        // Bytes per pixel, or per block_size x block_size block when compressed.
+        uint32_t block_bytes;
+        uint32_t block_size;
+        uint32_t channels;
+        Sample sample;
+        bool bgra;
+        bool srgb;
+        bool typeless;
+        // The readback array: dtype per element and elements per pixel; a
+        // single element gives a 2-D array. nullptr when there is none.
+        const char* numpy_dtype;
+        uint32_t numpy_channels;
+        // glTexStorage / glTexImage2D arguments; 0 when GL has no equivalent.
+        uint32_t gl_internal_format;
+        uint32_t gl_format;
+        uint32_t gl_type;
+        // Relatives sharing the same memory layout: the typeless parent, the
+        // sRGB view and the typed linear view. UNKNOWN when there is none.
+        DXGI_FORMAT typeless_format;
+        DXGI_FORMAT srgb_format;
+        DXGI_FORMAT linear_format;
+    };
+
+    namespace Detail {
+        constexpr DXGI_FORMAT kNone = DXGI_FORMAT_UNKNOWN;
+        using S = Sample;
+    }
+
+#define DP_FORMAT(name, ...) { DXGI_FORMAT_##name, #name, __VA_ARGS__ }
+    inline constexpr Traits kTable[] = {
+        //         name                    bytes blk ch sample     bgra   srgb   tless  numpy      n  gl internal / format / type                                       typeless                         srgb                               linear
+        DP_FORMAT(R32G32B32A32_TYPELESS,   16,   1, 4, Detail::S::F32,     false, false, true,  "float32", 4, 0, 0, 0,                                                          DXGI_FORMAT_R32G32B32A32_TYPELESS, Detail::kNone,                     DXGI_FORMAT_R32G32B32A32_FLOAT),
+        DP_FORMAT(R32G32B32A32_FLOAT,      16,   1, 4, Detail::S::F32,     false, false, false, "float32", 4, GL::RGBA32F, GL::RGBA, GL::FLOAT,                             DXGI_FORMAT_R32G32B32A32_TYPELESS, Detail::kNone,                     DXGI_FORMAT_R32G32B32A32_FLOAT),
+        DP_FORMAT(R16G16B16A16_TYPELESS,   8,    1, 4, Detail::S::F16,     false, false, true,  "float16", 4, 0, 0, 0,                                                          DXGI_FORMAT_R16G16B16A16_TYPELESS, Detail::kNone,                     DXGI_FORMAT_R16G16B16A16_FLOAT),
+        DP_FORMAT(R16G16B16A16_FLOAT,      8,    1, 4, Detail::S::F16,     false, false, false, "float16", 4, GL::RGBA16F, GL::RGBA, GL::HALF_FLOAT,                        DXGI_FORMAT_R16G16B16A16_TYPELESS, Detail::kNone,                     DXGI_FORMAT_R16G16B16A16_FLOAT),
+        DP_FORMAT(R10G10B10A2_TYPELESS,    4,    1, 4, Detail::S::RGB10A2, false, false, true,  "uint32",  1, 0, 0, 0,                                                          DXGI_FORMAT_R10G10B10A2_TYPELESS,  Detail::kNone,                     DXGI_FORMAT_R10G10B10A2_UNORM),
+        DP_FORMAT(R10G10B10A2_UNORM,       4,    1, 4, Detail::S::RGB10A2, false, false, false, "uint32",  1, GL::RGB10_A2, GL::RGBA, GL::UNSIGNED_INT_2_10_10_10_REV,       DXGI_FORMAT_R10G10B10A2_TYPELESS,  Detail::kNone,                     DXGI_FORMAT_R10G10B10A2_UNORM),
+        DP_FORMAT(R8G8B8A8_TYPELESS,       4,    1, 4, Detail::S::U8,      false, false, true,  "uint8",   4, 0, 0, 0,                                                          DXGI_FORMAT_R8G8B8A8_TYPELESS,     DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,   DXGI_FORMAT_R8G8B8A8_UNORM),
+        DP_FORMAT(R8G8B8A8_UNORM,          4,    1, 4, Detail::S::U8,      false, false, false, "uint8",   4, GL::RGBA8, GL::RGBA, GL::UNSIGNED_BYTE,                       DXGI_FORMAT_R8G8B8A8_TYPELESS,     DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,   DXGI_FORMAT_R8G8B8A8_UNORM),
+        DP_FORMAT(R8G8B8A8_UNORM_SRGB,     4,    1, 4, Detail::S::U8,      false, true,  false, "uint8",   4, GL::SRGB8_ALPHA8, GL::RGBA, GL::UNSIGNED_BYTE,                DXGI_FORMAT_R8G8B8A8_TYPELESS,     DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,   DXGI_FORMAT_R8G8B8A8_UNORM),
+        DP_FORMAT(R32_TYPELESS,            4,    1, 1, Detail::S::F32,     false, false, true,  "float32", 1, 0, 0, 0,                                                          DXGI_FORMAT_R32_TYPELESS,          Detail::kNone,                     DXGI_FORMAT_R32_FLOAT),
+        DP_FORMAT(R32_FLOAT,               4,    1, 1, Detail::S::F32,     false, false, false, "float32", 1, GL::R32F, GL::RED, GL::FLOAT,                                 DXGI_FORMAT_R32_TYPELESS,          Detail::kNone,                     DXGI_FORMAT_R32_FLOAT),
+        DP_FORMAT(R8G8_TYPELESS,           2,    1, 2, Detail::S::U8,      false, false, true,  "uint8",   2, 0, 0, 0,                                                          DXGI_FORMAT_R8G8_TYPELESS,         Detail::kNone,                     DXGI_FORMAT_R8G8_UNORM),
+        DP_FORMAT(R8G8_UNORM,              2,    1, 2, Detail::S::U8,      false, false, false, "uint8",   2, GL::RG8, GL::RG, GL::UNSIGNED_BYTE,                           DXGI_FORMAT_R8G8_TYPELESS,         Detail::kNone,                     DXGI_FORMAT_R8G8_UNORM),
+        DP_FORMAT(R16_TYPELESS,            2,    1, 1, Detail::S::F16,     false, false, true,  "float16", 1, 0, 0, 0,                                                          DXGI_FORMAT_R16_TYPELESS,          Detail::kNone,                     DXGI_FORMAT_R16_FLOAT),
+        DP_FORMAT(R16_FLOAT,               2,    1, 1, Detail::S::F16,     false, false, false, "float16", 1, GL::R16F, GL::RED, GL::HALF_FLOAT,                            DXGI_FORMAT_R16_TYPELESS,          Detail::kNone,                     DXGI_FORMAT_R16_FLOAT),
+        DP_FORMAT(R8_TYPELESS,             1,    1, 1, Detail::S::U8,      false, false, true,  "uint8",   1, 0, 0, 0,                                                          DXGI_FORMAT_R8_TYPELESS,           Detail::kNone,                     DXGI_FORMAT_R8_UNORM),
+        DP_FORMAT(R8_UNORM,                1,    1, 1, Detail::S::U8,      false, false, false, "uint8",   1, GL::R8, GL::RED, GL::UNSIGNED_BYTE,                           DXGI_FORMAT_R8_TYPELESS,           Detail::kNone,                     DXGI_FORMAT_R8_UNORM),
+        DP_FORMAT(BC1_TYPELESS,            8,    4, 4, Detail::S::None,    false, false, true,  nullptr,   0, 0, 0, 0,                                                          DXGI_FORMAT_BC1_TYPELESS,          DXGI_FORMAT_BC1_UNORM_SRGB,        DXGI_FORMAT_BC1_UNORM),
+        DP_FORMAT(BC1_UNORM,               8,    4, 4, Detail::S::None,    false, false, false, nullptr,   0, GL::COMPRESSED_RGBA_S3TC_DXT1, 0, 0,                             DXGI_FORMAT_BC1_TYPELESS,          DXGI_FORMAT_BC1_UNORM_SRGB,        DXGI_FORMAT_BC1_UNORM),
+        DP_FORMAT(BC1_UNORM_SRGB,          8,    4, 4, Detail::S::None,    false, true,  false, nullptr,   0, GL::COMPRESSED_SRGB_ALPHA_S3TC_DXT1, 0, 0,                       DXGI_FORMAT_BC1_TYPELESS,          DXGI_FORMAT_BC1_UNORM_SRGB,        DXGI_FORMAT_BC1_UNORM),
+        DP_FORMAT(BC3_TYPELESS,            16,   4, 4, Detail::S::None,    false, false, true,  nullptr,   0, 0, 0, 0,                                                          DXGI_FORMAT_BC3_TYPELESS,          DXGI_FORMAT_BC3_UNORM_SRGB,        DXGI_FORMAT_BC3_UNORM),
+        DP_FORMAT(BC3_UNORM,               16,   4, 4, Detail::S::None,    false, false, false, nullptr,   0, GL::COMPRESSED_RGBA_S3TC_DXT5, 0, 0,                             DXGI_FORMAT_BC3_TYPELESS,          DXGI_FORMAT_BC3_UNORM_SRGB,        DXGI_FORMAT_BC3_UNORM),
+        DP_FORMAT(BC3_UNORM_SRGB,          16,   4, 4, Detail::S::None,    false, true,  false, nullptr,   0, GL::COMPRESSED_SRGB_ALPHA_S3TC_DXT5, 0, 0,                       DXGI_FORMAT_BC3_TYPELESS,          DXGI_FORMAT_BC3_UNORM_SRGB,        DXGI_FORMAT_BC3_UNORM),
+        DP_FORMAT(B8G8R8A8_UNORM,          4,    1, 4, Detail::S::U8,      true,  false, false, "uint8",   4, GL::RGBA8, GL::BGRA, GL::UNSIGNED_BYTE,                       DXGI_FORMAT_B8G8R8A8_TYPELESS,     DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,   DXGI_FORMAT_B8G8R8A8_UNORM),
+        DP_FORMAT(B8G8R8A8_TYPELESS,       4,    1, 4, Detail::S::U8,      true,  false, true,  "uint8",   4, 0, 0, 0,                                                          DXGI_FORMAT_B8G8R8A8_TYPELESS,     DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,   DXGI_FORMAT_B8G8R8A8_UNORM),
+        DP_FORMAT(B8G8R8A8_UNORM_SRGB,     4,    1, 4, Detail::S::U8,      true,  true,  false, "uint8",   4, GL::SRGB8_ALPHA8, GL::BGRA, GL::UNSIGNED_BYTE,                DXGI_FORMAT_B8G8R8A8_TYPELESS,     DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,   DXGI_FORMAT_B8G8R8A8_UNORM),
+        DP_FORMAT(BC7_TYPELESS,            16,   4, 4, Detail::S::None,    false, false, true,  nullptr,   0, 0, 0, 0,                                                          DXGI_FORMAT_BC7_TYPELESS,          DXGI_FORMAT_BC7_UNORM_SRGB,        DXGI_FORMAT_BC7_UNORM),
+        DP_FORMAT(BC7_UNORM,               16,   4, 4, Detail::S::None,    false, false, false, nullptr,   0, GL::COMPRESSED_RGBA_BPTC_UNORM, 0, 0,                            DXGI_FORMAT_BC7_TYPELESS,          DXGI_FORMAT_BC7_UNORM_SRGB,        DXGI_FORMAT_BC7_UNORM),
+        DP_FORMAT(BC7_UNORM_SRGB,          16,   4, 4, Detail::S::None,    false, true,  false, nullptr,   0, GL::COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 0, 0,                      DXGI_FORMAT_BC7_TYPELESS,          DXGI_FORMAT_BC7_UNORM_SRGB,        DXGI_FORMAT_BC7_UNORM),
+    };
+#undef DP_FORMAT
+
+    constexpr size_t kCount = sizeof(kTable) / sizeof(kTable[0]);
+
+    namespace Detail {
+        // DXGI_FORMAT value -> row of kTable + 1, with 0 for unknown formats.
+        constexpr uint32_t kIndexSize = 128;
+        struct Index { uint8_t row[kIndexSize]; };
+
+        constexpr Index make_index() {
+            Index index = {};
+            for (size_t i = 0; i < kCount; ++i) index.row[kTable[i].format] = (uint8_t)(i + 1);
+            return index;
+        }
+        inline constexpr Index kIndex = make_index();
+
+        // The constexpr helpers go through row numbers rather than pointers:
+        // some compilers (GCC with -fsanitize=null) refuse pointer tests in
+        // constant expressions.
+        constexpr uint32_t row_of(DXGI_FORMAT format) {
+            return (uint32_t)format < kIndexSize ? kIndex.row[(uint32_t)format] : 0;
+        }
+    }
+
+    constexpr const Traits* find(DXGI_FORMAT format) {
+        const uint32_t row = Detail::row_of(format);
+        return row ? &kTable[row - 1] : nullptr;
+    }
+
+    // Throws std::invalid_argument for formats the table does not list.
+    inline const Traits& traits(DXGI_FORMAT format) {
+        const Traits* t = find(format);
+        if (!t) throw std::invalid_argument("Unsupported DXGI_FORMAT " + std::to_string((int)format) + ".");
+        return *t;
+    }
+
+    // For code that knows its format at compile time, e.g. copy kernels
+    // specialised per format.
+    template <DXGI_FORMAT F>
+    struct Of {
+        static_assert(Detail::row_of(F) != 0, "DXGI_FORMAT missing from Formats::kTable");
+        static constexpr Traits value = kTable[Detail::row_of(F) - 1];
+    };
+
+    // Formats Convert decodes and encodes: typed, linear and uncompressed.
+    constexpr bool is_convertible(DXGI_FORMAT format) {
+        const uint32_t row = Detail::row_of(format);
+        if (!row) return false;
+        const Traits& t = kTable[row - 1];
+        return t.sample != Sample::None && !t.srgb && !t.typeless;
+    }
+
+    constexpr size_t bytes_per_pixel(DXGI_FORMAT format) {
+        const uint32_t row = Detail::row_of(format);
+        return row && kTable[row - 1].block_size == 1 ? kTable[row - 1].block_bytes : 0;
+    }
+
+    // Bytes in one tightly packed row of blocks, and rows of blocks in an
+    // image; 0 for unknown formats.
+    constexpr size_t row_pitch(DXGI_FORMAT format, uint32_t width) {
+        const uint32_t row = Detail::row_of(format);
+        if (!row) return 0;
+        const Traits& t = kTable[row - 1];
+        return (size_t)((width + t.block_size - 1) / t.block_size) * t.block_bytes;
+    }
+
+    constexpr uint32_t row_count(DXGI_FORMAT format, uint32_t height) {
+        const uint32_t row = Detail::row_of(format);
+        return row ? (height + kTable[row - 1].block_size - 1) / kTable[row - 1].block_size : 0;
+    }
+
+    constexpr size_t image_size(DXGI_FORMAT format, uint32_t width, uint32_t height) {
+        return row_pitch(format, width) * row_count(format, height);
+    }
+
+    // --- Compile-time checks over every row ---
+
+    namespace Detail {
+        constexpr bool same(const char* a, const char* b) {
+            if (!a || !b) return a == b;
+            while (*a && *a == *b) { ++a; ++b; }
+            return *a == *b;
+        }
+
+        constexpr uint32_t dtype_bytes(const char* dtype) {
+            return same(dtype, "uint8") ? 1 : same(dtype, "float16") ? 2 : same(dtype, "float32") || same(dtype, "uint32") ? 4 : 0;
+        }
+
+        constexpr uint32_t sample_bytes(Sample sample) {
+            return sample == Sample::U8 ? 1 : sample == Sample::F16 ? 2 : sample == Sample::F32 ? 4 : 0;
+        }
+
+        // A relative must exist, share the memory layout and agree on the family.
+        constexpr bool relative_ok(const Traits& t, DXGI_FORMAT other) {
+            if (other == kNone) return true;
+            if (!row_of(other)) return false;
+            const Traits& r = kTable[row_of(other) - 1];
+            return r.block_bytes == t.block_bytes && r.block_size == t.block_size && r.channels == t.channels &&
+                   r.sample == t.sample && r.bgra == t.bgra && r.typeless_format == t.typeless_format &&
+                   r.srgb_format == t.srgb_format && r.linear_format == t.linear_format;
+        }
+
+        constexpr bool row_ok(size_t i) {
+            const Traits& t = kTable[i];
+            if (row_of(t.format) != i + 1) return false;  // listed once
+            if (t.block_size == 1) {
+                const uint32_t packed = t.sample == Sample::RGB10A2 ? 4 : t.channels * sample_bytes(t.sample);
+                if (packed != t.block_bytes) return false;
+                if (!t.numpy_dtype || dtype_bytes(t.numpy_dtype) * t.numpy_channels != t.block_bytes) return false;
+            } else if (t.sample != Sample::None || t.numpy_dtype || t.gl_format || t.gl_type) {
+                return false;
+            }
+            if (t.bgra && t.channels != 4) return false;
+            if (t.srgb && t.srgb_format != t.format) return false;
+            if (!t.srgb && !t.typeless && t.linear_format != t.format) return false;
+            if (t.typeless != (t.typeless_format == t.format)) return false;
+            if (t.typeless == (t.gl_internal_format != 0)) return false;  // GL has no typeless views
+            if (!row_of(t.linear_format) || kTable[row_of(t.linear_format) - 1].srgb || kTable[row_of(t.linear_format) - 1].typeless) return false;
+            return relative_ok(t, t.typeless_format) && relative_ok(t, t.srgb_format) && relative_ok(t, t.linear_format);
+        }
+
+        constexpr bool table_ok() {
+            for (size_t i = 0; i < kCount; ++i) {
+                if ((uint32_t)kTable[i].format >= kIndexSize || !row_ok(i)) return false;
+            }
+            return true;
+        }
+    }
+
+    // The convertible format that reads back as `dtype` elements with the
+    // channels of `like`, keeping its channel order when the table has both;
+    // `like` itself when it already matches, UNKNOWN when nothing does.
+    constexpr DXGI_FORMAT with_numpy_dtype(DXGI_FORMAT like, const char* dtype) {
+        const uint32_t row = Detail::row_of(like);
+        if (!row || !dtype) return DXGI_FORMAT_UNKNOWN;
+        const Traits& l = kTable[row - 1];
+        if (Detail::same(l.numpy_dtype, dtype)) return like;
+        DXGI_FORMAT found = DXGI_FORMAT_UNKNOWN;
+        for (size_t i = 0; i < kCount; ++i) {
+            const Traits& t = kTable[i];
+            if (!is_convertible(t.format) || t.channels != l.channels || !Detail::same(t.numpy_dtype, dtype)) continue;
+            if (t.bgra == l.bgra) return t.format;
+            if (found == DXGI_FORMAT_UNKNOWN) found = t.format;
+        }
+        return found;
+    }
+
+    static_assert(Detail::table_ok(), "Formats::kTable is inconsistent");
+    static_assert(!Detail::row_of(DXGI_FORMAT_UNKNOWN) && !Detail::row_of((DXGI_FORMAT)127) && !Detail::row_of((DXGI_FORMAT)4096));
+    static_assert(row_pitch(DXGI_FORMAT_B8G8R8A8_UNORM, 1920) == 7680 && row_pitch(DXGI_FORMAT_R8_UNORM, 3) == 3);
+    static_assert(row_pitch(DXGI_FORMAT_BC1_UNORM, 5) == 16 && row_count(DXGI_FORMAT_BC7_UNORM, 5) == 2);
+    static_assert(image_size(DXGI_FORMAT_R32G32B32A32_FLOAT, 3, 2) == 96 && image_size(DXGI_FORMAT_BC3_UNORM, 8, 8) == 64);
+    static_assert(is_convertible(DXGI_FORMAT_R10G10B10A2_UNORM) && !is_convertible(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB) &&
+                  !is_convertible(DXGI_FORMAT_R8G8B8A8_TYPELESS) && !is_convertible(DXGI_FORMAT_BC7_UNORM));
+    static_assert(Of<DXGI_FORMAT_R16G16B16A16_FLOAT>::value.gl_internal_format == GL::RGBA16F);
+    static_assert(with_numpy_dtype(DXGI_FORMAT_R16G16B16A16_FLOAT, "float32") == DXGI_FORMAT_R32G32B32A32_FLOAT &&
+                  with_numpy_dtype(DXGI_FORMAT_B8G8R8A8_UNORM, "float16") == DXGI_FORMAT_R16G16B16A16_FLOAT &&
+                  with_numpy_dtype(DXGI_FORMAT_R16_FLOAT, "float32") == DXGI_FORMAT_R32_FLOAT &&
+                  with_numpy_dtype(DXGI_FORMAT_R8G8B8A8_UNORM, "uint8") == DXGI_FORMAT_R8G8B8A8_UNORM &&
+                  with_numpy_dtype(DXGI_FORMAT_R8G8_UNORM, "float32") == DXGI_FORMAT_UNKNOWN);
+
+}
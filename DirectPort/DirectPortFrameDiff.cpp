@@ -0,0 +1,447 @@
+// src/DirectPort/DirectPortFrameDiff.cpp
+// Tile signatures and change detection. A task hashes one row of tiles, so it
+// walks the frame top to bottom and keeps every tile's accumulators (64 bytes
+// each) hot while it does. The accumulate and scramble steps follow XXH3,
+// whose multiplies are 32 x 32 -> 64 and so vectorise on SSE2 and AVX2; the
+// final mix is XXH64's, which needs no 128-bit product. Values do not match
+// XXH3 itself, but they match between kernel sets.
+
+#include "DirectPortFrameDiff.h"
+#include "DirectPortConvert.h"
+#include "DirectPortCopy.h"
+#include "DirectPortDirtyRects.h"
+#include "DirectPortFormats.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include "DirectPortSimd.h"
+
+using namespace DirectPort;
+
+namespace {
+
+    constexpr uint64_t kPrime32_1 = 0x9E3779B1u;
+    constexpr uint64_t kPrime64_1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t kPrime64_3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t kPrime64_5 = 0x27D4EB2F165667C5ull;
+
+    constexpr size_t kStripeBytes = 64;
+    // Stripes between scrambles; stripe k of a block is keyed by kSecret[k..k+7].
+    constexpr uint32_t kBlockStripes = 16;
+    constexpr uint32_t kScrambleKey = kBlockStripes;
+
+    constexpr std::array<uint64_t, kBlockStripes + 8> make_secret() {
+        std::array<uint64_t, kBlockStripes + 8> s = {};
+        uint64_t x = 0x243F6A8885A308D3ull;  // splitmix64 from the digits of pi
+        for (auto& k : s) {
+            x += 0x9E3779B97F4A7C15ull;
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            k = z ^ (z >> 31);
+        }
+        return s;
+    }
+    constexpr std::array<uint64_t, kBlockStripes + 8> kSecret = make_secret();
+
+    constexpr uint64_t kInit[8] = { kPrime32_1 ^ 0xC2B2AE3Du, kPrime64_1, kPrime64_2, kPrime64_3,
+                                    kPrime64_4, 0x85EBCA77u, kPrime64_5, kPrime32_1 };
+
+    inline uint64_t read64(const uint8_t* p) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        return v;
+    }
+
+    inline uint64_t rotl64(uint64_t v, int r) {
+        return (v << r) | (v >> (64 - r));
+    }
+
+    inline uint64_t round64(uint64_t h, uint64_t v) {
+        h += v * kPrime64_2;
+        return rotl64(h, 31) * kPrime64_1;
+    }
+
+    inline uint64_t avalanche(uint64_t h) {
+        h ^= h >> 33;
+        h *= kPrime64_2;
+        h ^= h >> 29;
+        h *= kPrime64_3;
+        return h ^ (h >> 32);
+    }
+
+    void scramble(uint64_t acc[8]) {
+        for (int i = 0; i < 8; ++i) {
+            uint64_t a = acc[i];
+            a ^= a >> 47;
+            a ^= kSecret[kScrambleKey + i];
+            acc[i] = a * kPrime32_1;
+        }
+    }
+
+    uint64_t finish(const uint64_t acc[8], uint64_t bytes) {
+        uint64_t h = bytes * kPrime64_1;
+        for (int i = 0; i < 8; ++i) h = (h ^ round64(0, acc[i])) * kPrime64_1 + kPrime64_4;
+        return avalanche(h);
+    }
+
+    // --- Row kernels ---
+
+    // Folds `stripes` 64-byte stripes into acc; stripe i is keyed by
+    // (key + i) % kBlockStripes, and the accumulators are scrambled after the
+    // last stripe of every block.
+    using AccumulateFn = void (*)(uint64_t acc[8], const uint8_t* p, size_t stripes, uint32_t key);
+
+    void accumulate_scalar(uint64_t acc[8], const uint8_t* p, size_t stripes, uint32_t key) {
+        for (size_t s = 0; s < stripes; ++s, p += kStripeBytes) {
+            for (int i = 0; i < 8; ++i) {
+                const uint64_t v = read64(p + 8 * i);
+                const uint64_t k = v ^ kSecret[key + i];
+                acc[i ^ 1] += v;
+                acc[i] += (k & 0xFFFFFFFFu) * (k >> 32);
+            }
+            if (++key == kBlockStripes) {
+                scramble(acc);
+                key = 0;
+            }
+        }
+    }
+
+    // Sum of absolute differences of `bytes` bytes.
+    using SadFn = uint64_t (*)(const uint8_t* a, const uint8_t* b, size_t bytes);
+
+    uint64_t sad_scalar(const uint8_t* a, const uint8_t* b, size_t bytes) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < bytes; ++i) sum += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+        return sum;
+    }
+
+#if DP_SIMD_X86
+    DP_TARGET("sse4.1")
+    inline void scramble_sse(__m128i acc[4], const uint64_t* key) {
+        const __m128i prime = _mm_set1_epi32((int)kPrime32_1);
+        for (int i = 0; i < 4; ++i) {
+            __m128i a = _mm_xor_si128(acc[i], _mm_srli_epi64(acc[i], 47));
+            a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(key + 2 * i)));
+            const __m128i lo = _mm_mul_epu32(a, prime);
+            const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+            acc[i] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+        }
+    }
+
+    DP_TARGET("sse4.1")
+    void accumulate_sse41(uint64_t acc[8], const uint8_t* p, size_t stripes, uint32_t key) {
+        __m128i a[4];
+        for (int i = 0; i < 4; ++i) a[i] = _mm_loadu_si128((const __m128i*)(acc + 2 * i));
+        for (size_t s = 0; s < stripes; ++s, p += kStripeBytes) {
+            for (int i = 0; i < 4; ++i) {
+                const __m128i v = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+                const __m128i k = _mm_xor_si128(v, _mm_loadu_si128((const __m128i*)(kSecret.data() + key + 2 * i)));
+                const __m128i product = _mm_mul_epu32(k, _mm_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+                a[i] = _mm_add_epi64(_mm_add_epi64(a[i], _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2))), product);
+            }
+            if (++key == kBlockStripes) {
+                scramble_sse(a, kSecret.data() + kScrambleKey);
+                key = 0;
+            }
+        }
+        for (int i = 0; i < 4; ++i) _mm_storeu_si128((__m128i*)(acc + 2 * i), a[i]);
+    }
+
+    DP_TARGET("sse4.1")
+    uint64_t sad_sse41(const uint8_t* a, const uint8_t* b, size_t bytes) {
+        __m128i sum = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= bytes; i += 16) {
+            sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i))));
+        }
+        return (uint64_t)_mm_cvtsi128_si64(sum) + (uint64_t)_mm_extract_epi64(sum, 1) + sad_scalar(a + i, b + i, bytes - i);
+    }
+
+    // One stripe is two vectors; the accumulators stay in registers across a
+    // tile row and the secret is loaded unaligned at each stripe's key.
+    DP_TARGET("avx2")
+    void accumulate_avx2(uint64_t acc[8], const uint8_t* p, size_t stripes, uint32_t key) {
+        const __m256i prime = _mm256_set1_epi32((int)kPrime32_1);
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+        for (size_t s = 0; s < stripes; ++s, p += kStripeBytes) {
+            const __m256i v0 = _mm256_loadu_si256((const __m256i*)p);
+            const __m256i v1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+            const __m256i k0 = _mm256_xor_si256(v0, _mm256_loadu_si256((const __m256i*)(kSecret.data() + key)));
+            const __m256i k1 = _mm256_xor_si256(v1, _mm256_loadu_si256((const __m256i*)(kSecret.data() + key + 4)));
+            a0 = _mm256_add_epi64(_mm256_add_epi64(a0, _mm256_shuffle_epi32(v0, _MM_SHUFFLE(1, 0, 3, 2))),
+                                  _mm256_mul_epu32(k0, _mm256_shuffle_epi32(k0, _MM_SHUFFLE(0, 3, 0, 1))));
+            a1 = _mm256_add_epi64(_mm256_add_epi64(a1, _mm256_shuffle_epi32(v1, _MM_SHUFFLE(1, 0, 3, 2))),
+                                  _mm256_mul_epu32(k1, _mm256_shuffle_epi32(k1, _MM_SHUFFLE(0, 3, 0, 1))));
+            if (++key == kBlockStripes) {
+                __m256i* both[2] = { &a0, &a1 };
+                for (int i = 0; i < 2; ++i) {
+                    __m256i x = _mm256_xor_si256(*both[i], _mm256_srli_epi64(*both[i], 47));
+                    x = _mm256_xor_si256(x, _mm256_loadu_si256((const __m256i*)(kSecret.data() + kScrambleKey + 4 * i)));
+                    const __m256i lo = _mm256_mul_epu32(x, prime);
+                    const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), prime);
+                    *both[i] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+                }
+                key = 0;
+            }
+        }
+        _mm256_storeu_si256((__m256i*)acc, a0);
+        _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+    }
+
+    DP_TARGET("avx2")
+    uint64_t sad_avx2(const uint8_t* a, const uint8_t* b, size_t bytes) {
+        __m256i sum = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 32 <= bytes; i += 32) {
+            sum = _mm256_add_epi64(sum, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i))));
+        }
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256((__m256i*)lanes, sum);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sad_sse41(a + i, b + i, bytes - i);
+    }
+#endif
+
+    struct Kernels {
+        AccumulateFn accumulate;
+        SadFn sad;
+    };
+
+    const Kernels kScalar = { accumulate_scalar, sad_scalar };
+#if DP_SIMD_X86
+    const Kernels kSSE41 = { accumulate_sse41, sad_sse41 };
+    const Kernels kAVX2 = { accumulate_avx2, sad_avx2 };
+#endif
+
+    const Kernels& kernels() {
+#if DP_SIMD_X86
+        const Convert::Isa isa = Convert::active_isa();
+        if (isa >= Convert::Isa::AVX2) return kAVX2;
+        if (isa >= Convert::Isa::SSE41) return kSSE41;
+#endif
+        return kScalar;
+    }
+
+    // --- Tiles ---
+
+    struct Grid {
+        uint32_t tiles_x;
+        uint32_t tiles_y;
+    };
+
+    Grid grid_of(uint32_t width, uint32_t height, uint32_t tile_size) {
+        return { (width + tile_size - 1) / tile_size, (height + tile_size - 1) / tile_size };
+    }
+
+    // Hashes tile row ty into tiles[ty * tiles_x ...].
+    void hash_tile_row(const uint8_t* pixels, size_t pitch, uint32_t width, uint32_t height, size_t bpp,
+                       uint32_t tile_size, uint32_t ty, uint32_t tiles_x, uint64_t* tiles) {
+        const AccumulateFn accumulate = kernels().accumulate;
+        std::vector<uint64_t> acc((size_t)tiles_x * 8);
+        for (uint32_t tx = 0; tx < tiles_x; ++tx) std::copy(kInit, kInit + 8, acc.begin() + (size_t)tx * 8);
+
+        const uint32_t y0 = ty * tile_size, y1 = std::min(height, y0 + tile_size);
+        for (uint32_t y = y0; y < y1; ++y) {
+            const uint8_t* row = pixels + (size_t)y * pitch;
+            for (uint32_t tx = 0; tx < tiles_x; ++tx) {
+                const size_t x0 = (size_t)tx * tile_size;
+                const size_t bytes = (std::min<size_t>(width, x0 + tile_size) - x0) * bpp;
+                const uint8_t* p = row + x0 * bpp;
+                uint64_t* a = acc.data() + (size_t)tx * 8;
+                const size_t stripes = bytes / kStripeBytes;
+                accumulate(a, p, stripes, 0);
+                if (bytes % kStripeBytes) {
+                    // Both frames of a comparison share the grid, so zero padding is unambiguous.
+                    uint8_t tail[kStripeBytes] = {};
+                    memcpy(tail, p + stripes * kStripeBytes, bytes % kStripeBytes);
+                    accumulate(a, tail, 1, (uint32_t)(stripes % kBlockStripes));
+                }
+                scramble(a);
+            }
+        }
+        for (uint32_t tx = 0; tx < tiles_x; ++tx) {
+            const size_t x0 = (size_t)tx * tile_size;
+            const uint64_t bytes = (uint64_t)(std::min<size_t>(width, x0 + tile_size) - x0) * bpp * (y1 - y0);
+            tiles[(size_t)ty * tiles_x + tx] = finish(acc.data() + (size_t)tx * 8, bytes);
+        }
+    }
+
+    uint64_t frame_hash_of(const FrameDiff::Signature& s) {
+        uint64_t h = ((uint64_t)s.width << 32 | s.height) * kPrime64_5;
+        for (uint64_t t : s.tiles) h = rotl64(h ^ round64(0, t), 27) * kPrime64_1 + kPrime64_4;
+        return avalanche(h);
+    }
+
+}
+
+FrameDiff::Signature FrameDiff::signature(const void* pixels, size_t pitch, uint32_t width, uint32_t height, size_t bytes_per_pixel,
+                                          uint32_t tile_size, Scheduler& scheduler) {
+    if (tile_size == 0 || bytes_per_pixel == 0) {
+        throw std::invalid_argument("FrameDiff::signature: tile_size and bytes_per_pixel must be non-zero.");
+    }
+    Signature s;
+    s.width = width;
+    s.height = height;
+    s.tile_size = tile_size;
+    if (width == 0 || height == 0) {
+        s.frame_hash = frame_hash_of(s);
+        return s;
+    }
+    const Grid g = grid_of(width, height, tile_size);
+    s.tiles_x = g.tiles_x;
+    s.tiles_y = g.tiles_y;
+    s.tiles.resize((size_t)g.tiles_x * g.tiles_y);
+    const auto* p = static_cast<const uint8_t*>(pixels);
+    scheduler.parallel_for(g.tiles_y, [&](uint32_t ty) {
+        hash_tile_row(p, pitch, width, height, bytes_per_pixel, tile_size, ty, g.tiles_x, s.tiles.data());
+    });
+    s.frame_hash = frame_hash_of(s);
+    return s;
+}
+
+FrameDiff::Result FrameDiff::compare(const Signature& previous, const Signature& current) {
+    Result r;
+    r.width = current.width;
+    r.height = current.height;
+    r.tile_size = current.tile_size;
+    r.tiles_x = current.tiles_x;
+    r.tiles_y = current.tiles_y;
+    r.changed.assign(current.tiles.size(), 1);
+    const bool same_grid = previous.width == current.width && previous.height == current.height &&
+                           previous.tile_size == current.tile_size && previous.tiles.size() == current.tiles.size();
+    if (!same_grid) {
+        r.changed_tiles = (uint32_t)current.tiles.size();
+        return r;
+    }
+    for (size_t i = 0; i < current.tiles.size(); ++i) {
+        r.changed[i] = previous.tiles[i] != current.tiles[i];
+        r.changed_tiles += r.changed[i];
+    }
+    return r;
+}
+
+std::vector<DirtyRect> FrameDiff::changed_rects(const Result& result) {
+    std::vector<DirtyRect> tiles;
+    for (uint32_t ty = 0; ty < result.tiles_y; ++ty) {
+        for (uint32_t tx = 0; tx < result.tiles_x; ++tx) {
+            if (result.changed[(size_t)ty * result.tiles_x + tx]) {
+                tiles.push_back({ tx * result.tile_size, ty * result.tile_size, result.tile_size, result.tile_size });
+            }
+        }
+    }
+    if (tiles.empty()) return tiles;
+    return DirtyRects::snap_to_tiles(tiles, result.tile_size, result.width, result.height);
+}
+
+// --- Detector ---
+
+struct FrameDiff::Detector::Impl {
+    uint32_t tile_size;
+    float threshold;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    Signature reference;
+    // Packed copy of the reference frame, kept only when threshold > 0.
+    std::vector<uint8_t> pixels;
+    uint64_t frames = 0;
+    uint64_t unchanged_frames = 0;
+};
+
+FrameDiff::Detector::Detector(uint32_t tile_size, float threshold) : pImpl(std::make_unique<Impl>()) {
+    if (tile_size == 0) {
+        throw std::invalid_argument("FrameDiff::Detector: tile_size must be non-zero.");
+    }
+    if (!(threshold >= 0.0f)) {
+        throw std::invalid_argument("FrameDiff::Detector: threshold must be non-negative.");
+    }
+    pImpl->tile_size = tile_size;
+    pImpl->threshold = threshold;
+}
+
+FrameDiff::Detector::~Detector() = default;
+
+FrameDiff::Result FrameDiff::Detector::update(DXGI_FORMAT format, const void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                                              Scheduler& scheduler) {
+    const size_t bpp = Formats::bytes_per_pixel(format);
+    if (bpp == 0) {
+        throw std::invalid_argument("FrameDiff::Detector::update: unsupported format.");
+    }
+    const bool thresholded = pImpl->threshold > 0.0f;
+    if (thresholded && Formats::traits(format).sample != Formats::Sample::U8) {
+        throw std::invalid_argument("FrameDiff::Detector::update: a threshold needs an 8-bit format.");
+    }
+    Signature current = signature(pixels, pitch, width, height, bpp, pImpl->tile_size, scheduler);
+    if (format != pImpl->format) pImpl->reference = Signature();
+    const Signature& reference = pImpl->reference;
+    const bool same_grid = !reference.tiles.empty() && reference.width == width && reference.height == height;
+    Result r = compare(reference, current);
+    const size_t packed_pitch = (size_t)width * bpp;
+    const auto* src = static_cast<const uint8_t*>(pixels);
+
+    if (thresholded && same_grid && r.changed_tiles != 0) {
+        // Confirm each hash change against the reference pixels, and move the
+        // reference forward only for the tiles that are reported.
+        const SadFn sad = kernels().sad;
+        const double limit = pImpl->threshold;
+        const uint32_t ts = pImpl->tile_size;
+        uint8_t* ref = pImpl->pixels.data();
+        scheduler.parallel_for(r.tiles_y, [&](uint32_t ty) {
+            const uint32_t y0 = ty * ts, y1 = std::min(height, y0 + ts);
+            for (uint32_t tx = 0; tx < r.tiles_x; ++tx) {
+                const size_t i = (size_t)ty * r.tiles_x + tx;
+                if (!r.changed[i]) continue;
+                const size_t x0 = (size_t)tx * ts * bpp;
+                const size_t bytes = (std::min<size_t>(width, (size_t)tx * ts + ts) - (size_t)tx * ts) * bpp;
+                uint64_t total = 0;
+                for (uint32_t y = y0; y < y1; ++y) total += sad(src + (size_t)y * pitch + x0, ref + (size_t)y * packed_pitch + x0, bytes);
+                if ((double)total > limit * (double)bytes * (y1 - y0)) {
+                    for (uint32_t y = y0; y < y1; ++y) memcpy(ref + (size_t)y * packed_pitch + x0, src + (size_t)y * pitch + x0, bytes);
+                    pImpl->reference.tiles[i] = current.tiles[i];
+                } else {
+                    r.changed[i] = 0;
+                }
+            }
+        });
+        r.changed_tiles = (uint32_t)std::count(r.changed.begin(), r.changed.end(), (uint8_t)1);
+        pImpl->reference.frame_hash = frame_hash_of(pImpl->reference);
+    } else if (r.changed_tiles != 0) {
+        pImpl->reference = std::move(current);
+        if (thresholded) {
+            pImpl->pixels.resize(packed_pitch * height);
+            Copy::copy_rows(pImpl->pixels.data(), packed_pitch, pixels, pitch, packed_pitch, height, scheduler);
+        }
+    }
+    pImpl->format = format;
+    ++pImpl->frames;
+    if (r.unchanged()) ++pImpl->unchanged_frames;
+    return r;
+}
+
+void FrameDiff::Detector::reset() {
+    pImpl->format = DXGI_FORMAT_UNKNOWN;
+    pImpl->reference = Signature();
+    pImpl->pixels.clear();
+    pImpl->pixels.shrink_to_fit();
+    pImpl->frames = 0;
+    pImpl->unchanged_frames = 0;
+}
+
+uint32_t FrameDiff::Detector::tile_size() const {
+    return pImpl->tile_size;
+}
+
+float FrameDiff::Detector::threshold() const {
+    return pImpl->threshold;
+}
+
+uint64_t FrameDiff::Detector::frames() const {
+    return pImpl->frames;
+}
+
+uint64_t FrameDiff::Detector::unchanged_frames() const {
+    return pImpl->unchanged_frames;
+}
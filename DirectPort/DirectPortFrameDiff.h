@@ -0,0 +1,85 @@
+// DirectPortFrameDiff.h
+#pragma once
+
+#include "DirectPort.h"
+#include "DirectPortScheduler.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DirectPort::FrameDiff {
+
+    constexpr uint32_t kDefaultTileSize = 64;
+
+    // A 64-bit hash of every tile_size x tile_size tile of a frame, row-major,
+    // with edge tiles clipped to the frame. Tiles are hashed XXH3-style: eight
+    // 64-bit lanes take 64-byte stripes of each tile row, keyed by position, and
+    // are scrambled at the end of every row, so moved or reordered content
+    // changes the hash. Every kernel set computes the same values, so
+    // signatures can be stored and compared across processes.
+    struct Signature {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t tile_size = 0;
+        uint32_t tiles_x = 0;
+        uint32_t tiles_y = 0;
+        uint64_t frame_hash = 0;
+        std::vector<uint64_t> tiles;
+    };
+
+    Signature signature(const void* pixels, size_t pitch, uint32_t width, uint32_t height, size_t bytes_per_pixel,
+                        uint32_t tile_size = kDefaultTileSize, Scheduler& scheduler = Scheduler::shared());
+
+    // Which tiles changed between two frames; changed[ty * tiles_x + tx] is 1
+    // for a changed tile.
+    struct Result {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t tile_size = 0;
+        uint32_t tiles_x = 0;
+        uint32_t tiles_y = 0;
+        uint32_t changed_tiles = 0;
+        std::vector<uint8_t> changed;
+
+        bool unchanged() const { return changed_tiles == 0; }
+    };
+
+    // Every tile counts as changed when the two grids differ in size.
+    Result compare(const Signature& previous, const Signature& current);
+
+    // The changed tiles as rects, clipped to the frame, with runs of tiles
+    // joined the way DirtyRects::snap_to_tiles joins them.
+    std::vector<DirtyRect> changed_rects(const Result& result);
+
+    // Tracks one stream. update() hashes the new frame and reports the tiles
+    // that differ from the reference; the first frame, and any change of size
+    // or format, reports every tile.
+    //
+    // With threshold > 0 (8-bit formats only) a tile whose hash changed is
+    // only reported when the mean absolute difference of its bytes from the
+    // reference exceeds threshold, in 0..255 code values, which absorbs
+    // sensor noise and encoder flicker. A tile that is not reported keeps its
+    // reference, so slow drift still shows once it adds up. This keeps a copy
+    // of the reference frame; threshold == 0 keeps only the signature.
+    class Detector {
+    public:
+        explicit Detector(uint32_t tile_size = kDefaultTileSize, float threshold = 0.0f);
+        ~Detector();
+
+        Result update(DXGI_FORMAT format, const void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                      Scheduler& scheduler = Scheduler::shared());
+        void reset();
+
+        uint32_t tile_size() const;
+        float threshold() const;
+        uint64_t frames() const;
+        // Frames update() reported with no changed tile.
+        uint64_t unchanged_frames() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+}
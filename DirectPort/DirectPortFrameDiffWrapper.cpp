@@ -0,0 +1,100 @@
+#include "DirectPortFrameDiff.h"
+#include "DirectPortFormats.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <algorithm>
+#include <string>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    struct Frame {
+        const uint8_t* data;
+        size_t pitch;
+        size_t pixel_bytes;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // A 2D or 3D array with packed pixels; the rows may be strided.
+    Frame frame_of(const char* what, const py::array& pixels) {
+        py::buffer_info info = pixels.request();
+        const size_t channels = info.ndim == 3 ? (size_t)info.shape[2] : 1;
+        const bool packed = (info.ndim == 2 || info.strides[2] == info.itemsize) &&
+                            info.strides[1] == (py::ssize_t)(channels * info.itemsize);
+        if ((info.ndim != 2 && info.ndim != 3) || !packed || info.strides[0] < info.shape[1] * info.strides[1]) {
+            throw py::value_error(std::string(what) + ": pixels must be a 2D or 3D array with packed rows.");
+        }
+        return { static_cast<const uint8_t*>(info.ptr), (size_t)info.strides[0], channels * info.itemsize,
+                 (uint32_t)info.shape[1], (uint32_t)info.shape[0] };
+    }
+
+    template <typename T>
+    py::array_t<T> tile_grid(const std::vector<T>& values, uint32_t tiles_x, uint32_t tiles_y) {
+        py::array_t<T> out({ (py::ssize_t)tiles_y, (py::ssize_t)tiles_x });
+        std::copy(values.begin(), values.end(), out.mutable_data());
+        return out;
+    }
+
+}
+
+void bind_frame_diff(py::module_& m) {
+    m.attr("FRAME_DIFF_DEFAULT_TILE_SIZE") = FrameDiff::kDefaultTileSize;
+
+    py::class_<FrameDiff::Signature>(m, "FrameSignature", "A 64-bit hash per tile of one frame.")
+        .def_readonly("width", &FrameDiff::Signature::width)
+        .def_readonly("height", &FrameDiff::Signature::height)
+        .def_readonly("tile_size", &FrameDiff::Signature::tile_size)
+        .def_readonly("tiles_x", &FrameDiff::Signature::tiles_x)
+        .def_readonly("tiles_y", &FrameDiff::Signature::tiles_y)
+        .def_readonly("frame_hash", &FrameDiff::Signature::frame_hash)
+        .def_property_readonly("tiles", [](const FrameDiff::Signature& s) {
+            return tile_grid(s.tiles, s.tiles_x, s.tiles_y);
+        }, "(tiles_y, tiles_x) uint64 hashes.");
+
+    py::class_<FrameDiff::Result>(m, "FrameDiffResult", "The tiles that changed between two frames.")
+        .def_readonly("width", &FrameDiff::Result::width)
+        .def_readonly("height", &FrameDiff::Result::height)
+        .def_readonly("tile_size", &FrameDiff::Result::tile_size)
+        .def_readonly("tiles_x", &FrameDiff::Result::tiles_x)
+        .def_readonly("tiles_y", &FrameDiff::Result::tiles_y)
+        .def_readonly("changed_tiles", &FrameDiff::Result::changed_tiles)
+        .def_property_readonly("unchanged", &FrameDiff::Result::unchanged)
+        .def_property_readonly("changed", [](const FrameDiff::Result& r) {
+            return tile_grid(r.changed, r.tiles_x, r.tiles_y).attr("astype")("bool");
+        }, "(tiles_y, tiles_x) bool map of changed tiles.")
+        .def("rects", &FrameDiff::changed_rects, "The changed tiles as DirtyRects, runs joined.")
+        .def("__repr__", [](const FrameDiff::Result& r) {
+            return "<FrameDiffResult " + std::to_string(r.changed_tiles) + " of " +
+                   std::to_string((size_t)r.tiles_x * r.tiles_y) + " tiles changed>";
+        });
+
+    py::class_<FrameDiff::Detector>(m, "FrameDiffDetector",
+        "Tracks one stream and reports which tiles of each new frame changed.")
+        .def(py::init<uint32_t, float>(), py::arg("tile_size") = FrameDiff::kDefaultTileSize, py::arg("threshold") = 0.0f,
+             "threshold > 0 (8-bit formats) ignores tiles whose mean absolute byte difference stays at or below it.")
+        .def("update", [](FrameDiff::Detector& detector, const py::array& pixels, DXGI_FORMAT format) {
+            const Frame f = frame_of("FrameDiffDetector.update", pixels);
+            if (f.pixel_bytes != Formats::bytes_per_pixel(format)) {
+                throw py::value_error("FrameDiffDetector.update: pixel size does not match the format.");
+            }
+            py::gil_scoped_release release;
+            return detector.update(format, f.data, f.pitch, f.width, f.height);
+        }, py::arg("pixels"), py::arg("format"))
+        .def("reset", &FrameDiff::Detector::reset, "")
+        .def_property_readonly("tile_size", &FrameDiff::Detector::tile_size)
+        .def_property_readonly("threshold", &FrameDiff::Detector::threshold)
+        .def_property_readonly("frames", &FrameDiff::Detector::frames)
+        .def_property_readonly("unchanged_frames", &FrameDiff::Detector::unchanged_frames);
+
+    m.def("frame_signature", [](const py::array& pixels, uint32_t tile_size) {
+        const Frame f = frame_of("frame_signature", pixels);
+        py::gil_scoped_release release;
+        return FrameDiff::signature(f.data, f.pitch, f.width, f.height, f.pixel_bytes, tile_size);
+    }, py::arg("pixels"), py::arg("tile_size") = FrameDiff::kDefaultTileSize,
+       "Hashes every tile of a (height, width[, channels]) array. Rows may be strided.");
+    m.def("compare_frame_signatures", &FrameDiff::compare, py::arg("previous"), py::arg("current"), "");
+}
@@ -0,0 +1,366 @@
+// src/DirectPort/DirectPortFrameGraph.cpp
+
+#include "DirectPortFrameGraph.h"
+#include <stdexcept>
+#include <algorithm>
+
+using namespace DirectPort;
+
+namespace {
+    bool same_desc(const FrameGraph::TextureDesc& a, const FrameGraph::TextureDesc& b) {
+        return a.width == b.width && a.height == b.height && a.format == b.format;
+    }
+}
+
+struct FrameGraph::Impl {
+    struct Resource {
+        std::string name;
+        TextureDesc desc;
+        bool imported = false;
+        bool output = false;
+        std::shared_ptr<Texture> texture;
+    };
+
+    struct Pass {
+        std::string name;
+        PassType type;
+        ResourceId output;
+        std::vector<ResourceId> inputs;
+        std::vector<uint8_t> shader_bytes;
+        std::string entry_point;
+        std::vector<uint8_t> constants;
+        uint32_t x = 0, y = 0, width = 0, height = 0;
+        uint32_t source_index = 0;
+    };
+
+    std::shared_ptr<IDirectXDevice> device;
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+
+    bool compiled = false;
+    std::vector<Pass> schedule;
+    std::vector<CompiledPass> compiledPasses;
+    std::vector<int> slotOf;
+    std::vector<TextureDesc> slotDescs;
+    std::vector<std::shared_ptr<Texture>> slotTextures;
+    CompileStats stats;
+
+    void check_id(ResourceId id, const char* what) const {
+        if (id >= resources.size()) {
+            throw std::invalid_argument(std::string("FrameGraph::") + what + ": unknown resource id " + std::to_string(id) + ".");
+        }
+    }
+
+    const std::string& label(ResourceId id) const { return resources[id].name; }
+
+    // Walks the recorded passes backwards from the marked outputs. A full write
+    // (shader, copy) satisfies every later reader, so earlier writers of that
+    // resource are dead; a blit only touches a region and keeps them alive.
+    std::vector<bool> find_live_passes() const {
+        std::vector<bool> needed(resources.size(), false);
+        for (size_t r = 0; r < resources.size(); ++r) needed[r] = resources[r].output;
+
+        std::vector<bool> live(passes.size(), false);
+        for (size_t i = passes.size(); i-- > 0;) {
+            const Pass& p = passes[i];
+            if (!needed[p.output]) continue;
+            live[i] = true;
+            if (p.type != PassType::Blit) needed[p.output] = false;
+            for (ResourceId in : p.inputs) needed[in] = true;
+        }
+        return live;
+    }
+
+    // Folds "X = pass(...); D = copy(X)" into "D = pass(...)" when X is a
+    // transient nobody else reads. Chains of copies collapse one link per sweep.
+    uint32_t merge_copies(std::vector<Pass>& live) const {
+        uint32_t merged = 0;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t j = 0; j < live.size() && !changed; ++j) {
+                const Pass& copy = live[j];
+                if (copy.type != PassType::Copy) continue;
+                const ResourceId src = copy.inputs[0];
+                const ResourceId dst = copy.output;
+                if (resources[src].imported || resources[src].output) continue;
+
+                int writer = -1, writes = 0, reads = 0;
+                for (size_t i = 0; i < live.size(); ++i) {
+                    if (live[i].output == src) { writes++; writer = (int)i; }
+                    reads += (int)std::count(live[i].inputs.begin(), live[i].inputs.end(), src);
+                }
+                if (writes != 1 || reads != 1 || writer > (int)j) continue;
+                const Pass& producer = live[writer];
+                if (producer.type == PassType::Blit) continue;
+                if (std::find(producer.inputs.begin(), producer.inputs.end(), dst) != producer.inputs.end()) continue;
+
+                // Moving the write of dst earlier is only safe if nothing in between touches dst.
+                bool touched = false;
+                for (size_t k = writer + 1; k < j && !touched; ++k) {
+                    touched = live[k].output == dst ||
+                              std::find(live[k].inputs.begin(), live[k].inputs.end(), dst) != live[k].inputs.end();
+                }
+                if (touched) continue;
+
+                live[writer].output = dst;
+                live.erase(live.begin() + j);
+                merged++;
+                changed = true;
+            }
+        }
+        return merged;
+    }
+
+    // Greedy interval packing: each transient takes the first slot of matching
+    // size and format whose previous occupant was last used before it starts.
+    // Marked outputs are read after execute(), so they stay live to the end.
+    void alias_transients() {
+        slotOf.assign(resources.size(), -1);
+        std::vector<int> first(resources.size(), -1), last(resources.size(), -1);
+        for (size_t i = 0; i < schedule.size(); ++i) {
+            auto touch = [&](ResourceId r) {
+                if (first[r] < 0) first[r] = (int)i;
+                last[r] = (int)i;
+            };
+            touch(schedule[i].output);
+            for (ResourceId in : schedule[i].inputs) touch(in);
+        }
+        for (ResourceId r = 0; r < resources.size(); ++r) {
+            if (resources[r].output && first[r] >= 0) last[r] = (int)schedule.size();
+        }
+
+        std::vector<ResourceId> transients;
+        for (ResourceId r = 0; r < resources.size(); ++r) {
+            if (!resources[r].imported && first[r] >= 0) transients.push_back(r);
+        }
+        std::sort(transients.begin(), transients.end(), [&](ResourceId a, ResourceId b) { return first[a] < first[b]; });
+
+        std::vector<TextureDesc> descs;
+        std::vector<int> busyUntil;
+        for (ResourceId r : transients) {
+            int slot = -1;
+            for (size_t s = 0; s < descs.size(); ++s) {
+                if (busyUntil[s] < first[r] && same_desc(descs[s], resources[r].desc)) { slot = (int)s; break; }
+            }
+            if (slot < 0) {
+                slot = (int)descs.size();
+                descs.push_back(resources[r].desc);
+                busyUntil.push_back(-1);
+            }
+            busyUntil[slot] = last[r];
+            slotOf[r] = slot;
+        }
+
+        slotDescs = descs;
+        stats.transient_textures = (uint32_t)transients.size();
+        stats.physical_textures = (uint32_t)descs.size();
+    }
+
+    std::shared_ptr<Texture> resolve(ResourceId id) const {
+        if (resources[id].imported) return resources[id].texture;
+        return slotOf[id] < 0 ? nullptr : slotTextures[slotOf[id]];
+    }
+};
+
+FrameGraph::FrameGraph(std::shared_ptr<IDirectXDevice> device) : pImpl(std::make_unique<Impl>()) {
+    pImpl->device = std::move(device);
+}
+
+FrameGraph::~FrameGraph() = default;
+
+FrameGraph::ResourceId FrameGraph::import_texture(std::shared_ptr<Texture> texture, const std::string& name) {
+    if (!texture) {
+        throw std::invalid_argument("FrameGraph::import_texture: texture is null.");
+    }
+    Impl::Resource r;
+    r.name = name.empty() ? "import" + std::to_string(pImpl->resources.size()) : name;
+    r.desc = { texture->get_width(), texture->get_height(), texture->get_format() };
+    r.imported = true;
+    r.texture = std::move(texture);
+    pImpl->resources.push_back(std::move(r));
+    pImpl->compiled = false;
+    return (ResourceId)(pImpl->resources.size() - 1);
+}
+
+FrameGraph::ResourceId FrameGraph::create_texture(const TextureDesc& desc, const std::string& name) {
+    if (desc.width == 0 || desc.height == 0 || desc.format == DXGI_FORMAT_UNKNOWN) {
+        throw std::invalid_argument("FrameGraph::create_texture requires non-zero dimensions and a known format.");
+    }
+    Impl::Resource r;
+    r.name = name.empty() ? "transient" + std::to_string(pImpl->resources.size()) : name;
+    r.desc = desc;
+    pImpl->resources.push_back(std::move(r));
+    pImpl->compiled = false;
+    return (ResourceId)(pImpl->resources.size() - 1);
+}
+
+void FrameGraph::set_imported_texture(ResourceId id, std::shared_ptr<Texture> texture) {
+    pImpl->check_id(id, "set_imported_texture");
+    auto& r = pImpl->resources[id];
+    if (!r.imported || !texture) {
+        throw std::invalid_argument("FrameGraph::set_imported_texture: '" + r.name + "' is not an imported resource or texture is null.");
+    }
+    TextureDesc desc = { texture->get_width(), texture->get_height(), texture->get_format() };
+    if (!same_desc(desc, r.desc)) {
+        r.desc = desc;
+        pImpl->compiled = false;
+    }
+    r.texture = std::move(texture);
+}
+
+void FrameGraph::add_shader_pass(const std::string& name, ResourceId output, const std::vector<uint8_t>& shader_bytes, const std::string& entry_point,
+                                 const std::vector<ResourceId>& inputs, const std::vector<uint8_t>& constants) {
+    pImpl->check_id(output, "add_shader_pass");
+    for (ResourceId in : inputs) {
+        pImpl->check_id(in, "add_shader_pass");
+        if (in == output) {
+            throw std::invalid_argument("FrameGraph::add_shader_pass: pass '" + name + "' reads and writes '" + pImpl->label(in) + "'.");
+        }
+    }
+    Impl::Pass p;
+    p.name = name;
+    p.type = PassType::Shader;
+    p.output = output;
+    p.inputs = inputs;
+    p.shader_bytes = shader_bytes;
+    p.entry_point = entry_point;
+    p.constants = constants;
+    p.source_index = (uint32_t)pImpl->passes.size();
+    pImpl->passes.push_back(std::move(p));
+    pImpl->compiled = false;
+}
+
+void FrameGraph::add_copy_pass(const std::string& name, ResourceId source, ResourceId destination) {
+    pImpl->check_id(source, "add_copy_pass");
+    pImpl->check_id(destination, "add_copy_pass");
+    if (!same_desc(pImpl->resources[source].desc, pImpl->resources[destination].desc)) {
+        throw std::invalid_argument("FrameGraph::add_copy_pass: '" + pImpl->label(source) + "' and '" + pImpl->label(destination) +
+                                    "' must have matching dimensions and format.");
+    }
+    if (source == destination) return;
+    Impl::Pass p;
+    p.name = name;
+    p.type = PassType::Copy;
+    p.output = destination;
+    p.inputs = { source };
+    p.source_index = (uint32_t)pImpl->passes.size();
+    pImpl->passes.push_back(std::move(p));
+    pImpl->compiled = false;
+}
+
+void FrameGraph::add_blit_pass(const std::string& name, ResourceId source, ResourceId destination,
+                               uint32_t dest_x, uint32_t dest_y, uint32_t dest_width, uint32_t dest_height) {
+    pImpl->check_id(source, "add_blit_pass");
+    pImpl->check_id(destination, "add_blit_pass");
+    if (source == destination) {
+        throw std::invalid_argument("FrameGraph::add_blit_pass: pass '" + name + "' reads and writes '" + pImpl->label(source) + "'.");
+    }
+    Impl::Pass p;
+    p.name = name;
+    p.type = PassType::Blit;
+    p.output = destination;
+    p.inputs = { source };
+    p.x = dest_x; p.y = dest_y; p.width = dest_width; p.height = dest_height;
+    p.source_index = (uint32_t)pImpl->passes.size();
+    pImpl->passes.push_back(std::move(p));
+    pImpl->compiled = false;
+}
+
+void FrameGraph::mark_output(ResourceId id) {
+    pImpl->check_id(id, "mark_output");
+    pImpl->resources[id].output = true;
+    pImpl->compiled = false;
+}
+
+void FrameGraph::compile() {
+    auto& impl = *pImpl;
+    impl.stats = CompileStats();
+    impl.stats.recorded_passes = (uint32_t)impl.passes.size();
+
+    std::vector<bool> live = impl.find_live_passes();
+    impl.schedule.clear();
+    for (size_t i = 0; i < impl.passes.size(); ++i) {
+        if (live[i]) impl.schedule.push_back(impl.passes[i]);
+    }
+    impl.stats.culled_passes = impl.stats.recorded_passes - (uint32_t)impl.schedule.size();
+    impl.stats.merged_copies = impl.merge_copies(impl.schedule);
+
+    impl.compiledPasses.clear();
+    for (const auto& p : impl.schedule) {
+        impl.compiledPasses.push_back({ p.name, p.type, p.source_index, p.output, p.inputs });
+    }
+
+    impl.alias_transients();
+    impl.compiled = true;
+}
+
+void FrameGraph::execute() {
+    auto& impl = *pImpl;
+    if (!impl.device) {
+        throw std::runtime_error("FrameGraph::execute requires a device.");
+    }
+    if (!impl.compiled) compile();
+
+    // Physical textures survive between executions and are only rebuilt when a
+    // recompile changes their size or format.
+    impl.slotTextures.resize(impl.slotDescs.size());
+    for (size_t s = 0; s < impl.slotDescs.size(); ++s) {
+        auto& tex = impl.slotTextures[s];
+        const auto& d = impl.slotDescs[s];
+        if (!tex || tex->get_width() != d.width || tex->get_height() != d.height || tex->get_format() != d.format) {
+            tex = impl.device->create_texture(d.width, d.height, d.format);
+        }
+    }
+
+    impl.device->begin_batch();
+    try {
+        for (const auto& p : impl.schedule) {
+            auto output = impl.resolve(p.output);
+            switch (p.type) {
+                case PassType::Shader: {
+                    std::vector<std::shared_ptr<Texture>> inputs;
+                    for (ResourceId in : p.inputs) inputs.push_back(impl.resolve(in));
+                    impl.device->apply_shader(output, p.shader_bytes, p.entry_point, inputs, p.constants);
+                    break;
+                }
+                case PassType::Copy:
+                    impl.device->copy_texture(impl.resolve(p.inputs[0]), output);
+                    break;
+                case PassType::Blit:
+                    impl.device->blit_texture_to_region(impl.resolve(p.inputs[0]), output, p.x, p.y, p.width, p.height);
+                    break;
+            }
+        }
+    } catch (...) {
+        impl.device->end_batch();
+        throw;
+    }
+    impl.device->end_batch();
+}
+
+void FrameGraph::reset() {
+    auto device = pImpl->device;
+    pImpl = std::make_unique<Impl>();
+    pImpl->device = std::move(device);
+}
+
+const std::vector<FrameGraph::CompiledPass>& FrameGraph::get_compiled_passes() const {
+    return pImpl->compiledPasses;
+}
+
+const FrameGraph::CompileStats& FrameGraph::get_stats() const {
+    return pImpl->stats;
+}
+
+int FrameGraph::get_physical_slot(ResourceId id) const {
+    pImpl->check_id(id, "get_physical_slot");
+    if (pImpl->resources[id].imported || !pImpl->compiled) return -1;
+    return pImpl->slotOf[id];
+}
+
+std::shared_ptr<Texture> FrameGraph::get_texture(ResourceId id) const {
+    pImpl->check_id(id, "get_texture");
+    if (!pImpl->resources[id].imported && (!pImpl->compiled || pImpl->slotTextures.empty())) return nullptr;
+    return pImpl->resolve(id);
+}
@@ -0,0 +1,88 @@
+// DirectPortFrameGraph.h
+#pragma once
+
+#include "DirectPort.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace DirectPort {
+
+    // Records a chain of apply_shader / copy_texture / blit_texture_to_region calls
+    // as passes over virtual resources, then compiles and runs them on any
+    // IDirectXDevice.
+    //
+    // Resources are either imported (a Texture the caller owns) or transient
+    // (described by size and format, allocated by the graph). Only passes that
+    // contribute to a resource passed to mark_output survive compilation. Copies
+    // out of single-use transients are folded into the pass that produced them,
+    // and transients whose lifetimes do not overlap share one physical texture,
+    // so a transient's contents are undefined until a pass writes it. A marked
+    // transient output keeps its texture to the end of the frame.
+    //
+    // compile() never touches the device, so the scheduling rules can be checked
+    // on any host. execute() compiles if needed and replays the surviving passes
+    // inside one device batch, so D3D12 records them into a single command list.
+    class FrameGraph {
+    public:
+        typedef uint32_t ResourceId;
+
+        enum class PassType { Shader, Copy, Blit };
+
+        struct TextureDesc {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        };
+
+        // One surviving pass after compilation. source_index points back at the
+        // recorded pass; output may differ from it when a copy was folded in.
+        struct CompiledPass {
+            std::string name;
+            PassType type;
+            uint32_t source_index;
+            ResourceId output;
+            std::vector<ResourceId> inputs;
+        };
+
+        struct CompileStats {
+            uint32_t recorded_passes = 0;
+            uint32_t culled_passes = 0;
+            uint32_t merged_copies = 0;
+            uint32_t transient_textures = 0;
+            uint32_t physical_textures = 0;
+        };
+
+        explicit FrameGraph(std::shared_ptr<IDirectXDevice> device = nullptr);
+        ~FrameGraph();
+
+        ResourceId import_texture(std::shared_ptr<Texture> texture, const std::string& name = "");
+        ResourceId create_texture(const TextureDesc& desc, const std::string& name = "");
+        // Swaps the texture behind an imported resource between executions
+        // (e.g. a new camera frame) without recompiling.
+        void set_imported_texture(ResourceId id, std::shared_ptr<Texture> texture);
+
+        void add_shader_pass(const std::string& name, ResourceId output, const std::vector<uint8_t>& shader_bytes, const std::string& entry_point,
+                             const std::vector<ResourceId>& inputs, const std::vector<uint8_t>& constants);
+        void add_copy_pass(const std::string& name, ResourceId source, ResourceId destination);
+        void add_blit_pass(const std::string& name, ResourceId source, ResourceId destination,
+                           uint32_t dest_x, uint32_t dest_y, uint32_t dest_width, uint32_t dest_height);
+
+        void mark_output(ResourceId id);
+
+        void compile();
+        void execute();
+        void reset();
+
+        const std::vector<CompiledPass>& get_compiled_passes() const;
+        const CompileStats& get_stats() const;
+        // The physical slot a transient was aliased to, or -1 if it was culled.
+        int get_physical_slot(ResourceId id) const;
+        std::shared_ptr<Texture> get_texture(ResourceId id) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+}
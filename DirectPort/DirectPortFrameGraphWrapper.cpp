@@ -0,0 +1,81 @@
+#include "DirectPortFrameGraph.h"
+#include "DirectPortCPU.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+// The Python device classes are registered without a common base, so the
+// graph accepts any of them and upcasts here.
+static std::shared_ptr<IDirectXDevice> device_from_object(const py::object& device) {
+    if (py::isinstance<DeviceCPU>(device)) return device.cast<std::shared_ptr<DeviceCPU>>();
+#ifdef _WIN32
+    if (py::isinstance<DeviceD3D11>(device)) return device.cast<std::shared_ptr<DeviceD3D11>>();
+    if (py::isinstance<DeviceD3D12>(device)) return device.cast<std::shared_ptr<DeviceD3D12>>();
+#endif
+    throw py::type_error("Expected a DirectPort device (DeviceD3D11, DeviceD3D12 or DeviceCPU).");
+}
+
+static std::vector<uint8_t> bytes_from_object(const py::object& obj) {
+    std::vector<uint8_t> out;
+    if (py::isinstance<py::str>(obj) || py::isinstance<py::bytes>(obj)) {
+        std::string s = obj.cast<std::string>();
+        out.assign(s.begin(), s.end());
+    } else if (!obj.is_none()) {
+        throw py::type_error("Shader must be bytes (CSO/HLSL) or str (HLSL source).");
+    }
+    return out;
+}
+
+void bind_framegraph(py::module_& m) {
+    py::class_<FrameGraph, std::shared_ptr<FrameGraph>> graph(m, "FrameGraph", "Records passes, culls unused work and aliases transient textures.");
+
+    py::enum_<FrameGraph::PassType>(graph, "PassType", "")
+        .value("Shader", FrameGraph::PassType::Shader, "")
+        .value("Copy", FrameGraph::PassType::Copy, "")
+        .value("Blit", FrameGraph::PassType::Blit, "");
+
+    py::class_<FrameGraph::CompiledPass>(graph, "CompiledPass", "")
+        .def_readonly("name", &FrameGraph::CompiledPass::name, "")
+        .def_readonly("type", &FrameGraph::CompiledPass::type, "")
+        .def_readonly("source_index", &FrameGraph::CompiledPass::source_index, "")
+        .def_readonly("output", &FrameGraph::CompiledPass::output, "")
+        .def_readonly("inputs", &FrameGraph::CompiledPass::inputs, "");
+
+    py::class_<FrameGraph::CompileStats>(graph, "CompileStats", "")
+        .def_readonly("recorded_passes", &FrameGraph::CompileStats::recorded_passes, "")
+        .def_readonly("culled_passes", &FrameGraph::CompileStats::culled_passes, "")
+        .def_readonly("merged_copies", &FrameGraph::CompileStats::merged_copies, "")
+        .def_readonly("transient_textures", &FrameGraph::CompileStats::transient_textures, "")
+        .def_readonly("physical_textures", &FrameGraph::CompileStats::physical_textures, "");
+
+    graph
+        .def(py::init([](const py::object& device) {
+            return std::make_shared<FrameGraph>(device.is_none() ? nullptr : device_from_object(device));
+        }), py::arg("device") = py::none(), "")
+        .def("import_texture", &FrameGraph::import_texture, py::arg("texture"), py::arg("name") = "", "")
+        .def("create_texture", [](FrameGraph& self, uint32_t w, uint32_t h, DXGI_FORMAT f, const std::string& name) {
+            FrameGraph::TextureDesc desc;
+            desc.width = w; desc.height = h; desc.format = f;
+            return self.create_texture(desc, name);
+        }, py::arg("width"), py::arg("height"), py::arg("format"), py::arg("name") = "", "")
+        .def("set_imported_texture", &FrameGraph::set_imported_texture, py::arg("id"), py::arg("texture"), "")
+        .def("add_shader_pass", [](FrameGraph& self, const std::string& name, FrameGraph::ResourceId output, const py::object& shader,
+                                   const std::string& entry_point, const std::vector<FrameGraph::ResourceId>& inputs, const py::bytes& constants) {
+            std::string_view const_sv(constants);
+            self.add_shader_pass(name, output, bytes_from_object(shader), entry_point, inputs, {const_sv.begin(), const_sv.end()});
+        }, py::arg("name"), py::arg("output"), py::arg("shader"), py::arg("entry_point") = "PSMain",
+           py::arg("inputs") = std::vector<FrameGraph::ResourceId>(), py::arg("constants") = py::bytes(""), "")
+        .def("add_copy_pass", &FrameGraph::add_copy_pass, py::arg("name"), py::arg("source"), py::arg("destination"), "")
+        .def("add_blit_pass", &FrameGraph::add_blit_pass, py::arg("name"), py::arg("source"), py::arg("destination"),
+             py::arg("dest_x"), py::arg("dest_y"), py::arg("dest_width"), py::arg("dest_height"), "")
+        .def("mark_output", &FrameGraph::mark_output, py::arg("id"), "")
+        .def("compile", &FrameGraph::compile, "")
+        .def("execute", &FrameGraph::execute, "", py::call_guard<py::gil_scoped_release>())
+        .def("reset", &FrameGraph::reset, "")
+        .def_property_readonly("compiled_passes", &FrameGraph::get_compiled_passes, "")
+        .def_property_readonly("stats", &FrameGraph::get_stats, "")
+        .def("get_physical_slot", &FrameGraph::get_physical_slot, py::arg("id"), "")
+        .def("get_texture", &FrameGraph::get_texture, py::arg("id"), "");
+}
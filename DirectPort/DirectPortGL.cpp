@@ -1,4 +1,5 @@
 #include "DirectPortGL.h"
+#include "DirectPortFormats.h"
 #include <stdexcept>
 #include <vector>
 #include <string>
@@ -317,19 +318,19 @@ std::shared_ptr<TextureGL> DeviceGL::create_texture(uint32_t width, uint32_t hei
     tex->pImpl->height = height;
     tex->pImpl->format = format;
 
-    GLenum gl_internal_format, gl_format, gl_type;
-    switch(format) {
-        case DXGI_FORMAT_B8G8R8A8_UNORM: gl_internal_format = GL_RGBA8; gl_format = GL_BGRA; gl_type = GL_UNSIGNED_BYTE; break;
-        case DXGI_FORMAT_R8G8B8A8_UNORM: gl_internal_format = GL_RGBA8; gl_format = GL_RGBA; gl_type = GL_UNSIGNED_BYTE; break;
-        case DXGI_FORMAT_R32_FLOAT: gl_internal_format = GL_R32F; gl_format = GL_RED; gl_type = GL_FLOAT; break;
-        default: throw std::runtime_error("Unsupported texture format for OpenGL.");
+    const DirectPort::Formats::Traits* traits = DirectPort::Formats::find(format);
+    if (!traits || !traits->gl_format) {
+        throw std::runtime_error("Unsupported texture format for OpenGL.");
     }
     
     GL_CHECK(glGenTextures(1, &tex->pImpl->textureID));
     GL_CHECK(glBindTexture(GL_TEXTURE_2D, tex->pImpl->textureID));
     GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
     GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-    GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, gl_internal_format, width, height, 0, gl_format, gl_type, data));
+    // Rows of 1- and 2-byte formats need not be 4-byte aligned.
+    GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, (GLint)traits->gl_internal_format, width, height, 0, traits->gl_format, traits->gl_type, data));
+    GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
     GL_CHECK(glBindTexture(GL_TEXTURE_2D, 0));
     
     return tex;
@@ -429,13 +430,11 @@ std::shared_ptr<ConsumerGL> DeviceGL::connect_to_producer(unsigned long pid) {
         throw std::runtime_error("Failed to open shared texture handle by name via D3D12. Ensure producer is running.");
     }
 
-    GLenum gl_internal_format;
-    switch(consumer->pImpl->currentManifest.format) {
-        case DXGI_FORMAT_B8G8R8A8_UNORM: gl_internal_format = GL_RGBA8; break;
-        case DXGI_FORMAT_R8G8B8A8_UNORM: gl_internal_format = GL_RGBA8; break;
-        case DXGI_FORMAT_R32_FLOAT: gl_internal_format = GL_R32F; break;
-        default: throw std::runtime_error("Unsupported shared texture format.");
+    const DirectPort::Formats::Traits* traits = DirectPort::Formats::find(consumer->pImpl->currentManifest.format);
+    if (!traits || !traits->gl_internal_format) {
+        throw std::runtime_error("Unsupported shared texture format.");
     }
+    const GLenum gl_internal_format = traits->gl_internal_format;
 
     consumer->pImpl->privateTexture = std::shared_ptr<TextureGL>(new TextureGL());
     consumer->pImpl->privateTexture->pImpl->width = consumer->pImpl->currentManifest.width;
@@ -0,0 +1,101 @@
+// DirectPortInternal.h
+// Private layouts shared by the device backends. Texture::Impl lives here so the
+// D3D devices (DirectPort.cpp) and the headless CPU device (DirectPortCPU.cpp)
+// can both build textures; the D3D device Impls live here so feature modules
+// (DirectPortCompositeD3D.cpp) can implement their D3D paths outside the core.
+// Not part of the public API; do not include from wrappers or examples.
+#pragma once
+
+#include "DirectPort.h"
+#include <map>
+#include <vector>
+
+namespace DirectPort {
+
+    struct Texture::Impl {
+#ifdef _WIN32
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> d3d11Texture;
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> d3d11SRV;
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> d3d11RTV;
+        Microsoft::WRL::ComPtr<ID3D12Resource> d3d12Resource;
+#endif
+        std::vector<uint8_t> cpuPixels;
+        size_t cpuRowPitch = 0;
+
+        UINT32 width = 0;
+        UINT32 height = 0;
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        bool is_d3d11 = false;
+        bool is_d3d12 = false;
+        bool is_cpu = false;
+    };
+
+#ifdef _WIN32
+    // Holds the device's ID3D11Multithread lock across a sequence of immediate
+    // context calls, so another thread cannot rebind the pipeline between them.
+    // The lock is recursive; a null multithread interface makes this a no-op.
+    class D3D11ContextLock {
+    public:
+        explicit D3D11ContextLock(ID3D11Multithread* multithread) : multithread(multithread) { if (multithread) multithread->Enter(); }
+        ~D3D11ContextLock() { if (multithread) multithread->Leave(); }
+        D3D11ContextLock(const D3D11ContextLock&) = delete;
+        D3D11ContextLock& operator=(const D3D11ContextLock&) = delete;
+    private:
+        ID3D11Multithread* multithread;
+    };
+
+    struct DeviceD3D11::Impl {
+        Microsoft::WRL::ComPtr<ID3D11Device> device;
+        Microsoft::WRL::ComPtr<ID3D11Device1> device1;
+        Microsoft::WRL::ComPtr<ID3D11Device5> device5;
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext4> context4;
+        Microsoft::WRL::ComPtr<ID3D11Multithread> multithread;
+
+        Microsoft::WRL::ComPtr<ID3D11VertexShader> blitVS;
+        Microsoft::WRL::ComPtr<ID3D11PixelShader> blitPS;
+        Microsoft::WRL::ComPtr<ID3D11SamplerState> blitSampler;
+
+        std::map<std::vector<uint8_t>, Microsoft::WRL::ComPtr<ID3D11PixelShader>> shaderCache;
+        LUID adapterLuid = {};
+
+        Microsoft::WRL::ComPtr<ID3D11VertexShader> compositeVS;
+        Microsoft::WRL::ComPtr<ID3D11PixelShader> compositePS;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> compositeCB;
+        Microsoft::WRL::ComPtr<ID3D11BlendState> compositeBlend;
+        Microsoft::WRL::ComPtr<ID3D11RasterizerState> compositeScissorRS;
+    };
+
+    struct DeviceD3D12::Impl {
+        Microsoft::WRL::ComPtr<ID3D12Device> device;
+        Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue;
+        Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
+        Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList;
+        Microsoft::WRL::ComPtr<ID3D12Fence> fence;
+        HANDLE fenceEvent;
+        UINT64 fenceValue = 1;
+        UINT64 frameFenceValues[2] = {};
+        LUID adapterLuid;
+
+        Microsoft::WRL::ComPtr<ID3D12RootSignature> blitRootSignature;
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> blitPSO;
+        Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> blitSrvHeap;
+        Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> blitRtvHeap;
+
+        std::map<std::vector<uint8_t>, Microsoft::WRL::ComPtr<ID3D12PipelineState>> psoCache;
+        Microsoft::WRL::ComPtr<ID3D12RootSignature> shaderRootSignature;
+
+        Microsoft::WRL::ComPtr<ID3D12RootSignature> compositeRootSignature;
+        std::map<DXGI_FORMAT, Microsoft::WRL::ComPtr<ID3D12PipelineState>> compositePSOs;
+        Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> compositeSrvHeap;
+        UINT compositeSrvCapacity = 0;
+
+        bool batching = false;
+        bool recording = false;
+        // Per-call heaps and upload buffers referenced by submitted or still
+        // recording commands; released after the next WaitForGpu.
+        std::vector<Microsoft::WRL::ComPtr<ID3D12Pageable>> inFlight;
+    };
+#endif
+
+}
@@ -1,15 +1,145 @@
 // src/DirectPort/DirectPortNumpy.cpp
 
 #include "DirectPortNumpy.h"
+#include "DirectPortNumpyPixels.h"
+#include <deque>
 #include <stdexcept>
 #include <vector>
 #include <map>
+#include <mutex>
 
 namespace py = pybind11;
 using namespace Microsoft::WRL;
 
 namespace DirectPort::Numpy {
 
+namespace {
+
+ComPtr<ID3D11Texture2D> create_staging(ID3D11Device* d3d, const DirectPort::Staging::Key& key) {
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = key.width;
+    desc.Height = key.height;
+    desc.MipLevels = key.mip_levels;
+    desc.ArraySize = key.array_size;
+    desc.Format = key.format;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_STAGING;
+    desc.CPUAccessFlags = key.access == DirectPort::Staging::Access::Read ? D3D11_CPU_ACCESS_READ : D3D11_CPU_ACCESS_WRITE;
+    ComPtr<ID3D11Texture2D> texture;
+    HRESULT hr = d3d->CreateTexture2D(&desc, nullptr, &texture);
+    if (FAILED(hr)) {
+        throw std::runtime_error("Numpy: Failed to create staging texture. HRESULT: " + std::to_string(hr));
+    }
+    return texture;
+}
+
+std::shared_ptr<DirectPort::Staging::Pool> make_staging_pool(const ComPtr<ID3D11Device>& d3d, uint32_t ring_size) {
+    return std::make_shared<DirectPort::Staging::Pool>([d3d](const DirectPort::Staging::Key& key) {
+        ComPtr<ID3D11Texture2D> texture = create_staging(d3d.Get(), key);
+        return std::shared_ptr<void>(texture.Detach(), [](void* p) { static_cast<ID3D11Texture2D*>(p)->Release(); });
+    }, ring_size);
+}
+
+// A staging texture for read_texture_async with the event query that marks
+// its copy done; pooled together, so neither is created per frame.
+struct AsyncStaging {
+    ComPtr<ID3D11Texture2D> texture;
+    ComPtr<ID3D11Query> query;
+};
+
+// The async ring holds every readback in flight plus the one being issued.
+std::shared_ptr<DirectPort::Staging::Pool> make_async_pool(const ComPtr<ID3D11Device>& d3d, uint32_t depth) {
+    return std::make_shared<DirectPort::Staging::Pool>([d3d](const DirectPort::Staging::Key& key) {
+        auto staging = std::make_shared<AsyncStaging>();
+        staging->texture = create_staging(d3d.Get(), key);
+        D3D11_QUERY_DESC desc = { D3D11_QUERY_EVENT, 0 };
+        HRESULT hr = d3d->CreateQuery(&desc, &staging->query);
+        if (FAILED(hr)) {
+            throw std::runtime_error("Numpy: Failed to create readback query. HRESULT: " + std::to_string(hr));
+        }
+        return std::shared_ptr<void>(staging);
+    }, depth + 1);
+}
+
+// Per-device state, looked up by address: the staging pool read_texture and
+// write_texture share, one sized for read_textures batches, and the readback
+// queue with its own pool. Entries
+// whose device has gone are dropped on the next lookup; the pools' closures
+// hold their own reference to the ID3D11Device until then.
+struct StagingEntry {
+    std::weak_ptr<DirectPort::DeviceD3D11> device;
+    std::shared_ptr<DirectPort::Staging::Pool> pool;
+    std::shared_ptr<DirectPort::Staging::Pool> batch_pool;
+    std::shared_ptr<DirectPort::Staging::Pool> async_pool;
+    std::shared_ptr<DirectPort::Readback::Queue> readback;
+};
+
+std::mutex g_staging_mutex;
+std::map<const DirectPort::DeviceD3D11*, StagingEntry> g_staging;
+
+// Call with g_staging_mutex held.
+StagingEntry& device_entry(const std::shared_ptr<DirectPort::DeviceD3D11>& device) {
+    for (auto it = g_staging.begin(); it != g_staging.end();) {
+        it = it->second.device.expired() ? g_staging.erase(it) : std::next(it);
+    }
+    StagingEntry& entry = g_staging[device.get()];
+    if (!entry.pool) {
+        ComPtr<ID3D11Device> d3d = device->get_d3d11_device();
+        entry.device = device;
+        entry.pool = make_staging_pool(d3d, 2);
+        entry.async_pool = make_async_pool(d3d, DirectPort::Readback::kDefaultDepth);
+        entry.readback = std::make_shared<DirectPort::Readback::Queue>();
+    }
+    return entry;
+}
+
+std::shared_ptr<DirectPort::Staging::Pool> staging_pool(const std::shared_ptr<DirectPort::DeviceD3D11>& device) {
+    std::lock_guard<std::mutex> lock(g_staging_mutex);
+    return device_entry(device).pool;
+}
+
+// A batch holds one staging texture per frame at once, more than the shared
+// ring keeps, so batches get a ring that grows to the largest batch seen.
+std::shared_ptr<DirectPort::Staging::Pool> batch_pool(const std::shared_ptr<DirectPort::DeviceD3D11>& device, size_t count) {
+    std::lock_guard<std::mutex> lock(g_staging_mutex);
+    StagingEntry& entry = device_entry(device);
+    if (!entry.batch_pool || entry.batch_pool->ring_size() < count) {
+        entry.batch_pool = make_staging_pool(device->get_d3d11_device(), (uint32_t)count);
+    }
+    return entry.batch_pool;
+}
+
+std::shared_ptr<DirectPort::Readback::Queue> readback_queue(const std::shared_ptr<DirectPort::DeviceD3D11>& device) {
+    if (!device) {
+        throw std::invalid_argument("Device cannot be null.");
+    }
+    std::lock_guard<std::mutex> lock(g_staging_mutex);
+    return device_entry(device).readback;
+}
+
+DirectPort::Staging::Key staging_key(const D3D11_TEXTURE2D_DESC& desc, DirectPort::Staging::Access access) {
+    DirectPort::Staging::Key key;
+    key.width = desc.Width;
+    key.height = desc.Height;
+    key.format = desc.Format;
+    key.mip_levels = desc.MipLevels;
+    key.array_size = desc.ArraySize;
+    key.access = access;
+    return key;
+}
+
+// A single-level staging texture the size of `box`, for region transfers.
+DirectPort::Staging::Key region_key(const D3D11_TEXTURE2D_DESC& desc, const DirectPort::DirtyRect& box, DirectPort::Staging::Access access) {
+    DirectPort::Staging::Key key = staging_key(desc, access);
+    key.width = box.width;
+    key.height = box.height;
+    key.mip_levels = 1;
+    key.array_size = 1;
+    return key;
+}
+
+}
+
 struct unmapper {
     ComPtr<ID3D11DeviceContext> context;
     ComPtr<ID3D11Resource> resource;
@@ -27,7 +157,9 @@ struct unmapper {
 void write_texture(
     std::shared_ptr<DirectPort::DeviceD3D11> device,
     std::shared_ptr<DirectPort::Texture> texture,
-    const py::array& array) {
+    const py::array& array,
+    DXGI_FORMAT format,
+    const py::object& dest) {
 
     if (!device) {
         throw std::invalid_argument("Device cannot be null.");
@@ -47,58 +179,50 @@ void write_texture(
         throw std::runtime_error("Failed to retrieve valid D3D11 pointers via mirror structures.");
     }
 
-    py::buffer_info info = array.request();
     D3D11_TEXTURE2D_DESC desc_target;
     pTexture->GetDesc(&desc_target);
 
-    if (info.ndim < 2 || info.ndim > 3) {
-        throw std::invalid_argument("NumPy array must be 2D (HxW) or 3D (HxWxC).");
-    }
-    if (static_cast<UINT>(info.shape[0]) != desc_target.Height || static_cast<UINT>(info.shape[1]) != desc_target.Width) {
-        throw std::invalid_argument("NumPy array dimensions do not match the target texture.");
-    }
+    // With `dest`, only the array's box goes through staging and into the texture.
+    const DirectPort::DirtyRect box = placement(dest, array, desc_target.Width, desc_target.Height);
+    const bool whole = dest.is_none();
+    const auto key = whole ? staging_key(desc_target, DirectPort::Staging::Access::Write)
+                           : region_key(desc_target, box, DirectPort::Staging::Access::Write);
 
-    D3D11_TEXTURE2D_DESC desc_staging = desc_target;
-    desc_staging.Usage = D3D11_USAGE_STAGING;
-    desc_staging.BindFlags = 0;
-    desc_staging.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-    desc_staging.MiscFlags = 0;
-
-    ComPtr<ID3D11Texture2D> stagingTexture;
-    HRESULT hr = pDevice->CreateTexture2D(&desc_staging, nullptr, &stagingTexture);
-    if (FAILED(hr)) {
-        throw std::runtime_error("Failed to create staging texture for writing. HRESULT: " + std::to_string(hr));
-    }
+    // The lease outlives the unmapper below, so the texture is unmapped before it returns to the ring.
+    auto staging = staging_pool(device)->acquire(key);
+    ID3D11Texture2D* stagingTexture = staging.as<ID3D11Texture2D>();
 
+    // Map waits for the GPU if it still reads this staging texture; other
+    // Python threads run meanwhile, and write_pixels drops the GIL again to copy.
     D3D11_MAPPED_SUBRESOURCE mapped_resource;
-    hr = pContext->Map(stagingTexture.Get(), 0, D3D11_MAP_WRITE, 0, &mapped_resource);
+    HRESULT hr;
+    {
+        py::gil_scoped_release release;
+        hr = pContext->Map(stagingTexture, 0, D3D11_MAP_WRITE, 0, &mapped_resource);
+    }
     if (FAILED(hr)) {
         throw std::runtime_error("Failed to map staging texture for writing. HRESULT: " + std::to_string(hr));
     }
 
-    unmapper u(pContext, stagingTexture.Get(), 0);
-
-    const auto* src_data = static_cast<const uint8_t*>(info.ptr);
-    auto* dst_data = static_cast<uint8_t*>(mapped_resource.pData);
-    
-    const size_t src_row_pitch = info.strides[0];
-    const size_t dst_row_pitch = mapped_resource.RowPitch;
-    const size_t bytes_to_copy_per_row = static_cast<size_t>(info.shape[1]) * info.strides[1];
+    {
+        unmapper u(pContext, stagingTexture, 0);
+        write_pixels(desc_target.Format, mapped_resource.pData, mapped_resource.RowPitch, box.width, box.height, array, format);
+    }
 
-    if (src_row_pitch == dst_row_pitch) {
-        memcpy(dst_data, src_data, src_row_pitch * info.shape[0]);
+    if (whole) {
+        pContext->CopyResource(pTexture, stagingTexture);
     } else {
-        for (size_t y = 0; y < static_cast<size_t>(info.shape[0]); ++y) {
-            memcpy(dst_data + y * dst_row_pitch, src_data + y * src_row_pitch, bytes_to_copy_per_row);
-        }
+        pContext->CopySubresourceRegion(pTexture, 0, box.x, box.y, 0, stagingTexture, 0, nullptr);
     }
-
-    pContext->CopyResource(pTexture, stagingTexture.Get());
 }
 
 py::array read_texture(
     std::shared_ptr<DirectPort::DeviceD3D11> device,
-    std::shared_ptr<DirectPort::Texture> texture)
+    std::shared_ptr<DirectPort::Texture> texture,
+    DXGI_FORMAT format,
+    const py::object& dtype,
+    const py::object& out,
+    const py::object& rect)
 {
     if (!device) {
         throw std::invalid_argument("Device cannot be null.");
@@ -118,61 +242,261 @@ py::array read_texture(
     D3D11_TEXTURE2D_DESC desc;
     pTexture->GetDesc(&desc);
 
-    desc.Usage = D3D11_USAGE_STAGING;
-    desc.BindFlags = 0;
-    desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-    desc.MiscFlags = 0;
-    
-    ComPtr<ID3D11Texture2D> stagingTexture;
-    HRESULT hr = pDevice->CreateTexture2D(&desc, nullptr, &stagingTexture);
+    // With `rect`, only that box is copied to a staging texture of its size.
+    const DirectPort::DirtyRect box = region(rect, desc.Width, desc.Height);
+    const bool whole = rect.is_none();
+    const auto key = whole ? staging_key(desc, DirectPort::Staging::Access::Read) : region_key(desc, box, DirectPort::Staging::Access::Read);
+    auto staging = staging_pool(device)->acquire(key);
+    ID3D11Texture2D* stagingTexture = staging.as<ID3D11Texture2D>();
+
+    // The copy and the GPU wait inside Map run without the GIL.
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr;
+    {
+        py::gil_scoped_release release;
+        if (whole) {
+            pContext->CopyResource(stagingTexture, pTexture);
+        } else {
+            const D3D11_BOX source = { box.x, box.y, 0, box.x + box.width, box.y + box.height, 1 };
+            pContext->CopySubresourceRegion(stagingTexture, 0, 0, 0, 0, pTexture, 0, &source);
+        }
+        hr = pContext->Map(stagingTexture, 0, D3D11_MAP_READ, 0, &mappedResource);
+    }
     if (FAILED(hr)) {
-        throw std::runtime_error("Numpy: Failed to create staging texture.");
+        throw std::runtime_error("Numpy: Failed to map staging texture.");
+    }
+    
+    unmapper u(pContext, stagingTexture, 0);
+
+    return read_pixels(desc.Format, mappedResource.pData, mappedResource.RowPitch, box.width, box.height, format, dtype, out);
+}
+
+py::array read_textures(
+    std::shared_ptr<DirectPort::DeviceD3D11> device,
+    const std::vector<std::shared_ptr<DirectPort::Texture>>& textures,
+    DXGI_FORMAT format,
+    const py::object& dtype,
+    const py::object& size,
+    DirectPort::Resample::Filter filter,
+    const py::object& out)
+{
+    if (!device) {
+        throw std::invalid_argument("Device cannot be null.");
+    }
+    auto* pContext = device->get_d3d11_context();
+    if (!pContext) {
+        throw std::runtime_error("Failed to retrieve valid D3D11 pointers via mirror structures.");
     }
+    auto pool = batch_pool(device, textures.size());
 
-    pContext->CopyResource(stagingTexture.Get(), pTexture);
+    // Every copy is queued before the first Map, so the GPU works through
+    // them back to back and only the first Map waits, without the GIL.
+    // Declared before the unmappers, so each staging texture is unmapped
+    // before its lease ends.
+    std::vector<DirectPort::Staging::Pool::Lease> leases;
+    std::vector<D3D11_TEXTURE2D_DESC> descs;
+    std::deque<unmapper> unmappers;
+    std::vector<Source> sources;
+    {
+        py::gil_scoped_release release;
+        for (const auto& texture : textures) {
+            if (!texture || !texture->get_d3d11_texture_ptr()) {
+                throw std::invalid_argument("Invalid D3D11 texture provided.");
+            }
+            auto* pTexture = reinterpret_cast<ID3D11Texture2D*>(texture->get_d3d11_texture_ptr());
+            D3D11_TEXTURE2D_DESC desc;
+            pTexture->GetDesc(&desc);
+            leases.push_back(pool->acquire(staging_key(desc, DirectPort::Staging::Access::Read)));
+            descs.push_back(desc);
+            pContext->CopyResource(leases.back().as<ID3D11Texture2D>(), pTexture);
+        }
+        pContext->Flush();
 
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-    hr = pContext->Map(stagingTexture.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
+        for (size_t i = 0; i < leases.size(); ++i) {
+            ID3D11Texture2D* stagingTexture = leases[i].as<ID3D11Texture2D>();
+            D3D11_MAPPED_SUBRESOURCE mapped;
+            HRESULT hr = pContext->Map(stagingTexture, 0, D3D11_MAP_READ, 0, &mapped);
+            if (FAILED(hr)) {
+                throw std::runtime_error("Numpy: Failed to map staging texture.");
+            }
+            unmappers.emplace_back(pContext, stagingTexture, 0);
+            sources.push_back({ descs[i].Format, mapped.pData, mapped.RowPitch, descs[i].Width, descs[i].Height });
+        }
+    }
+    return read_batch(sources, format, dtype, size, filter, out);
+}
+
+namespace {
+
+// A mapped staging texture, kept leased until it is unmapped.
+struct MappedStaging {
+    DirectPort::Staging::Pool::Lease staging;
+    unmapper unmap;
+
+    MappedStaging(DirectPort::Staging::Pool::Lease lease, const ComPtr<ID3D11DeviceContext>& context)
+        : staging(std::move(lease)), unmap(context, staging.as<ID3D11Texture2D>(), 0) {}
+};
+
+}
+
+Mapping map_texture(
+    std::shared_ptr<DirectPort::DeviceD3D11> device,
+    std::shared_ptr<DirectPort::Texture> texture)
+{
+    if (!device) {
+        throw std::invalid_argument("Device cannot be null.");
+    }
+    if (!texture || !texture->get_d3d11_texture_ptr()) {
+        throw std::invalid_argument("Invalid D3D11 texture provided.");
+    }
+
+    auto* pContext = device->get_d3d11_context();
+    auto* pTexture = reinterpret_cast<ID3D11Texture2D*>(texture->get_d3d11_texture_ptr());
+    if (!pContext || !pTexture) {
+        throw std::runtime_error("Failed to retrieve valid D3D11 pointers via mirror structures.");
+    }
+
+    D3D11_TEXTURE2D_DESC desc;
+    pTexture->GetDesc(&desc);
+
+    auto staging = staging_pool(device)->acquire(staging_key(desc, DirectPort::Staging::Access::Read));
+    ID3D11Texture2D* stagingTexture = staging.as<ID3D11Texture2D>();
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    HRESULT hr;
+    {
+        py::gil_scoped_release release;
+        pContext->CopyResource(stagingTexture, pTexture);
+        hr = pContext->Map(stagingTexture, 0, D3D11_MAP_READ, 0, &mapped);
+    }
     if (FAILED(hr)) {
         throw std::runtime_error("Numpy: Failed to map staging texture.");
     }
-    
-    unmapper u(pContext, stagingTexture.Get(), 0);
-
-    std::vector<py::ssize_t> shape;
-    py::dtype dtype("uint8"); 
-    size_t bytesPerPixel = 4;
-
-    switch (desc.Format) {
-        case DXGI_FORMAT_B8G8R8A8_UNORM:
-        case DXGI_FORMAT_R8G8B8A8_UNORM:
-            shape = {(py::ssize_t)desc.Height, (py::ssize_t)desc.Width, 4};
-            dtype = py::dtype("uint8");
-            bytesPerPixel = 4;
-            break;
-        case DXGI_FORMAT_R32_FLOAT:
-            shape = {(py::ssize_t)desc.Height, (py::ssize_t)desc.Width};
-            dtype = py::dtype("float32");
-            bytesPerPixel = 4;
-            break;
-        default:
-            throw std::runtime_error("Numpy: Unsupported texture format for readback.");
-    }
-
-    py::array result(dtype, shape);
-    auto buf = result.request();
-    auto* pDest = static_cast<uint8_t*>(buf.ptr);
-    const auto* pSrc = static_cast<const uint8_t*>(mappedResource.pData);
-
-    const size_t bytes_to_copy_per_row = desc.Width * bytesPerPixel;
-    const size_t src_row_pitch = mappedResource.RowPitch;
-    const size_t dst_row_pitch = buf.strides[0];
-
-    for (UINT y = 0; y < desc.Height; ++y) {
-        memcpy(pDest + y * dst_row_pitch, pSrc + y * src_row_pitch, bytes_to_copy_per_row);
+    auto keep = std::make_shared<MappedStaging>(std::move(staging), pContext);
+    // The staging copy is read-only: writes would never reach the texture.
+    return Mapping(desc.Format, mapped.pData, mapped.RowPitch, desc.Width, desc.Height, std::move(keep), false);
+}
+
+namespace {
+
+// A CopyResource into a leased staging texture, followed by an event query:
+// ready() asks the query without flushing or waiting, read() maps the copy,
+// which only blocks if the GPU has not got to it yet.
+class D3D11Transfer : public DirectPort::Readback::Transfer {
+public:
+    D3D11Transfer(ComPtr<ID3D11DeviceContext> context, DirectPort::Staging::Pool::Lease staging)
+        : context_(std::move(context)), staging_(std::move(staging)) {}
+
+    bool ready() override {
+        return context_->GetData(staging_.as<AsyncStaging>()->query.Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
     }
-    
-    return result;
+
+    void read(const std::function<void(const void*, size_t)>& fn) override {
+        ID3D11Texture2D* texture = staging_.as<AsyncStaging>()->texture.Get();
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        HRESULT hr = context_->Map(texture, 0, D3D11_MAP_READ, 0, &mapped);
+        if (FAILED(hr)) {
+            throw std::runtime_error("Numpy: Failed to map readback texture. HRESULT: " + std::to_string(hr));
+        }
+        unmapper u(context_, texture, 0);
+        fn(mapped.pData, mapped.RowPitch);
+    }
+
+private:
+    ComPtr<ID3D11DeviceContext> context_;
+    DirectPort::Staging::Pool::Lease staging_;
+};
+
+}
+
+DirectPort::Readback::Future read_texture_async(
+    std::shared_ptr<DirectPort::DeviceD3D11> device,
+    std::shared_ptr<DirectPort::Texture> texture,
+    DXGI_FORMAT format)
+{
+    if (!texture || !texture->get_d3d11_texture_ptr()) {
+        throw std::invalid_argument("Invalid D3D11 texture provided.");
+    }
+    auto queue = readback_queue(device);
+    std::shared_ptr<DirectPort::Staging::Pool> pool;
+    {
+        std::lock_guard<std::mutex> lock(g_staging_mutex);
+        pool = device_entry(device).async_pool;
+    }
+
+    auto* pContext = device->get_d3d11_context();
+    auto* pTexture = reinterpret_cast<ID3D11Texture2D*>(texture->get_d3d11_texture_ptr());
+    if (!pContext || !pTexture) {
+        throw std::runtime_error("Failed to retrieve valid D3D11 pointers via mirror structures.");
+    }
+
+    D3D11_TEXTURE2D_DESC desc;
+    pTexture->GetDesc(&desc);
+
+    auto staging = pool->acquire(staging_key(desc, DirectPort::Staging::Access::Read));
+    const AsyncStaging* copy = staging.as<AsyncStaging>();
+    pContext->CopyResource(copy->texture.Get(), pTexture);
+    pContext->End(copy->query.Get());
+    // Submitted now, so the copy runs while the caller renders the next frame.
+    pContext->Flush();
+
+    return queue->push(std::make_unique<D3D11Transfer>(pContext, std::move(staging)), desc.Format, desc.Width, desc.Height, format);
+}
+
+DirectPort::Readback::Queue::Stats readback_stats(std::shared_ptr<DirectPort::DeviceD3D11> device) {
+    return readback_queue(device)->get_stats();
+}
+
+size_t poll_readbacks(std::shared_ptr<DirectPort::DeviceD3D11> device) {
+    return readback_queue(device)->poll();
+}
+
+void flush_readbacks(std::shared_ptr<DirectPort::DeviceD3D11> device) {
+    readback_queue(device)->flush();
+}
+
+void set_readback_depth(std::shared_ptr<DirectPort::DeviceD3D11> device, uint32_t depth) {
+    auto queue = readback_queue(device);
+    {
+        std::lock_guard<std::mutex> lock(g_staging_mutex);
+        StagingEntry& entry = device_entry(device);
+        if (entry.async_pool->ring_size() != depth + 1) {
+            // Leases from the old ring finish normally and are dropped on release.
+            entry.async_pool = make_async_pool(device->get_d3d11_device(), depth);
+        }
+    }
+    queue->set_depth(depth);
+}
+
+DirectPort::Staging::Pool::Stats staging_stats(std::shared_ptr<DirectPort::DeviceD3D11> device) {
+    if (!device) {
+        throw std::invalid_argument("Device cannot be null.");
+    }
+    return staging_pool(device)->get_stats();
+}
+
+size_t trim_staging(std::shared_ptr<DirectPort::DeviceD3D11> device, bool all) {
+    if (!device) {
+        throw std::invalid_argument("Device cannot be null.");
+    }
+    std::vector<std::shared_ptr<DirectPort::Staging::Pool>> pools;
+    {
+        std::lock_guard<std::mutex> lock(g_staging_mutex);
+        StagingEntry& entry = device_entry(device);
+        pools = { entry.pool, entry.batch_pool };
+    }
+    size_t count = 0;
+    for (const auto& pool : pools) {
+        if (!pool) continue;
+        if (!all) {
+            count += pool->trim();
+            continue;
+        }
+        const uint32_t live = pool->get_stats().live;
+        pool->clear();
+        count += live - pool->get_stats().live;
+    }
+    return count;
 }
 
 }
\ No newline at end of file
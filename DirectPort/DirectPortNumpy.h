@@ -1,6 +1,9 @@
 #pragma once
 
 #include "DirectPort.h"
+#include "DirectPortNumpyPixels.h"
+#include "DirectPortReadback.h"
+#include "DirectPortStaging.h"
 #include <memory>
 #include <pybind11/numpy.h>
 
@@ -8,15 +11,81 @@ namespace py = pybind11;
 
 namespace DirectPort::Numpy {
 
+    // `format` converts on the way through; DXGI_FORMAT_UNKNOWN keeps the
+    // texture's own format. The array layout follows the format: uint8 for
+    // 8-bit channels, uint32 for R10G10B10A2, float16 and float32 for the
+    // float formats, with a channel axis when there is more than one channel.
+    // `dtype` reads into another element type in the same pass, e.g. float32
+    // from an fp16 texture. write_texture infers the array's format from its
+    // dtype and converts, and also takes (height, width, 3) uint8 arrays for
+    // 8-bit RGBA and BGRA textures, expanding them with opaque alpha. See
+    // DirectPortNumpyPixels.h. `out` receives the pixels instead of a new
+    // array, so capture loops can reuse one buffer per stream. `rect` reads
+    // just that box and `dest` writes the array's box at (x, y); only the
+    // box crosses to or from staging memory. The GPU wait and the row copies
+    // run without the GIL, so transfers on several threads overlap.
     py::array read_texture(
         std::shared_ptr<DirectPort::DeviceD3D11> device,
-        std::shared_ptr<DirectPort::Texture> texture
+        std::shared_ptr<DirectPort::Texture> texture,
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN,
+        const py::object& dtype = py::none(),
+        const py::object& out = py::none(),
+        const py::object& rect = py::none()
+    );
+
+    // Reads a batch into one (N, H, W[, C]) array: every copy is issued
+    // before the first map, so the batch waits on the GPU once, and each
+    // frame is converted (and resized to `size`, if given) straight into its
+    // slice. See Numpy::read_batch.
+    py::array read_textures(
+        std::shared_ptr<DirectPort::DeviceD3D11> device,
+        const std::vector<std::shared_ptr<DirectPort::Texture>>& textures,
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN,
+        const py::object& dtype = py::none(),
+        const py::object& size = py::none(),
+        DirectPort::Resample::Filter filter = DirectPort::Resample::Filter::Bilinear,
+        const py::object& out = py::none()
     );
 
     void write_texture(
         std::shared_ptr<DirectPort::DeviceD3D11> device,
         std::shared_ptr<DirectPort::Texture> texture,
-        const py::array& numpy_array
+        const py::array& numpy_array,
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN,
+        const py::object& dest = py::none()
     );
 
+    // read_texture without the final copy: the staging texture stays mapped
+    // and the array views it, row pitch and all, until the mapping is
+    // released and the last view dies. Read-only. The staging texture is
+    // out of the device's ring meanwhile, so release mappings promptly.
+    Mapping map_texture(
+        std::shared_ptr<DirectPort::DeviceD3D11> device,
+        std::shared_ptr<DirectPort::Texture> texture
+    );
+
+    // Copies the texture to a staging texture and returns at once; the copy
+    // is mapped `depth` calls later (or when the future's result is asked
+    // for), by which time the GPU has finished it. `format` converts as
+    // read_texture does; resolve it from a dtype with readback_format first.
+    DirectPort::Readback::Future read_texture_async(
+        std::shared_ptr<DirectPort::DeviceD3D11> device,
+        std::shared_ptr<DirectPort::Texture> texture,
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN
+    );
+
+    DirectPort::Readback::Queue::Stats readback_stats(std::shared_ptr<DirectPort::DeviceD3D11> device);
+    size_t poll_readbacks(std::shared_ptr<DirectPort::DeviceD3D11> device);
+    void flush_readbacks(std::shared_ptr<DirectPort::DeviceD3D11> device);
+    // Readbacks kept in flight per device; Readback::kDefaultDepth by default.
+    void set_readback_depth(std::shared_ptr<DirectPort::DeviceD3D11> device, uint32_t depth);
+
+    // Both calls stage through a Staging::Pool kept per device, so a stream
+    // of same-sized frames reuses a couple of staging textures instead of
+    // creating one per call. Idle ones are released after a few seconds.
+    DirectPort::Staging::Pool::Stats staging_stats(std::shared_ptr<DirectPort::DeviceD3D11> device);
+    // Releases idle staging textures now, or every unleased one with `all`;
+    // returns how many were released.
+    size_t trim_staging(std::shared_ptr<DirectPort::DeviceD3D11> device, bool all = false);
+
 }
\ No newline at end of file
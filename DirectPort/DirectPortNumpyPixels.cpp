@@ -0,0 +1,485 @@
+// src/DirectPort/DirectPortNumpyPixels.cpp
+
+#include "DirectPortNumpyPixels.h"
+#include "DirectPortConvert.h"
+#include "DirectPortCopy.h"
+#include "DirectPortFormats.h"
+#include "DirectPortResample.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace DirectPort::Numpy {
+
+namespace {
+
+    std::string dtype_name(const py::dtype& dtype) {
+        return py::str(dtype.attr("name"));
+    }
+
+    const Formats::Traits& readback_traits(DXGI_FORMAT format) {
+        const Formats::Traits* traits = Formats::find(format);
+        if (!traits || !traits->numpy_dtype) {
+            throw std::runtime_error("Numpy: Unsupported texture format for readback.");
+        }
+        return *traits;
+    }
+
+    // The format whose NumPy layout is the array's, preferring `texture_format`.
+    DXGI_FORMAT array_format(DXGI_FORMAT texture_format, const std::string& dtype, size_t channels) {
+        const DXGI_FORMAT format = Formats::with_numpy_dtype(texture_format, dtype.c_str());
+        const Formats::Traits* traits = Formats::find(format);
+        if (!traits || traits->numpy_channels != channels) {
+            throw std::invalid_argument("Numpy: no format holds " + std::to_string(channels) + "-channel " + dtype +
+                                        " pixels for a " + Formats::traits(texture_format).name + " texture.");
+        }
+        return format;
+    }
+
+    // `out` must have the shape and dtype read_pixels would allocate, and
+    // packed pixels; rows may be strided, so it can be a view into a larger
+    // array such as one tile of a mosaic. A leading batch axis may have any
+    // stride that keeps the slices apart.
+    void check_destination(const py::array& out, const std::vector<py::ssize_t>& shape, const Formats::Traits& layout) {
+        if (!out.writeable()) {
+            throw std::invalid_argument("Numpy: out is read-only.");
+        }
+        if (dtype_name(out.dtype()) != layout.numpy_dtype) {
+            throw std::invalid_argument("Numpy: out has dtype " + dtype_name(out.dtype()) + ", the readback is " + layout.numpy_dtype + ".");
+        }
+        bool match = (size_t)out.ndim() == shape.size();
+        for (size_t i = 0; match && i < shape.size(); ++i) match = out.shape(i) == shape[i];
+        if (!match) {
+            std::string expected;
+            for (py::ssize_t n : shape) expected += (expected.empty() ? "(" : ", ") + std::to_string(n);
+            throw std::invalid_argument("Numpy: out must have shape " + expected + ").");
+        }
+        const py::ssize_t item = out.itemsize();
+        const py::ssize_t pixel = item * (py::ssize_t)layout.numpy_channels;
+        const size_t row = shape.size() - (layout.numpy_channels > 1 ? 3 : 2);
+        if ((layout.numpy_channels > 1 && out.strides(row + 2) != item) || out.strides(row + 1) != pixel ||
+            out.strides(row) < pixel * shape[row + 1]) {
+            throw std::invalid_argument("Numpy: out pixels must be packed; rows may be strided.");
+        }
+        if (row == 1 && out.strides(0) < out.strides(1) * shape[1]) {
+            throw std::invalid_argument("Numpy: out slices must not overlap.");
+        }
+    }
+
+    void copy_or_convert(DXGI_FORMAT src_format, const void* src, size_t src_pitch, DXGI_FORMAT format, void* dst, size_t dst_pitch,
+                         uint32_t width, uint32_t height) {
+        if (format != src_format) {
+            Convert::convert(src_format, src, src_pitch, format, dst, dst_pitch, width, height);
+        } else {
+            Copy::copy_texels(format, dst, dst_pitch, src, src_pitch, width, height);
+        }
+    }
+
+    // Conversions from strided arrays: each band packs a row into scratch,
+    // or reads it in place when only the row stride is unusual, and converts it.
+    void convert_strided(DXGI_FORMAT src_format, const uint8_t* src, const Copy::Strides& strides, size_t item, uint32_t channels,
+                         DXGI_FORMAT dst_format, uint8_t* dst, size_t dst_pitch, uint32_t width, uint32_t height) {
+        const size_t row_bytes = item * channels * width;
+        const bool packed = strides.pixel == (ptrdiff_t)(item * channels) && (channels == 1 || strides.channel == (ptrdiff_t)item);
+        Scheduler::shared().for_each_band(height, row_bytes, [&](uint32_t y0, uint32_t y1) {
+            std::vector<uint8_t> scratch(packed ? 0 : row_bytes);
+            for (uint32_t y = y0; y < y1; ++y) {
+                const uint8_t* row = src + (ptrdiff_t)y * strides.row;
+                if (!packed) {
+                    Copy::gather_row(item, channels, row, strides, scratch.data(), width);
+                    row = scratch.data();
+                }
+                Convert::convert_row(src_format, row, dst_format, dst + (size_t)y * dst_pitch, width);
+            }
+        });
+    }
+
+    // One batch slice: resized in the source format, where there are usually
+    // fewer bytes per pixel, then converted.
+    void read_slice(const Source& src, DXGI_FORMAT format, uint8_t* dst, size_t dst_pitch, uint32_t width, uint32_t height,
+                    Resample::Filter filter, std::vector<uint8_t>& scratch) {
+        if (src.width == width && src.height == height) {
+            copy_or_convert(src.format, src.data, src.pitch, format, dst, dst_pitch, width, height);
+        } else if (format == src.format) {
+            Resample::resize(format, src.data, src.pitch, src.width, src.height, dst, dst_pitch, width, height, filter);
+        } else {
+            const size_t pitch = Formats::row_pitch(src.format, width);
+            scratch.resize(pitch * height);
+            Resample::resize(src.format, src.data, src.pitch, src.width, src.height, scratch.data(), pitch, width, height, filter);
+            Convert::convert(src.format, scratch.data(), pitch, format, dst, dst_pitch, width, height);
+        }
+    }
+
+    // An array over `data` whose base keeps `keep` alive.
+    py::array view(DXGI_FORMAT format, const void* data, size_t pitch, uint32_t width, uint32_t height, std::shared_ptr<void> keep,
+                   bool writable) {
+        const Formats::Traits& layout = readback_traits(format);
+        const py::dtype dtype(layout.numpy_dtype);
+        const py::ssize_t item = dtype.itemsize();
+        std::vector<py::ssize_t> shape = { (py::ssize_t)height, (py::ssize_t)width };
+        std::vector<py::ssize_t> strides = { (py::ssize_t)pitch, item * (py::ssize_t)layout.numpy_channels };
+        if (layout.numpy_channels > 1) {
+            shape.push_back(layout.numpy_channels);
+            strides.push_back(item);
+        }
+        py::capsule owner(new std::shared_ptr<void>(std::move(keep)), [](void* p) { delete static_cast<std::shared_ptr<void>*>(p); });
+        py::array result(dtype, shape, strides, data, owner);
+        if (!writable) {
+            result.attr("flags").attr("writeable") = false;
+        }
+        return result;
+    }
+
+}
+
+DirtyRect region(const py::object& rect, uint32_t width, uint32_t height) {
+    if (rect.is_none()) return { 0, 0, width, height };
+    DirtyRect box;
+    if (py::isinstance<DirtyRect>(rect)) {
+        box = rect.cast<DirtyRect>();
+    } else {
+        const py::sequence items = rect.cast<py::sequence>();
+        if (items.size() != 4) {
+            throw std::invalid_argument("Numpy: rect must be a DirtyRect or (x, y, width, height).");
+        }
+        box = { items[0].cast<uint32_t>(), items[1].cast<uint32_t>(), items[2].cast<uint32_t>(), items[3].cast<uint32_t>() };
+    }
+    if (box.width == 0 || box.height == 0 || (uint64_t)box.x + box.width > width || (uint64_t)box.y + box.height > height) {
+        throw std::invalid_argument("Numpy: rect (" + std::to_string(box.x) + ", " + std::to_string(box.y) + ", " + std::to_string(box.width) +
+                                    ", " + std::to_string(box.height) + ") does not fit a " + std::to_string(width) + "x" +
+                                    std::to_string(height) + " texture.");
+    }
+    return box;
+}
+
+DirtyRect placement(const py::object& dest, const py::array& array, uint32_t width, uint32_t height) {
+    if (array.ndim() < 2) {
+        throw std::invalid_argument("NumPy array must be 2D (HxW) or 3D (HxWxC).");
+    }
+    uint32_t x = 0, y = 0;
+    if (!dest.is_none()) {
+        const py::sequence items = dest.cast<py::sequence>();
+        if (items.size() != 2) {
+            throw std::invalid_argument("Numpy: dest must be (x, y).");
+        }
+        x = items[0].cast<uint32_t>();
+        y = items[1].cast<uint32_t>();
+    }
+    if (dest.is_none() && ((uint64_t)array.shape(0) != height || (uint64_t)array.shape(1) != width)) {
+        throw std::invalid_argument("NumPy array dimensions do not match the target texture.");
+    }
+    return region(py::make_tuple(x, y, array.shape(1), array.shape(0)), width, height);
+}
+
+size_t texel_offset(DXGI_FORMAT format, size_t pitch, uint32_t x, uint32_t y) {
+    return (size_t)y * pitch + (size_t)x * Formats::bytes_per_pixel(format);
+}
+
+DXGI_FORMAT format_for_dtype(DXGI_FORMAT format, const py::dtype& dtype) {
+    const std::string name = dtype_name(dtype);
+    const DXGI_FORMAT result = Formats::with_numpy_dtype(format, name.c_str());
+    if (result == DXGI_FORMAT_UNKNOWN) {
+        throw std::invalid_argument("Numpy: " + std::string(readback_traits(format).name) + " cannot be read as " + name + ".");
+    }
+    return result;
+}
+
+DXGI_FORMAT readback_format(DXGI_FORMAT src_format, DXGI_FORMAT format, const py::object& dtype) {
+    DXGI_FORMAT out_format = format == DXGI_FORMAT_UNKNOWN ? src_format : format;
+    if (!dtype.is_none()) {
+        out_format = format_for_dtype(out_format, py::dtype::from_args(dtype));
+    }
+    readback_traits(out_format);
+    if (out_format != src_format && (!Convert::is_supported(src_format) || !Convert::is_supported(out_format))) {
+        throw std::runtime_error("Numpy: Unsupported texture format for readback.");
+    }
+    return out_format;
+}
+
+py::array read_pixels(DXGI_FORMAT src_format, const void* src, size_t src_pitch, uint32_t width, uint32_t height,
+                      DXGI_FORMAT format, const py::object& dtype, const py::object& out) {
+    if (!out.is_none() && !py::isinstance<py::array>(out)) {
+        throw std::invalid_argument("Numpy: out must be a NumPy array.");
+    }
+    // Without a dtype, `out` picks it, so a float32 buffer reads an fp16 texture as float32.
+    py::object element = dtype;
+    if (dtype.is_none() && !out.is_none()) element = py::reinterpret_borrow<py::array>(out).dtype();
+    const DXGI_FORMAT out_format = readback_format(src_format, format, element);
+    const Formats::Traits& layout = readback_traits(out_format);
+
+    std::vector<py::ssize_t> shape = { (py::ssize_t)height, (py::ssize_t)width };
+    if (layout.numpy_channels > 1) shape.push_back(layout.numpy_channels);
+    py::array result = out.is_none() ? py::array(py::dtype(layout.numpy_dtype), shape) : py::reinterpret_borrow<py::array>(out);
+    if (!out.is_none()) check_destination(result, shape, layout);
+    void* dst = result.mutable_data();
+    const size_t dst_pitch = (size_t)result.strides(0);
+    {
+        py::gil_scoped_release release;
+        copy_or_convert(src_format, src, src_pitch, out_format, dst, dst_pitch, width, height);
+    }
+    return result;
+}
+
+py::array read_batch(const std::vector<Source>& sources, DXGI_FORMAT format, const py::object& dtype, const py::object& size,
+                     Resample::Filter filter, const py::object& out) {
+    if (sources.empty()) {
+        throw std::invalid_argument("Numpy: read_textures needs at least one texture.");
+    }
+    if (!out.is_none() && !py::isinstance<py::array>(out)) {
+        throw std::invalid_argument("Numpy: out must be a NumPy array.");
+    }
+    py::object element = dtype;
+    if (dtype.is_none() && !out.is_none()) element = py::reinterpret_borrow<py::array>(out).dtype();
+
+    const DXGI_FORMAT out_format = readback_format(sources[0].format, format, element);
+    uint32_t width = sources[0].width;
+    uint32_t height = sources[0].height;
+    if (!size.is_none()) {
+        const py::sequence items = size.cast<py::sequence>();
+        if (items.size() != 2 || items[0].cast<uint32_t>() == 0 || items[1].cast<uint32_t>() == 0) {
+            throw std::invalid_argument("Numpy: size must be (width, height).");
+        }
+        width = items[0].cast<uint32_t>();
+        height = items[1].cast<uint32_t>();
+    }
+    for (const Source& src : sources) {
+        if (readback_format(src.format, format, element) != out_format) {
+            throw std::invalid_argument("Numpy: the textures read back as different formats; pass format or dtype.");
+        }
+        if (size.is_none() && (src.width != width || src.height != height)) {
+            throw std::invalid_argument("Numpy: the textures differ in size; pass size to resize them to one.");
+        }
+    }
+
+    const Formats::Traits& layout = readback_traits(out_format);
+    std::vector<py::ssize_t> shape = { (py::ssize_t)sources.size(), (py::ssize_t)height, (py::ssize_t)width };
+    if (layout.numpy_channels > 1) shape.push_back(layout.numpy_channels);
+    py::array result = out.is_none() ? py::array(py::dtype(layout.numpy_dtype), shape) : py::reinterpret_borrow<py::array>(out);
+    if (!out.is_none()) check_destination(result, shape, layout);
+
+    auto* base = static_cast<uint8_t*>(result.mutable_data());
+    const size_t slice_stride = (size_t)result.strides(0);
+    const size_t row_stride = (size_t)result.strides(1);
+    {
+        py::gil_scoped_release release;
+        std::vector<uint8_t> scratch;
+        for (size_t i = 0; i < sources.size(); ++i) {
+            read_slice(sources[i], out_format, base + i * slice_stride, row_stride, width, height, filter, scratch);
+        }
+    }
+    return result;
+}
+
+py::array frame_array(const Readback::Frame& frame) {
+    if (!frame.pixels) {
+        throw std::runtime_error("Numpy: the readback has no pixels.");
+    }
+    return view(frame.format, frame.pixels->data(), frame.pitch(), frame.width, frame.height, frame.pixels, true);
+}
+
+Mapping::Mapping(DXGI_FORMAT format, void* data, size_t pitch, uint32_t width, uint32_t height, std::shared_ptr<void> keep,
+                 bool writable)
+    : format_(format), data_(data), pitch_(pitch), width_(width), height_(height), keep_(std::move(keep)), writable_(writable) {
+    readback_traits(format);
+    if (!data_ || !keep_) {
+        throw std::invalid_argument("Numpy: nothing to map.");
+    }
+}
+
+py::array Mapping::array() const {
+    if (!keep_) {
+        throw std::runtime_error("Numpy: the mapping has been released.");
+    }
+    return view(format_, data_, pitch_, width_, height_, keep_, writable_);
+}
+
+py::capsule Mapping::dlpack() const {
+    if (!keep_) {
+        throw std::runtime_error("Numpy: the mapping has been released.");
+    }
+    if (!writable_) {
+        throw py::buffer_error("Numpy: a read-only mapping cannot be exported through DLPack.");
+    }
+    return dlpack_capsule(DLPack::export_pixels(format_, data_, pitch_, width_, height_, keep_));
+}
+
+void Mapping::release() {
+    keep_.reset();
+}
+
+py::capsule dlpack_capsule(DLPack::DLManagedTensor* tensor) {
+    // Frees the tensor unless a consumer renamed the capsule, taking it over.
+    auto destructor = [](PyObject* capsule) {
+        if (PyCapsule_IsValid(capsule, DLPack::kUsedCapsuleName)) return;
+        PyObject *type, *value, *traceback;
+        PyErr_Fetch(&type, &value, &traceback);
+        auto* unused = static_cast<DLPack::DLManagedTensor*>(PyCapsule_GetPointer(capsule, DLPack::kCapsuleName));
+        if (unused && unused->deleter) unused->deleter(unused);
+        else PyErr_WriteUnraisable(capsule);
+        PyErr_Restore(type, value, traceback);
+    };
+    PyObject* capsule = PyCapsule_New(tensor, DLPack::kCapsuleName, destructor);
+    if (!capsule) {
+        tensor->deleter(tensor);
+        throw py::error_already_set();
+    }
+    return py::reinterpret_steal<py::capsule>(capsule);
+}
+
+py::array from_dlpack(const py::object& tensor) {
+    if (py::isinstance<py::array>(tensor)) return py::reinterpret_borrow<py::array>(tensor);
+    if (!py::hasattr(tensor, "__dlpack__")) {
+        throw py::type_error("Numpy: the object does not support DLPack.");
+    }
+    if (py::hasattr(tensor, "__dlpack_device__")) {
+        const py::tuple device = tensor.attr("__dlpack_device__")();
+        if (device[0].cast<int32_t>() != DLPack::kDLCPU && device[0].cast<int32_t>() != DLPack::kDLCUDAHost) {
+            throw py::buffer_error("Numpy: only CPU tensors can be imported; copy the tensor to the CPU first.");
+        }
+    }
+    py::object capsule = tensor.attr("__dlpack__")();
+    auto* managed = static_cast<DLPack::DLManagedTensor*>(PyCapsule_GetPointer(capsule.ptr(), DLPack::kCapsuleName));
+    if (!managed) throw py::error_already_set();
+    // Ours from here: the capsule is marked consumed and the array's base frees the tensor.
+    PyCapsule_SetName(capsule.ptr(), DLPack::kUsedCapsuleName);
+    py::capsule owner(managed, [](void* p) {
+        auto* t = static_cast<DLPack::DLManagedTensor*>(p);
+        if (t->deleter) t->deleter(t);
+    });
+
+    const DLPack::DLTensor& t = managed->dl_tensor;
+    const py::dtype dtype(DLPack::numpy_typestr(t.dtype));
+    const py::ssize_t item = dtype.itemsize();
+    std::vector<py::ssize_t> shape(t.shape, t.shape + t.ndim);
+    std::vector<py::ssize_t> strides(t.ndim);
+    for (int32_t i = t.ndim - 1; i >= 0; --i) {
+        strides[i] = t.strides ? (py::ssize_t)t.strides[i] * item : (i + 1 < t.ndim ? strides[i + 1] * shape[i + 1] : item);
+    }
+    return py::array(dtype, shape, strides, static_cast<uint8_t*>(t.data) + t.byte_offset, owner);
+}
+
+py::array as_array(const py::object& pixels) {
+    if (py::isinstance<py::array>(pixels)) return py::reinterpret_borrow<py::array>(pixels);
+    if (py::hasattr(pixels, "__dlpack__")) return from_dlpack(pixels);
+    py::array array = py::array::ensure(pixels);
+    if (!array) {
+        throw py::type_error("Numpy: pixels must be an array or support DLPack.");
+    }
+    return array;
+}
+
+py::capsule texture_dlpack(const std::shared_ptr<Texture>& texture, const py::kwargs& options) {
+    if (!texture || !texture->get_cpu_ptr()) {
+        throw py::buffer_error("Numpy: only CPU textures export through DLPack; read the texture back first.");
+    }
+    if (options.contains("copy") && py::bool_(options["copy"])) {
+        throw py::buffer_error("Numpy: texture exports are always zero-copy.");
+    }
+    if (options.contains("dl_device") && !options["dl_device"].is_none() &&
+        py::reinterpret_borrow<py::tuple>(options["dl_device"])[0].cast<int32_t>() != DLPack::kDLCPU) {
+        throw py::buffer_error("Numpy: CPU textures export to the CPU only.");
+    }
+    return dlpack_capsule(DLPack::export_pixels(texture->get_format(), reinterpret_cast<void*>(texture->get_cpu_ptr()),
+                                                texture->get_cpu_row_pitch(), texture->get_width(), texture->get_height(), texture));
+}
+
+py::tuple texture_dlpack_device(const std::shared_ptr<Texture>& texture) {
+    if (!texture || !texture->get_cpu_ptr()) {
+        throw py::buffer_error("Numpy: only CPU textures export through DLPack.");
+    }
+    return py::make_tuple((int32_t)DLPack::kDLCPU, 0);
+}
+
+py::capsule frame_dlpack(const Readback::Frame& frame) {
+    if (!frame.pixels) {
+        throw std::runtime_error("Numpy: the readback has no pixels.");
+    }
+    return dlpack_capsule(DLPack::export_pixels(frame.format, frame.pixels->data(), frame.pitch(), frame.width, frame.height, frame.pixels));
+}
+
+void then_array(const Readback::Future& future, const py::object& callback) {
+    if (callback.is_none()) return;
+    if (!PyCallable_Check(callback.ptr())) {
+        throw py::type_error("Numpy: the readback callback must be callable.");
+    }
+    // Released with the GIL held, since the queue may drop it from any thread.
+    std::shared_ptr<py::object> fn(new py::object(callback), [](py::object* p) {
+        py::gil_scoped_acquire acquire;
+        delete p;
+    });
+    future.then([fn](const Readback::Frame& frame) {
+        py::gil_scoped_acquire acquire;
+        try {
+            (*fn)(frame_array(frame));
+        } catch (py::error_already_set& e) {
+            e.discard_as_unraisable("directport readback callback");
+        } catch (const std::exception& e) {
+            PyErr_SetString(PyExc_RuntimeError, e.what());
+            PyErr_WriteUnraisable(fn->ptr());
+        }
+    });
+}
+
+void write_pixels(DXGI_FORMAT dst_format, void* dst, size_t dst_pitch, uint32_t width, uint32_t height,
+                  const py::array& array, DXGI_FORMAT format) {
+    py::buffer_info info = array.request();
+    if (info.ndim < 2 || info.ndim > 3) {
+        throw std::invalid_argument("NumPy array must be 2D (HxW) or 3D (HxWxC).");
+    }
+    if ((uint32_t)info.shape[0] != height || (uint32_t)info.shape[1] != width) {
+        throw std::invalid_argument("NumPy array dimensions do not match the target texture.");
+    }
+    const size_t channels = info.ndim == 3 ? (size_t)info.shape[2] : 1;
+    const size_t item = (size_t)info.itemsize;
+    // Any strides are taken as they are, so flipped, sliced and channel
+    // reordered views upload without np.ascontiguousarray first.
+    Copy::Strides strides;
+    strides.row = info.strides[0];
+    strides.pixel = info.strides[1];
+    strides.channel = info.ndim == 3 ? info.strides[2] : (ptrdiff_t)item;
+    const bool pitched = strides.pixel == (ptrdiff_t)(item * channels) && (channels == 1 || strides.channel == (ptrdiff_t)item) &&
+                         strides.row >= (ptrdiff_t)(item * channels * width);
+    const auto* src = static_cast<const uint8_t*>(info.ptr);
+    const std::string dtype = dtype_name(array.dtype());
+
+    // Three-channel uint8 arrays fill a four-channel 8-bit texture with opaque
+    // alpha; `format` gives their channel order, defaulting to the texture's.
+    const Formats::Traits* target = Formats::find(dst_format);
+    if (channels == 3 && dtype == "uint8" && target && target->sample == Formats::Sample::U8 && target->channels == 4) {
+        const Formats::Traits* source = format == DXGI_FORMAT_UNKNOWN ? target : Formats::find(format);
+        if (!source || source->sample != Formats::Sample::U8 || source->channels != 4) {
+            throw std::invalid_argument("Numpy: three-channel arrays need uint8 pixels and an 8-bit RGBA or BGRA format.");
+        }
+        Copy::Swizzle swizzle;
+        swizzle.src_channels = 3;
+        swizzle.swap_rb = source->bgra != target->bgra;
+        py::gil_scoped_release release;
+        Copy::transfer(swizzle, dst, dst_pitch, src, strides, width, height);
+        return;
+    }
+
+    DXGI_FORMAT src_format = format;
+    if (src_format == DXGI_FORMAT_UNKNOWN) {
+        src_format = array_format(dst_format, dtype, channels);
+    } else {
+        const Formats::Traits* source = Formats::find(src_format);
+        if (!source || !source->numpy_dtype || dtype != source->numpy_dtype || channels != source->numpy_channels) {
+            throw std::invalid_argument("Numpy: the array's dtype and channels do not match the given format.");
+        }
+    }
+    if (src_format != dst_format && (!Convert::is_supported(src_format) || !Convert::is_supported(dst_format))) {
+        throw std::invalid_argument("Numpy: Unsupported format conversion for write_texture.");
+    }
+    py::gil_scoped_release release;
+    if (pitched) {
+        copy_or_convert(src_format, src, (size_t)strides.row, dst_format, dst, dst_pitch, width, height);
+    } else if (src_format == dst_format) {
+        Copy::gather(item, (uint32_t)channels, dst, dst_pitch, src, strides, width, height);
+    } else {
+        convert_strided(src_format, src, strides, item, (uint32_t)channels, dst_format, static_cast<uint8_t*>(dst), dst_pitch, width, height);
+    }
+}
+
+}
@@ -0,0 +1,143 @@
+// DirectPortNumpyPixels.h
+#pragma once
+
+#include "DirectPort.h"
+#include "DirectPortDLPack.h"
+#include "DirectPortReadback.h"
+#include "DirectPortResample.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <pybind11/numpy.h>
+
+namespace py = pybind11;
+
+namespace DirectPort::Numpy {
+
+    // The CPU side of read_texture and write_texture, shared by every device
+    // that can map its textures: array layouts, dtype selection and the
+    // conversions between them. None of it touches a GPU. The transfers are
+    // called with the GIL and drop it for the copy loops, once the arrays
+    // are checked and allocated; the caller keeps them referenced meanwhile.
+
+    // The part of a width x height texture a read touches: `rect` is a
+    // DirtyRect or (x, y, width, height), None for the whole surface. Throws
+    // std::invalid_argument when it is empty or reaches past the texture.
+    DirtyRect region(const py::object& rect, uint32_t width, uint32_t height);
+    // The box an (rows, cols, ...) array covers when written at `dest`, an
+    // (x, y) pair or None for the origin; throws when it does not fit.
+    DirtyRect placement(const py::object& dest, const py::array& array, uint32_t width, uint32_t height);
+    // Byte offset of pixel (x, y) in rows `pitch` bytes apart.
+    size_t texel_offset(DXGI_FORMAT format, size_t pitch, uint32_t x, uint32_t y);
+
+    // The format an array of `dtype` ("uint8", "float16", "float32", ...) reads
+    // back as from a `format` texture: `format` when its layout already uses
+    // that dtype, otherwise the convertible format with the same channels.
+    // Throws std::invalid_argument when there is none.
+    DXGI_FORMAT format_for_dtype(DXGI_FORMAT format, const py::dtype& dtype);
+
+    // The format read_pixels would produce from `src_format` for these
+    // arguments, validated, so asynchronous reads fail when issued rather than
+    // when resolved.
+    DXGI_FORMAT readback_format(DXGI_FORMAT src_format, DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN,
+                                const py::object& dtype = py::none());
+
+    // Mapped pixels to a new array. `format` converts on the way, UNKNOWN
+    // keeps `src_format`; a dtype (None for the format's own) then picks the
+    // array's element type, so an fp16 texture can read straight to float32.
+    // With `out`, the pixels land there instead and `out` is returned: it
+    // must have the result's shape and dtype (which it supplies when `dtype`
+    // is None) and packed pixels, but its rows may be strided, so a view of
+    // part of a larger array works.
+    py::array read_pixels(DXGI_FORMAT src_format, const void* src, size_t src_pitch, uint32_t width, uint32_t height,
+                          DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN, const py::object& dtype = py::none(),
+                          const py::object& out = py::none());
+
+    // Mapped pixels of one texture in a batch read.
+    struct Source {
+        DXGI_FORMAT format;
+        const void* data;
+        size_t pitch;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Several textures into one (N, height, width[, C]) array, each written
+    // straight into its slice. Every source must read back as the same format
+    // under `format` and `dtype`; `size` (width, height) resizes each with
+    // `filter`, and without it the sources must all be one size. `out` as for
+    // read_pixels, with the batch axis first.
+    py::array read_batch(const std::vector<Source>& sources, DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN,
+                         const py::object& dtype = py::none(), const py::object& size = py::none(),
+                         Resample::Filter filter = Resample::Filter::Bilinear, const py::object& out = py::none());
+
+    // A finished asynchronous readback as an array over its pixels, without a
+    // copy: the array keeps the frame's buffer alive.
+    py::array frame_array(const Readback::Frame& frame);
+
+    // Mapped pixels handed out as NumPy views instead of copies: what
+    // map_texture returns. `keep` owns the mapping (a CPU texture, or a
+    // staging texture plus its unmap) and every view holds a reference, so
+    // the memory stays valid until release() and the last view are gone,
+    // whichever is later.
+    class Mapping {
+    public:
+        // Throws std::runtime_error for formats without a NumPy layout.
+        Mapping(DXGI_FORMAT format, void* data, size_t pitch, uint32_t width, uint32_t height, std::shared_ptr<void> keep,
+                bool writable);
+
+        // A view with the mapping's row pitch as its row stride.
+        py::array array() const;
+        // The same memory as a DLPack capsule; py::buffer_error when the
+        // mapping is read-only, which DLPack cannot signal.
+        py::capsule dlpack() const;
+        void release();
+        bool released() const { return keep_ == nullptr; }
+        bool writable() const { return writable_; }
+
+    private:
+        DXGI_FORMAT format_;
+        void* data_;
+        size_t pitch_;
+        uint32_t width_;
+        uint32_t height_;
+        std::shared_ptr<void> keep_;
+        bool writable_;
+    };
+
+    // DLPack, for handing frames to PyTorch, CuPy or JAX without a copy.
+    // Only CPU memory is exchanged: D3D textures have no device-side
+    // interop here, so they go through a readback first.
+
+    // `tensor` as a "dltensor" capsule that frees it if never consumed.
+    py::capsule dlpack_capsule(DLPack::DLManagedTensor* tensor);
+    // A CPU tensor from any __dlpack__ producer as an array viewing its
+    // memory; arrays pass through. py::buffer_error for device memory.
+    py::array from_dlpack(const py::object& tensor);
+    // What write_texture accepts: arrays, DLPack producers (imported without
+    // a copy) and anything NumPy can make an array of.
+    py::array as_array(const py::object& pixels);
+    // __dlpack__ and __dlpack_device__ for textures with CPU memory; others
+    // raise py::buffer_error.
+    py::capsule texture_dlpack(const std::shared_ptr<Texture>& texture, const py::kwargs& options);
+    py::tuple texture_dlpack_device(const std::shared_ptr<Texture>& texture);
+    // A finished readback's pixels, shared with the frame.
+    py::capsule frame_dlpack(const Readback::Frame& frame);
+
+    // Calls `callback(array)` once `future` resolves, with the GIL, on
+    // whichever thread resolves it. Exceptions it raises are reported as
+    // unraisable rather than propagated into the resolving call.
+    void then_array(const Readback::Future& future, const py::object& callback);
+
+    // An array into mapped pixels of `dst_format`. `format` names the array's
+    // pixel format; with UNKNOWN it is inferred from the array's dtype and
+    // channels, so float32 arrays convert into fp16 and 8-bit textures. Arrays
+    // whose layout matches no format are rejected rather than copied as bytes.
+    // (height, width, 3) uint8 arrays fill 8-bit RGBA and BGRA textures with
+    // opaque alpha. Views with any strides are gathered during the copy, so
+    // img[::-1], img[:, ::2] and rgba[..., :3] need no contiguous copy first.
+    void write_pixels(DXGI_FORMAT dst_format, void* dst, size_t dst_pitch, uint32_t width, uint32_t height,
+                      const py::array& array, DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN);
+
+}
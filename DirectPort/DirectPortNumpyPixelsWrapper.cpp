@@ -0,0 +1,21 @@
+#include "DirectPortNumpyPixels.h"
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+void bind_numpy_pixels(py::module_& m) {
+    // Returned by map_texture on every device that supports it.
+    py::class_<Numpy::Mapping>(m, "TextureMapping", "Texture memory mapped for NumPy; a context manager yielding the array.")
+        .def_property_readonly("array", &Numpy::Mapping::array, "A view over the mapped rows, strided by the row pitch.")
+        .def_property_readonly("released", &Numpy::Mapping::released)
+        .def_property_readonly("writable", &Numpy::Mapping::writable)
+        .def("release", &Numpy::Mapping::release, "Drops this mapping's hold; views still alive keep the memory mapped until they die.")
+        .def("__dlpack__", [](const Numpy::Mapping& mapping, const py::kwargs&) { return mapping.dlpack(); })
+        .def("__dlpack_device__", [](const Numpy::Mapping&) { return py::make_tuple((int32_t)DLPack::kDLCPU, 0); })
+        .def("__enter__", &Numpy::Mapping::array)
+        .def("__exit__", [](Numpy::Mapping& mapping, const py::args&) { mapping.release(); });
+
+    m.def("from_dlpack", &Numpy::from_dlpack, py::arg("tensor"),
+        "A NumPy array viewing a CPU tensor from PyTorch, CuPy, JAX or any other DLPack producer, without a copy.");
+}
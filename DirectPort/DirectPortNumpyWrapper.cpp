@@ -1,20 +1,79 @@
 #include "DirectPortNumpy.h"
+#include "DirectPortNumpyPixels.h"
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 namespace py = pybind11;
 
 void bind_numpy(py::module_& m) {
     auto numpy_module = m.def_submodule("numpy", "The fiefdom for NumPy-GPU interoperability.");
 
+    // None keeps the texture's own format.
+    auto format_or_unknown = [](const py::object& format) {
+        return format.is_none() ? DXGI_FORMAT_UNKNOWN : format.cast<DXGI_FORMAT>();
+    };
+
     numpy_module.def("read_texture",
-        &DirectPort::Numpy::read_texture,
-        py::arg("device"), py::arg("texture"),
-        "Reads a GPU texture to a NumPy array without copying in Python."
+        [format_or_unknown](std::shared_ptr<DirectPort::DeviceD3D11> device, std::shared_ptr<DirectPort::Texture> texture, const py::object& format, const py::object& dtype, const py::object& out, const py::object& rect) {
+            return DirectPort::Numpy::read_texture(device, texture, format_or_unknown(format), dtype, out, rect);
+        },
+        py::arg("device"), py::arg("texture"), py::arg("format") = py::none(), py::arg("dtype") = py::none(), py::arg("out") = py::none(),
+        py::arg("rect") = py::none(),
+        "Reads a GPU texture, or its (x, y, width, height) `rect`, to a NumPy array without copying in Python, converting to "
+        "`format` and `dtype` if given. With `out`, fills that array (or view) instead of allocating one and returns it."
+    );
+
+    numpy_module.def("read_textures",
+        [format_or_unknown](std::shared_ptr<DirectPort::DeviceD3D11> device, const std::vector<std::shared_ptr<DirectPort::Texture>>& textures, const py::object& format, const py::object& dtype, const py::object& size, DirectPort::Resample::Filter filter, const py::object& out) {
+            return DirectPort::Numpy::read_textures(device, textures, format_or_unknown(format), dtype, size, filter, out);
+        },
+        py::arg("device"), py::arg("textures"), py::arg("format") = py::none(), py::arg("dtype") = py::none(), py::arg("size") = py::none(),
+        py::arg("filter") = DirectPort::Resample::Filter::Bilinear, py::arg("out") = py::none(),
+        "Reads several textures into one (N, H, W, C) array with a single wait, resized to `size` (width, height) if given."
     );
 
     numpy_module.def("write_texture",
-        &DirectPort::Numpy::write_texture,
-        py::arg("device"), py::arg("texture"), py::arg("numpy_array"),
-        "Writes a NumPy array's contents to a GPU texture."
+        [format_or_unknown](std::shared_ptr<DirectPort::DeviceD3D11> device, std::shared_ptr<DirectPort::Texture> texture, const py::object& numpy_array, const py::object& format, const py::object& dest) {
+            DirectPort::Numpy::write_texture(device, texture, DirectPort::Numpy::as_array(numpy_array), format_or_unknown(format), dest);
+        },
+        py::arg("device"), py::arg("texture"), py::arg("numpy_array"), py::arg("format") = py::none(), py::arg("dest") = py::none(),
+        "Writes a NumPy array or CPU DLPack tensor to a GPU texture, at `dest` (x, y) if given, converting from the format its dtype implies; "
+        "`format` names it explicitly."
     );
+
+    numpy_module.def("map_texture", &DirectPort::Numpy::map_texture, py::arg("device"), py::arg("texture"),
+        "A TextureMapping whose array views the mapped staging copy, saving read_texture's copy; use it as a context manager.");
+
+    // The device's immediate context is multithread-protected and each readback
+    // maps its own staging texture, so readbacks resolve without the GIL, like
+    // read_texture's wait.
+    numpy_module.def("read_texture_async",
+        [format_or_unknown](std::shared_ptr<DirectPort::DeviceD3D11> device, std::shared_ptr<DirectPort::Texture> texture, const py::object& format, const py::object& dtype, const py::object& callback) {
+            if (!texture) {
+                throw py::value_error("Invalid D3D11 texture provided.");
+            }
+            const DXGI_FORMAT out_format = DirectPort::Numpy::readback_format(texture->get_format(), format_or_unknown(format), dtype);
+            DirectPort::Readback::Future future;
+            {
+                py::gil_scoped_release release;
+                future = DirectPort::Numpy::read_texture_async(device, texture, out_format);
+            }
+            DirectPort::Numpy::then_array(future, callback);
+            return future;
+        },
+        py::arg("device"), py::arg("texture"), py::arg("format") = py::none(), py::arg("dtype") = py::none(), py::arg("callback") = py::none(),
+        "Starts a readback and returns a ReadbackFuture; frames resolve in order, `depth` submissions behind the newest."
+    );
+    numpy_module.def("readback_stats", &DirectPort::Numpy::readback_stats, py::arg("device"), "");
+    numpy_module.def("poll_readbacks", &DirectPort::Numpy::poll_readbacks, py::arg("device"),
+        "Resolves finished readbacks without waiting; returns how many.", py::call_guard<py::gil_scoped_release>());
+    numpy_module.def("flush_readbacks", &DirectPort::Numpy::flush_readbacks, py::arg("device"),
+        "Resolves every readback in flight.", py::call_guard<py::gil_scoped_release>());
+    numpy_module.def("set_readback_depth", &DirectPort::Numpy::set_readback_depth, py::arg("device"), py::arg("depth"),
+        "Readbacks kept in flight before the oldest is mapped.");
+
+    numpy_module.def("staging_stats", &DirectPort::Numpy::staging_stats, py::arg("device"),
+        "Counts for the staging textures read_texture and write_texture reuse on this device.");
+    numpy_module.def("trim_staging", &DirectPort::Numpy::trim_staging, py::arg("device"), py::arg("all") = false,
+        "Releases idle staging textures now (every unused one with all=True); returns how many.");
 }
\ No newline at end of file
@@ -0,0 +1,276 @@
+// src/DirectPort/DirectPortReadback.cpp
+// Two locks: `mutex` guards the list of transfers and is only held briefly,
+// `resolve_mutex` is held while transfers are mapped and converted, so they
+// resolve one at a time and in order, which also keeps a D3D11 immediate
+// context to one thread. Callbacks run after both are released.
+
+#include "DirectPortReadback.h"
+#include "DirectPortConvert.h"
+#include "DirectPortCopy.h"
+#include "DirectPortFormats.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+using namespace DirectPort;
+using namespace DirectPort::Readback;
+
+size_t Frame::pitch() const {
+    return (size_t)width * Formats::bytes_per_pixel(format);
+}
+
+struct Future::State {
+    std::weak_ptr<Queue::Impl> queue;
+    uint64_t index = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    Frame frame;
+    std::exception_ptr error;
+    std::vector<Callback> callbacks;
+};
+
+struct Queue::Impl {
+    struct Entry {
+        std::unique_ptr<Transfer> transfer;
+        std::shared_ptr<Future::State> state;
+        DXGI_FORMAT src_format;
+        DXGI_FORMAT format;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct Finished {
+        std::shared_ptr<Future::State> state;
+        std::vector<Future::Callback> callbacks;
+    };
+
+    // Finishes a state; returns the callbacks to run once the locks are released.
+    static std::vector<Future::Callback> complete(Future::State& state, Frame frame, std::exception_ptr error) {
+        std::vector<Future::Callback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.frame = std::move(frame);
+            state.error = error;
+            state.done = true;
+            if (!error) callbacks.swap(state.callbacks);
+            else state.callbacks.clear();
+        }
+        state.cv.notify_all();
+        return callbacks;
+    }
+
+    static void run_callbacks(std::vector<Finished>& finished) {
+        for (Finished& f : finished) {
+            for (auto& callback : f.callbacks) callback(f.state->frame);
+        }
+        finished.clear();
+    }
+
+    mutable std::mutex mutex;
+    std::mutex resolve_mutex;
+    std::deque<Entry> entries;
+    uint32_t depth;
+    uint64_t next_index = 0;
+    Stats stats;
+
+    // Resolves the oldest transfer, if there is one and it is ready or `wait`
+    // allows waiting for it. Call with resolve_mutex held.
+    bool resolve_front(bool wait, std::vector<Finished>& finished) {
+        Entry entry;
+        bool waited = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (entries.empty()) return false;
+            if (!entries.front().transfer->ready()) {
+                if (!wait) return false;
+                waited = true;
+            }
+            entry = std::move(entries.front());
+            entries.pop_front();
+        }
+
+        Frame frame;
+        frame.format = entry.format;
+        frame.width = entry.width;
+        frame.height = entry.height;
+        frame.index = entry.state->index;
+        std::exception_ptr error;
+        try {
+            const size_t pitch = frame.pitch();
+            frame.pixels = std::make_shared<std::vector<uint8_t>>(pitch * frame.height);
+            entry.transfer->read([&](const void* data, size_t src_pitch) {
+                if (entry.format == entry.src_format) {
+                    Copy::copy_texels(entry.format, frame.pixels->data(), pitch, data, src_pitch, frame.width, frame.height);
+                } else {
+                    Convert::convert(entry.src_format, data, src_pitch, entry.format, frame.pixels->data(), pitch, frame.width, frame.height);
+                }
+            });
+        } catch (...) {
+            error = std::current_exception();
+            frame.pixels.reset();
+        }
+        entry.transfer.reset();  // returns the staging resource before callbacks run
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.waited += waited ? 1 : 0;
+            ++(error ? stats.failed : stats.completed);
+        }
+        finished.push_back({ entry.state, complete(*entry.state, std::move(frame), error) });
+        return true;
+    }
+
+    size_t in_flight() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    void resolve_through(uint64_t index) {
+        std::vector<Finished> finished;
+        {
+            std::lock_guard<std::mutex> resolving(resolve_mutex);
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (entries.empty() || entries.front().state->index > index) break;
+                }
+                resolve_front(true, finished);
+            }
+        }
+        run_callbacks(finished);
+    }
+};
+
+// --- Future ---
+
+bool Future::done() const {
+    if (!state_) return false;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->done;
+}
+
+uint64_t Future::index() const {
+    return state_ ? state_->index : 0;
+}
+
+const Frame& Future::result() const {
+    if (!state_) {
+        throw std::runtime_error("Readback::Future: no readback.");
+    }
+    if (!done()) {
+        if (auto queue = state_->queue.lock()) queue->resolve_through(state_->index);
+    }
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->cv.wait(lock, [&] { return state_->done; });
+    if (state_->error) std::rethrow_exception(state_->error);
+    return state_->frame;
+}
+
+void Future::then(Callback callback) const {
+    if (!state_ || !callback) return;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->done) {
+            state_->callbacks.push_back(std::move(callback));
+            return;
+        }
+        if (state_->error) return;
+    }
+    callback(state_->frame);
+}
+
+// --- Queue ---
+
+Queue::Queue(uint32_t depth) : pImpl(std::make_shared<Impl>()) {
+    pImpl->depth = depth;
+}
+
+Queue::~Queue() {
+    std::deque<Impl::Entry> pending;
+    {
+        std::lock_guard<std::mutex> resolving(pImpl->resolve_mutex);
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pending.swap(pImpl->entries);
+    }
+    const auto error = std::make_exception_ptr(std::runtime_error("Readback: the queue was destroyed before the frame was read."));
+    for (Impl::Entry& entry : pending) {
+        entry.transfer.reset();
+        Impl::complete(*entry.state, Frame(), error);
+    }
+}
+
+Future Queue::push(std::unique_ptr<Transfer> transfer, DXGI_FORMAT src_format, uint32_t width, uint32_t height, DXGI_FORMAT format) {
+    if (!transfer) {
+        throw std::invalid_argument("Readback::Queue::push: no transfer.");
+    }
+    if (format == DXGI_FORMAT_UNKNOWN) format = src_format;
+    if (Formats::bytes_per_pixel(format) == 0 ||
+        (format != src_format && (!Convert::is_supported(src_format) || !Convert::is_supported(format)))) {
+        throw std::invalid_argument("Readback::Queue::push: unsupported format conversion.");
+    }
+
+    Future future;
+    future.state_ = std::make_shared<Future::State>();
+    future.state_->queue = pImpl;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        future.state_->index = pImpl->next_index++;
+        pImpl->entries.push_back({ std::move(transfer), future.state_, src_format, format, width, height });
+        ++pImpl->stats.submitted;
+    }
+
+    std::vector<Impl::Finished> finished;
+    {
+        std::lock_guard<std::mutex> resolving(pImpl->resolve_mutex);
+        while (pImpl->in_flight() > pImpl->depth && pImpl->resolve_front(true, finished)) {}
+        while (pImpl->resolve_front(false, finished)) {}
+    }
+    Impl::run_callbacks(finished);
+    return future;
+}
+
+size_t Queue::poll() {
+    std::vector<Impl::Finished> finished;
+    {
+        std::lock_guard<std::mutex> resolving(pImpl->resolve_mutex);
+        while (pImpl->resolve_front(false, finished)) {}
+    }
+    const size_t count = finished.size();
+    Impl::run_callbacks(finished);
+    return count;
+}
+
+void Queue::flush() {
+    std::vector<Impl::Finished> finished;
+    {
+        std::lock_guard<std::mutex> resolving(pImpl->resolve_mutex);
+        while (pImpl->resolve_front(true, finished)) {}
+    }
+    Impl::run_callbacks(finished);
+}
+
+uint32_t Queue::depth() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->depth;
+}
+
+void Queue::set_depth(uint32_t depth) {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->depth = depth;
+}
+
+Queue::Stats Queue::get_stats() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    Stats stats = pImpl->stats;
+    stats.in_flight = (uint32_t)pImpl->entries.size();
+    return stats;
+}
+
+void Queue::reset_stats() {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->stats = Stats();
+}
@@ -0,0 +1,109 @@
+// DirectPortReadback.h
+#pragma once
+
+#include "DirectPortPlatform.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace DirectPort::Readback {
+
+    // Frames in flight before the oldest is mapped: enough for the GPU to
+    // finish a copy while the next frame renders.
+    constexpr uint32_t kDefaultDepth = 2;
+
+    // One texture copy in flight to CPU-visible memory, made by a backend: a
+    // staging texture plus an event query on D3D11, a snapshot on DeviceCPU.
+    class Transfer {
+    public:
+        virtual ~Transfer() = default;
+        // True once the copy has finished; never blocks.
+        virtual bool ready() = 0;
+        // Maps the copy, waiting for it if needed, and hands the rows to `fn`.
+        virtual void read(const std::function<void(const void* data, size_t pitch)>& fn) = 0;
+    };
+
+    // A finished readback: tightly packed rows of `format`.
+    struct Frame {
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint64_t index = 0;
+        std::shared_ptr<std::vector<uint8_t>> pixels;
+
+        size_t pitch() const;
+    };
+
+    class Queue;
+
+    // The result of one Queue::push. result() resolves this readback, and
+    // every older one, if the queue has not got to it yet.
+    class Future {
+    public:
+        using Callback = std::function<void(const Frame&)>;
+
+        Future() = default;
+
+        bool valid() const { return state_ != nullptr; }
+        bool done() const;
+        uint64_t index() const;
+        // Blocks until the frame is read back; rethrows the backend's error.
+        const Frame& result() const;
+        // Runs `callback` with the frame once it is read back, on the thread
+        // that resolves it, or now if it already has been. Not called on error.
+        void then(Callback callback) const;
+
+    private:
+        friend class Queue;
+        struct State;
+        std::shared_ptr<State> state_;
+    };
+
+    // Pipelines readbacks with a fixed latency: push() starts frame N's copy
+    // and maps frame N - depth, which the GPU has long finished by then, so
+    // the caller never waits on the copy it just issued. Transfers that are
+    // already ready are resolved early, in order. Resolving converts to the
+    // requested format and runs callbacks outside the queue's lock, so a
+    // callback may push the next readback. Thread-safe.
+    class Queue {
+    public:
+        struct Stats {
+            uint64_t submitted = 0;
+            uint64_t completed = 0;
+            uint64_t failed = 0;
+            // Resolutions that had to wait for the copy: the stalls the
+            // pipeline exists to avoid. Non-zero means depth is too small.
+            uint64_t waited = 0;
+            uint32_t in_flight = 0;
+        };
+
+        explicit Queue(uint32_t depth = kDefaultDepth);
+        // Pending readbacks fail with std::runtime_error.
+        ~Queue();
+        Queue(const Queue&) = delete;
+        Queue& operator=(const Queue&) = delete;
+
+        // `transfer` holds a copy of a src_format texture; the frame is read
+        // back as `format` (UNKNOWN keeps src_format), converting if they
+        // differ. Throws std::invalid_argument for unconvertible pairs.
+        Future push(std::unique_ptr<Transfer> transfer, DXGI_FORMAT src_format, uint32_t width, uint32_t height,
+                    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN);
+        // Resolves every leading transfer that is ready, without waiting; returns how many.
+        size_t poll();
+        // Resolves everything in flight, waiting as needed.
+        void flush();
+
+        uint32_t depth() const;
+        void set_depth(uint32_t depth);
+        Stats get_stats() const;
+        void reset_stats();
+
+    private:
+        friend class Future;
+        struct Impl;
+        std::shared_ptr<Impl> pImpl;
+    };
+
+}
@@ -0,0 +1,48 @@
+#include "DirectPortReadback.h"
+#include "DirectPortNumpyPixels.h"
+#include <pybind11/pybind11.h>
+#include <string>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    const Readback::Frame& resolve(const Readback::Future& future) {
+        py::gil_scoped_release release;
+        return future.result();
+    }
+
+}
+
+void bind_readback(py::module_& m) {
+    m.attr("READBACK_DEFAULT_DEPTH") = Readback::kDefaultDepth;
+
+    py::class_<Readback::Queue::Stats>(m, "ReadbackStats", "")
+        .def_readonly("submitted", &Readback::Queue::Stats::submitted)
+        .def_readonly("completed", &Readback::Queue::Stats::completed)
+        .def_readonly("failed", &Readback::Queue::Stats::failed)
+        .def_readonly("waited", &Readback::Queue::Stats::waited, "Readbacks that stalled on their copy; raise the depth if this grows.")
+        .def_readonly("in_flight", &Readback::Queue::Stats::in_flight)
+        .def("__repr__", [](const Readback::Queue::Stats& s) {
+            return "<ReadbackStats " + std::to_string(s.submitted) + " submitted, " + std::to_string(s.completed) + " completed, " +
+                   std::to_string(s.waited) + " waited, " + std::to_string(s.in_flight) + " in flight>";
+        });
+
+    // Returned by read_texture_async on every device that supports it.
+    py::class_<Readback::Future>(m, "ReadbackFuture", "A texture readback in flight.")
+        .def_property_readonly("done", &Readback::Future::done)
+        .def_property_readonly("index", &Readback::Future::index, "Submission order on the device's readback queue.")
+        // Resolving may wait on the GPU and copy rows, so it runs without the GIL.
+        .def("result", [](const Readback::Future& future) {
+            return Numpy::frame_array(resolve(future));
+        }, "The frame as a NumPy array, waiting for it (and every older readback) if needed.")
+        .def("__dlpack__", [](const Readback::Future& future, const py::kwargs&) { return Numpy::frame_dlpack(resolve(future)); },
+             "Resolves the readback and shares its pixels as a DLPack tensor.")
+        .def("__dlpack_device__", [](const Readback::Future&) { return py::make_tuple((int32_t)DLPack::kDLCPU, 0); })
+        .def("add_done_callback", &Numpy::then_array, py::arg("callback"),
+             "callback(array) runs once the frame is read back, immediately if it already is.")
+        .def("__repr__", [](const Readback::Future& future) {
+            return "<ReadbackFuture #" + std::to_string(future.index()) + (future.done() ? " done>" : " pending>");
+        });
+}
@@ -0,0 +1,427 @@
+// src/DirectPort/DirectPortResample.cpp
+// A separable resampler. Each axis gets a filter bank up front: for every
+// output pixel, a first source index and a fixed number of weights. An output
+// row is then one vertical pass over its source rows, contiguous and vectorised
+// across the whole row, into a float row, and one horizontal pass out of it.
+
+#include "DirectPortResample.h"
+#include "DirectPortConvert.h"
+#include "DirectPortCopy.h"
+#include "DirectPortFormats.h"
+#include "DirectPortScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "DirectPortSimd.h"
+
+using namespace DirectPort;
+using Resample::Filter;
+
+namespace {
+
+    const double kPi = 3.14159265358979323846;
+
+    double sinc(double x) {
+        if (x == 0.0) return 1.0;
+        x *= kPi;
+        return std::sin(x) / x;
+    }
+
+    double support(Filter filter) {
+        switch (filter) {
+        case Filter::Bicubic: return 2.0;
+        case Filter::Lanczos: return 3.0;
+        default: return 1.0;
+        }
+    }
+
+    double kernel(Filter filter, double x) {
+        x = std::fabs(x);
+        switch (filter) {
+        case Filter::Bicubic: {
+            const double a = -0.5;
+            if (x < 1.0) return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+            if (x < 2.0) return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+            return 0.0;
+        }
+        case Filter::Lanczos: return x < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+        default: return x < 1.0 ? 1.0 - x : 0.0;
+        }
+    }
+
+    // Output pixel i reads source pixels [first[i], first[i] + taps).
+    struct Bank {
+        uint32_t taps = 0;
+        std::vector<uint32_t> first;
+        std::vector<double> weights;
+        std::vector<float> weights_f;
+    };
+
+    Bank make_bank(Filter filter, uint32_t src_len, uint32_t dst_len) {
+        const double scale = (double)src_len / dst_len;
+        const double filter_scale = std::max(scale, 1.0);
+        const double radius = support(filter) * filter_scale;
+        std::vector<uint32_t> lo(dst_len);
+        std::vector<std::vector<double>> taps(dst_len);
+        size_t widest = 1;
+        for (uint32_t i = 0; i < dst_len; ++i) {
+            int64_t a, b;
+            std::vector<double>& w = taps[i];
+            if (filter == Filter::Area) {
+                const double x0 = i * scale, x1 = (i + 1) * scale;
+                a = (int64_t)std::floor(x0);
+                b = std::min<int64_t>(src_len, (int64_t)std::ceil(x1));
+                for (int64_t j = a; j < b; ++j) w.push_back(std::min((double)j + 1.0, x1) - std::max((double)j, x0));
+            } else {
+                const double center = (i + 0.5) * scale;
+                a = std::max<int64_t>(0, (int64_t)std::floor(center - radius));
+                b = std::min<int64_t>(src_len, (int64_t)std::ceil(center + radius));
+                for (int64_t j = a; j < b; ++j) w.push_back(kernel(filter, (j + 0.5 - center) / filter_scale));
+            }
+            // Zero weights at the ends only cost loads.
+            size_t skip = 0;
+            while (skip + 1 < w.size() && w[skip] == 0.0) ++skip;
+            while (w.size() > skip + 1 && w.back() == 0.0) w.pop_back();
+            w.erase(w.begin(), w.begin() + skip);
+            a += (int64_t)skip;
+            double sum = 0.0;
+            for (double v : w) sum += v;
+            for (double& v : w) v = sum != 0.0 ? v / sum : 1.0 / w.size();
+            lo[i] = (uint32_t)a;
+            widest = std::max(widest, w.size());
+        }
+
+        // Every pixel gets the same tap count, its window slid back inside the image.
+        Bank bank;
+        bank.taps = (uint32_t)std::min<size_t>(widest, src_len);
+        bank.first.resize(dst_len);
+        bank.weights.assign((size_t)dst_len * bank.taps, 0.0);
+        for (uint32_t i = 0; i < dst_len; ++i) {
+            const uint32_t first = std::min(lo[i], src_len - bank.taps);
+            bank.first[i] = first;
+            for (size_t k = 0; k < taps[i].size(); ++k) bank.weights[(size_t)i * bank.taps + (lo[i] - first) + k] = taps[i][k];
+        }
+        bank.weights_f.assign(bank.weights.begin(), bank.weights.end());
+        return bank;
+    }
+
+    // Channel count and sample type of the formats filtered directly; 0 for the rest.
+    struct Layout {
+        uint32_t channels;
+        bool u8;
+    };
+
+    Layout layout_of(DXGI_FORMAT format) {
+        const Formats::Traits* t = Formats::find(format);
+        if (!Formats::is_convertible(format) || (t->sample != Formats::Sample::U8 && t->sample != Formats::Sample::F32)) {
+            return { 0, false };
+        }
+        return { t->channels, t->sample == Formats::Sample::U8 };
+    }
+
+    // Round to nearest even, as cvtps2dq does, after clamping to 0..255.
+    inline uint8_t to_u8(float v) {
+        v = std::min(std::max(v, 0.0f), 255.0f);
+        return (uint8_t)(int)((v + 12582912.0f) - 12582912.0f);
+    }
+
+    inline void store(uint8_t* out, float v) { *out = to_u8(v); }
+    inline void store(float* out, float v) { *out = v; }
+
+    // --- Scalar kernels ---
+
+    // out[i] = sum over k of w[k] * rows[k][i], one source row at a time.
+    template <typename T>
+    void vertical_scalar(const T* const* rows, const float* w, uint32_t taps, uint32_t n, float* out) {
+        for (uint32_t i = 0; i < n; ++i) out[i] = w[0] * (float)rows[0][i];
+        for (uint32_t k = 1; k < taps; ++k) {
+            const T* row = rows[k];
+            const float wk = w[k];
+            for (uint32_t i = 0; i < n; ++i) out[i] += wk * (float)row[i];
+        }
+    }
+
+    template <typename T>
+    void vertical_tail(const T* const* rows, const float* w, uint32_t taps, uint32_t i, uint32_t n, float* out) {
+        for (; i < n; ++i) {
+            float acc = 0.0f;
+            for (uint32_t k = 0; k < taps; ++k) acc += w[k] * (float)rows[k][i];
+            out[i] = acc;
+        }
+    }
+
+    template <typename T>
+    void horizontal_scalar(const float* row, const Bank& bank, uint32_t channels, uint32_t n, T* out) {
+        for (uint32_t x = 0; x < n; ++x) {
+            const float* w = &bank.weights_f[(size_t)x * bank.taps];
+            const float* p = row + (size_t)bank.first[x] * channels;
+            for (uint32_t c = 0; c < channels; ++c) {
+                float acc = 0.0f;
+                for (uint32_t k = 0; k < bank.taps; ++k) acc += w[k] * p[k * channels + c];
+                store(out + (size_t)x * channels + c, acc);
+            }
+        }
+    }
+
+    void vertical_u8_scalar(const uint8_t* const* rows, const float* w, uint32_t taps, uint32_t n, float* out) {
+        vertical_scalar(rows, w, taps, n, out);
+    }
+    void vertical_f32_scalar(const float* const* rows, const float* w, uint32_t taps, uint32_t n, float* out) {
+        vertical_scalar(rows, w, taps, n, out);
+    }
+    void horizontal4_u8_scalar(const float* row, const Bank& bank, uint32_t n, uint8_t* out) {
+        horizontal_scalar(row, bank, 4, n, out);
+    }
+    void horizontal4_f32_scalar(const float* row, const Bank& bank, uint32_t n, float* out) {
+        horizontal_scalar(row, bank, 4, n, out);
+    }
+
+#ifdef DP_SIMD_X86
+
+    // --- SSE4.1 ---
+
+    DP_TARGET("sse4.1") void vertical_u8_sse41(const uint8_t* const* rows, const float* w, uint32_t taps, uint32_t n, float* out) {
+        uint32_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128 acc[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+            for (uint32_t k = 0; k < taps; ++k) {
+                const __m128i b = _mm_loadu_si128((const __m128i*)(rows[k] + i));
+                const __m128 wk = _mm_set1_ps(w[k]);
+                acc[0] = _mm_add_ps(acc[0], _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(b)), wk));
+                acc[1] = _mm_add_ps(acc[1], _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(b, 4))), wk));
+                acc[2] = _mm_add_ps(acc[2], _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(b, 8))), wk));
+                acc[3] = _mm_add_ps(acc[3], _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(b, 12))), wk));
+            }
+            for (int j = 0; j < 4; ++j) _mm_storeu_ps(out + i + 4 * j, acc[j]);
+        }
+        vertical_tail(rows, w, taps, i, n, out);
+    }
+
+    DP_TARGET("sse4.1") void vertical_f32_sse41(const float* const* rows, const float* w, uint32_t taps, uint32_t n, float* out) {
+        uint32_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128 acc[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+            for (uint32_t k = 0; k < taps; ++k) {
+                const __m128 wk = _mm_set1_ps(w[k]);
+                for (int j = 0; j < 4; ++j) acc[j] = _mm_add_ps(acc[j], _mm_mul_ps(_mm_loadu_ps(rows[k] + i + 4 * j), wk));
+            }
+            for (int j = 0; j < 4; ++j) _mm_storeu_ps(out + i + 4 * j, acc[j]);
+        }
+        vertical_tail(rows, w, taps, i, n, out);
+    }
+
+    // One four-channel pixel per register.
+    DP_TARGET("sse4.1") inline __m128 horizontal4_pixel_sse41(const float* row, const Bank& bank, uint32_t x) {
+        const float* w = &bank.weights_f[(size_t)x * bank.taps];
+        const float* p = row + (size_t)bank.first[x] * 4;
+        __m128 acc = _mm_mul_ps(_mm_loadu_ps(p), _mm_set1_ps(w[0]));
+        for (uint32_t k = 1; k < bank.taps; ++k) acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(p + 4 * k), _mm_set1_ps(w[k])));
+        return acc;
+    }
+
+    DP_TARGET("sse4.1") void horizontal4_u8_sse41(const float* row, const Bank& bank, uint32_t n, uint8_t* out) {
+        for (uint32_t x = 0; x < n; ++x) {
+            __m128i v = _mm_cvtps_epi32(horizontal4_pixel_sse41(row, bank, x));
+            v = _mm_packs_epi32(v, v);
+            const int px = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+            memcpy(out + (size_t)x * 4, &px, 4);
+        }
+    }
+
+    DP_TARGET("sse4.1") void horizontal4_f32_sse41(const float* row, const Bank& bank, uint32_t n, float* out) {
+        for (uint32_t x = 0; x < n; ++x) _mm_storeu_ps(out + (size_t)x * 4, horizontal4_pixel_sse41(row, bank, x));
+    }
+
+    // --- AVX2 ---
+    // The horizontal pass gathers a few pixels per output and gains little from
+    // wider registers, so the AVX2 set reuses the SSE4.1 one there.
+
+    DP_TARGET("avx2") void vertical_u8_avx2(const uint8_t* const* rows, const float* w, uint32_t taps, uint32_t n, float* out) {
+        uint32_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256 acc[4] = { _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps() };
+            for (uint32_t k = 0; k < taps; ++k) {
+                const __m256 wk = _mm256_set1_ps(w[k]);
+                for (int j = 0; j < 4; ++j) {
+                    const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(rows[k] + i + 8 * j)));
+                    acc[j] = _mm256_add_ps(acc[j], _mm256_mul_ps(_mm256_cvtepi32_ps(v), wk));
+                }
+            }
+            for (int j = 0; j < 4; ++j) _mm256_storeu_ps(out + i + 8 * j, acc[j]);
+        }
+        vertical_tail(rows, w, taps, i, n, out);
+    }
+
+    DP_TARGET("avx2") void vertical_f32_avx2(const float* const* rows, const float* w, uint32_t taps, uint32_t n, float* out) {
+        uint32_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256 acc[4] = { _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps() };
+            for (uint32_t k = 0; k < taps; ++k) {
+                const __m256 wk = _mm256_set1_ps(w[k]);
+                for (int j = 0; j < 4; ++j) acc[j] = _mm256_add_ps(acc[j], _mm256_mul_ps(_mm256_loadu_ps(rows[k] + i + 8 * j), wk));
+            }
+            for (int j = 0; j < 4; ++j) _mm256_storeu_ps(out + i + 8 * j, acc[j]);
+        }
+        vertical_tail(rows, w, taps, i, n, out);
+    }
+
+#endif
+
+    struct Kernels {
+        void (*vertical_u8)(const uint8_t* const*, const float*, uint32_t, uint32_t, float*);
+        void (*vertical_f32)(const float* const*, const float*, uint32_t, uint32_t, float*);
+        void (*horizontal4_u8)(const float*, const Bank&, uint32_t, uint8_t*);
+        void (*horizontal4_f32)(const float*, const Bank&, uint32_t, float*);
+    };
+
+    const Kernels kScalar = { vertical_u8_scalar, vertical_f32_scalar, horizontal4_u8_scalar, horizontal4_f32_scalar };
+#ifdef DP_SIMD_X86
+    const Kernels kSSE41 = { vertical_u8_sse41, vertical_f32_sse41, horizontal4_u8_sse41, horizontal4_f32_sse41 };
+    const Kernels kAVX2 = { vertical_u8_avx2, vertical_f32_avx2, horizontal4_u8_sse41, horizontal4_f32_sse41 };
+#endif
+
+    const Kernels& kernels() {
+#ifdef DP_SIMD_X86
+        const Convert::Isa isa = Convert::active_isa();
+        if (isa >= Convert::Isa::AVX2) return kAVX2;
+        if (isa >= Convert::Isa::SSE41) return kSSE41;
+#endif
+        return kScalar;
+    }
+
+    void check_args(DXGI_FORMAT format, const char* what) {
+        if (!Convert::is_supported(format)) {
+            throw std::invalid_argument(std::string("Resample::") + what + ": unsupported format.");
+        }
+    }
+
+    // Formats without a direct path are resized as RGBA floats.
+    template <typename Fn>
+    void through_rgba32f(DXGI_FORMAT format, const void* src, size_t src_pitch, uint32_t src_width, uint32_t src_height,
+                         void* dst, size_t dst_pitch, uint32_t dst_width, uint32_t dst_height, Fn&& resize) {
+        const DXGI_FORMAT wide = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        std::vector<float> in((size_t)src_width * src_height * 4), out((size_t)dst_width * dst_height * 4);
+        Convert::convert(format, src, src_pitch, wide, in.data(), (size_t)src_width * 16, src_width, src_height);
+        resize(wide, in.data(), (size_t)src_width * 16, out.data(), (size_t)dst_width * 16);
+        Convert::convert(wide, out.data(), (size_t)dst_width * 16, format, dst, dst_pitch, dst_width, dst_height);
+    }
+
+}
+
+const char* Resample::filter_name(Filter filter) {
+    switch (filter) {
+    case Filter::Bilinear: return "Bilinear";
+    case Filter::Bicubic: return "Bicubic";
+    case Filter::Lanczos: return "Lanczos";
+    case Filter::Area: return "Area";
+    }
+    return "Unknown";
+}
+
+void Resample::resize(DXGI_FORMAT format, const void* src, size_t src_pitch, uint32_t src_width, uint32_t src_height,
+                      void* dst, size_t dst_pitch, uint32_t dst_width, uint32_t dst_height, Filter filter) {
+    check_args(format, "resize");
+    if (src_width == 0 || src_height == 0 || dst_width == 0 || dst_height == 0) return;
+    const size_t bpp = Convert::bytes_per_pixel(format);
+    if (src_width == dst_width && src_height == dst_height) {
+        Copy::copy_pixels(bpp, dst, dst_pitch, src, src_pitch, src_width, src_height);
+        return;
+    }
+    const Layout layout = layout_of(format);
+    if (layout.channels == 0) {
+        through_rgba32f(format, src, src_pitch, src_width, src_height, dst, dst_pitch, dst_width, dst_height,
+            [&](DXGI_FORMAT wide, const void* s, size_t sp, void* d, size_t dp) {
+                resize(wide, s, sp, src_width, src_height, d, dp, dst_width, dst_height, filter);
+            });
+        return;
+    }
+
+    const Bank bx = make_bank(filter, src_width, dst_width);
+    const Bank by = make_bank(filter, src_height, dst_height);
+    const Kernels& kn = kernels();
+    const uint32_t channels = layout.channels;
+    const uint32_t n = src_width * channels;
+    const auto* s = static_cast<const uint8_t*>(src);
+    auto* d = static_cast<uint8_t*>(dst);
+
+    Scheduler::shared().for_each_band(dst_height, (size_t)dst_width * bpp, [&](uint32_t y0, uint32_t y1) {
+        std::vector<float> column(n);
+        std::vector<const uint8_t*> rows8(by.taps);
+        std::vector<const float*> rows32(by.taps);
+        for (uint32_t y = y0; y < y1; ++y) {
+            const float* w = &by.weights_f[(size_t)y * by.taps];
+            for (uint32_t k = 0; k < by.taps; ++k) {
+                rows8[k] = s + (size_t)(by.first[y] + k) * src_pitch;
+                rows32[k] = reinterpret_cast<const float*>(rows8[k]);
+            }
+            if (layout.u8) kn.vertical_u8(rows8.data(), w, by.taps, n, column.data());
+            else kn.vertical_f32(rows32.data(), w, by.taps, n, column.data());
+
+            uint8_t* out = d + (size_t)y * dst_pitch;
+            if (channels == 4) {
+                if (layout.u8) kn.horizontal4_u8(column.data(), bx, dst_width, out);
+                else kn.horizontal4_f32(column.data(), bx, dst_width, reinterpret_cast<float*>(out));
+            } else {
+                if (layout.u8) horizontal_scalar(column.data(), bx, channels, dst_width, out);
+                else horizontal_scalar(column.data(), bx, channels, dst_width, reinterpret_cast<float*>(out));
+            }
+        }
+    });
+}
+
+void Resample::resize_reference(DXGI_FORMAT format, const void* src, size_t src_pitch, uint32_t src_width, uint32_t src_height,
+                                void* dst, size_t dst_pitch, uint32_t dst_width, uint32_t dst_height, Filter filter) {
+    check_args(format, "resize_reference");
+    if (src_width == 0 || src_height == 0 || dst_width == 0 || dst_height == 0) return;
+    const Layout layout = layout_of(format);
+    if (layout.channels == 0) {
+        through_rgba32f(format, src, src_pitch, src_width, src_height, dst, dst_pitch, dst_width, dst_height,
+            [&](DXGI_FORMAT wide, const void* s, size_t sp, void* d, size_t dp) {
+                resize_reference(wide, s, sp, src_width, src_height, d, dp, dst_width, dst_height, filter);
+            });
+        return;
+    }
+
+    const Bank bx = make_bank(filter, src_width, dst_width);
+    const Bank by = make_bank(filter, src_height, dst_height);
+    const uint32_t channels = layout.channels;
+    const size_t n = (size_t)src_width * channels;
+    const auto* s = static_cast<const uint8_t*>(src);
+    auto* d = static_cast<uint8_t*>(dst);
+    auto sample = [&](uint32_t y, size_t i) -> double {
+        const uint8_t* row = s + (size_t)y * src_pitch;
+        if (layout.u8) return row[i];
+        float v;
+        memcpy(&v, row + i * 4, 4);
+        return v;
+    };
+
+    std::vector<double> column(n);
+    for (uint32_t y = 0; y < dst_height; ++y) {
+        for (size_t i = 0; i < n; ++i) {
+            double acc = 0.0;
+            for (uint32_t k = 0; k < by.taps; ++k) acc += by.weights[(size_t)y * by.taps + k] * sample(by.first[y] + k, i);
+            column[i] = acc;
+        }
+        uint8_t* out = d + (size_t)y * dst_pitch;
+        for (uint32_t x = 0; x < dst_width; ++x) {
+            for (uint32_t c = 0; c < channels; ++c) {
+                double acc = 0.0;
+                for (uint32_t k = 0; k < bx.taps; ++k) {
+                    acc += bx.weights[(size_t)x * bx.taps + k] * column[(size_t)(bx.first[x] + k) * channels + c];
+                }
+                const size_t o = (size_t)x * channels + c;
+                if (layout.u8) {
+                    out[o] = (uint8_t)std::nearbyint(std::min(std::max(acc, 0.0), 255.0));
+                } else {
+                    const float v = (float)acc;
+                    memcpy(out + o * 4, &v, 4);
+                }
+            }
+        }
+    }
+}
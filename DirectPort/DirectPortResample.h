@@ -0,0 +1,31 @@
+// DirectPortResample.h
+#pragma once
+
+#include "DirectPort.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace DirectPort::Resample {
+
+    // Bilinear, Bicubic (Keys, a = -0.5) and Lanczos (3 lobes) widen with the
+    // downscale ratio so every source pixel contributes, as Pillow does; Area
+    // weights each source pixel by how much of the output pixel it covers,
+    // which suits large reductions such as monitoring-wall thumbnails. Edges
+    // clamp by renormalising the taps that fall inside the image.
+    enum class Filter { Bilinear, Bicubic, Lanczos, Area };
+
+    const char* filter_name(Filter filter);
+
+    // Resizes a pitched image of any format Convert supports. 8-bit UNORM and
+    // 32-bit float formats are filtered directly, channel by channel; the others
+    // go through RGBA floats. Rows are split across Scheduler::shared() and run
+    // on the active Convert kernel set. Alpha is filtered like any other channel.
+    void resize(DXGI_FORMAT format, const void* src, size_t src_pitch, uint32_t src_width, uint32_t src_height,
+                void* dst, size_t dst_pitch, uint32_t dst_width, uint32_t dst_height, Filter filter = Filter::Bilinear);
+
+    // The same filter in double precision with no intermediate rounding, single
+    // threaded. resize() stays within one 8-bit step of it.
+    void resize_reference(DXGI_FORMAT format, const void* src, size_t src_pitch, uint32_t src_width, uint32_t src_height,
+                          void* dst, size_t dst_pitch, uint32_t dst_width, uint32_t dst_height, Filter filter = Filter::Bilinear);
+
+}
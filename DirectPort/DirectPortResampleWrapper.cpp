@@ -0,0 +1,68 @@
+#include "DirectPortResample.h"
+#include "DirectPortConvert.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <string>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    // Tightly packed rows in and out; the result is (out_height, out_width * bytes per pixel) uint8.
+    template <typename Fn>
+    py::array_t<uint8_t, py::array::c_style> resize_pixels(const char* what, const py::buffer& src, uint32_t width, uint32_t height, DXGI_FORMAT format,
+                                                           uint32_t out_width, uint32_t out_height, const py::object& out, Fn&& resize) {
+        const size_t bpp = Convert::bytes_per_pixel(format);
+        if (bpp == 0) {
+            throw py::value_error(std::string(what) + ": unsupported format.");
+        }
+        py::buffer_info in = src.request();
+        if ((size_t)(in.size * in.itemsize) < (size_t)width * height * bpp) {
+            throw py::value_error(std::string(what) + ": source buffer is smaller than width * height pixels.");
+        }
+        using Bytes = py::array_t<uint8_t, py::array::c_style>;
+        if (!out.is_none() && !py::isinstance<Bytes>(out)) {
+            throw py::type_error(std::string(what) + ": out must be a C-contiguous uint8 array.");
+        }
+        Bytes result = out.is_none() ? Bytes({ (py::ssize_t)out_height, (py::ssize_t)(out_width * bpp) }) : out.cast<Bytes>();
+        py::buffer_info dst = result.request(true);
+        if ((size_t)dst.size < (size_t)out_width * out_height * bpp) {
+            throw py::value_error(std::string(what) + ": out is smaller than out_width * out_height pixels.");
+        }
+        {
+            py::gil_scoped_release release;
+            resize(in.ptr, width * bpp, dst.ptr, out_width * bpp);
+        }
+        return result;
+    }
+
+}
+
+void bind_resample(py::module_& m) {
+    py::enum_<Resample::Filter>(m, "ResampleFilter", "Filters for CPU-side scaling.")
+        .value("Bilinear", Resample::Filter::Bilinear, "")
+        .value("Bicubic", Resample::Filter::Bicubic, "")
+        .value("Lanczos", Resample::Filter::Lanczos, "")
+        .value("Area", Resample::Filter::Area, "");
+
+    m.def("resize_pixels", [](const py::buffer& src, uint32_t width, uint32_t height, DXGI_FORMAT format,
+                              uint32_t out_width, uint32_t out_height, Resample::Filter filter, const py::object& out) {
+        return resize_pixels("resize_pixels", src, width, height, format, out_width, out_height, out,
+            [&](const void* s, size_t sp, void* d, size_t dp) {
+                Resample::resize(format, s, sp, width, height, d, dp, out_width, out_height, filter);
+            });
+    }, py::arg("src"), py::arg("width"), py::arg("height"), py::arg("format"), py::arg("out_width"), py::arg("out_height"),
+       py::arg("filter") = Resample::Filter::Bilinear, py::arg("out") = py::none(),
+       "Resizes packed pixels on the CPU.");
+
+    m.def("resize_pixels_reference", [](const py::buffer& src, uint32_t width, uint32_t height, DXGI_FORMAT format,
+                                        uint32_t out_width, uint32_t out_height, Resample::Filter filter) {
+        return resize_pixels("resize_pixels_reference", src, width, height, format, out_width, out_height, py::none(),
+            [&](const void* s, size_t sp, void* d, size_t dp) {
+                Resample::resize_reference(format, s, sp, width, height, d, dp, out_width, out_height, filter);
+            });
+    }, py::arg("src"), py::arg("width"), py::arg("height"), py::arg("format"), py::arg("out_width"), py::arg("out_height"),
+       py::arg("filter") = Resample::Filter::Bilinear,
+       "The same resize in double precision, single threaded, for validation.");
+}
@@ -0,0 +1,278 @@
+// src/DirectPort/DirectPortScheduler.cpp
+
+#include "DirectPortScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+using namespace DirectPort;
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    // A lane's unclaimed indices, [begin, end), packed so owner and thieves can
+    // claim from it with a single compare-exchange.
+    uint64_t pack(uint32_t begin, uint32_t end) { return (uint64_t)end << 32 | begin; }
+    uint32_t range_begin(uint64_t range) { return (uint32_t)range; }
+    uint32_t range_end(uint64_t range) { return (uint32_t)(range >> 32); }
+
+    // The scheduler whose task this thread is running, if any.
+    thread_local const void* t_running = nullptr;
+
+}
+
+struct Scheduler::Impl {
+    // Padded so owners and thieves touching neighbouring lanes do not false-share.
+    struct alignas(64) Lane {
+        std::atomic<uint64_t> range{ 0 };
+        std::atomic<uint64_t> tasks{ 0 };
+        std::atomic<uint64_t> steals{ 0 };
+        std::atomic<uint64_t> busy_ns{ 0 };
+    };
+
+    uint32_t lane_count = 1;
+    std::unique_ptr<Lane[]> lanes;
+    std::vector<std::thread> workers;
+
+    std::mutex submit_mutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(uint32_t)>* job = nullptr;
+    uint32_t job_count = 0;
+    uint32_t active = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+    std::atomic<uint32_t> completed{ 0 };
+    std::exception_ptr error;
+
+    std::atomic<uint64_t> jobs{ 0 };
+    Clock::time_point stats_start = Clock::now();
+
+    bool pop(Lane& lane, uint32_t& index) {
+        uint64_t range = lane.range.load(std::memory_order_acquire);
+        for (;;) {
+            const uint32_t begin = range_begin(range), end = range_end(range);
+            if (begin >= end) return false;
+            if (lane.range.compare_exchange_weak(range, pack(begin + 1, end), std::memory_order_acq_rel)) {
+                index = begin;
+                return true;
+            }
+        }
+    }
+
+    // Moves the back half of the first non-empty lane after `self` into `self`,
+    // which is empty, so nobody else can be claiming from it meanwhile.
+    bool steal(uint32_t self) {
+        for (uint32_t k = 1; k < lane_count; ++k) {
+            Lane& victim = lanes[(self + k) % lane_count];
+            uint64_t range = victim.range.load(std::memory_order_acquire);
+            for (;;) {
+                const uint32_t begin = range_begin(range), end = range_end(range);
+                if (begin >= end) break;
+                const uint32_t mid = begin + (end - begin) / 2;
+                if (victim.range.compare_exchange_weak(range, pack(begin, mid), std::memory_order_acq_rel)) {
+                    lanes[self].range.store(pack(mid, end), std::memory_order_release);
+                    lanes[self].steals.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static void account(Lane& lane, Clock::time_point start) {
+        lane.busy_ns.fetch_add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count(), std::memory_order_relaxed);
+        lane.tasks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void run_task(Lane& lane, const std::function<void(uint32_t)>& fn, uint32_t index) {
+        const auto start = Clock::now();
+        try {
+            fn(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+        account(lane, start);
+    }
+
+    void drain(uint32_t self, const std::function<void(uint32_t)>& fn, uint32_t count) {
+        const void* outer = t_running;
+        t_running = this;
+        Lane& lane = lanes[self];
+        for (;;) {
+            uint32_t index;
+            if (!pop(lane, index)) {
+                if (!steal(self)) break;
+                continue;
+            }
+            run_task(lane, fn, index);
+            if (completed.fetch_add(1) + 1 == count) {
+                std::lock_guard<std::mutex> lock(mutex);
+                done.notify_all();
+            }
+        }
+        t_running = outer;
+    }
+
+    void worker_loop(uint32_t self) {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(uint32_t)>* fn;
+            uint32_t count;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || (job && generation != seen); });
+                if (stopping) return;
+                seen = generation;
+                fn = job;
+                count = job_count;
+                active++;
+            }
+            drain(self, *fn, count);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                active--;
+            }
+            done.notify_all();
+        }
+    }
+};
+
+Scheduler::Scheduler(uint32_t lanes) : pImpl(std::make_unique<Impl>()) {
+    pImpl->lane_count = lanes ? lanes : std::max(1u, std::thread::hardware_concurrency());
+    pImpl->lanes.reset(new Impl::Lane[pImpl->lane_count]);
+    for (uint32_t i = 1; i < pImpl->lane_count; ++i) {
+        pImpl->workers.emplace_back([this, i] { pImpl->worker_loop(i); });
+    }
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->stopping = true;
+    }
+    pImpl->wake.notify_all();
+    for (auto& t : pImpl->workers) t.join();
+}
+
+Scheduler& Scheduler::shared() {
+    // Never destroyed: joining workers during interpreter or DLL teardown can hang.
+    static Scheduler* instance = new Scheduler(0);
+    return *instance;
+}
+
+uint32_t Scheduler::lanes() const {
+    return pImpl->lane_count;
+}
+
+void Scheduler::parallel_for(uint32_t count, const std::function<void(uint32_t)>& fn) {
+    if (count == 0) return;
+    if (t_running == pImpl.get()) {
+        // Already on one of our lanes; going wide again would wait on ourselves.
+        for (uint32_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    if (count == 1 || pImpl->workers.empty()) {
+        pImpl->jobs.fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto start = Clock::now();
+            try {
+                fn(i);
+            } catch (...) {
+                Impl::account(pImpl->lanes[0], start);
+                throw;
+            }
+            Impl::account(pImpl->lanes[0], start);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(pImpl->submit_mutex);
+    const uint32_t lane_count = pImpl->lane_count;
+    for (uint32_t k = 0; k < lane_count; ++k) {
+        const uint32_t begin = (uint32_t)((uint64_t)count * k / lane_count);
+        const uint32_t end = (uint32_t)((uint64_t)count * (k + 1) / lane_count);
+        pImpl->lanes[k].range.store(pack(begin, end), std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->job = &fn;
+        pImpl->job_count = count;
+        pImpl->completed = 0;
+        pImpl->error = nullptr;
+        pImpl->generation++;
+    }
+    pImpl->jobs.fetch_add(1, std::memory_order_relaxed);
+    pImpl->wake.notify_all();
+    pImpl->drain(0, fn, count);
+
+    std::unique_lock<std::mutex> lock(pImpl->mutex);
+    pImpl->done.wait(lock, [&] { return pImpl->completed == pImpl->job_count && pImpl->active == 0; });
+    pImpl->job = nullptr;
+    if (pImpl->error) std::rethrow_exception(std::exchange(pImpl->error, nullptr));
+}
+
+void Scheduler::for_each_band(uint32_t rows, size_t row_bytes, const std::function<void(uint32_t, uint32_t)>& fn, uint32_t min_rows) {
+    if (rows == 0) return;
+    uint32_t band = (uint32_t)std::min<size_t>(rows, std::max<size_t>(1, kTileBytes / std::max<size_t>(row_bytes, 1)));
+    band = std::min(band, (rows + pImpl->lane_count - 1) / pImpl->lane_count);
+    band = std::max(band, std::max(min_rows, 1u));
+    const uint32_t bands = (rows + band - 1) / band;
+    parallel_for(bands, [&](uint32_t b) {
+        const uint32_t y0 = b * band;
+        fn(y0, std::min(rows, y0 + band));
+    });
+}
+
+void Scheduler::for_each_tile(uint32_t width, uint32_t height, size_t bytes_per_pixel,
+                              const std::function<void(uint32_t, uint32_t, uint32_t, uint32_t)>& fn) {
+    if (width == 0 || height == 0) return;
+    const size_t pixels = std::max<size_t>(1, kTileBytes / std::max<size_t>(bytes_per_pixel, 1));
+    const uint32_t tile_w = std::min<uint32_t>(width, 256);
+    const uint32_t tile_h = (uint32_t)std::min<size_t>(height, std::max<size_t>(1, pixels / tile_w));
+    const uint32_t cols = (width + tile_w - 1) / tile_w;
+    const uint32_t rows = (height + tile_h - 1) / tile_h;
+    parallel_for(cols * rows, [&](uint32_t t) {
+        const uint32_t x0 = (t % cols) * tile_w, y0 = (t / cols) * tile_h;
+        fn(x0, y0, std::min(width, x0 + tile_w), std::min(height, y0 + tile_h));
+    });
+}
+
+Scheduler::Stats Scheduler::get_stats() const {
+    Stats stats;
+    stats.lanes = pImpl->lane_count;
+    stats.jobs = pImpl->jobs.load(std::memory_order_relaxed);
+    uint64_t busy_ns = 0;
+    for (uint32_t k = 0; k < pImpl->lane_count; ++k) {
+        const auto& lane = pImpl->lanes[k];
+        const uint64_t tasks = lane.tasks.load(std::memory_order_relaxed);
+        stats.tasks_per_lane.push_back(tasks);
+        stats.tasks += tasks;
+        stats.steals += lane.steals.load(std::memory_order_relaxed);
+        busy_ns += lane.busy_ns.load(std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    stats.busy_seconds = busy_ns * 1e-9;
+    stats.wall_seconds = std::chrono::duration<double>(Clock::now() - pImpl->stats_start).count();
+    if (stats.wall_seconds > 0.0) stats.utilisation = stats.busy_seconds / (stats.wall_seconds * stats.lanes);
+    return stats;
+}
+
+void Scheduler::reset_stats() {
+    pImpl->jobs = 0;
+    for (uint32_t k = 0; k < pImpl->lane_count; ++k) {
+        pImpl->lanes[k].tasks = 0;
+        pImpl->lanes[k].steals = 0;
+        pImpl->lanes[k].busy_ns = 0;
+    }
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->stats_start = Clock::now();
+}
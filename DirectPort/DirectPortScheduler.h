@@ -0,0 +1,66 @@
+// DirectPortScheduler.h
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace DirectPort {
+
+    // A persistent pool of worker threads for CPU-side pixel work. Each job is a
+    // range of task indices; every lane starts on its own contiguous share and,
+    // once that runs dry, steals half of what another lane has left, so uneven
+    // tiles still finish together. The submitting thread is lane 0, and a job
+    // submitted from inside a running task runs inline on that lane.
+    class Scheduler {
+    public:
+        struct Stats {
+            uint32_t lanes = 0;
+            uint64_t jobs = 0;
+            uint64_t tasks = 0;
+            uint64_t steals = 0;
+            double busy_seconds = 0.0;
+            double wall_seconds = 0.0;
+            // busy_seconds / (wall_seconds * lanes): the share of the pool's
+            // capacity spent running tasks since creation or reset_stats().
+            double utilisation = 0.0;
+            std::vector<uint64_t> tasks_per_lane;
+        };
+
+        // lanes == 0 uses every hardware thread.
+        explicit Scheduler(uint32_t lanes = 0);
+        ~Scheduler();
+
+        // The process-wide scheduler shared by the NumPy, camera and CPU device paths.
+        static Scheduler& shared();
+
+        uint32_t lanes() const;
+
+        // Runs fn(i) for every i in [0, count) and returns once all have finished.
+        // The first exception a task throws is rethrown here.
+        void parallel_for(uint32_t count, const std::function<void(uint32_t)>& fn);
+
+        // Splits [0, rows) into bands of about kTileBytes (at least min_rows, and
+        // at least one band per lane when there are enough rows) and runs fn(y0, y1).
+        void for_each_band(uint32_t rows, size_t row_bytes, const std::function<void(uint32_t, uint32_t)>& fn, uint32_t min_rows = 1);
+
+        // Splits a width x height image into tiles of about kTileBytes and runs
+        // fn(x0, y0, x1, y1) on each, for kernels that read a 2D neighbourhood.
+        void for_each_tile(uint32_t width, uint32_t height, size_t bytes_per_pixel,
+                           const std::function<void(uint32_t, uint32_t, uint32_t, uint32_t)>& fn);
+
+        Stats get_stats() const;
+        void reset_stats();
+
+        // Roughly half a typical per-core L2, so a tile's source and destination
+        // stay resident while a lane works on it.
+        static constexpr size_t kTileBytes = 256 * 1024;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pImpl;
+    };
+
+}
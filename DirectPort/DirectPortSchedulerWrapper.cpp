@@ -0,0 +1,28 @@
+#include "DirectPortScheduler.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+void bind_scheduler(py::module_& m) {
+    py::class_<Scheduler::Stats>(m, "SchedulerStats", "Counters for a CPU work-stealing scheduler since creation or the last reset.")
+        .def_readonly("lanes", &Scheduler::Stats::lanes, "")
+        .def_readonly("jobs", &Scheduler::Stats::jobs, "")
+        .def_readonly("tasks", &Scheduler::Stats::tasks, "")
+        .def_readonly("steals", &Scheduler::Stats::steals, "")
+        .def_readonly("busy_seconds", &Scheduler::Stats::busy_seconds, "")
+        .def_readonly("wall_seconds", &Scheduler::Stats::wall_seconds, "")
+        .def_readonly("utilisation", &Scheduler::Stats::utilisation, "busy_seconds / (wall_seconds * lanes).")
+        .def_readonly("tasks_per_lane", &Scheduler::Stats::tasks_per_lane, "")
+        .def("__repr__", [](const Scheduler::Stats& s) {
+            return "SchedulerStats(lanes=" + std::to_string(s.lanes) + ", jobs=" + std::to_string(s.jobs) +
+                   ", tasks=" + std::to_string(s.tasks) + ", steals=" + std::to_string(s.steals) +
+                   ", utilisation=" + std::to_string(s.utilisation) + ")";
+        });
+
+    m.def("scheduler_lanes", [] { return Scheduler::shared().lanes(); },
+          "Lanes in the process-wide scheduler used by NumPy, camera and DeviceCPU work.");
+    m.def("scheduler_stats", [] { return Scheduler::shared().get_stats(); }, "");
+    m.def("reset_scheduler_stats", [] { Scheduler::shared().reset_stats(); }, "");
+}
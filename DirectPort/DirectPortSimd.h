@@ -0,0 +1,15 @@
+// DirectPortSimd.h
+// Switches for kernels that pick an instruction set at runtime through
+// Convert::active_isa(). DP_SIMD_X86 marks x86 builds; DP_TARGET enables an
+// instruction set for a single function on compilers that need it.
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DP_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DP_TARGET(isa)
+#else
+#define DP_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
@@ -0,0 +1,207 @@
+// src/DirectPort/DirectPortStaging.cpp
+// Rings are kept in a small vector searched linearly: a process has a handful
+// of stream sizes at most, and a lookup is cheaper than the hash of a Key.
+
+#include "DirectPortStaging.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace DirectPort::Staging;
+
+namespace {
+
+    struct Slot {
+        std::shared_ptr<void> resource;
+        uint64_t id = 0;
+        bool leased = false;
+        Pool::Clock::time_point last_used;
+    };
+
+    struct Ring {
+        Key key;
+        std::vector<Slot> slots;
+    };
+
+}
+
+struct Pool::Impl {
+    Create create;
+    uint32_t ring_size;
+    Clock::duration idle_timeout;
+
+    mutable std::mutex mutex;
+    std::vector<Ring> rings;
+    uint64_t next_id = 1;
+    Stats stats;
+
+    // Drops free slots idle since before `cutoff`, and rings left empty.
+    // Resources are moved into `dropped` so they are released outside the lock.
+    size_t trim_locked(Clock::time_point cutoff, std::vector<std::shared_ptr<void>>& dropped) {
+        size_t count = 0;
+        for (Ring& ring : rings) {
+            auto idle = [&](Slot& s) { return !s.leased && s.last_used < cutoff; };
+            for (Slot& s : ring.slots) {
+                if (idle(s)) {
+                    dropped.push_back(std::move(s.resource));
+                    ++count;
+                }
+            }
+            ring.slots.erase(std::remove_if(ring.slots.begin(), ring.slots.end(), [](const Slot& s) { return !s.resource; }),
+                             ring.slots.end());
+        }
+        rings.erase(std::remove_if(rings.begin(), rings.end(), [](const Ring& r) { return r.slots.empty(); }), rings.end());
+        stats.trimmed += count;
+        stats.live -= (uint32_t)count;
+        return count;
+    }
+
+    void release(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Ring& ring : rings) {
+            for (Slot& s : ring.slots) {
+                if (s.id == id) {
+                    s.leased = false;
+                    s.last_used = Clock::now();
+                    return;
+                }
+            }
+        }
+    }
+};
+
+// --- Lease ---
+
+Pool::Lease::Lease(Lease&& other) noexcept
+    : resource_(std::move(other.resource_)), owner_(std::move(other.owner_)), slot_(other.slot_) {
+    other.slot_ = 0;
+}
+
+Pool::Lease& Pool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        reset();
+        resource_ = std::move(other.resource_);
+        owner_ = std::move(other.owner_);
+        slot_ = other.slot_;
+        other.slot_ = 0;
+    }
+    return *this;
+}
+
+Pool::Lease::~Lease() {
+    reset();
+}
+
+void Pool::Lease::reset() {
+    if (slot_) {
+        if (auto owner = owner_.lock()) owner->release(slot_);
+    }
+    resource_.reset();
+    owner_.reset();
+    slot_ = 0;
+}
+
+// --- Pool ---
+
+Pool::Pool(Create create, uint32_t ring_size, Clock::duration idle_timeout) : pImpl(std::make_shared<Impl>()) {
+    if (!create) {
+        throw std::invalid_argument("Staging::Pool: create must be callable.");
+    }
+    pImpl->create = std::move(create);
+    pImpl->ring_size = std::max(ring_size, 1u);
+    pImpl->idle_timeout = idle_timeout;
+}
+
+Pool::~Pool() = default;
+
+Pool::Lease Pool::acquire(const Key& key) {
+    const Clock::time_point now = Clock::now();
+    std::vector<std::shared_ptr<void>> dropped;
+    Lease lease;
+    lease.owner_ = pImpl;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        ++pImpl->stats.acquires;
+        pImpl->trim_locked(now - pImpl->idle_timeout, dropped);
+
+        auto ring = std::find_if(pImpl->rings.begin(), pImpl->rings.end(), [&](const Ring& r) { return r.key == key; });
+        if (ring != pImpl->rings.end()) {
+            Slot* oldest = nullptr;
+            for (Slot& s : ring->slots) {
+                if (!s.leased && (!oldest || s.last_used < oldest->last_used)) oldest = &s;
+            }
+            // Reuse only once the ring is full, so consecutive copies rotate
+            // through ring_size resources instead of waiting on the last one.
+            if (oldest && ring->slots.size() >= pImpl->ring_size) {
+                oldest->leased = true;
+                oldest->last_used = now;
+                ++pImpl->stats.reused;
+                lease.resource_ = oldest->resource;
+                lease.slot_ = oldest->id;
+                return lease;
+            }
+        }
+    }
+
+    // Created outside the lock: driver allocations can take milliseconds.
+    std::shared_ptr<void> resource = pImpl->create(key);
+    if (!resource) {
+        throw std::runtime_error("Staging::Pool: create returned no resource.");
+    }
+    lease.resource_ = resource;
+
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    ++pImpl->stats.created;
+    auto ring = std::find_if(pImpl->rings.begin(), pImpl->rings.end(), [&](const Ring& r) { return r.key == key; });
+    if (ring == pImpl->rings.end()) {
+        pImpl->rings.push_back({ key, {} });
+        ring = pImpl->rings.end() - 1;
+    }
+    if (ring->slots.size() >= pImpl->ring_size) {
+        ++pImpl->stats.overflow;
+        return lease;  // not kept: slot_ stays 0, so release just drops it
+    }
+    Slot slot;
+    slot.resource = std::move(resource);
+    slot.id = pImpl->next_id++;
+    slot.leased = true;
+    slot.last_used = now;
+    lease.slot_ = slot.id;
+    ring->slots.push_back(std::move(slot));
+    ++pImpl->stats.live;
+    return lease;
+}
+
+size_t Pool::trim(Clock::time_point now) {
+    std::vector<std::shared_ptr<void>> dropped;
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->trim_locked(now - pImpl->idle_timeout, dropped);
+}
+
+void Pool::clear() {
+    std::vector<std::shared_ptr<void>> dropped;
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->trim_locked(Clock::time_point::max(), dropped);
+}
+
+uint32_t Pool::ring_size() const {
+    return pImpl->ring_size;
+}
+
+Pool::Clock::duration Pool::idle_timeout() const {
+    return pImpl->idle_timeout;
+}
+
+Pool::Stats Pool::get_stats() const {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->stats;
+}
+
+void Pool::reset_stats() {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    const uint32_t live = pImpl->stats.live;
+    pImpl->stats = Stats();
+    pImpl->stats.live = live;
+}
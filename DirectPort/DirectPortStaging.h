@@ -0,0 +1,103 @@
+// DirectPortStaging.h
+#pragma once
+
+#include "DirectPortPlatform.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace DirectPort::Staging {
+
+    // What a staging resource is for; readback and upload surfaces differ in
+    // CPU access flags, so they never share a slot.
+    enum class Access : uint8_t { Read, Write };
+
+    struct Key {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        uint32_t mip_levels = 1;
+        uint32_t array_size = 1;
+        Access access = Access::Read;
+
+        bool operator==(const Key& other) const {
+            return width == other.width && height == other.height && format == other.format &&
+                   mip_levels == other.mip_levels && array_size == other.array_size && access == other.access;
+        }
+    };
+
+    // Reuses staging resources across calls instead of creating one per copy.
+    // Each distinct Key gets a ring of up to ring_size resources, handed out
+    // least recently used first so back-to-back copies do not wait on the one
+    // the GPU may still be writing. When every slot of a ring is leased the
+    // pool creates one more that is dropped on release rather than kept.
+    // Slots unused for longer than idle_timeout are released on the next
+    // acquire() or trim().
+    //
+    // The pool only sees opaque resources made by `create`, so it holds no
+    // backend types; the D3D11 NumPy path passes a closure that calls
+    // CreateTexture2D. Thread-safe.
+    class Pool {
+        struct Impl;
+
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Create = std::function<std::shared_ptr<void>(const Key&)>;
+
+        struct Stats {
+            uint64_t acquires = 0;
+            uint64_t created = 0;    // calls to `create`
+            uint64_t reused = 0;     // acquires served from a ring
+            uint64_t overflow = 0;   // acquires served by an unkept resource
+            uint64_t trimmed = 0;    // kept resources released by idle trimming
+            uint32_t live = 0;       // resources kept in rings now
+        };
+
+        // A leased resource; returns to its ring when destroyed.
+        class Lease {
+        public:
+            Lease() = default;
+            Lease(Lease&& other) noexcept;
+            Lease& operator=(Lease&& other) noexcept;
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            ~Lease();
+
+            void* get() const { return resource_.get(); }
+            template <typename T> T* as() const { return static_cast<T*>(resource_.get()); }
+            explicit operator bool() const { return resource_ != nullptr; }
+            // Releases the resource now rather than at destruction.
+            void reset();
+
+        private:
+            friend class Pool;
+            std::shared_ptr<void> resource_;
+            std::weak_ptr<Impl> owner_;  // the lease may outlive the pool
+            uint64_t slot_ = 0;
+        };
+
+        explicit Pool(Create create, uint32_t ring_size = 2,
+                      Clock::duration idle_timeout = std::chrono::seconds(2));
+        ~Pool();
+
+        // Throws whatever `create` throws; a null resource from `create`
+        // throws std::runtime_error.
+        Lease acquire(const Key& key);
+        // Releases free slots idle since before `now - idle_timeout`; returns how many.
+        size_t trim(Clock::time_point now = Clock::now());
+        // Releases every free slot.
+        void clear();
+
+        uint32_t ring_size() const;
+        Clock::duration idle_timeout() const;
+        Stats get_stats() const;
+        void reset_stats();
+
+    private:
+        // Shared with outstanding leases, which may be released after the pool.
+        std::shared_ptr<Impl> pImpl;
+    };
+
+}
@@ -0,0 +1,77 @@
+#include "DirectPortStaging.h"
+#include <pybind11/pybind11.h>
+#include <chrono>
+#include <string>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    // Python objects kept by the pool are released with the GIL held, since
+    // the pool may drop them from any thread.
+    std::shared_ptr<void> hold(py::object object) {
+        return std::shared_ptr<void>(new py::object(std::move(object)), [](void* p) {
+            py::gil_scoped_acquire acquire;
+            delete static_cast<py::object*>(p);
+        });
+    }
+
+}
+
+void bind_staging(py::module_& m) {
+    py::enum_<Staging::Access>(m, "StagingAccess", "")
+        .value("Read", Staging::Access::Read, "")
+        .value("Write", Staging::Access::Write, "");
+
+    py::class_<Staging::Pool::Stats>(m, "StagingStats", "")
+        .def_readonly("acquires", &Staging::Pool::Stats::acquires)
+        .def_readonly("created", &Staging::Pool::Stats::created)
+        .def_readonly("reused", &Staging::Pool::Stats::reused)
+        .def_readonly("overflow", &Staging::Pool::Stats::overflow)
+        .def_readonly("trimmed", &Staging::Pool::Stats::trimmed)
+        .def_readonly("live", &Staging::Pool::Stats::live)
+        .def("__repr__", [](const Staging::Pool::Stats& s) {
+            return "<StagingStats " + std::to_string(s.acquires) + " acquires, " + std::to_string(s.created) + " created, " +
+                   std::to_string(s.live) + " live>";
+        });
+
+    py::class_<Staging::Pool::Lease>(m, "StagingLease", "A resource on loan from a StagingPool; a context manager.")
+        .def_property_readonly("resource", [](const Staging::Pool::Lease& lease) -> py::object {
+            return lease ? *lease.as<py::object>() : py::none();
+        })
+        .def("release", &Staging::Pool::Lease::reset, "Returns the resource to its ring.")
+        .def("__enter__", [](Staging::Pool::Lease& lease) -> Staging::Pool::Lease& { return lease; }, py::return_value_policy::reference)
+        .def("__exit__", [](Staging::Pool::Lease& lease, const py::args&) { lease.reset(); });
+
+    // The pool behind directport.numpy's staging textures, with any Python
+    // callable as the allocator, so its reuse and trimming can be driven
+    // (and counted) without a GPU.
+    py::class_<Staging::Pool>(m, "StagingPool", "Per-descriptor rings of reusable resources made by `create`.")
+        .def(py::init([](py::function create, uint32_t ring_size, double idle_seconds) {
+            auto allocate = [create](const Staging::Key& key) {
+                py::gil_scoped_acquire acquire;
+                return hold(create(key.width, key.height, key.format, key.access));
+            };
+            const auto idle = std::chrono::duration_cast<Staging::Pool::Clock::duration>(std::chrono::duration<double>(idle_seconds));
+            return new Staging::Pool(allocate, ring_size, idle);
+        }), py::arg("create"), py::arg("ring_size") = 2, py::arg("idle_seconds") = 2.0,
+            "create(width, height, format, access) returns the resource to keep.")
+        .def("acquire", [](Staging::Pool& pool, uint32_t width, uint32_t height, DXGI_FORMAT format, Staging::Access access) {
+            Staging::Key key;
+            key.width = width;
+            key.height = height;
+            key.format = format;
+            key.access = access;
+            return pool.acquire(key);
+        }, py::arg("width"), py::arg("height"), py::arg("format"), py::arg("access") = Staging::Access::Read)
+        .def("trim", [](Staging::Pool& pool, double idle_for_seconds) {
+            // Trims as if `idle_for_seconds` more had passed, so tests need not sleep.
+            const auto ahead = std::chrono::duration_cast<Staging::Pool::Clock::duration>(std::chrono::duration<double>(idle_for_seconds));
+            return pool.trim(Staging::Pool::Clock::now() + ahead);
+        }, py::arg("idle_for_seconds") = 0.0, "Releases resources idle for longer than the timeout; returns how many.")
+        .def("clear", &Staging::Pool::clear, "")
+        .def_property_readonly("ring_size", &Staging::Pool::ring_size)
+        .def_property_readonly("stats", &Staging::Pool::get_stats)
+        .def("reset_stats", &Staging::Pool::reset_stats, "");
+}
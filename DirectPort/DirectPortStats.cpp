@@ -0,0 +1,457 @@
+// src/DirectPort/DirectPortStats.cpp
+// Two reduction paths. 8-bit formats only count: every band fills its own
+// histograms (two copies per channel, alternating pixels, so runs of equal
+// values do not stall on one counter), and min, max, mean and variance are
+// read off the merged histograms. Other formats decode to RGBA floats in
+// L1-sized chunks and reduce min, max, sum and sum of squares per row, adding
+// row sums into double band sums. AVX-512 machines run the AVX2 kernels.
+
+#include "DirectPortStats.h"
+#include "DirectPortConvert.h"
+#include "DirectPortFormats.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "DirectPortSimd.h"
+
+using namespace DirectPort;
+using Stats::kBins;
+using Stats::kLuma;
+
+namespace {
+
+    constexpr uint32_t kChunk = 256;
+
+    // Storage byte of each RGBA channel in a four-channel 8-bit pixel, and the
+    // luma weights in the same byte order.
+    struct ByteOrder {
+        uint32_t channel[4];
+        int16_t weight[4];
+    };
+
+    ByteOrder byte_order(bool bgra) {
+        if (bgra) return { { 2, 1, 0, 3 }, { 19, 183, 54, 0 } };
+        return { { 0, 1, 2, 3 }, { 54, 183, 19, 0 } };
+    }
+
+    // One band's share. The 8-bit path fills only `histogram`.
+    struct Partial {
+        uint64_t pixels = 0;
+        float min[5];
+        float max[5];
+        double sum[5] = {};
+        double sumsq[5] = {};
+        uint64_t histogram[5][kBins] = {};
+
+        Partial() {
+            std::fill(min, min + 5, FLT_MAX);
+            std::fill(max, max + 5, -FLT_MAX);
+        }
+
+        void merge(const Partial& o) {
+            pixels += o.pixels;
+            for (int c = 0; c < 5; ++c) {
+                min[c] = std::min(min[c], o.min[c]);
+                max[c] = std::max(max[c], o.max[c]);
+                sum[c] += o.sum[c];
+                sumsq[c] += o.sumsq[c];
+                for (uint32_t b = 0; b < kBins; ++b) histogram[c][b] += o.histogram[c][b];
+            }
+        }
+    };
+
+    // Per-row float sums, folded into a Partial's doubles after each row.
+    struct RowSums {
+        float min[5];
+        float max[5];
+        float sum[5];
+        float sumsq[5];
+    };
+
+    inline uint32_t bin_of(float v) {
+        if (!(v > 0.0f)) return 0;
+        return v >= 1.0f ? kBins - 1 : std::min<uint32_t>(kBins - 1, (uint32_t)(v * (float)kBins));
+    }
+
+    // --- Row kernels ---
+
+    // luma = (w . pixel + 128) >> 8 for `n` four-channel pixels.
+    using LumaFn = void (*)(const uint8_t* px, uint32_t n, const int16_t w[4], uint8_t* luma);
+
+    void luma_scalar(const uint8_t* px, uint32_t n, const int16_t w[4], uint8_t* luma) {
+        for (uint32_t i = 0; i < n; ++i) {
+            const uint8_t* p = px + (size_t)i * 4;
+            luma[i] = (uint8_t)((p[0] * w[0] + p[1] * w[1] + p[2] * w[2] + 128) >> 8);
+        }
+    }
+
+    // min, max, sum and sum of squares of `n` RGBA float pixels and of their
+    // luminance, which is also written out for the histogram.
+    using ReduceFn = void (*)(const float* rgba, uint32_t n, const float w[4], float* luma, RowSums& sums);
+
+    void reduce_scalar(const float* rgba, uint32_t n, const float w[4], float* luma, RowSums& s) {
+        for (uint32_t i = 0; i < n; ++i) {
+            const float* p = rgba + (size_t)i * 4;
+            const float l = p[0] * w[0] + p[1] * w[1] + p[2] * w[2];
+            luma[i] = l;
+            for (int c = 0; c < 5; ++c) {
+                const float v = c == 4 ? l : p[c];
+                s.min[c] = std::min(s.min[c], v);
+                s.max[c] = std::max(s.max[c], v);
+                s.sum[c] += v;
+                s.sumsq[c] += v * v;
+            }
+        }
+    }
+
+#if DP_SIMD_X86
+    // Four pixels: widen to 16 bits, multiply-add the weight pairs, and a
+    // horizontal add leaves one 32-bit dot product per pixel, in order.
+    DP_TARGET("sse4.1")
+    void luma_sse41(const uint8_t* px, uint32_t n, const int16_t w[4], uint8_t* luma) {
+        const __m128i weights = _mm_setr_epi16(w[0], w[1], w[2], w[3], w[0], w[1], w[2], w[3]);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi32(128);
+        uint32_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(px + (size_t)i * 4));
+            const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(v, zero), weights);
+            const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(v, zero), weights);
+            const __m128i dot = _mm_srli_epi32(_mm_add_epi32(_mm_hadd_epi32(lo, hi), round), 8);
+            const __m128i bytes = _mm_packus_epi16(_mm_packus_epi32(dot, dot), zero);
+            const int packed = _mm_cvtsi128_si32(bytes);
+            memcpy(luma + i, &packed, 4);
+        }
+        luma_scalar(px + (size_t)i * 4, n - i, w, luma + i);
+    }
+
+    // Eight pixels; the unpacks work per 128-bit lane, which the lane-wise
+    // horizontal add puts back in pixel order.
+    DP_TARGET("avx2")
+    void luma_avx2(const uint8_t* px, uint32_t n, const int16_t w[4], uint8_t* luma) {
+        const __m256i weights = _mm256_setr_epi16(w[0], w[1], w[2], w[3], w[0], w[1], w[2], w[3],
+                                                  w[0], w[1], w[2], w[3], w[0], w[1], w[2], w[3]);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i round = _mm256_set1_epi32(128);
+        uint32_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const __m256i v = _mm256_loadu_si256((const __m256i*)(px + (size_t)i * 4));
+            const __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(v, zero), weights);
+            const __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(v, zero), weights);
+            const __m256i dot = _mm256_srli_epi32(_mm256_add_epi32(_mm256_hadd_epi32(lo, hi), round), 8);
+            const __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(dot, dot), zero);
+            const int a = _mm256_cvtsi256_si32(bytes);
+            const int b = _mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1));
+            memcpy(luma + i, &a, 4);
+            memcpy(luma + i + 4, &b, 4);
+        }
+        luma_sse41(px + (size_t)i * 4, n - i, w, luma + i);
+    }
+
+    // Two pixels per vector, channel c in lanes c and c + 4. Luminance comes
+    // from two horizontal adds, which leave it in every lane of its half.
+    DP_TARGET("avx2")
+    void reduce_avx2(const float* rgba, uint32_t n, const float w[4], float* luma, RowSums& s) {
+        const __m256 weights = _mm256_setr_ps(w[0], w[1], w[2], 0.0f, w[0], w[1], w[2], 0.0f);
+        __m256 vmin = _mm256_set1_ps(FLT_MAX), vmax = _mm256_set1_ps(-FLT_MAX);
+        __m256 vsum = _mm256_setzero_ps(), vsq = _mm256_setzero_ps();
+        __m256 lmin = vmin, lmax = vmax, lsum = vsum, lsq = vsq;
+        uint32_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            const __m256 v = _mm256_loadu_ps(rgba + (size_t)i * 4);
+            vmin = _mm256_min_ps(vmin, v);
+            vmax = _mm256_max_ps(vmax, v);
+            vsum = _mm256_add_ps(vsum, v);
+            vsq = _mm256_add_ps(vsq, _mm256_mul_ps(v, v));
+            const __m256 p = _mm256_mul_ps(v, weights);
+            const __m256 h = _mm256_hadd_ps(p, p);
+            const __m256 l = _mm256_hadd_ps(h, h);
+            lmin = _mm256_min_ps(lmin, l);
+            lmax = _mm256_max_ps(lmax, l);
+            lsum = _mm256_add_ps(lsum, l);
+            lsq = _mm256_add_ps(lsq, _mm256_mul_ps(l, l));
+            luma[i] = _mm256_cvtss_f32(l);
+            luma[i + 1] = _mm_cvtss_f32(_mm256_extractf128_ps(l, 1));
+        }
+        alignas(32) float a[4][8], b[4][8];
+        _mm256_store_ps(a[0], vmin); _mm256_store_ps(a[1], vmax); _mm256_store_ps(a[2], vsum); _mm256_store_ps(a[3], vsq);
+        _mm256_store_ps(b[0], lmin); _mm256_store_ps(b[1], lmax); _mm256_store_ps(b[2], lsum); _mm256_store_ps(b[3], lsq);
+        for (int c = 0; c < 5; ++c) {
+            const float (*src)[8] = c == 4 ? b : a;
+            const int k = c == 4 ? 0 : c;
+            s.min[c] = std::min(s.min[c], std::min(src[0][k], src[0][k + 4]));
+            s.max[c] = std::max(s.max[c], std::max(src[1][k], src[1][k + 4]));
+            s.sum[c] += src[2][k] + src[2][k + 4];
+            s.sumsq[c] += src[3][k] + src[3][k + 4];
+        }
+        reduce_scalar(rgba + (size_t)i * 4, n - i, w, luma + i, s);
+    }
+#endif
+
+    struct Kernels {
+        LumaFn luma;
+        ReduceFn reduce;
+    };
+
+    const Kernels kScalar = { luma_scalar, reduce_scalar };
+#if DP_SIMD_X86
+    const Kernels kSSE41 = { luma_sse41, reduce_scalar };
+    const Kernels kAVX2 = { luma_avx2, reduce_avx2 };
+#endif
+
+    const Kernels& kernels() {
+#if DP_SIMD_X86
+        const Convert::Isa isa = Convert::active_isa();
+        if (isa >= Convert::Isa::AVX2) return kAVX2;
+        if (isa >= Convert::Isa::SSE41) return kSSE41;
+#endif
+        return kScalar;
+    }
+
+    // --- Bands ---
+
+    void count_u8(const Formats::Traits& t, const uint8_t* p, size_t pitch, uint32_t width, uint32_t y0, uint32_t y1,
+                  Partial& out) {
+        const uint32_t channels = t.channels;
+        const ByteOrder order = byte_order(t.bgra);
+        const LumaFn luma_fn = kernels().luma;
+        // [channel][copy][bin]; pixel i counts into copy i & 1.
+        std::vector<uint32_t> counts((size_t)5 * 2 * kBins, 0);
+        auto table = [&](uint32_t c, uint32_t copy) { return counts.data() + ((size_t)c * 2 + copy) * kBins; };
+        std::vector<uint8_t> luma(channels == 4 ? width : 0);
+
+        for (uint32_t y = y0; y < y1; ++y) {
+            const uint8_t* row = p + (size_t)y * pitch;
+            if (channels == 4) {
+                luma_fn(row, width, order.weight, luma.data());
+                uint32_t* h[2][5];
+                for (uint32_t k = 0; k < 2; ++k) {
+                    for (uint32_t c = 0; c < 4; ++c) h[k][c] = table(c, k);
+                    h[k][kLuma] = table(kLuma, k);
+                }
+                for (uint32_t x = 0; x < width; ++x) {
+                    const uint8_t* px = row + (size_t)x * 4;
+                    uint32_t** hk = h[x & 1];
+                    ++hk[0][px[order.channel[0]]];
+                    ++hk[1][px[order.channel[1]]];
+                    ++hk[2][px[order.channel[2]]];
+                    ++hk[3][px[order.channel[3]]];
+                    ++hk[kLuma][luma[x]];
+                }
+            } else {
+                for (uint32_t x = 0; x < width; ++x) {
+                    for (uint32_t c = 0; c < channels; ++c) ++table(c, x & 1)[row[(size_t)x * channels + c]];
+                }
+            }
+        }
+        for (uint32_t c = 0; c < 5; ++c) {
+            if (c >= channels && c != kLuma) continue;
+            const uint32_t* a = table(channels == 4 || c != kLuma ? c : 0, 0);
+            const uint32_t* b = table(channels == 4 || c != kLuma ? c : 0, 1);
+            for (uint32_t bin = 0; bin < kBins; ++bin) out.histogram[c][bin] += (uint64_t)a[bin] + b[bin];
+        }
+        out.pixels += (uint64_t)width * (y1 - y0);
+    }
+
+    void reduce_float(const Formats::Traits& t, const uint8_t* p, size_t pitch, uint32_t width, uint32_t y0, uint32_t y1,
+                      Partial& out) {
+        const float w[4] = { t.channels >= 3 ? 0.2126f : 1.0f, t.channels >= 3 ? 0.7152f : 0.0f, t.channels >= 3 ? 0.0722f : 0.0f, 0.0f };
+        const ReduceFn reduce = kernels().reduce;
+        std::vector<float> rgba((size_t)kChunk * 4);
+        std::vector<float> luma(kChunk);
+
+        for (uint32_t y = y0; y < y1; ++y) {
+            const uint8_t* row = p + (size_t)y * pitch;
+            RowSums s;
+            std::fill(s.min, s.min + 5, FLT_MAX);
+            std::fill(s.max, s.max + 5, -FLT_MAX);
+            std::fill(s.sum, s.sum + 5, 0.0f);
+            std::fill(s.sumsq, s.sumsq + 5, 0.0f);
+            for (uint32_t x = 0; x < width; x += kChunk) {
+                const uint32_t n = std::min(kChunk, width - x);
+                Convert::decode_rgba32f(t.format, row + (size_t)x * t.block_bytes, rgba.data(), n);
+                reduce(rgba.data(), n, w, luma.data(), s);
+                for (uint32_t i = 0; i < n; ++i) {
+                    for (uint32_t c = 0; c < t.channels; ++c) ++out.histogram[c][bin_of(rgba[(size_t)i * 4 + c])];
+                    ++out.histogram[kLuma][bin_of(luma[i])];
+                }
+            }
+            for (int c = 0; c < 5; ++c) {
+                out.min[c] = std::min(out.min[c], s.min[c]);
+                out.max[c] = std::max(out.max[c], s.max[c]);
+                out.sum[c] += s.sum[c];
+                out.sumsq[c] += s.sumsq[c];
+            }
+        }
+        out.pixels += (uint64_t)width * (y1 - y0);
+    }
+
+    // Exact moments of 8-bit data from its histogram.
+    void from_histogram(const uint64_t* histogram, uint64_t pixels, Stats::Result& r, uint32_t c) {
+        uint32_t lo = kBins, hi = 0;
+        double sum = 0.0, sumsq = 0.0;
+        for (uint32_t b = 0; b < kBins; ++b) {
+            if (!histogram[b]) continue;
+            lo = std::min(lo, b);
+            hi = b;
+            sum += (double)b * histogram[b];
+            sumsq += (double)b * b * histogram[b];
+        }
+        const double mean = sum / pixels;
+        r.min[c] = lo / 255.0f;
+        r.max[c] = hi / 255.0f;
+        r.mean[c] = mean / 255.0;
+        r.variance[c] = std::max(0.0, sumsq / pixels - mean * mean) / (255.0 * 255.0);
+    }
+
+    const char* kShaderHLSL = R"(
+struct TileStats {
+    float4 min_rgba;
+    float4 max_rgba;
+    float4 sum_rgba;
+    float4 sumsq_rgba;
+    float4 luma;        // min, max, sum, sum of squares
+    uint pixels;
+    uint3 pad;
+};
+
+Texture2D<float4> g_input : register(t0);
+RWStructuredBuffer<TileStats> g_tiles : register(u0);   // tile_count + 1 records
+RWByteAddressBuffer g_histogram : register(u1);         // 5 x 256 uints, cleared before StatsTiles
+
+cbuffer StatsConstants : register(b0) {
+    uint2 g_size;
+    uint g_tile_count;
+    uint g_pad;
+    float4 g_luma_weights;   // BT.709 (0.2126, 0.7152, 0.0722, 0)
+};
+
+static const float kMax = 3.402823466e+38;
+
+groupshared uint gs_hist[5 * 256];
+groupshared TileStats gs_stats[256];
+
+TileStats empty_stats() {
+    TileStats s;
+    s.min_rgba = kMax; s.max_rgba = -kMax; s.sum_rgba = 0; s.sumsq_rgba = 0;
+    s.luma = float4(kMax, -kMax, 0, 0);
+    s.pixels = 0; s.pad = 0;
+    return s;
+}
+
+TileStats combine(TileStats a, TileStats b) {
+    TileStats s;
+    s.min_rgba = min(a.min_rgba, b.min_rgba);
+    s.max_rgba = max(a.max_rgba, b.max_rgba);
+    s.sum_rgba = a.sum_rgba + b.sum_rgba;
+    s.sumsq_rgba = a.sumsq_rgba + b.sumsq_rgba;
+    s.luma = float4(min(a.luma.x, b.luma.x), max(a.luma.y, b.luma.y), a.luma.zw + b.luma.zw);
+    s.pixels = a.pixels + b.pixels;
+    s.pad = 0;
+    return s;
+}
+
+// Tree reduction of gs_stats into gs_stats[0]; barriers are uniform.
+void reduce_group(uint gi) {
+    GroupMemoryBarrierWithGroupSync();
+    [unroll]
+    for (uint stride = 128; stride > 0; stride >>= 1) {
+        if (gi < stride) gs_stats[gi] = combine(gs_stats[gi], gs_stats[gi + stride]);
+        GroupMemoryBarrierWithGroupSync();
+    }
+}
+
+uint bin_of(float v) { return (uint)clamp(v * 256.0, 0.0, 255.0); }
+
+[numthreads(16, 16, 1)]
+void StatsTiles(uint3 group : SV_GroupID, uint3 id : SV_DispatchThreadID, uint gi : SV_GroupIndex) {
+    for (uint b = gi; b < 5 * 256; b += 256) gs_hist[b] = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    TileStats s = empty_stats();
+    if (all(id.xy < g_size)) {
+        const float4 c = g_input[id.xy];
+        const float l = dot(c.rgb, g_luma_weights.rgb);
+        s.min_rgba = c; s.max_rgba = c; s.sum_rgba = c; s.sumsq_rgba = c * c;
+        s.luma = float4(l, l, l, l * l);
+        s.pixels = 1;
+        InterlockedAdd(gs_hist[0 * 256 + bin_of(c.r)], 1);
+        InterlockedAdd(gs_hist[1 * 256 + bin_of(c.g)], 1);
+        InterlockedAdd(gs_hist[2 * 256 + bin_of(c.b)], 1);
+        InterlockedAdd(gs_hist[3 * 256 + bin_of(c.a)], 1);
+        InterlockedAdd(gs_hist[4 * 256 + bin_of(l)], 1);
+    }
+    gs_stats[gi] = s;
+    reduce_group(gi);
+
+    const uint tiles_x = (g_size.x + 15) / 16;
+    if (gi == 0) g_tiles[group.y * tiles_x + group.x] = gs_stats[0];
+    for (uint k = gi; k < 5 * 256; k += 256) {
+        if (gs_hist[k] != 0) g_histogram.InterlockedAdd(k * 4, gs_hist[k]);
+    }
+}
+
+[numthreads(256, 1, 1)]
+void StatsMerge(uint gi : SV_GroupIndex) {
+    TileStats s = empty_stats();
+    for (uint t = gi; t < g_tile_count; t += 256) s = combine(s, g_tiles[t]);
+    gs_stats[gi] = s;
+    reduce_group(gi);
+    if (gi == 0) g_tiles[g_tile_count] = gs_stats[0];
+}
+)";
+
+}
+
+bool Stats::is_supported(DXGI_FORMAT format) {
+    return Formats::is_convertible(format);
+}
+
+Stats::Result Stats::compute(DXGI_FORMAT format, const void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                             Scheduler& scheduler) {
+    if (!is_supported(format)) {
+        throw std::invalid_argument("Stats::compute: unsupported format.");
+    }
+    const Formats::Traits& t = Formats::traits(format);
+    Result r;
+    r.width = width;
+    r.height = height;
+    r.channels = t.channels;
+    if (width == 0 || height == 0) return r;
+
+    const bool u8 = t.sample == Formats::Sample::U8;
+    const auto* p = static_cast<const uint8_t*>(pixels);
+    Partial total;
+    std::mutex mutex;
+    scheduler.for_each_band(height, (size_t)width * t.block_bytes, [&](uint32_t y0, uint32_t y1) {
+        Partial band;
+        if (u8) count_u8(t, p, pitch, width, y0, y1, band);
+        else reduce_float(t, p, pitch, width, y0, y1, band);
+        std::lock_guard<std::mutex> lock(mutex);
+        total.merge(band);
+    });
+
+    r.pixels = total.pixels;
+    std::memcpy(r.histogram, total.histogram, sizeof(r.histogram));
+    for (uint32_t c = 0; c < 5; ++c) {
+        if (c >= t.channels && c != kLuma) continue;
+        if (u8) {
+            from_histogram(total.histogram[c], total.pixels, r, c);
+            continue;
+        }
+        const double mean = total.sum[c] / total.pixels;
+        r.min[c] = total.min[c];
+        r.max[c] = total.max[c];
+        r.mean[c] = mean;
+        r.variance[c] = std::max(0.0, total.sumsq[c] / total.pixels - mean * mean);
+    }
+    return r;
+}
+
+const char* Stats::shader_source() {
+    return kShaderHLSL;
+}
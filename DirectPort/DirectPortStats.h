@@ -0,0 +1,55 @@
+// DirectPortStats.h
+#pragma once
+
+#include "DirectPortPlatform.h"
+#include "DirectPortScheduler.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace DirectPort::Stats {
+
+    constexpr uint32_t kBins = 256;
+    // Index of luminance in the per-channel arrays, after R, G, B and A.
+    constexpr uint32_t kLuma = 4;
+
+    // Per-channel statistics of one frame, in RGBA order whatever the storage
+    // order, with values in the format's own units (0..1 for UNORM). Only the
+    // first `channels` entries and kLuma are filled. Luminance is BT.709 for
+    // formats with colour and the red channel for one- and two-channel formats.
+    //
+    // Histograms cover [0, 1] in kBins bins; values outside land in the end
+    // bins. For 8-bit formats every bin is one code value, so min, max, mean
+    // and variance come exactly from the histograms, and luminance is the
+    // 8-bit fixed-point (54 R + 183 G + 19 B) / 256.
+    struct Result {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t channels = 0;
+        uint64_t pixels = 0;
+        float min[5] = {};
+        float max[5] = {};
+        double mean[5] = {};
+        double variance[5] = {};
+        uint64_t histogram[5][kBins] = {};
+    };
+
+    // Formats Convert can decode.
+    bool is_supported(DXGI_FORMAT format);
+
+    // Rows are reduced in bands on `scheduler`, each band into its own
+    // partial, and the partials merged into the frame result. Row kernels come
+    // from Convert::active_isa(); 8-bit results are identical on every set.
+    Result compute(DXGI_FORMAT format, const void* pixels, size_t pitch, uint32_t width, uint32_t height,
+                   Scheduler& scheduler = Scheduler::shared());
+
+    // HLSL (cs_5_0) for the same statistics on the GPU, in two passes:
+    //   StatsTiles   one 16x16 group per tile reduces in groupshared memory and
+    //                writes one TileStats record, then adds its non-empty
+    //                histogram bins to a shared 5 x 256 uint histogram;
+    //   StatsMerge   one group of 256 threads folds the tile records into
+    //                record tile_count.
+    // Device memory sees one record and at most 1280 atomics per 256 pixels,
+    // spread over 1280 addresses, instead of an atomic per pixel on one.
+    const char* shader_source();
+
+}
@@ -0,0 +1,77 @@
+#include "DirectPortStats.h"
+#include "DirectPortFormats.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <algorithm>
+#include <string>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    // The first `channels` entries, then luminance, as a tuple.
+    template <typename T>
+    py::tuple channel_tuple(const Stats::Result& r, const T (&values)[5]) {
+        py::tuple out(r.channels);
+        for (uint32_t c = 0; c < r.channels; ++c) out[c] = values[c];
+        return out;
+    }
+
+}
+
+void bind_stats(py::module_& m) {
+    py::class_<Stats::Result>(m, "ImageStats",
+        "Per-channel statistics in RGBA order, in the format's units. Histograms cover [0, 1] in 256 bins.")
+        .def_readonly("width", &Stats::Result::width)
+        .def_readonly("height", &Stats::Result::height)
+        .def_readonly("channels", &Stats::Result::channels)
+        .def_readonly("pixels", &Stats::Result::pixels)
+        .def_property_readonly("min", [](const Stats::Result& r) { return channel_tuple(r, r.min); })
+        .def_property_readonly("max", [](const Stats::Result& r) { return channel_tuple(r, r.max); })
+        .def_property_readonly("mean", [](const Stats::Result& r) { return channel_tuple(r, r.mean); })
+        .def_property_readonly("variance", [](const Stats::Result& r) { return channel_tuple(r, r.variance); })
+        .def_property_readonly("luma_min", [](const Stats::Result& r) { return r.min[Stats::kLuma]; })
+        .def_property_readonly("luma_max", [](const Stats::Result& r) { return r.max[Stats::kLuma]; })
+        .def_property_readonly("luma_mean", [](const Stats::Result& r) { return r.mean[Stats::kLuma]; })
+        .def_property_readonly("luma_variance", [](const Stats::Result& r) { return r.variance[Stats::kLuma]; })
+        .def_property_readonly("histogram", [](const Stats::Result& r) {
+            py::array_t<uint64_t> out({ (py::ssize_t)r.channels, (py::ssize_t)Stats::kBins });
+            for (uint32_t c = 0; c < r.channels; ++c) std::copy(r.histogram[c], r.histogram[c] + Stats::kBins, out.mutable_data(c, 0));
+            return out;
+        }, "(channels, 256) uint64 counts.")
+        .def_property_readonly("luma_histogram", [](const Stats::Result& r) {
+            py::array_t<uint64_t> out(Stats::kBins);
+            std::copy(r.histogram[Stats::kLuma], r.histogram[Stats::kLuma] + Stats::kBins, out.mutable_data());
+            return out;
+        })
+        .def("__repr__", [](const Stats::Result& r) {
+            return "<ImageStats " + std::to_string(r.width) + "x" + std::to_string(r.height) +
+                   " luma mean " + std::to_string(r.mean[Stats::kLuma]) + ">";
+        });
+
+    m.def("image_stats", [](const py::array& pixels, DXGI_FORMAT format) {
+        if (!Stats::is_supported(format)) {
+            throw py::value_error("image_stats: unsupported format.");
+        }
+        const size_t bpp = Formats::bytes_per_pixel(format);
+        py::buffer_info info = pixels.request();
+        const size_t channels = info.ndim == 3 ? (size_t)info.shape[2] : 1;
+        const bool packed = (info.ndim == 2 || info.strides[2] == info.itemsize) &&
+                            info.strides[1] == (py::ssize_t)(channels * info.itemsize);
+        if ((info.ndim != 2 && info.ndim != 3) || !packed || channels * info.itemsize != bpp ||
+            info.strides[0] < info.shape[1] * info.strides[1]) {
+            throw py::value_error("image_stats: pixels must be a (height, width[, channels]) array with packed " +
+                                  std::to_string(bpp) + "-byte pixels.");
+        }
+        const auto* data = static_cast<const uint8_t*>(info.ptr);
+        const size_t pitch = (size_t)info.strides[0];
+        const uint32_t width = (uint32_t)info.shape[1], height = (uint32_t)info.shape[0];
+        py::gil_scoped_release release;
+        return Stats::compute(format, data, pitch, width, height);
+    }, py::arg("pixels"), py::arg("format"),
+       "Histograms, min, max, mean and variance per channel and of luminance. Rows may be strided.");
+
+    m.def("stats_shader_source", &Stats::shader_source,
+          "HLSL for the two-pass GPU reduction (StatsTiles, then StatsMerge) that mirrors image_stats.");
+}
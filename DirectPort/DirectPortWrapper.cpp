@@ -1,4 +1,5 @@
 #include "DirectPort.h"
+#include "DirectPortNumpyPixels.h"
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
@@ -14,6 +15,9 @@ static std::string wstring_to_string(const std::wstring& wstr) {
     return strTo;
 }
 
+std::vector<CompositeLayer> composite_layers_from_python(const py::iterable& items);
+std::vector<DirtyRect> dirty_rects_from_python(const py::object& items);
+
 void bind_prime(py::module_& m) {
     m.doc() = "The ancestral library for high-performance GPU operations in Python.";
 
@@ -26,6 +30,7 @@ void bind_prime(py::module_& m) {
         .value("R32_FLOAT", DXGI_FORMAT_R32_FLOAT, "")
         .value("R16_FLOAT", DXGI_FORMAT_R16_FLOAT, "")
         .value("R8_UNORM", DXGI_FORMAT_R8_UNORM, "")
+        .value("R8G8_UNORM", DXGI_FORMAT_R8G8_UNORM, "")
         .export_values();
 
     py::class_<ProducerInfo>(m, "ProducerInfo", "")
@@ -43,17 +48,31 @@ void bind_prime(py::module_& m) {
         .def("get_d3d11_texture_ptr", &Texture::get_d3d11_texture_ptr, "")
         .def("get_d3d11_srv_ptr", &Texture::get_d3d11_srv_ptr, "")
         .def("get_d3d11_rtv_ptr", &Texture::get_d3d11_rtv_ptr, "")
-        .def("get_d3d12_resource_ptr", &Texture::get_d3d12_resource_ptr, "");
+        .def("get_d3d12_resource_ptr", &Texture::get_d3d12_resource_ptr, "")
+        .def("get_cpu_ptr", &Texture::get_cpu_ptr, "")
+        .def_property_readonly("cpu_row_pitch", &Texture::get_cpu_row_pitch, "")
+        .def("__dlpack__", &Numpy::texture_dlpack, "CPU textures share their pixels as a DLPack tensor; GPU textures raise BufferError.")
+        .def("__dlpack_device__", &Numpy::texture_dlpack_device, "");
 
     py::class_<Consumer, std::shared_ptr<Consumer>>(m, "Consumer", "")
         .def("wait_for_frame", &Consumer::wait_for_frame, "", py::call_guard<py::gil_scoped_release>())
         .def("is_alive", &Consumer::is_alive, "", py::call_guard<py::gil_scoped_release>())
         .def("get_texture", &Consumer::get_texture, "")
         .def("get_shared_texture", &Consumer::get_shared_texture, "")
+        .def("get_dirty_rects", &Consumer::get_dirty_rects, "Regions changed since the previous frame; the full surface when unknown.")
         .def_property_readonly("pid", &Consumer::get_pid, "");
 
     py::class_<Producer, std::shared_ptr<Producer>>(m, "Producer", "")
-        .def("signal_frame", &Producer::signal_frame, "", py::call_guard<py::gil_scoped_release>())
+        .def("signal_frame", [](Producer& self, const py::object& dirty_rects) {
+            if (dirty_rects.is_none()) {
+                py::gil_scoped_release release;
+                self.signal_frame();
+                return;
+            }
+            auto rects = dirty_rects_from_python(dirty_rects);
+            py::gil_scoped_release release;
+            self.signal_frame(rects);
+        }, py::arg("dirty_rects") = py::none(), "Publishes a frame; dirty_rects limits it to the regions that changed.")
         .def_property_readonly("pid", &Producer::get_pid, "");
         
     py::class_<Window, std::shared_ptr<Window>>(m, "Window", "")
@@ -117,6 +136,36 @@ void bind_prime(py::module_& m) {
         self.apply_shader(output, shader_bytes, entry_point, cpp_inputs, {const_sv.begin(), const_sv.end()});
     };
 
+    auto composite_d3d11 = [](DeviceD3D11& self, std::shared_ptr<Texture> destination, const py::iterable& layers, bool clear, std::tuple<float, float, float, float> background, const py::object& regions) {
+        auto cpp_layers = composite_layers_from_python(layers);
+        // None redraws everything; an empty list means nothing changed.
+        std::optional<std::vector<DirtyRect>> cpp_regions;
+        if (!regions.is_none()) cpp_regions = dirty_rects_from_python(regions);
+        py::gil_scoped_release release;
+        self.composite(destination, cpp_layers, clear, std::get<0>(background), std::get<1>(background), std::get<2>(background), std::get<3>(background), cpp_regions);
+    };
+
+    auto copy_texture_regions_d3d11 = [](DeviceD3D11& self, std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination, const py::object& regions) {
+        auto cpp_regions = dirty_rects_from_python(regions);
+        py::gil_scoped_release release;
+        self.copy_texture_regions(source, destination, cpp_regions);
+    };
+
+    auto composite_d3d12 = [](DeviceD3D12& self, std::shared_ptr<Texture> destination, const py::iterable& layers, bool clear, std::tuple<float, float, float, float> background, const py::object& regions) {
+        auto cpp_layers = composite_layers_from_python(layers);
+        // None redraws everything; an empty list means nothing changed.
+        std::optional<std::vector<DirtyRect>> cpp_regions;
+        if (!regions.is_none()) cpp_regions = dirty_rects_from_python(regions);
+        py::gil_scoped_release release;
+        self.composite(destination, cpp_layers, clear, std::get<0>(background), std::get<1>(background), std::get<2>(background), std::get<3>(background), cpp_regions);
+    };
+
+    auto copy_texture_regions_d3d12 = [](DeviceD3D12& self, std::shared_ptr<Texture> source, std::shared_ptr<Texture> destination, const py::object& regions) {
+        auto cpp_regions = dirty_rects_from_python(regions);
+        py::gil_scoped_release release;
+        self.copy_texture_regions(source, destination, cpp_regions);
+    };
+
     py::class_<DeviceD3D11, std::shared_ptr<DeviceD3D11>>(m, "DeviceD3D11", "")
         .def_static("create", &DeviceD3D11::create, "")
         .def("create_texture", create_texture_d3d11, py::arg("width"), py::arg("height"), py::arg("format"), py::arg("data") = py::none(), "")
@@ -127,11 +176,14 @@ void bind_prime(py::module_& m) {
         .def("apply_shader", apply_shader_lambda_d3d11, py::arg("output"), py::arg("shader"), py::arg("entry_point") = "PSMain", py::arg("inputs") = py::list(), py::arg("constants") = py::bytes(""), 
         "", py::call_guard<py::gil_scoped_release>())
         .def("copy_texture", &DeviceD3D11::copy_texture, py::arg("source"), py::arg("destination"), "", py::call_guard<py::gil_scoped_release>())
+        .def("copy_texture_regions", copy_texture_regions_d3d11, py::arg("source"), py::arg("destination"), py::arg("regions"), "")
         .def("blit", &DeviceD3D11::blit, py::arg("source"), py::arg("destination"), "", py::call_guard<py::gil_scoped_release>())
         .def("clear", &DeviceD3D11::clear, py::arg("window"), py::arg("r"), py::arg("g"), py::arg("b"), py::arg("a"), "", py::call_guard<py::gil_scoped_release>())
         .def("blit_texture_to_region", &DeviceD3D11::blit_texture_to_region, py::arg("source"), py::arg("destination"),
              py::arg("dest_x"), py::arg("dest_y"), py::arg("dest_width"), py::arg("dest_height"),
              "", py::call_guard<py::gil_scoped_release>())
+        .def("composite", composite_d3d11, py::arg("destination"), py::arg("layers"), py::arg("clear") = true,
+             py::arg("background") = std::make_tuple(0.0f, 0.0f, 0.0f, 1.0f), py::arg("regions") = py::none(), "")
         .def("get_d3d11_device", [](DeviceD3D11& self) { return reinterpret_cast<uintptr_t>(self.get_d3d11_device()); })
         .def("get_d3d11_context", [](DeviceD3D11& self) { return reinterpret_cast<uintptr_t>(self.get_d3d11_context()); });
     
@@ -145,9 +197,12 @@ void bind_prime(py::module_& m) {
         .def("apply_shader", apply_shader_lambda_d3d12, py::arg("output"), py::arg("shader"), py::arg("entry_point") = "PSMain", py::arg("inputs") = py::list(), py::arg("constants") = py::bytes(""), 
         "", py::call_guard<py::gil_scoped_release>())
         .def("copy_texture", &DeviceD3D12::copy_texture, py::arg("source"), py::arg("destination"), "", py::call_guard<py::gil_scoped_release>())
+        .def("copy_texture_regions", copy_texture_regions_d3d12, py::arg("source"), py::arg("destination"), py::arg("regions"), "")
         .def("blit", &DeviceD3D12::blit, py::arg("source"), py::arg("destination"), "", py::call_guard<py::gil_scoped_release>())
         .def("clear", &DeviceD3D12::clear, py::arg("window"), py::arg("r"), py::arg("g"), py::arg("b"), py::arg("a"), "", py::call_guard<py::gil_scoped_release>())
         .def("blit_texture_to_region", &DeviceD3D12::blit_texture_to_region, py::arg("source"), py::arg("destination"),
              py::arg("dest_x"), py::arg("dest_y"), py::arg("dest_width"), py::arg("dest_height"),
-             "", py::call_guard<py::gil_scoped_release>());
+             "", py::call_guard<py::gil_scoped_release>())
+        .def("composite", composite_d3d12, py::arg("destination"), py::arg("layers"), py::arg("clear") = true,
+             py::arg("background") = std::make_tuple(0.0f, 0.0f, 0.0f, 1.0f), py::arg("regions") = py::none(), "");
 }
\ No newline at end of file
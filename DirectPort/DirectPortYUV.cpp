@@ -0,0 +1,569 @@
+// src/DirectPort/DirectPortYUV.cpp
+// Every path ends in one matrix kernel: three multiply-adds per channel on raw
+// sample codes, with range, matrix and output scale folded into the constants.
+// Full-size sources feed it straight from the planes, widening and
+// duplicating chroma in registers; downscaled output first averages float
+// 4:4:4 rows. AVX-512 machines run the AVX2 kernels.
+
+#include "DirectPortYUV.h"
+#include "DirectPortConvert.h"
+#include "DirectPortScheduler.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "DirectPortSimd.h"
+
+using namespace DirectPort;
+using namespace DirectPort::YUV;
+
+namespace {
+
+    // R = y*Y + rv*V + r0, G = y*Y + gu*U + gv*V + g0, B = y*Y + bu*U + b0,
+    // in output units, so results only need clamping to [0, hi].
+    struct Coeffs {
+        float y, rv, gu, gv, bu, r0, g0, b0, hi;
+    };
+
+    Coeffs make_coeffs(Matrix matrix, Range range, int bits, float scale) {
+        double kr, kb;
+        switch (matrix) {
+        case Matrix::BT601: kr = 0.299; kb = 0.114; break;
+        case Matrix::BT2020: kr = 0.2627; kb = 0.0593; break;
+        default: kr = 0.2126; kb = 0.0722; break;
+        }
+        const double kg = 1.0 - kr - kb;
+        const double s = (double)(1 << (bits - 8));
+        const double c_off = 128.0 * s;
+        double y_off, y_span, c_span;
+        if (range == Range::Limited) {
+            y_off = 16.0 * s;
+            y_span = 219.0 * s;
+            c_span = 224.0 * s;
+        } else {
+            y_off = 0.0;
+            y_span = c_span = (double)((1 << bits) - 1);
+        }
+        const double y = scale / y_span, c = scale / c_span;
+        const double rv = c * 2.0 * (1.0 - kr);
+        const double bu = c * 2.0 * (1.0 - kb);
+        const double gu = -c * 2.0 * kb * (1.0 - kb) / kg;
+        const double gv = -c * 2.0 * kr * (1.0 - kr) / kg;
+        Coeffs k;
+        k.y = (float)y;
+        k.rv = (float)rv;
+        k.gu = (float)gu;
+        k.gv = (float)gv;
+        k.bu = (float)bu;
+        k.r0 = (float)(-y * y_off - rv * c_off);
+        k.g0 = (float)(-y * y_off - (gu + gv) * c_off);
+        k.b0 = (float)(-y * y_off - bu * c_off);
+        k.hi = scale;
+        return k;
+    }
+
+    // Where one output row goes.
+    struct Row {
+        Output output = Output::BGRA8;
+        uint8_t* pixels = nullptr;
+        float* planes[3] = {};
+    };
+
+    // Round to nearest even, as cvtps2dq does, without a libm call.
+    inline uint8_t to_u8(float v) {
+        return (uint8_t)(int)((v + 12582912.0f) - 12582912.0f);
+    }
+
+    void emit(const Coeffs& k, const Row& row, uint32_t i, float Y, float U, float V) {
+        const float yy = k.y * Y;
+        const float r = std::min(std::max(yy + k.rv * V + k.r0, 0.0f), k.hi);
+        const float g = std::min(std::max(yy + k.gu * U + (k.gv * V + k.g0), 0.0f), k.hi);
+        const float b = std::min(std::max(yy + k.bu * U + k.b0, 0.0f), k.hi);
+        if (row.output == Output::PlanarFloat) {
+            row.planes[0][i] = r;
+            row.planes[1][i] = g;
+            row.planes[2][i] = b;
+            return;
+        }
+        uint8_t* p = row.pixels + 4 * (size_t)i;
+        const uint8_t R = to_u8(r), G = to_u8(g), B = to_u8(b);
+        p[0] = row.output == Output::RGBA8 ? R : B;
+        p[1] = G;
+        p[2] = row.output == Output::RGBA8 ? B : R;
+        p[3] = 255;
+    }
+
+    // --- Scalar kernels ---
+
+    void split_scalar(const uint8_t* src, uint8_t* even, uint8_t* odd, uint32_t pairs) {
+        for (uint32_t i = 0; i < pairs; ++i) {
+            even[i] = src[2 * i];
+            odd[i] = src[2 * i + 1];
+        }
+    }
+
+    // Full-width luma with half-width chroma, from pixel `i` on.
+    void row_u8_scalar(const Coeffs& k, const Row& row, const uint8_t* y, const uint8_t* u, const uint8_t* v, uint32_t i, uint32_t n) {
+        for (; i < n; ++i) emit(k, row, i, y[i], u[i / 2], v[i / 2]);
+    }
+    void row_u8_scalar(const Coeffs& k, const Row& row, const uint8_t* y, const uint8_t* u, const uint8_t* v, uint32_t n) {
+        row_u8_scalar(k, row, y, u, v, 0, n);
+    }
+
+    // P010 luma with interleaved UV words, both holding samples in the top 10 bits.
+    void row_p010_scalar(const Coeffs& k, const Row& row, const uint16_t* y, const uint16_t* c, uint32_t i, uint32_t n) {
+        for (; i < n; ++i) emit(k, row, i, (float)(y[i] >> 6), (float)(c[i & ~1u] >> 6), (float)(c[i | 1u] >> 6));
+    }
+    void row_p010_scalar(const Coeffs& k, const Row& row, const uint16_t* y, const uint16_t* c, uint32_t n) {
+        row_p010_scalar(k, row, y, c, 0, n);
+    }
+
+    void row_f32_scalar(const Coeffs& k, const Row& row, const float* y, const float* u, const float* v, uint32_t i, uint32_t n) {
+        for (; i < n; ++i) emit(k, row, i, y[i], u[i], v[i]);
+    }
+    void row_f32_scalar(const Coeffs& k, const Row& row, const float* y, const float* u, const float* v, uint32_t n) {
+        row_f32_scalar(k, row, y, u, v, 0, n);
+    }
+
+#ifdef DP_SIMD_X86
+
+    // --- SSE2 ---
+
+    DP_TARGET("sse2") void split_sse2(const uint8_t* src, uint8_t* even, uint8_t* odd, uint32_t pairs) {
+        const __m128i mask = _mm_set1_epi16(0x00FF);
+        uint32_t i = 0;
+        for (; i + 16 <= pairs; i += 16) {
+            const __m128i a = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+            const __m128i b = _mm_loadu_si128((const __m128i*)(src + 2 * i + 16));
+            _mm_storeu_si128((__m128i*)(even + i), _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+            _mm_storeu_si128((__m128i*)(odd + i), _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+        }
+        split_scalar(src + 2 * i, even + i, odd + i, pairs - i);
+    }
+
+    // Sixteen 8-bit results as int32 lanes saturate to 0..255 through the packs.
+    DP_TARGET("sse2") inline __m128i pack_u8_sse2(const __m128* v) {
+        return _mm_packus_epi16(_mm_packs_epi32(_mm_cvtps_epi32(v[0]), _mm_cvtps_epi32(v[1])),
+                                _mm_packs_epi32(_mm_cvtps_epi32(v[2]), _mm_cvtps_epi32(v[3])));
+    }
+
+    DP_TARGET("sse2") inline void store_pixels_sse2(uint8_t* dst, __m128i r, __m128i g, __m128i b) {
+        const __m128i a = _mm_set1_epi8((char)0xFF);
+        const __m128i bg_lo = _mm_unpacklo_epi8(b, g), bg_hi = _mm_unpackhi_epi8(b, g);
+        const __m128i ra_lo = _mm_unpacklo_epi8(r, a), ra_hi = _mm_unpackhi_epi8(r, a);
+        _mm_storeu_si128((__m128i*)dst + 0, _mm_unpacklo_epi16(bg_lo, ra_lo));
+        _mm_storeu_si128((__m128i*)dst + 1, _mm_unpackhi_epi16(bg_lo, ra_lo));
+        _mm_storeu_si128((__m128i*)dst + 2, _mm_unpacklo_epi16(bg_hi, ra_hi));
+        _mm_storeu_si128((__m128i*)dst + 3, _mm_unpackhi_epi16(bg_hi, ra_hi));
+    }
+
+    // Sixteen pixels, as four vectors each of Y, U and V.
+    DP_TARGET("sse2") inline void emit16_sse2(const Coeffs& k, const Row& row, uint32_t i, const __m128* Y, const __m128* U, const __m128* V) {
+        const __m128 ky = _mm_set1_ps(k.y), krv = _mm_set1_ps(k.rv), kgu = _mm_set1_ps(k.gu), kgv = _mm_set1_ps(k.gv);
+        const __m128 kbu = _mm_set1_ps(k.bu), kr0 = _mm_set1_ps(k.r0), kg0 = _mm_set1_ps(k.g0), kb0 = _mm_set1_ps(k.b0);
+        __m128 r[4], g[4], b[4];
+        for (int j = 0; j < 4; ++j) {
+            const __m128 yy = _mm_mul_ps(Y[j], ky);
+            r[j] = _mm_add_ps(_mm_add_ps(yy, _mm_mul_ps(V[j], krv)), kr0);
+            g[j] = _mm_add_ps(_mm_add_ps(yy, _mm_mul_ps(U[j], kgu)), _mm_add_ps(_mm_mul_ps(V[j], kgv), kg0));
+            b[j] = _mm_add_ps(_mm_add_ps(yy, _mm_mul_ps(U[j], kbu)), kb0);
+        }
+        if (row.output == Output::PlanarFloat) {
+            const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+            for (int j = 0; j < 4; ++j) {
+                _mm_storeu_ps(row.planes[0] + i + 4 * j, _mm_min_ps(_mm_max_ps(r[j], zero), one));
+                _mm_storeu_ps(row.planes[1] + i + 4 * j, _mm_min_ps(_mm_max_ps(g[j], zero), one));
+                _mm_storeu_ps(row.planes[2] + i + 4 * j, _mm_min_ps(_mm_max_ps(b[j], zero), one));
+            }
+            return;
+        }
+        const __m128i R = pack_u8_sse2(r), G = pack_u8_sse2(g), B = pack_u8_sse2(b);
+        if (row.output == Output::RGBA8) store_pixels_sse2(row.pixels + 4 * (size_t)i, B, G, R);
+        else store_pixels_sse2(row.pixels + 4 * (size_t)i, R, G, B);
+    }
+
+    DP_TARGET("sse2") inline void widen16_sse2(__m128i bytes, __m128* f) {
+        const __m128i z = _mm_setzero_si128();
+        const __m128i lo = _mm_unpacklo_epi8(bytes, z), hi = _mm_unpackhi_epi8(bytes, z);
+        f[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, z));
+        f[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, z));
+        f[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, z));
+        f[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, z));
+    }
+
+    DP_TARGET("sse2") void row_u8_sse2(const Coeffs& k, const Row& row, const uint8_t* y, const uint8_t* u, const uint8_t* v, uint32_t n) {
+        uint32_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i u8 = _mm_loadl_epi64((const __m128i*)(u + i / 2));
+            const __m128i v8 = _mm_loadl_epi64((const __m128i*)(v + i / 2));
+            __m128 Y[4], U[4], V[4];
+            widen16_sse2(_mm_loadu_si128((const __m128i*)(y + i)), Y);
+            widen16_sse2(_mm_unpacklo_epi8(u8, u8), U);
+            widen16_sse2(_mm_unpacklo_epi8(v8, v8), V);
+            emit16_sse2(k, row, i, Y, U, V);
+        }
+        row_u8_scalar(k, row, y, u, v, i, n);
+    }
+
+    DP_TARGET("sse2") void row_p010_sse2(const Coeffs& k, const Row& row, const uint16_t* y, const uint16_t* c, uint32_t n) {
+        const __m128i z = _mm_setzero_si128();
+        uint32_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128 Y[4], U[4], V[4];
+            for (int h = 0; h < 2; ++h) {
+                const __m128i yv = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(y + i + 8 * h)), 6);
+                Y[2 * h] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(yv, z));
+                Y[2 * h + 1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(yv, z));
+                // Four UV pairs cover these eight pixels.
+                const __m128i cv = _mm_loadu_si128((const __m128i*)(c + i + 8 * h));
+                const __m128i u = _mm_srli_epi32(_mm_slli_epi32(cv, 16), 22), v = _mm_srli_epi32(cv, 22);
+                U[2 * h] = _mm_cvtepi32_ps(_mm_unpacklo_epi32(u, u));
+                U[2 * h + 1] = _mm_cvtepi32_ps(_mm_unpackhi_epi32(u, u));
+                V[2 * h] = _mm_cvtepi32_ps(_mm_unpacklo_epi32(v, v));
+                V[2 * h + 1] = _mm_cvtepi32_ps(_mm_unpackhi_epi32(v, v));
+            }
+            emit16_sse2(k, row, i, Y, U, V);
+        }
+        row_p010_scalar(k, row, y, c, i, n);
+    }
+
+    DP_TARGET("sse2") void row_f32_sse2(const Coeffs& k, const Row& row, const float* y, const float* u, const float* v, uint32_t n) {
+        uint32_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128 Y[4], U[4], V[4];
+            for (int j = 0; j < 4; ++j) {
+                Y[j] = _mm_loadu_ps(y + i + 4 * j);
+                U[j] = _mm_loadu_ps(u + i + 4 * j);
+                V[j] = _mm_loadu_ps(v + i + 4 * j);
+            }
+            emit16_sse2(k, row, i, Y, U, V);
+        }
+        row_f32_scalar(k, row, y, u, v, i, n);
+    }
+
+    // --- AVX2 ---
+
+    DP_TARGET("avx2") inline __m128i pack_u8_avx2(const __m256* v) {
+        // packs works within 128-bit lanes; the permute puts the halves back in order.
+        const __m256i p = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_cvtps_epi32(v[0]), _mm256_cvtps_epi32(v[1])), 0xD8);
+        return _mm_packus_epi16(_mm256_castsi256_si128(p), _mm256_extracti128_si256(p, 1));
+    }
+
+    DP_TARGET("avx2") inline void emit16_avx2(const Coeffs& k, const Row& row, uint32_t i, const __m256* Y, const __m256* U, const __m256* V) {
+        const __m256 ky = _mm256_set1_ps(k.y), krv = _mm256_set1_ps(k.rv), kgu = _mm256_set1_ps(k.gu), kgv = _mm256_set1_ps(k.gv);
+        const __m256 kbu = _mm256_set1_ps(k.bu), kr0 = _mm256_set1_ps(k.r0), kg0 = _mm256_set1_ps(k.g0), kb0 = _mm256_set1_ps(k.b0);
+        __m256 r[2], g[2], b[2];
+        for (int j = 0; j < 2; ++j) {
+            const __m256 yy = _mm256_mul_ps(Y[j], ky);
+            r[j] = _mm256_add_ps(_mm256_add_ps(yy, _mm256_mul_ps(V[j], krv)), kr0);
+            g[j] = _mm256_add_ps(_mm256_add_ps(yy, _mm256_mul_ps(U[j], kgu)), _mm256_add_ps(_mm256_mul_ps(V[j], kgv), kg0));
+            b[j] = _mm256_add_ps(_mm256_add_ps(yy, _mm256_mul_ps(U[j], kbu)), kb0);
+        }
+        if (row.output == Output::PlanarFloat) {
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+            for (int j = 0; j < 2; ++j) {
+                _mm256_storeu_ps(row.planes[0] + i + 8 * j, _mm256_min_ps(_mm256_max_ps(r[j], zero), one));
+                _mm256_storeu_ps(row.planes[1] + i + 8 * j, _mm256_min_ps(_mm256_max_ps(g[j], zero), one));
+                _mm256_storeu_ps(row.planes[2] + i + 8 * j, _mm256_min_ps(_mm256_max_ps(b[j], zero), one));
+            }
+            return;
+        }
+        const __m128i R = pack_u8_avx2(r), G = pack_u8_avx2(g), B = pack_u8_avx2(b);
+        if (row.output == Output::RGBA8) store_pixels_sse2(row.pixels + 4 * (size_t)i, B, G, R);
+        else store_pixels_sse2(row.pixels + 4 * (size_t)i, R, G, B);
+    }
+
+    DP_TARGET("avx2") inline void widen16_avx2(__m128i bytes, __m256* f) {
+        f[0] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        f[1] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_unpackhi_epi64(bytes, bytes)));
+    }
+
+    DP_TARGET("avx2") void row_u8_avx2(const Coeffs& k, const Row& row, const uint8_t* y, const uint8_t* u, const uint8_t* v, uint32_t n) {
+        uint32_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i u8 = _mm_loadl_epi64((const __m128i*)(u + i / 2));
+            const __m128i v8 = _mm_loadl_epi64((const __m128i*)(v + i / 2));
+            __m256 Y[2], U[2], V[2];
+            widen16_avx2(_mm_loadu_si128((const __m128i*)(y + i)), Y);
+            widen16_avx2(_mm_unpacklo_epi8(u8, u8), U);
+            widen16_avx2(_mm_unpacklo_epi8(v8, v8), V);
+            emit16_avx2(k, row, i, Y, U, V);
+        }
+        row_u8_scalar(k, row, y, u, v, i, n);
+    }
+
+    DP_TARGET("avx2") void row_p010_avx2(const Coeffs& k, const Row& row, const uint16_t* y, const uint16_t* c, uint32_t n) {
+        const __m256i pairs = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        uint32_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m256 Y[2], U[2], V[2];
+            for (int h = 0; h < 2; ++h) {
+                const __m256i yv = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(y + i + 8 * h)));
+                Y[h] = _mm256_cvtepi32_ps(_mm256_srli_epi32(yv, 6));
+                const __m256i cv = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(c + i + 8 * h)));
+                const __m256i u = _mm256_srli_epi32(_mm256_slli_epi32(cv, 16), 22), v = _mm256_srli_epi32(cv, 22);
+                U[h] = _mm256_cvtepi32_ps(_mm256_permutevar8x32_epi32(u, pairs));
+                V[h] = _mm256_cvtepi32_ps(_mm256_permutevar8x32_epi32(v, pairs));
+            }
+            emit16_avx2(k, row, i, Y, U, V);
+        }
+        row_p010_scalar(k, row, y, c, i, n);
+    }
+
+    DP_TARGET("avx2") void row_f32_avx2(const Coeffs& k, const Row& row, const float* y, const float* u, const float* v, uint32_t n) {
+        uint32_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m256 Y[2], U[2], V[2];
+            for (int j = 0; j < 2; ++j) {
+                Y[j] = _mm256_loadu_ps(y + i + 8 * j);
+                U[j] = _mm256_loadu_ps(u + i + 8 * j);
+                V[j] = _mm256_loadu_ps(v + i + 8 * j);
+            }
+            emit16_avx2(k, row, i, Y, U, V);
+        }
+        row_f32_scalar(k, row, y, u, v, i, n);
+    }
+
+#endif
+
+    struct Kernels {
+        void (*split)(const uint8_t*, uint8_t*, uint8_t*, uint32_t);
+        void (*row_u8)(const Coeffs&, const Row&, const uint8_t*, const uint8_t*, const uint8_t*, uint32_t);
+        void (*row_p010)(const Coeffs&, const Row&, const uint16_t*, const uint16_t*, uint32_t);
+        void (*row_f32)(const Coeffs&, const Row&, const float*, const float*, const float*, uint32_t);
+    };
+
+    const Kernels kScalar = { split_scalar, row_u8_scalar, row_p010_scalar, row_f32_scalar };
+#ifdef DP_SIMD_X86
+    const Kernels kSSE2 = { split_sse2, row_u8_sse2, row_p010_sse2, row_f32_sse2 };
+    const Kernels kAVX2 = { split_sse2, row_u8_avx2, row_p010_avx2, row_f32_avx2 };
+#endif
+
+    const Kernels& kernels() {
+#ifdef DP_SIMD_X86
+        const Convert::Isa isa = Convert::active_isa();
+        if (isa >= Convert::Isa::AVX2) return kAVX2;
+        if (isa >= Convert::Isa::SSE41) return kSSE2;
+#endif
+        return kScalar;
+    }
+
+    size_t packed_pitch(Format format, uint32_t width) {
+        // Interleaved chroma needs an even number of samples per row.
+        const size_t even = ((size_t)width + 1) & ~(size_t)1;
+        switch (format) {
+        case Format::NV12: return even;
+        case Format::P010: return even * 2;
+        case Format::YUY2:
+        case Format::UYVY: return even * 2;
+        default: return width;
+        }
+    }
+
+    // Per-band scratch rows.
+    struct Scratch {
+        std::vector<uint8_t> y, c, u, v;
+        std::vector<float> fy, fu, fv;
+        std::vector<float> sy, su, sv;
+    };
+
+    // Luma and half-width chroma rows of an 8-bit source. Interleaved chroma
+    // and packed 4:2:2 are split into scratch first.
+    void fetch_u8(const Kernels& kn, const Image& img, uint32_t row, Scratch& s,
+                  const uint8_t*& y, const uint8_t*& u, const uint8_t*& v) {
+        const uint32_t cw = (img.width + 1) / 2;
+        switch (img.format) {
+        case Format::NV12:
+            y = img.planes[0] + row * img.pitches[0];
+            kn.split(img.planes[1] + (row / 2) * img.pitches[1], s.u.data(), s.v.data(), cw);
+            break;
+        case Format::I420:
+            y = img.planes[0] + row * img.pitches[0];
+            u = img.planes[1] + (row / 2) * img.pitches[1];
+            v = img.planes[2] + (row / 2) * img.pitches[2];
+            return;
+        case Format::YUY2:
+            kn.split(img.planes[0] + row * img.pitches[0], s.y.data(), s.c.data(), cw * 2);
+            kn.split(s.c.data(), s.u.data(), s.v.data(), cw);
+            y = s.y.data();
+            break;
+        case Format::UYVY:
+            kn.split(img.planes[0] + row * img.pitches[0], s.c.data(), s.y.data(), cw * 2);
+            kn.split(s.c.data(), s.u.data(), s.v.data(), cw);
+            y = s.y.data();
+            break;
+        default:
+            break;
+        }
+        u = s.u.data();
+        v = s.v.data();
+    }
+
+    // One source row as float 4:4:4 codes in s.fy, s.fu and s.fv.
+    void fetch_f32(const Kernels& kn, const Image& img, uint32_t row, Scratch& s) {
+        const uint32_t w = img.width;
+        if (img.format == Format::P010) {
+            const uint16_t* y = reinterpret_cast<const uint16_t*>(img.planes[0] + row * img.pitches[0]);
+            const uint16_t* c = reinterpret_cast<const uint16_t*>(img.planes[1] + (row / 2) * img.pitches[1]);
+            for (uint32_t x = 0; x < w; ++x) {
+                s.fy[x] = (float)(y[x] >> 6);
+                s.fu[x] = (float)(c[x & ~1u] >> 6);
+                s.fv[x] = (float)(c[x | 1u] >> 6);
+            }
+            return;
+        }
+        const uint8_t *y, *u, *v;
+        fetch_u8(kn, img, row, s, y, u, v);
+        for (uint32_t x = 0; x < w; ++x) {
+            s.fy[x] = y[x];
+            s.fu[x] = u[x / 2];
+            s.fv[x] = v[x / 2];
+        }
+    }
+
+}
+
+Image YUV::describe(Format format, const void* data, uint32_t width, uint32_t height, size_t pitch) {
+    Image img;
+    img.format = format;
+    img.width = width;
+    img.height = height;
+    const auto* p = static_cast<const uint8_t*>(data);
+    const size_t luma = pitch ? pitch : packed_pitch(format, width);
+    const size_t chroma_rows = (height + 1) / 2;
+    img.planes[0] = p;
+    img.pitches[0] = luma;
+    switch (format) {
+    case Format::NV12:
+    case Format::P010:
+        img.planes[1] = p + luma * height;
+        img.pitches[1] = luma;
+        break;
+    case Format::I420:
+        img.pitches[1] = img.pitches[2] = (luma + 1) / 2;
+        img.planes[1] = p + luma * height;
+        img.planes[2] = img.planes[1] + img.pitches[1] * chroma_rows;
+        break;
+    default:
+        break;
+    }
+    return img;
+}
+
+size_t YUV::frame_size(Format format, uint32_t width, uint32_t height, size_t pitch) {
+    const size_t luma = pitch ? pitch : packed_pitch(format, width);
+    const size_t chroma_rows = (height + 1) / 2;
+    switch (format) {
+    case Format::NV12:
+    case Format::P010: return luma * (height + chroma_rows);
+    case Format::I420: return luma * height + 2 * ((luma + 1) / 2) * chroma_rows;
+    default: return luma * height;
+    }
+}
+
+size_t YUV::output_row_bytes(Output output, uint32_t width) {
+    (void)output; // four bytes per pixel, or per sample in each float plane
+    return (size_t)width * 4;
+}
+
+size_t YUV::output_size(Output output, uint32_t width, uint32_t height) {
+    return output_row_bytes(output, width) * height * (output == Output::PlanarFloat ? 3 : 1);
+}
+
+void YUV::to_rgb(const Image& src, Output output, void* dst, uint32_t out_width, uint32_t out_height,
+                 Matrix matrix, Range range, size_t dst_pitch) {
+    const uint32_t w = src.width, h = src.height;
+    if (w == 0 || h == 0 || out_width == 0 || out_height == 0) return;
+    if (out_width > w || out_height > h) {
+        throw std::invalid_argument("YUV::to_rgb: the output cannot be larger than the source.");
+    }
+    const int plane_count = src.format == Format::I420 ? 3 : (src.format == Format::NV12 || src.format == Format::P010) ? 2 : 1;
+    for (int p = 0; p < plane_count; ++p) {
+        if (!src.planes[p]) throw std::invalid_argument("YUV::to_rgb: missing source plane.");
+    }
+    if (src.pitches[0] < packed_pitch(src.format, w)) {
+        throw std::invalid_argument("YUV::to_rgb: source pitch is smaller than a row.");
+    }
+    const size_t row_bytes = output_row_bytes(output, out_width);
+    const size_t pitch = dst_pitch ? dst_pitch : row_bytes;
+    if (pitch < row_bytes) throw std::invalid_argument("YUV::to_rgb: destination pitch is smaller than a row.");
+
+    const bool planar = output == Output::PlanarFloat;
+    const Coeffs k = make_coeffs(matrix, range, src.format == Format::P010 ? 10 : 8, planar ? 1.0f : 255.0f);
+    const Kernels& kn = kernels();
+    auto* base = static_cast<uint8_t*>(dst);
+    auto row_at = [&](uint32_t oy) {
+        Row row;
+        row.output = output;
+        if (planar) {
+            for (int c = 0; c < 3; ++c) row.planes[c] = reinterpret_cast<float*>(base + (c * (size_t)out_height + oy) * pitch);
+        } else {
+            row.pixels = base + oy * pitch;
+        }
+        return row;
+    };
+
+    const uint32_t cw = (w + 1) / 2;
+    const bool scaled = out_width != w || out_height != h;
+    // Each source column and row lands in exactly one output pixel.
+    std::vector<uint32_t> column_of, column_count;
+    if (scaled) {
+        column_of.resize(w);
+        column_count.assign(out_width, 0);
+        for (uint32_t x = 0; x < w; ++x) {
+            column_of[x] = (uint32_t)((uint64_t)x * out_width / w);
+            column_count[column_of[x]]++;
+        }
+    }
+
+    Scheduler::shared().for_each_band(out_height, row_bytes, [&](uint32_t y0, uint32_t y1) {
+        Scratch s;
+        s.y.resize(cw * 2);
+        s.c.resize(cw * 2);
+        s.u.resize(cw);
+        s.v.resize(cw);
+        if (scaled) {
+            s.fy.resize(w);
+            s.fu.resize(w);
+            s.fv.resize(w);
+            s.sy.resize(out_width);
+            s.su.resize(out_width);
+            s.sv.resize(out_width);
+        }
+        for (uint32_t oy = y0; oy < y1; ++oy) {
+            const Row row = row_at(oy);
+            if (!scaled) {
+                if (src.format == Format::P010) {
+                    kn.row_p010(k, row, reinterpret_cast<const uint16_t*>(src.planes[0] + oy * src.pitches[0]),
+                                reinterpret_cast<const uint16_t*>(src.planes[1] + (oy / 2) * src.pitches[1]), w);
+                } else {
+                    const uint8_t *y, *u, *v;
+                    fetch_u8(kn, src, oy, s, y, u, v);
+                    kn.row_u8(k, row, y, u, v, w);
+                }
+                continue;
+            }
+            const uint32_t first = (uint32_t)(((uint64_t)oy * h + out_height - 1) / out_height);
+            const uint32_t last = (uint32_t)(((uint64_t)(oy + 1) * h + out_height - 1) / out_height);
+            std::fill(s.sy.begin(), s.sy.end(), 0.0f);
+            std::fill(s.su.begin(), s.su.end(), 0.0f);
+            std::fill(s.sv.begin(), s.sv.end(), 0.0f);
+            for (uint32_t sy = first; sy < last; ++sy) {
+                fetch_f32(kn, src, sy, s);
+                for (uint32_t x = 0; x < w; ++x) {
+                    const uint32_t c = column_of[x];
+                    s.sy[c] += s.fy[x];
+                    s.su[c] += s.fu[x];
+                    s.sv[c] += s.fv[x];
+                }
+            }
+            for (uint32_t c = 0; c < out_width; ++c) {
+                const float scale = 1.0f / (float)(column_count[c] * (last - first));
+                s.sy[c] *= scale;
+                s.su[c] *= scale;
+                s.sv[c] *= scale;
+            }
+            kn.row_f32(k, row, s.sy.data(), s.su.data(), s.sv.data(), out_width);
+        }
+    });
+}
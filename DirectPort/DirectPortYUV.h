@@ -0,0 +1,45 @@
+// DirectPortYUV.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DirectPort::YUV {
+
+    // Camera and decoder layouts. NV12, I420 and P010 are 4:2:0 with the chroma
+    // plane(s) after luma; YUY2 and UYVY are packed 4:2:2. P010 holds 10-bit
+    // samples in the high bits of 16-bit words.
+    enum class Format { NV12, YUY2, UYVY, I420, P010 };
+    enum class Matrix { BT601, BT709, BT2020 };
+    enum class Range { Limited, Full };
+    // PlanarFloat writes R, G and B planes of floats in [0, 1], one after another.
+    enum class Output { BGRA8, RGBA8, PlanarFloat };
+
+    // Plane pointers and row pitches in bytes. I420 uses all three planes,
+    // NV12 and P010 two, YUY2 and UYVY one.
+    struct Image {
+        Format format = Format::NV12;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        const uint8_t* planes[3] = {};
+        size_t pitches[3] = {};
+    };
+
+    // A frame stored in one buffer, planes back to back, as Media Foundation
+    // delivers it. pitch is the luma (or packed) row pitch; 0 means tightly packed.
+    Image describe(Format format, const void* data, uint32_t width, uint32_t height, size_t pitch = 0);
+    size_t frame_size(Format format, uint32_t width, uint32_t height, size_t pitch = 0);
+
+    // Bytes in one packed output row (one plane row for PlanarFloat) and in a packed image.
+    size_t output_row_bytes(Output output, uint32_t width);
+    size_t output_size(Output output, uint32_t width, uint32_t height);
+
+    // Converts src into an out_width x out_height image, which may be smaller
+    // than the source: every output pixel then averages the source pixels it
+    // covers. Chroma is upsampled by replication. dst_pitch 0 means packed rows;
+    // PlanarFloat planes are dst_pitch * out_height bytes apart. Rows are split
+    // across Scheduler::shared() and run on the active Convert kernel set.
+    void to_rgb(const Image& src, Output output, void* dst, uint32_t out_width, uint32_t out_height,
+                Matrix matrix = Matrix::BT709, Range range = Range::Limited, size_t dst_pitch = 0);
+
+}
@@ -0,0 +1,83 @@
+#include "DirectPortYUV.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <type_traits>
+#include <vector>
+
+namespace py = pybind11;
+using namespace DirectPort;
+
+namespace {
+
+    // A C-contiguous array of T with at least `count` elements, taken from `out` or freshly made.
+    template <typename T>
+    py::array_t<T, py::array::c_style> output_array(const py::object& out, std::vector<py::ssize_t> shape, size_t count) {
+        using Array = py::array_t<T, py::array::c_style>;
+        if (out.is_none()) return Array(shape);
+        if (!py::isinstance<Array>(out)) {
+            throw py::type_error(std::is_same<T, float>::value ? "yuv_to_rgb: out must be a C-contiguous float32 array."
+                                                               : "yuv_to_rgb: out must be a C-contiguous uint8 array.");
+        }
+        Array result = out.cast<Array>();
+        if ((size_t)result.size() < count) throw py::value_error("yuv_to_rgb: out is too small for the output image.");
+        return result;
+    }
+
+}
+
+void bind_yuv(py::module_& m) {
+    py::enum_<YUV::Format>(m, "YuvFormat", "YUV layouts the CPU colour converter reads.")
+        .value("NV12", YUV::Format::NV12, "")
+        .value("YUY2", YUV::Format::YUY2, "")
+        .value("UYVY", YUV::Format::UYVY, "")
+        .value("I420", YUV::Format::I420, "")
+        .value("P010", YUV::Format::P010, "");
+
+    py::enum_<YUV::Matrix>(m, "YuvMatrix")
+        .value("BT601", YUV::Matrix::BT601, "")
+        .value("BT709", YUV::Matrix::BT709, "")
+        .value("BT2020", YUV::Matrix::BT2020, "");
+
+    py::enum_<YUV::Range>(m, "YuvRange")
+        .value("Limited", YUV::Range::Limited, "")
+        .value("Full", YUV::Range::Full, "");
+
+    py::enum_<YUV::Output>(m, "YuvOutput")
+        .value("BGRA8", YUV::Output::BGRA8, "")
+        .value("RGBA8", YUV::Output::RGBA8, "")
+        .value("PlanarFloat", YUV::Output::PlanarFloat, "");
+
+    m.def("yuv_frame_size", &YUV::frame_size, py::arg("format"), py::arg("width"), py::arg("height"), py::arg("pitch") = 0,
+          "Bytes in one frame with its planes back to back.");
+
+    // BGRA8 / RGBA8 return (height, width, 4) uint8; PlanarFloat returns (3, height, width) float32.
+    m.def("yuv_to_rgb", [](const py::buffer& src, YUV::Format format, uint32_t width, uint32_t height,
+                           YUV::Matrix matrix, YUV::Range range, YUV::Output output,
+                           uint32_t out_width, uint32_t out_height, size_t pitch, const py::object& out) {
+        py::buffer_info in = src.request();
+        if ((size_t)(in.size * in.itemsize) < YUV::frame_size(format, width, height, pitch)) {
+            throw py::value_error("yuv_to_rgb: source buffer is smaller than one frame.");
+        }
+        if (out_width == 0) out_width = width;
+        if (out_height == 0) out_height = height;
+        if (out_width > width || out_height > height) {
+            throw py::value_error("yuv_to_rgb: the output cannot be larger than the source.");
+        }
+        const YUV::Image image = YUV::describe(format, in.ptr, width, height, pitch);
+        auto convert = [&](void* dst) {
+            py::gil_scoped_release release;
+            YUV::to_rgb(image, output, dst, out_width, out_height, matrix, range);
+        };
+        if (output == YUV::Output::PlanarFloat) {
+            auto result = output_array<float>(out, { 3, (py::ssize_t)out_height, (py::ssize_t)out_width }, (size_t)3 * out_width * out_height);
+            convert(result.mutable_data());
+            return py::array(result);
+        }
+        auto result = output_array<uint8_t>(out, { (py::ssize_t)out_height, (py::ssize_t)out_width, 4 }, (size_t)4 * out_width * out_height);
+        convert(result.mutable_data());
+        return py::array(result);
+    }, py::arg("src"), py::arg("format"), py::arg("width"), py::arg("height"),
+       py::arg("matrix") = YUV::Matrix::BT709, py::arg("range") = YUV::Range::Limited, py::arg("output") = YUV::Output::BGRA8,
+       py::arg("out_width") = 0, py::arg("out_height") = 0, py::arg("pitch") = 0, py::arg("out") = py::none(),
+       "Converts a YUV frame to RGB on the CPU, optionally box-downscaling it.");
+}
@@ -13,6 +13,23 @@ void bind_numpy(py::module_& m);
 void bind_camera(py::module_& m);
 void bind_onnx(py::module_& m);
 void bind_gl(py::module_& m);
+void bind_scheduler(py::module_& m);
+void bind_copy(py::module_& m);
+void bind_cpu(py::module_& m);
+void bind_convert(py::module_& m);
+void bind_yuv(py::module_& m);
+void bind_resample(py::module_& m);
+void bind_blend(py::module_& m);
+void bind_stats(py::module_& m);
+void bind_frame_diff(py::module_& m);
+void bind_codec(py::module_& m);
+void bind_staging(py::module_& m);
+void bind_readback(py::module_& m);
+void bind_numpy_pixels(py::module_& m);
+void bind_file_producer(py::module_& m);
+void bind_framegraph(py::module_& m);
+void bind_composite(py::module_& m);
+void bind_dirty_rects(py::module_& m);
 
 // PYBIND11_MODULE defines the entry point for the 'directport' kingdom.
 PYBIND11_MODULE(directport, m) {
@@ -20,9 +37,29 @@ PYBIND11_MODULE(directport, m) {
 
     // Call the other wrappers to come and add their bindings.
     // Each function will build its own self-contained fiefdom.
+#ifdef _WIN32
     bind_prime(m);
     bind_numpy(m);
     bind_camera(m);
     bind_onnx(m);
     bind_gl(m);
+#endif
+    // The portable fiefdoms below also build off Windows.
+    bind_scheduler(m);
+    bind_copy(m);
+    bind_resample(m);
+    bind_blend(m);
+    bind_stats(m);
+    bind_frame_diff(m);
+    bind_codec(m);
+    bind_staging(m);
+    bind_readback(m);
+    bind_numpy_pixels(m);
+    bind_file_producer(m);
+    bind_cpu(m);
+    bind_convert(m);
+    bind_yuv(m);
+    bind_framegraph(m);
+    bind_composite(m);
+    bind_dirty_rects(m);
 }
\ No newline at end of file
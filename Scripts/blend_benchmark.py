@@ -0,0 +1,138 @@
+# --- blend_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+RGBA = directport.DXGI_FORMAT.R8G8B8A8_UNORM
+MODES = [directport.BlendMode.Over, directport.BlendMode.PremultipliedOver,
+         directport.BlendMode.Add, directport.BlendMode.Multiply]
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) / iterations
+
+def expected_blend(mode, src, dst, opacity):
+    """The blend equations in float, with opacity quantised to 8 bits as the kernels do."""
+    s = src.astype(np.float64) / 255.0
+    d = dst.astype(np.float64) / 255.0
+    op = np.round(opacity * 255.0) / 255.0
+    a = s[..., 3:4] * op
+    if mode == directport.BlendMode.Over:
+        rgb = s[..., :3] * a + d[..., :3] * (1.0 - a)
+    elif mode == directport.BlendMode.PremultipliedOver:
+        rgb = np.minimum(s[..., :3] * op + d[..., :3] * (1.0 - a), 1.0)
+    elif mode == directport.BlendMode.Add:
+        rgb = np.minimum(d[..., :3] + s[..., :3] * a, 1.0)
+    else:
+        rgb = d[..., :3] * (s[..., :3] * a + (1.0 - a))
+    alpha = a + d[..., 3:4] * (1.0 - a)
+    return np.concatenate([rgb, alpha], axis=-1) * 255.0
+
+def expected_key(pixels, fmt, value_fn, level, softness):
+    p = pixels.astype(np.float64)
+    r, g, b = (p[..., 2], p[..., 1], p[..., 0]) if fmt == BGRA else (p[..., 0], p[..., 1], p[..., 2])
+    t = (value_fn(r, g, b) - level * 255.0) / (softness * 255.0)
+    return np.clip(t, 0.0, 1.0) * p[..., 3]
+
+def check(rng, isas):
+    """Every kernel set against the scalar one (bit for bit) and against the float equations."""
+    failures = 0
+    src = rng.integers(0, 256, size=(67, 1031, 4), dtype=np.uint8)
+    dst = rng.integers(0, 256, size=(67, 1031, 4), dtype=np.uint8)
+    region = (slice(5, 60), slice(3, 1000))
+
+    for mode in MODES:
+        for opacity in (1.0, 0.6):
+            results = []
+            for isa in isas:
+                directport.set_convert_isa(isa)
+                out = dst.copy()
+                # A sliced region, so strided rows are covered too.
+                directport.blend_pixels(src[region], out[region], mode, opacity)
+                results.append(out)
+            if any(not np.array_equal(results[0], r) for r in results[1:]):
+                failures += 1
+                print(f"  MISMATCH between kernel sets: {mode.name} opacity {opacity}")
+            if not np.array_equal(results[0][:5], dst[:5]) or not np.array_equal(results[0][:, :3], dst[:, :3]):
+                failures += 1
+                print(f"  {mode.name} wrote outside its region")
+            error = np.abs(results[0][region].astype(np.float64) - expected_blend(mode, src[region], dst[region], opacity)).max()
+            if error > 1.5:
+                failures += 1
+                print(f"  {mode.name} opacity {opacity}: {error:.2f} steps from the float equation")
+
+    cb = lambda r, g, b: -0.2126 / 1.8556 * r - 0.7152 / 1.8556 * g + 0.5 * b
+    cr = lambda r, g, b: 0.5 * r - 0.7152 / 1.5748 * g - 0.0722 / 1.5748 * b
+    key = (0.1, 0.8, 0.2)
+    for fmt in (BGRA, RGBA):
+        k = tuple(c * 255.0 for c in key)
+        chroma = lambda r, g, b: np.hypot(cb(r, g, b) - cb(*k), cr(r, g, b) - cr(*k))
+        luma = lambda r, g, b: 0.2126 * r + 0.7152 * g + 0.0722 * b
+        cases = [
+            ("chroma", lambda px: directport.chroma_key_pixels(px, fmt, key, 0.2, 0.1), chroma, 0.2, 0.1),
+            ("luma", lambda px: directport.luma_key_pixels(px, fmt, 0.4, 0.1), luma, 0.4, 0.1),
+            ("inverted luma", lambda px: directport.luma_key_pixels(px, fmt, 0.4, 0.1, True),
+             lambda r, g, b: -luma(r, g, b), -0.4, 0.1),
+        ]
+        for name, run, value_fn, level, softness in cases:
+            results = []
+            for isa in isas:
+                directport.set_convert_isa(isa)
+                out = src.copy()
+                run(out)
+                results.append(out)
+            if any(not np.array_equal(results[0], r) for r in results[1:]):
+                failures += 1
+                print(f"  MISMATCH between kernel sets: {name} key on {fmt.name}")
+            if not np.array_equal(results[0][..., :3], src[..., :3]):
+                failures += 1
+                print(f"  {name} key changed colour channels")
+            error = np.abs(results[0][..., 3] - expected_key(src, fmt, value_fn, level, softness)).max()
+            if error > 0.51:
+                failures += 1
+                print(f"  {name} key on {fmt.name}: {error:.2f} steps from the float matte")
+    return failures
+
+def main():
+    """
+    Validates the CPU blend and key kernels on every kernel set this CPU
+    supports, then times them on 4K BGRA frames. Runs headless, on any platform.
+    """
+    print("--- DirectPort Blend Benchmark ---")
+    iterations = int(sys.argv[1]) if len(sys.argv) > 1 else 10
+    rng = np.random.default_rng(11)
+
+    best = directport.best_convert_isa()
+    isas = [isa for isa in (directport.ConvertIsa.Scalar, directport.ConvertIsa.SSE41,
+                            directport.ConvertIsa.AVX2, directport.ConvertIsa.AVX512) if int(isa) <= int(best)]
+    failures = check(rng, isas)
+    print(f"Validation on {', '.join(isa.name for isa in isas)}: "
+          + ("all kernel sets agree." if failures == 0 else f"{failures} failures."))
+
+    width, height = 3840, 2160
+    overlay = rng.integers(0, 256, size=(height, width, 4), dtype=np.uint8)
+    frame = rng.integers(0, 256, size=(height, width, 4), dtype=np.uint8)
+    frame_bytes = width * height * 4
+    print(f"\n4K BGRA, {directport.scheduler_lanes()} lanes, {iterations} iterations")
+    print(f"{'kernel':>20}" + "".join(f"{isa.name:>18}" for isa in isas))
+    rows = [(mode.name, 3, lambda mode=mode: directport.blend_pixels(overlay, frame, mode, 0.8)) for mode in MODES]
+    rows.append(("chroma key", 2, lambda: directport.chroma_key_pixels(frame, BGRA, (0.0, 1.0, 0.0), 0.15, 0.1)))
+    rows.append(("luma key", 2, lambda: directport.luma_key_pixels(frame, BGRA, 0.1, 0.05)))
+    for name, passes, fn in rows:
+        cells = []
+        for isa in isas:
+            directport.set_convert_isa(isa)
+            seconds = bench(fn, iterations)
+            # Bytes read plus bytes written.
+            cells.append(f"{seconds * 1000.0:7.2f} ms {passes * frame_bytes / seconds / 1e9:5.1f} GB/s")
+        print(f"{name:>20}" + "".join(f"{cell:>18}" for cell in cells))
+    directport.set_convert_isa(best)
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,137 @@
+# --- codec_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+FORMATS = [
+    (directport.DXGI_FORMAT.B8G8R8A8_UNORM, np.uint8, 4),
+    (directport.DXGI_FORMAT.R8_UNORM, np.uint8, 1),
+    (directport.DXGI_FORMAT.R16G16B16A16_FLOAT, np.float16, 4),
+    (directport.DXGI_FORMAT.R32G32B32A32_FLOAT, np.float32, 4),
+]
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) / iterations
+
+def desktop(rng, height, width):
+    """Smooth gradients, flat panels and some noise: roughly what a desktop capture looks like."""
+    y, x = np.mgrid[0:height, 0:width]
+    frame = np.empty((height, width, 4), np.uint8)
+    frame[..., 0] = (x * 255 // max(width - 1, 1))
+    frame[..., 1] = (y * 255 // max(height - 1, 1))
+    frame[..., 2] = ((x + y) // 7) & 0xFF
+    frame[..., 3] = 255
+    frame[height // 4:height // 2, width // 3:width // 2] = (40, 40, 40, 255)
+    noise = rng.integers(0, 256, size=(height // 8, width // 8, 4), dtype=np.uint8)
+    frame[:height // 8, -(width // 8):] = noise
+    return frame
+
+def sample(rng, dtype, channels, height, width):
+    base = desktop(rng, height, width)[..., :channels]
+    if dtype == np.uint8:
+        return np.ascontiguousarray(base)
+    return (base.astype(np.float32) / 255.0).astype(dtype)
+
+def check(rng, isas):
+    """Every kernel set round-trips every format exactly and writes the same bytes."""
+    failures = 0
+    for format, dtype, channels in FORMATS:
+        for height, width, tile in ((1, 1, 64), (37, 53, 16), (300, 517, 64), (130, 70, 100)):
+            first = sample(rng, dtype, channels, height + 3, width + 5)
+            second = first.copy()
+            second[height // 2:, :width // 3] = second[height // 2:, :width // 3][::-1]
+            # Sliced views, so strided rows are covered too.
+            frames = [first[1:height + 1, 2:width + 2], second[1:height + 1, 2:width + 2]]
+            encoded = []
+            for isa in isas:
+                directport.set_convert_isa(isa)
+                encoder = directport.FrameEncoder(tile)
+                decoder = directport.FrameDecoder()
+                stream = [encoder.encode(f, format) for f in frames]
+                encoded.append(stream)
+                for f, data in zip(frames, stream):
+                    out = decoder.decode(data)
+                    if out.view(np.uint8).tobytes() != np.ascontiguousarray(f).view(np.uint8).tobytes():
+                        failures += 1
+                        print(f"  {isa.name} {format.name} {width}x{height}: round trip differs")
+            if any(e != encoded[0] for e in encoded[1:]):
+                failures += 1
+                print(f"  MISMATCH between kernel sets: {format.name} {width}x{height}")
+    directport.set_convert_isa(isas[-1])
+
+    # A delta frame only decodes on top of the frame before it.
+    frame = sample(rng, np.uint8, 4, 64, 64)
+    encoder = directport.FrameEncoder()
+    key = encoder.encode(frame, FORMATS[0][0])
+    encoder.encode(frame, FORMATS[0][0])
+    delta = encoder.encode(frame, FORMATS[0][0])
+    decoder = directport.FrameDecoder()
+    decoder.decode(key)
+    try:
+        decoder.decode(delta)
+        failures += 1
+        print("  a delta frame decoded without the frame before it")
+    except RuntimeError:
+        pass
+    return failures
+
+def main():
+    """
+    Validates exact round trips on every kernel set this CPU supports, then
+    times key and delta frames of a 1080p BGRA desktop-like capture next to
+    zlib at its fastest level. Runs headless, on any platform.
+    """
+    print("--- DirectPort Frame Codec Benchmark ---")
+    iterations = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+    rng = np.random.default_rng(31)
+
+    best = directport.best_convert_isa()
+    isas = [isa for isa in (directport.ConvertIsa.Scalar, directport.ConvertIsa.SSE41,
+                            directport.ConvertIsa.AVX2, directport.ConvertIsa.AVX512) if int(isa) <= int(best)]
+    failures = check(rng, isas)
+    print(f"Validation on {', '.join(isa.name for isa in isas)}: "
+          + ("all kernel sets agree." if failures == 0 else f"{failures} failures."))
+
+    width, height = 1920, 1080
+    bgra = FORMATS[0][0]
+    key = desktop(rng, height, width)
+    moved = key.copy()
+    moved[500:540, 900:1000] ^= 0x55  # a cursor-sized change
+    frame_bytes = key.nbytes
+
+    print(f"\n1080p BGRA, {directport.CODEC_DEFAULT_TILE_SIZE}-pixel tiles, {directport.scheduler_lanes()} lanes, {iterations} iterations")
+    print(f"{'method':>26}{'time':>12}{'ratio':>9}{'throughput':>14}")
+    for isa in isas:
+        directport.set_convert_isa(isa)
+        data = directport.encode_frame(key, bgra)
+        encode = bench(lambda: directport.encode_frame(key, bgra), iterations)
+        decode = bench(lambda: directport.decode_frame(data), iterations)
+        ratio = frame_bytes / len(data)
+        print(f"{'key encode (' + isa.name + ')':>26}{encode * 1000.0:9.2f} ms{ratio:8.2f}x{frame_bytes / encode / 1e9:9.2f} GB/s")
+        print(f"{'key decode (' + isa.name + ')':>26}{decode * 1000.0:9.2f} ms{'':>9}{frame_bytes / decode / 1e9:9.2f} GB/s")
+    directport.set_convert_isa(best)
+
+    delta = directport.encode_frame(moved, bgra, previous=key, frame_index=1)
+    seconds = bench(lambda: directport.encode_frame(moved, bgra, previous=key, frame_index=1), iterations)
+    modes = directport.codec_tile_modes(delta)
+    print(f"{'delta encode':>26}{seconds * 1000.0:9.2f} ms{frame_bytes / len(delta):8.0f}x{frame_bytes / seconds / 1e9:9.2f} GB/s  "
+          + ", ".join(f"{directport.CodecTileMode(i).name} {n}" for i, n in enumerate(modes)))
+    seconds = bench(lambda: directport.decode_frame(delta, key), iterations)
+    print(f"{'delta decode':>26}{seconds * 1000.0:9.2f} ms{'':>9}{frame_bytes / seconds / 1e9:9.2f} GB/s")
+
+    try:
+        import zlib
+        packed = zlib.compress(key.tobytes(), 1)
+        seconds = bench(lambda: zlib.compress(key.tobytes(), 1), max(iterations // 4, 1))
+        print(f"{'zlib level 1':>26}{seconds * 1000.0:9.2f} ms{frame_bytes / len(packed):8.2f}x{frame_bytes / seconds / 1e9:9.2f} GB/s")
+    except ImportError:
+        pass
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
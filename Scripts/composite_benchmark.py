@@ -0,0 +1,113 @@
+# --- composite_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+
+def over(dst, src, opacity):
+    """The 8-bit blend DeviceCPU uses for a translucent layer."""
+    a = int(np.float32(opacity) * np.float32(255) + np.float32(0.5))
+    s, d = src.astype(np.uint32), dst.astype(np.uint32)
+    s[..., 3] = 255
+    x = s * a + d * (255 - a) + 128
+    return ((x + (x >> 8)) >> 8).astype(np.uint8)
+
+def check(device):
+    """composite() against a clear and one blit_texture_to_region per layer, in draw order."""
+    rng = np.random.default_rng(28)
+
+    def texture(w, h):
+        t = device.create_texture(w, h, BGRA)
+        device.write_texture(t, rng.integers(0, 256, (h, w, 4), np.uint8))
+        return t
+
+    wide, tall, big, a, b = texture(160, 90), texture(60, 120), texture(256, 128), texture(100, 80), texture(100, 80)
+    fit = directport.CompositeFit
+    # Each layer, where it must land and the part of its source it shows, in
+    # draw order: by z, then by list position among equal z.
+    cases = [
+        (directport.CompositeLayer(wide, 0, 0, 150, 150, fit=fit.Letterbox), (0, 33, 150, 84), None),
+        (directport.CompositeLayer(tall, 160, 0, 150, 100, fit=fit.Letterbox), (210, 0, 50, 100), None),
+        (directport.CompositeLayer(big, 10, 100, 64, 64, fit=fit.Crop), (10, 100, 64, 64), (64, 0, 128, 128)),
+        (directport.CompositeLayer(a, 40, 40, 140, 90, opacity=0.5, z=1), (40, 40, 140, 90), None),
+        (directport.CompositeLayer(big, 100, 60, 128, 128, z=1, fit=fit.Crop), (100, 60, 128, 128), (64, 0, 128, 128)),
+        (directport.CompositeLayer(b, 90, 60, 100, 80, opacity=0.3, z=1), (90, 60, 100, 80), None),
+    ]
+    layers = [cases[i][0] for i in (3, 0, 4, 1, 5, 2)]
+
+    width, height = 320, 200
+    expected = device.create_texture(width, height, BGRA)
+    device.clear_texture(expected, 0.0, 0.0, 0.0, 1.0)
+    for layer, (x, y, w, h), crop in cases:
+        source = layer.source
+        if crop:
+            cx, cy, cw, ch = crop
+            source = device.create_texture(cw, ch, BGRA)
+            device.write_texture(source, device.read_texture(layer.source)[cy:cy + ch, cx:cx + cw])
+        if layer.opacity >= 1.0:
+            device.blit_texture_to_region(source, expected, x, y, w, h)
+            continue
+        drawn = device.create_texture(width, height, BGRA)
+        device.blit_texture_to_region(source, drawn, x, y, w, h)
+        pixels = device.read_texture(expected)
+        pixels[y:y + h, x:x + w] = over(pixels[y:y + h, x:x + w], device.read_texture(drawn)[y:y + h, x:x + w], layer.opacity)
+        device.write_texture(expected, pixels)
+
+    output = device.create_texture(width, height, BGRA)
+    device.composite(output, layers)
+    wrong = np.any(device.read_texture(output) != device.read_texture(expected), axis=2)
+    if wrong.any():
+        ys, xs = np.nonzero(wrong)
+        print(f"  composite differs from clear + blits at {wrong.sum()} pixels, first at ({xs[0]}, {ys[0]})")
+        return 1
+    return 0
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) * 1000.0 / iterations
+
+def main():
+    """
+    Checks DeviceCPU.composite against a clear and one
+    blit_texture_to_region per layer for letterboxed, cropped, translucent
+    and equal-z layers, then times the two for 4/16/64-input grids at 1080p
+    and 4K. Runs headless, on any platform.
+    """
+    print("--- DirectPort CPU Composite Benchmark ---")
+    threads = int(sys.argv[1]) if len(sys.argv) > 1 else 0
+    iterations = int(sys.argv[2]) if len(sys.argv) > 2 else 10
+
+    device = directport.DeviceCPU.create(threads)
+    failures = check(device)
+    print("Validation: " + ("composite matches clear + per-layer blits." if failures == 0 else f"{failures} failures."))
+    fmt = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+    print(f"Worker lanes: {device.thread_count}, iterations: {iterations}")
+
+    for width, height in ((1920, 1080), (3840, 2160)):
+        output = device.create_texture(width, height, fmt)
+        for count in (4, 16, 64):
+            sources = [device.create_texture(1280, 720, fmt) for _ in range(count)]
+            for i, tex in enumerate(sources):
+                device.clear_texture(tex, (i % 4) / 3.0, ((i // 4) % 4) / 3.0, 0.5, 1.0)
+            layers = directport.grid_layout(sources, width, height, fit=directport.CompositeFit.Stretch)
+
+            def one_pass():
+                device.composite(output, layers)
+
+            def per_input():
+                device.clear_texture(output, 0.0, 0.0, 0.0, 1.0)
+                for layer in layers:
+                    device.blit_texture_to_region(layer.source, output, layer.x, layer.y, layer.width, layer.height)
+
+            composite_ms = bench(one_pass, iterations)
+            blit_ms = bench(per_input, iterations)
+            print(f"{width}x{height} {count:>2} inputs: composite {composite_ms:7.2f} ms | per-input blits {blit_ms:7.2f} ms")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
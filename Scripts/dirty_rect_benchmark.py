@@ -0,0 +1,196 @@
+# --- dirty_rect_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+
+def mask(rects, width, height):
+    """How many of `rects` cover each pixel, clipped to the frame."""
+    m = np.zeros((height, width), np.int32)
+    for r in rects:
+        x, y, w, h = (r.x, r.y, r.width, r.height) if isinstance(r, directport.DirtyRect) else r
+        m[y:y + h, x:x + w] += 1
+    return m
+
+def inside(r, width, height):
+    return r.width > 0 and r.height > 0 and r.x + r.width <= width and r.y + r.height <= height
+
+def check_normalize(rng):
+    """Random rect lists: normalize stays in the frame, within max_rects, disjoint, and covers every input."""
+    failures = 0
+    for trial in range(500):
+        width, height = (int(v) for v in rng.integers(1, 300, 2))
+        max_rects = int(rng.integers(1, 17))
+        coverage = float(rng.uniform(0.3, 1.0))
+        count = int(rng.integers(0, 400 if trial % 10 == 0 else 40))
+        rects = [tuple(int(v) for v in rng.integers(0, (width + 40, height + 40, 80, 80))) for _ in range(count)]
+        out = directport.normalize_dirty_rects(rects, width, height, max_rects=max_rects, full_coverage=coverage)
+        covered = mask(out, width, height)
+        problems = []
+        if not all(inside(r, width, height) for r in out):
+            problems.append("a rect leaves the frame")
+        if len(out) > max_rects:
+            problems.append(f"{len(out)} rects for max_rects={max_rects}")
+        if covered.max(initial=0) > 1:
+            problems.append("rects overlap")
+        if np.any((mask(rects, width, height) > 0) & (covered == 0)):
+            problems.append("an input pixel is not covered")
+        full = len(out) == 1 and (out[0].x, out[0].y, out[0].width, out[0].height) == (0, 0, width, height)
+        if not full and directport.dirty_rects_area(out) > coverage * width * height:
+            problems.append("covers more than full_coverage without falling back to the full frame")
+        if problems:
+            failures += 1
+            if failures <= 5:
+                print(f"  normalize {width}x{height}, {count} rects, max {max_rects}: " + ", ".join(problems))
+
+    # Above the coverage threshold the full frame comes back; below it, the rect itself.
+    for rect, coverage, expected in (((0, 0, 100, 80), 0.75, (0, 0, 100, 100)), ((0, 0, 100, 80), 0.9, (0, 0, 100, 80)),
+                                     ((10, 10, 60, 60), 0.75, (10, 10, 60, 60))):
+        out = directport.normalize_dirty_rects([rect], 100, 100, full_coverage=coverage)
+        if [(r.x, r.y, r.width, r.height) for r in out] != [expected]:
+            failures += 1
+            print(f"  normalize {rect} at full_coverage={coverage} gave {out} instead of {expected}")
+    return failures
+
+def check_snap(rng):
+    """snap_to_tiles covers exactly the tiles the input touches, each pixel once."""
+    failures = 0
+    for trial in range(300):
+        width, height = (int(v) for v in rng.integers(1, 300, 2))
+        tile = int(2 ** rng.integers(3, 7))
+        rects = [tuple(int(v) for v in rng.integers(0, (width + 40, height + 40, 80, 80))) for _ in range(int(rng.integers(0, 30)))]
+        out = directport.snap_dirty_rects_to_tiles(rects, tile, width, height)
+        ys, xs = np.nonzero(mask(rects, width, height))
+        touched = np.zeros((-(-height // tile), -(-width // tile)), bool)
+        touched[ys // tile, xs // tile] = True
+        expected = np.kron(touched, np.ones((tile, tile), bool))[:height, :width]
+        aligned = all(r.x % tile == 0 and r.y % tile == 0 and ((r.x + r.width) % tile == 0 or r.x + r.width == width) and
+                      ((r.y + r.height) % tile == 0 or r.y + r.height == height) for r in out)
+        if not aligned or not all(inside(r, width, height) for r in out) or not np.array_equal(mask(out, width, height), expected.astype(np.int32)):
+            failures += 1
+            if failures <= 5:
+                print(f"  snap_to_tiles {width}x{height} with {tile}px tiles covers other pixels than the touched tiles")
+    return failures
+
+def check_propagate(device, rng):
+    """Recompositing only the propagated rects matches a full recomposite byte for byte; regions=[] redraws nothing."""
+    failures = 0
+    width, height = 480, 270
+    for trial in range(20):
+        sources, pixels = [], []
+        for _ in range(6):
+            w, h = int(rng.integers(40, 240)), int(rng.integers(30, 180))
+            pixels.append(rng.integers(0, 256, (h, w, 4), np.uint8))
+            sources.append(device.create_texture(w, h, BGRA))
+            device.write_texture(sources[-1], pixels[-1])
+        fit = directport.CompositeFit.Letterbox if trial % 2 else directport.CompositeFit.Crop
+        layers = directport.grid_layout(sources, width, height, gap=4, fit=fit)
+        layers.append(directport.CompositeLayer(sources[0], 100, 50, 200, 150, opacity=0.6, z=1))
+        output, expected = device.create_texture(width, height, BGRA), device.create_texture(width, height, BGRA)
+        device.composite(output, layers, background=(0.1, 0.2, 0.3, 1.0))
+
+        changed = [[] for _ in sources]
+        for i, frame in enumerate(pixels):
+            if rng.random() < 0.5:
+                continue
+            h, w = frame.shape[:2]
+            for _ in range(3):
+                x, y = int(rng.integers(0, w)), int(rng.integers(0, h))
+                rw, rh = int(rng.integers(1, min(w - x, 30) + 1)), int(rng.integers(1, min(h - y, 30) + 1))
+                frame[y:y + rh, x:x + rw] = rng.integers(0, 256, (rh, rw, 4), np.uint8)
+                changed[i].append((x, y, rw, rh))
+            device.write_texture(sources[i], frame)
+        source_dirty = changed + [changed[0]]
+        regions = directport.propagate_dirty_rects(layers, source_dirty, width, height)
+
+        device.composite(output, layers, background=(0.1, 0.2, 0.3, 1.0), regions=regions)
+        device.composite(expected, layers, background=(0.1, 0.2, 0.3, 1.0))
+        if not np.array_equal(device.read_texture(output), device.read_texture(expected)):
+            failures += 1
+            print(f"  {fit.name} grid: recompositing {len(regions)} propagated rects differs from a full recomposite")
+
+    # No changed regions means nothing to redraw, unlike regions=None.
+    idle = rng.integers(0, 256, (height, width, 4), np.uint8)
+    device.write_texture(output, idle)
+    device.composite(output, layers, background=(0.1, 0.2, 0.3, 1.0), regions=[])
+    if not np.array_equal(device.read_texture(output), idle):
+        failures += 1
+        print("  composite with regions=[] redrew the output")
+    device.composite(output, layers, background=(0.1, 0.2, 0.3, 1.0))
+    if not np.array_equal(device.read_texture(output), device.read_texture(expected)):
+        failures += 1
+        print("  composite without regions did not redraw the whole output")
+    return failures
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) * 1000.0 / iterations
+
+def main():
+    """
+    Checks that normalized and tile-snapped rect lists cover exactly what
+    they should and that recompositing propagated rects matches a full
+    composite. Then measures what dirty-rect tracking saves on DeviceCPU:
+    copying only the changed regions of a 1080p frame, and recompositing only
+    the grid cells a change lands in. Runs headless, on any platform.
+    """
+    print("--- DirectPort Dirty Rect Benchmark ---")
+    threads = int(sys.argv[1]) if len(sys.argv) > 1 else 0
+    iterations = int(sys.argv[2]) if len(sys.argv) > 2 else 20
+
+    device = directport.DeviceCPU.create(threads)
+    fmt = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+    rng = np.random.default_rng(29)
+    failures = check_normalize(rng) + check_snap(rng) + check_propagate(device, rng)
+    print("Validation: " + ("rect lists and region composites are exact." if failures == 0 else f"{failures} failures."))
+
+    width, height = 1920, 1080
+    frame_bytes = width * height * 4
+    print(f"Worker lanes: {device.thread_count}, iterations: {iterations}")
+
+    # Typical per-frame damage for a desktop-style producer.
+    scenarios = {
+        "cursor": [(900, 500, 32, 32), (880, 490, 32, 32)],
+        "typing": [(200 + 12 * i, 300, 12, 20) for i in range(6)],
+        "video window": [(640, 360, 640, 360)],
+        "scattered": [((i * 211) % 1800, (i * 97) % 1000, 64, 48) for i in range(60)],
+        "full frame": [(0, 0, width, height)],
+    }
+
+    source = device.create_texture(width, height, fmt)
+    destination = device.create_texture(width, height, fmt)
+    device.clear_texture(source, 0.2, 0.4, 0.6, 1.0)
+
+    full_ms = bench(lambda: device.copy_texture(source, destination), iterations)
+    print(f"\nFull copy: {full_ms:7.3f} ms, {frame_bytes / 1e6:.2f} MB")
+    for name, rects in scenarios.items():
+        regions = directport.normalize_dirty_rects(rects, width, height)
+        moved = directport.dirty_rects_area(regions) * 4
+        region_ms = bench(lambda: device.copy_texture_regions(source, destination, regions), iterations)
+        print(f"{name:>13}: {len(regions):>2} rects, {moved / 1e6:6.3f} MB ({100.0 * moved / frame_bytes:5.1f}%), "
+              f"{region_ms:7.3f} ms ({full_ms / max(region_ms, 1e-6):6.1f}x)")
+
+    # A 16-input multiplexer where one input reports a small change.
+    inputs = [device.create_texture(1280, 720, fmt) for _ in range(16)]
+    for i, tex in enumerate(inputs):
+        device.clear_texture(tex, (i % 4) / 3.0, ((i // 4) % 4) / 3.0, 0.5, 1.0)
+    layers = directport.grid_layout(inputs, width, height, fit=directport.CompositeFit.Stretch)
+    output = device.create_texture(width, height, fmt)
+    source_dirty = [[] for _ in inputs]
+    source_dirty[5] = [(600, 300, 80, 60)]
+    regions = directport.propagate_dirty_rects(layers, source_dirty, width, height)
+
+    full_ms = bench(lambda: device.composite(output, layers), iterations)
+    region_ms = bench(lambda: device.composite(output, layers, regions=regions), iterations)
+    touched = directport.dirty_rects_area(regions)
+    print(f"\n16-input composite: full {full_ms:7.3f} ms | dirty {region_ms:7.3f} ms "
+          f"({len(regions)} rects, {100.0 * touched / (width * height):.2f}% of the output)")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,122 @@
+# --- dlpack_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+F16 = directport.DXGI_FORMAT.R16G16B16A16_FLOAT
+
+class Producer:
+    """A bare DLPack producer, so write paths are checked without an array type NumPy already knows."""
+    def __init__(self, array):
+        self.array = array
+    def __dlpack__(self, **kwargs):
+        return self.array.__dlpack__()
+    def __dlpack_device__(self):
+        return self.array.__dlpack_device__()
+
+def check(device):
+    """Zero-copy exports, imports and rejections on DeviceCPU."""
+    failures = 0
+    rng = np.random.default_rng(11)
+    frame = rng.integers(0, 256, (36, 64, 4), np.uint8)
+    texture = device.create_texture(64, 36, BGRA)
+    device.write_texture(texture, frame)
+
+    view = np.from_dlpack(texture)
+    if view.shape != (36, 64, 4) or not np.array_equal(view, frame):
+        failures += 1
+        print(f"  np.from_dlpack(texture) came back as {view.shape} and did not match")
+    device.clear_texture(texture, 0.0, 0.0, 1.0, 1.0)
+    if not np.array_equal(view[0, 0], [255, 0, 0, 255]):
+        failures += 1
+        print("  a clear was not visible through the DLPack view, so it was a copy")
+    del texture
+    if view.sum() != 36 * 64 * 2 * 255:
+        failures += 1
+        print("  the view did not keep its texture alive")
+
+    wide = device.create_texture(16, 16, F16)
+    device.clear_texture(wide, 0.25, 0.5, 0.75, 1.0)
+    halves = np.from_dlpack(wide)
+    if halves.dtype != np.float16 or not np.array_equal(halves[3, 3], np.float16([0.25, 0.5, 0.75, 1.0])):
+        failures += 1
+        print(f"  an fp16 texture exported as {halves.dtype}")
+
+    texture = device.create_texture(64, 36, BGRA)
+    device.write_texture(texture, Producer(frame))
+    if not np.array_equal(device.read_texture(texture), frame):
+        failures += 1
+        print("  write_texture from a DLPack producer wrote different pixels")
+    shared = directport.from_dlpack(Producer(frame))
+    if not np.shares_memory(shared, frame):
+        failures += 1
+        print("  directport.from_dlpack copied its tensor")
+
+    future = device.read_texture_async(texture)
+    device.flush_readbacks()
+    if not np.array_equal(np.from_dlpack(future), frame):
+        failures += 1
+        print("  a readback future exported different pixels")
+
+    with device.map_texture(texture) as mapped:
+        if not np.shares_memory(np.from_dlpack(device.map_texture(texture)), mapped):
+            failures += 1
+            print("  a mapping exported a copy")
+    try:
+        texture.__dlpack__(copy=True)
+        failures += 1
+        print("  copy=True was accepted by a zero-copy export")
+    except BufferError:
+        pass
+    return failures
+
+def best(fn, repeats):
+    times = []
+    for _ in range(repeats):
+        start = time.perf_counter()
+        fn()
+        times.append(time.perf_counter() - start)
+    return min(times) * 1000.0
+
+def main():
+    """
+    Validates DLPack export of DeviceCPU textures, mappings and readback
+    futures and import through write_texture and directport.from_dlpack, then
+    times handing a 4K frame to another framework by read_texture against
+    np.from_dlpack. With PyTorch installed it also hands the frame to
+    torch.from_dlpack and back without a copy.
+    """
+    print("--- DirectPort DLPack Benchmark ---")
+    repeats = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+    device = directport.DeviceCPU.create()
+    failures = check(device)
+    print("Validation: " + ("exports and imports share memory." if failures == 0 else f"{failures} failures."))
+
+    texture = device.create_texture(3840, 2160, BGRA)
+    copy_ms = best(lambda: device.read_texture(texture), repeats)
+    share_ms = best(lambda: np.from_dlpack(texture), repeats)
+    print(f"\nDeviceCPU 4K BGRA: read_texture {copy_ms:.3f} ms, np.from_dlpack {share_ms:.4f} ms")
+
+    try:
+        import torch
+    except ImportError:
+        torch = None
+    if torch is not None:
+        tensor = torch.from_dlpack(texture)
+        device.clear_texture(texture, 0.0, 0.0, 1.0, 1.0)
+        if tensor[0, 0, 0].item() != 255:
+            failures += 1
+            print("  torch.from_dlpack(texture) did not see a later clear")
+        target = device.create_texture(3840, 2160, BGRA)
+        device.write_texture(target, torch.full((2160, 3840, 4), 7, dtype=torch.uint8))
+        if device.read_texture(target, rect=(0, 0, 1, 1))[0, 0, 0] != 7:
+            failures += 1
+            print("  write_texture from a torch tensor wrote different pixels")
+        torch_ms = best(lambda: torch.from_dlpack(texture), repeats)
+        print(f"DeviceCPU 4K BGRA: torch.from_dlpack {torch_ms:.4f} ms")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,153 @@
+# --- file_producer_benchmark.py ---
+import directport
+import numpy as np
+import os
+import struct
+import tempfile
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+F16 = directport.DXGI_FORMAT.R16G16B16A16_FLOAT
+
+def crafted_archives(folder, frames):
+    """
+    Damaged copies of an np.savez archive whose `frames` member comes first:
+    a Zip64 locator pointing near 2^64, a Zip64 record moving the directory
+    there, a directory that shrinks the member below what its .npy header
+    claims, and a cut-off file. Yields (name, path) pairs.
+    """
+    path = os.path.join(folder, "base.npz")
+    np.savez(path, frames=frames, rest=frames)
+    with open(path, "rb") as f:
+        data = f.read()
+    eocd = data.rfind(b"PK\x05\x06")
+    directory = struct.unpack_from("<I", data, eocd + 16)[0]
+
+    def saved(name, content):
+        out = os.path.join(folder, name + ".npz")
+        with open(out, "wb") as f:
+            f.write(content)
+        return name, out
+
+    def zip64(record_offset, prefix=b""):
+        locator = struct.pack("<IIQI", 0x07064B50, 0, record_offset, 1)
+        end = bytearray(data[eocd:])
+        struct.pack_into("<HH", end, 8, 0xFFFF, 0xFFFF)
+        return data[:eocd] + prefix + locator + bytes(end)
+
+    yield saved("zip64_locator", zip64(2**64 - 16))
+    record = struct.pack("<IQHHIIQQQQ", 0x06064B50, 44, 45, 45, 0, 0, 2, 2, eocd - directory, 2**64 - 16)
+    yield saved("zip64_directory", zip64(eocd, record))
+    shrunk = bytearray(data)
+    struct.pack_into("<II", shrunk, directory + 20, len(frames[0].tobytes()), len(frames[0].tobytes()))
+    yield saved("short_member", bytes(shrunk))
+    yield saved("truncated", data[:len(data) // 2])
+
+def check(device, folder):
+    """Frames from .npy, .npz and raw files against np.load, in lockstep and paced; damaged archives raise."""
+    failures = 0
+    rng = np.random.default_rng(3)
+    frames = rng.integers(0, 256, (24, 72, 128, 4), np.uint8)
+    rgb = rng.integers(0, 256, (6, 72, 128, 3), np.uint8)
+    np.save(os.path.join(folder, "frames.npy"), frames)
+    np.savez(os.path.join(folder, "frames.npz"), rgb=rgb, frames=frames)
+    with open(os.path.join(folder, "frames.raw"), "wb") as f:
+        f.write(b"header!!")
+        f.write(frames.tobytes())
+
+    sources = [("npy", directport.FileProducer.open(os.path.join(folder, "frames.npy"))),
+               ("npz", directport.FileProducer.open(os.path.join(folder, "frames.npz"), key="frames")),
+               ("raw", directport.FileProducer.open_raw(os.path.join(folder, "frames.raw"), 128, 72, BGRA, header_bytes=8))]
+    texture = device.create_texture(128, 72, BGRA)
+    for name, producer in sources:
+        if len(producer) != len(frames) or not all(np.array_equal(producer.frame(i), frames[i]) for i in range(len(frames))):
+            failures += 1
+            print(f"  {name}: frame views differ from np.load")
+        producer.start(texture)
+        seen = []
+        while producer.wait_for_frame(1000):
+            if not np.array_equal(device.read_texture(texture), frames[producer.frame_index]):
+                failures += 1
+                print(f"  {name}: frame {producer.frame_index} was not in the texture when announced")
+                break
+            seen.append(producer.frame_index)
+        if seen != list(range(len(frames))):
+            failures += 1
+            print(f"  {name}: lockstep replay delivered frames {seen[:8]}... instead of each once in order")
+
+    rgb_producer = directport.FileProducer.open(os.path.join(folder, "frames.npz"), key="rgb")
+    rgb_producer.read_frame(4, texture)
+    expected = np.concatenate([rgb[4], np.full((72, 128, 1), 255, np.uint8)], axis=2)
+    if not np.array_equal(device.read_texture(texture), expected):
+        failures += 1
+        print("  an RGB .npz member did not fill a BGRA texture with opaque alpha")
+    wide = device.create_texture(128, 72, F16)
+    sources[0][1].read_frame(5, wide)
+    if not np.allclose(device.read_texture(wide, dtype=np.float32), frames[5] / 255, atol=1e-3):
+        failures += 1
+        print("  converting into an fp16 texture gave other values")
+
+    for name, path in crafted_archives(folder, frames):
+        try:
+            directport.FileProducer.open(path, key="frames")
+            failures += 1
+            print(f"  a {name} archive opened instead of raising")
+        except ValueError:
+            pass
+
+    producer = sources[0][1]
+    producer.start(texture, fps=100, loop=True)
+    start = time.perf_counter()
+    count = sum(producer.wait_for_frame(100) for _ in range(50))
+    rate = count / (time.perf_counter() - start)
+    producer.stop()
+    if abs(rate - 100) > 15:
+        failures += 1
+        print(f"  paced replay ran at {rate:.1f} fps instead of 100")
+    return failures
+
+def main():
+    """
+    Writes small .npy, .npz and raw frame files and checks that a
+    FileProducer maps, converts and publishes exactly what np.load reads,
+    every frame once in lockstep and at the requested rate when paced. Then
+    replays a 4K stack through a producer and through a Python loop of
+    np.load(mmap_mode='r') and write_texture and prints frames per second.
+    """
+    print("--- DirectPort FileProducer Benchmark ---")
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 120
+    device = directport.DeviceCPU.create()
+    with tempfile.TemporaryDirectory() as folder:
+        failures = check(device, folder)
+        print("Validation: " + ("replays match np.load." if failures == 0 else f"{failures} failures."))
+
+        path = os.path.join(folder, "stack.npy")
+        stack = np.lib.format.open_memmap(path, mode="w+", dtype=np.uint8, shape=(count, 2160, 3840, 4))
+        for i in range(count):
+            stack[i] = i
+        stack.flush()
+        del stack
+        print(f"\n{count} 4K BGRA frames, {os.path.getsize(path) / 2**30:.2f} GB:")
+
+        texture = device.create_texture(3840, 2160, BGRA)
+        loaded = np.load(path, mmap_mode="r")
+        start = time.perf_counter()
+        for i in range(count):
+            device.write_texture(texture, loaded[i])
+        python_fps = count / (time.perf_counter() - start)
+        del loaded
+
+        producer = directport.FileProducer.open(path)
+        producer.start(texture)
+        start = time.perf_counter()
+        while producer.wait_for_frame(1000):
+            pass
+        native_fps = producer.stats.published / (time.perf_counter() - start)
+        print(f"  np.load + write_texture: {python_fps:7.1f} fps")
+        print(f"  FileProducer (lockstep): {native_fps:7.1f} fps, {producer.stats}")
+        del producer
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,68 @@
+# --- format_traits_check.py ---
+# Walks every DXGI value through the format traits table and checks that the
+# rows agree with each other, with NumPy and with the CPU device. The table is
+# also checked at compile time; this covers the bindings built on top of it.
+import directport
+import numpy as np
+import sys
+
+failures = []
+
+def check(condition, message):
+    if not condition:
+        failures.append(message)
+
+rows = {}
+for value in range(128):
+    t = directport.format_traits(value)
+    if t is not None:
+        rows[value] = t
+check(directport.format_traits(4096) is None, "out-of-range value should have no traits")
+print(f"{len(rows)} formats in the traits table")
+
+for value, t in rows.items():
+    name = t["name"]
+    if t["block_size"] == 1:
+        dtype = np.dtype(t["numpy_dtype"])
+        check(dtype.itemsize * t["numpy_channels"] == t["block_bytes"], f"{name}: NumPy layout does not cover a pixel")
+    else:
+        check(t["numpy_dtype"] is None, f"{name}: block-compressed format has a NumPy layout")
+    for width in (1, 3, 4, 5, 1920):
+        blocks = -(-width // t["block_size"])
+        check(directport.format_row_pitch(value, width) == blocks * t["block_bytes"], f"{name}: row pitch for width {width}")
+
+    # Relatives share the memory layout and agree on the family.
+    for key in ("typeless_format", "srgb_format", "linear_format"):
+        other = t[key]
+        if other == 0:
+            continue
+        r = rows.get(other)
+        check(r is not None, f"{name}: {key} {other} is not in the table")
+        if r is None:
+            continue
+        for field in ("block_bytes", "block_size", "channels", "bgra", "typeless_format", "srgb_format", "linear_format"):
+            check(r[field] == t[field], f"{name}: {field} differs from its {key}")
+    check(t["typeless"] == (t["typeless_format"] == value), f"{name}: typeless flag")
+    check(not t["typeless"] or t["gl_internal_format"] == 0, f"{name}: typeless format maps to GL")
+
+# The formats Convert handles are exactly the ones Python can name.
+enum_values = {int(v) for v in directport.DXGI_FORMAT.__members__.values()}
+convertible = {v for v, t in rows.items() if t["convertible"]}
+check(convertible <= enum_values, f"convertible formats missing from DXGI_FORMAT: {sorted(convertible - enum_values)}")
+
+# The CPU device and convert_pixels size buffers from the same table.
+device = directport.DeviceCPU.create()
+for value in sorted(convertible):
+    fmt = directport.DXGI_FORMAT(value)
+    name = rows[value]["name"]
+    check(directport.format_bytes_per_pixel(fmt) == rows[value]["block_bytes"], f"{name}: format_bytes_per_pixel")
+    tex = device.create_texture(7, 3, fmt)
+    check(tex.cpu_row_pitch == directport.format_row_pitch(value, 7), f"{name}: DeviceCPU row pitch")
+    src = np.zeros(7 * 3 * rows[value]["block_bytes"], np.uint8)
+    out = directport.convert_pixels(src, 7, 3, fmt, directport.DXGI_FORMAT.B8G8R8A8_UNORM)
+    check(out.shape == (3, 7 * 4), f"{name}: convert_pixels output shape {out.shape}")
+
+for message in failures:
+    print("FAIL:", message)
+print("OK" if not failures else f"{len(failures)} failures")
+sys.exit(1 if failures else 0)
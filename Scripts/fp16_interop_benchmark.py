@@ -0,0 +1,103 @@
+# --- fp16_interop_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+F16 = directport.DXGI_FORMAT.R16G16B16A16_FLOAT
+R16 = directport.DXGI_FORMAT.R16_FLOAT
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) / iterations
+
+def same_bits(a, b):
+    return a.shape == b.shape and a.dtype == b.dtype and a.tobytes() == b.tobytes()
+
+def check(device, rng, isas):
+    """dtype reads and float32 writes match NumPy's own casts bit for bit on every kernel set."""
+    failures = 0
+    height, width = 67, 131
+    values = rng.standard_normal((height, width, 4)).astype(np.float32) * 300.0
+    values[0, :4] = [np.inf, -np.inf, 1e-8, 70000.0]  # overflow and denormals
+    half = values.astype(np.float16)
+    texture = device.create_texture(width, height, F16)
+    single = device.create_texture(width, height, R16)
+    for isa in isas:
+        directport.set_convert_isa(isa)
+        device.write_texture(texture, values)
+        if not same_bits(device.read_texture(texture), half):
+            failures += 1
+            print(f"  {isa.name}: float32 write to fp16 differs from astype(float16)")
+        if not same_bits(device.read_texture(texture, dtype=np.float32), half.astype(np.float32)):
+            failures += 1
+            print(f"  {isa.name}: float32 read from fp16 differs from astype(float32)")
+        device.write_texture(single, values[..., 0])
+        if not same_bits(device.read_texture(single, dtype=np.float32), half[..., 0].astype(np.float32)):
+            failures += 1
+            print(f"  {isa.name}: R16_FLOAT round trip differs")
+
+    # 8-bit textures read as normalised floats, and arrays no format holds are refused.
+    bgra = device.create_texture(width, height, BGRA)
+    pixels = rng.integers(0, 256, size=(height, width, 4), dtype=np.uint8)
+    device.write_texture(bgra, pixels)
+    as_float = device.read_texture(bgra, dtype=np.float32)
+    if not np.allclose(as_float, pixels[..., [2, 1, 0, 3]] / 255.0, atol=1e-6):
+        failures += 1
+        print("  BGRA read as float32 is not RGBA / 255")
+    for bad in (np.zeros((height, width, 4), np.int16), np.zeros((height, width, 2), np.float32)):
+        try:
+            device.write_texture(texture, bad)
+            failures += 1
+            print(f"  a {bad.dtype} array with {bad.shape[2]} channels was accepted")
+        except ValueError:
+            pass
+    directport.set_convert_isa(isas[-1])
+    return failures
+
+def main():
+    """
+    Validates fp16 reads and writes through the CPU conversion layer on every
+    kernel set this CPU supports, then times reading a 4K fp16 texture as
+    float32 and writing float32 into it against going through NumPy's astype.
+    Runs headless on DeviceCPU, on any platform.
+    """
+    print("--- DirectPort fp16 NumPy Interop Benchmark ---")
+    iterations = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+    rng = np.random.default_rng(40)
+    device = directport.DeviceCPU.create()
+
+    best = directport.best_convert_isa()
+    isas = [isa for isa in (directport.ConvertIsa.Scalar, directport.ConvertIsa.SSE41,
+                            directport.ConvertIsa.AVX2, directport.ConvertIsa.AVX512) if int(isa) <= int(best)]
+    failures = check(device, rng, isas)
+    print(f"Validation on {', '.join(isa.name for isa in isas)}: "
+          + ("all kernel sets agree with NumPy." if failures == 0 else f"{failures} failures."))
+
+    width, height = 3840, 2160
+    texture = device.create_texture(width, height, F16)
+    values = rng.random((height, width, 4), dtype=np.float32)
+    device.write_texture(texture, values)
+    frame_bytes = width * height * 8
+
+    print(f"\n4K R16G16B16A16_FLOAT, {directport.scheduler_lanes()} lanes, {iterations} iterations")
+    print(f"{'method':>38}{'time':>12}{'throughput':>14}")
+    rows = [("read, then astype(float32)", lambda: device.read_texture(texture).astype(np.float32))]
+    for isa in isas:
+        rows.append((f"read_texture(dtype=float32) ({isa.name})",
+                     lambda isa=isa: (directport.set_convert_isa(isa), device.read_texture(texture, dtype=np.float32))))
+    directport.set_convert_isa(best)
+    rows += [("astype(float16), then write", lambda: device.write_texture(texture, values.astype(np.float16))),
+             ("write_texture(float32)", lambda: device.write_texture(texture, values))]
+    for name, fn in rows:
+        seconds = bench(fn, iterations)
+        print(f"{name:>38}{seconds * 1000.0:9.2f} ms{frame_bytes / seconds / 1e9:9.1f} GB/s")
+    directport.set_convert_isa(best)
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,118 @@
+# --- frame_diff_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) / iterations
+
+def check(rng, isas):
+    """Signatures agree between kernel sets, and a change lands in exactly its own tile."""
+    failures = 0
+    frame = rng.integers(0, 256, size=(300, 517, 4), dtype=np.uint8)
+    for tile_size in (16, 64, 100):
+        signatures = []
+        for isa in isas:
+            directport.set_convert_isa(isa)
+            # A sliced region, so strided rows are covered too.
+            signatures.append(directport.frame_signature(frame[7:290, 3:510], tile_size))
+        if any(not np.array_equal(signatures[0].tiles, s.tiles) for s in signatures[1:]):
+            failures += 1
+            print(f"  MISMATCH between kernel sets at tile size {tile_size}")
+        for isa in isas:
+            directport.set_convert_isa(isa)
+            for y, x in ((0, 0), (140, 250), (282, 506)):
+                changed = frame.copy()
+                changed[7 + y, 3 + x, 1] ^= 1
+                diff = directport.compare_frame_signatures(signatures[0], directport.frame_signature(changed[7:290, 3:510], tile_size))
+                expected = np.zeros((diff.tiles_y, diff.tiles_x), bool)
+                expected[y // tile_size, x // tile_size] = True
+                rects = diff.rects()
+                if not np.array_equal(diff.changed, expected) or len(rects) != 1:
+                    failures += 1
+                    print(f"  {isa.name} tile {tile_size}: change at ({x}, {y}) reported as {np.argwhere(diff.changed).tolist()}")
+
+    # Sensor noise on every pixel is absorbed by a threshold, a real change is not.
+    for isa in isas:
+        directport.set_convert_isa(isa)
+        detector = directport.FrameDiffDetector(64, 2.0)
+        detector.update(frame, BGRA)
+        noisy = np.clip(frame.astype(np.int16) + rng.integers(-1, 2, size=frame.shape), 0, 255).astype(np.uint8)
+        if not detector.update(noisy, BGRA).unchanged:
+            failures += 1
+            print(f"  {isa.name}: noise reported as a change")
+        noisy[100:120, 200:230] = 255 - noisy[100:120, 200:230]
+        diff = detector.update(noisy, BGRA)
+        if diff.changed_tiles != 1 or not diff.changed[1, 3]:
+            failures += 1
+            print(f"  {isa.name}: moved region reported as {np.argwhere(diff.changed).tolist()}")
+    return failures
+
+def main():
+    """
+    Validates tile signatures and change maps on every kernel set this CPU
+    supports, then times them on 4K BGRA frames against the NumPy ways of
+    asking "did this frame change": a full comparison with the previous frame
+    and a per-tile comparison. Runs headless, on any platform.
+    """
+    print("--- DirectPort Frame Diff Benchmark ---")
+    iterations = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+    rng = np.random.default_rng(23)
+
+    best = directport.best_convert_isa()
+    isas = [isa for isa in (directport.ConvertIsa.Scalar, directport.ConvertIsa.SSE41,
+                            directport.ConvertIsa.AVX2, directport.ConvertIsa.AVX512) if int(isa) <= int(best)]
+    failures = check(rng, isas)
+    print(f"Validation on {', '.join(isa.name for isa in isas)}: "
+          + ("all kernel sets agree." if failures == 0 else f"{failures} failures."))
+
+    width, height = 3840, 2160
+    previous = rng.integers(0, 256, size=(height, width, 4), dtype=np.uint8)
+    current = previous.copy()
+    current[1000:1040, 2000:2100] ^= 0x55  # a cursor-sized change
+    frame_bytes = width * height * 4
+    tile = 64
+    ty, tx = height // tile, width // tile
+
+    def numpy_tiles():
+        d = (previous[:ty * tile, :tx * tile] != current[:ty * tile, :tx * tile])
+        return d.reshape(ty, tile, tx, tile * 4).any(axis=(1, 3))
+
+    print(f"\n4K BGRA, {tile}-pixel tiles, {directport.scheduler_lanes()} lanes, {iterations} iterations")
+    print(f"{'method':>30}{'time':>12}{'throughput':>14}")
+    rows = [("numpy array_equal", lambda: np.array_equal(previous, current)),
+            ("numpy per-tile compare", numpy_tiles)]
+    for isa in isas:
+        rows.append((f"frame_signature ({isa.name})", lambda isa=isa: (directport.set_convert_isa(isa),
+                                                                     directport.frame_signature(current, tile))))
+    for name, fn in rows:
+        seconds = bench(fn, iterations)
+        print(f"{name:>30}{seconds * 1000.0:9.2f} ms{frame_bytes / seconds / 1e9:9.1f} GB/s")
+    directport.set_convert_isa(best)
+
+    # A detector only needs the new frame; the previous one is its signature.
+    for threshold in (0.0, 2.0):
+        detector = directport.FrameDiffDetector(tile, threshold)
+        detector.update(previous, BGRA)
+        frames = [current, previous]
+        state = {"i": 0}
+
+        def step():
+            state["i"] ^= 1
+            return detector.update(frames[state["i"]], BGRA)
+
+        seconds = bench(step, iterations)
+        diff = step()
+        print(f"{'detector, threshold ' + str(threshold):>30}{seconds * 1000.0:9.2f} ms"
+              f"{frame_bytes / seconds / 1e9:9.1f} GB/s  {diff.changed_tiles} tiles, {len(diff.rects())} rects")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
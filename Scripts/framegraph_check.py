@@ -0,0 +1,137 @@
+# --- framegraph_check.py ---
+# Records small frame graphs on DeviceCPU and checks what compile() kept,
+# folded and aliased, then that execute() writes exactly the bytes the same
+# passes give when issued by hand. Runs headless, on any platform.
+import directport
+import numpy as np
+import sys
+
+RGBA = directport.DXGI_FORMAT.R8G8B8A8_UNORM
+W, H = 64, 48
+
+failures = []
+
+def check(condition, message):
+    if not condition:
+        failures.append(message)
+
+device = directport.DeviceCPU.create()
+rng = np.random.default_rng(27)
+source = device.create_texture(W, H, RGBA)
+device.write_texture(source, rng.integers(0, 256, (H, W, 4), np.uint8))
+
+def run(label, transients, steps):
+    """
+    Records `steps` into a graph over the imported "in" and "out" textures and
+    the named transients, executes it, and replays the same steps by hand on
+    fresh textures. Returns the graph, its resource ids and both outputs.
+    """
+    graph = directport.FrameGraph(device)
+    out = device.create_texture(W, H, RGBA)
+    ids = {"in": graph.import_texture(source, "in"), "out": graph.import_texture(out, "out")}
+    for name in transients:
+        ids[name] = graph.create_texture(W, H, RGBA, name)
+    textures = {"in": source, "out": device.create_texture(W, H, RGBA)}
+    for name in transients:
+        textures[name] = device.create_texture(W, H, RGBA)
+
+    for name, kind, output, inputs, *region in steps:
+        if kind == "copy":
+            graph.add_copy_pass(name, ids[inputs[0]], ids[output])
+            device.copy_texture(textures[inputs[0]], textures[output])
+        elif kind == "blit":
+            graph.add_blit_pass(name, ids[inputs[0]], ids[output], *region)
+            device.blit_texture_to_region(textures[inputs[0]], textures[output], *region)
+        else:
+            graph.add_shader_pass(name, ids[output], kind, inputs=[ids[i] for i in inputs])
+            device.apply_shader(textures[output], kind, inputs=[textures[i] for i in inputs])
+    graph.mark_output(ids["out"])
+    graph.compile()
+    graph.execute()
+    check(np.array_equal(device.read_texture(out), device.read_texture(textures["out"])),
+          f"{label}: execute() output differs from the passes issued by hand")
+    return graph, ids
+
+def passes(graph):
+    return [(p.name, p.source_index) for p in graph.compiled_passes]
+
+# A dead branch is culled and the copy out of the single-use "b" is folded
+# into the pass that wrote it.
+graph, ids = run("cull and fold", ["a", "dead", "b"], [
+    ("inv", "invert", "a", ["in"]),
+    ("unused", "grayscale", "dead", ["a"]),
+    ("gray", "grayscale", "b", ["a"]),
+    ("present", "copy", "out", ["b"]),
+])
+check(passes(graph) == [("inv", 0), ("gray", 2)], f"cull and fold: compiled {passes(graph)}")
+check(graph.compiled_passes[1].output == ids["out"], "cull and fold: the folded pass does not write out")
+s = graph.stats
+check((s.recorded_passes, s.culled_passes, s.merged_copies) == (4, 1, 1),
+      f"cull and fold: {s.recorded_passes} recorded, {s.culled_passes} culled, {s.merged_copies} merged")
+check((s.transient_textures, s.physical_textures) == (1, 1),
+      f"cull and fold: {s.transient_textures} transients in {s.physical_textures} textures")
+check(graph.get_physical_slot(ids["dead"]) == -1, "cull and fold: the culled transient has a slot")
+check(graph.get_physical_slot(ids["b"]) == -1, "cull and fold: the folded transient has a slot")
+check(graph.get_physical_slot(ids["a"]) == 0, "cull and fold: the live transient has no slot")
+check(graph.get_physical_slot(ids["in"]) == -1, "cull and fold: an imported texture has a slot")
+
+# A blit only writes a region, so the full write under it stays alive, the
+# copy out of the twice-written "base" is not folded, and "base" and "patch"
+# overlap and need two textures.
+graph, ids = run("blit", ["base", "patch"], [
+    ("inv", "invert", "base", ["in"]),
+    ("gray", "grayscale", "patch", ["in"]),
+    ("inset", "blit", "base", ["patch"], 8, 8, 32, 24),
+    ("present", "copy", "out", ["base"]),
+])
+check(passes(graph) == [("inv", 0), ("gray", 1), ("inset", 2), ("present", 3)], f"blit: compiled {passes(graph)}")
+s = graph.stats
+check((s.culled_passes, s.merged_copies) == (0, 0), f"blit: {s.culled_passes} culled, {s.merged_copies} merged")
+check((s.transient_textures, s.physical_textures) == (2, 2), f"blit: {s.transient_textures} transients in {s.physical_textures} textures")
+check(graph.get_physical_slot(ids["base"]) != graph.get_physical_slot(ids["patch"]), "blit: overlapping transients share a slot")
+
+# In a chain a -> b -> c, "a" is dead before "c" is first written, so they
+# share a texture while "b", alive alongside both, gets its own.
+graph, ids = run("chain", ["a", "b", "c", "d"], [
+    ("inv", "invert", "a", ["in"]),
+    ("gray", "grayscale", "b", ["a"]),
+    ("inv2", "invert", "c", ["b"]),
+    ("gray2", "grayscale", "d", ["c"]),
+    ("present", "copy", "out", ["d"]),
+])
+check(passes(graph) == [("inv", 0), ("gray", 1), ("inv2", 2), ("gray2", 3)], f"chain: compiled {passes(graph)}")
+s = graph.stats
+check((s.merged_copies, s.transient_textures, s.physical_textures) == (1, 3, 2),
+      f"chain: {s.merged_copies} merged, {s.transient_textures} transients in {s.physical_textures} textures")
+slots = {name: graph.get_physical_slot(ids[name]) for name in "abcd"}
+check(slots["a"] == slots["c"], f"chain: disjoint transients got slots {slots}")
+check(slots["a"] != slots["b"] and slots["b"] != slots["c"], f"chain: overlapping transients got slots {slots}")
+check(slots["d"] == -1, "chain: the folded transient has a slot")
+
+# A second execute() reuses the physical textures and gives the same bytes.
+first = device.read_texture(graph.get_texture(ids["out"]))
+graph.execute()
+check(np.array_equal(device.read_texture(graph.get_texture(ids["out"])), first), "chain: a second execute() gave other bytes")
+
+# Transients marked as outputs are read after execute(), so a later pass must
+# not reuse their texture even though nothing in the graph reads them again.
+graph = directport.FrameGraph(device)
+src = graph.import_texture(source, "in")
+t1, t2 = graph.create_texture(W, H, RGBA, "t1"), graph.create_texture(W, H, RGBA, "t2")
+graph.add_shader_pass("p1", t1, "invert", inputs=[src])
+graph.add_shader_pass("p2", t2, "grayscale", inputs=[src])
+graph.mark_output(t1)
+graph.mark_output(t2)
+graph.execute()
+check(graph.get_physical_slot(t1) != graph.get_physical_slot(t2) and graph.stats.physical_textures == 2,
+      f"outputs: transient outputs share slots {graph.get_physical_slot(t1)}, {graph.get_physical_slot(t2)}")
+for name, resource, kind in (("t1", t1, "invert"), ("t2", t2, "grayscale")):
+    expected = device.create_texture(W, H, RGBA)
+    device.apply_shader(expected, kind, inputs=[source])
+    check(np.array_equal(device.read_texture(graph.get_texture(resource)), device.read_texture(expected)),
+          f"outputs: {name} does not hold its own pass's pixels")
+
+for message in failures:
+    print("  " + message)
+print("Validation: " + ("frame graphs compile and execute as expected." if not failures else f"{len(failures)} failures."))
+sys.exit(1 if failures else 0)
@@ -0,0 +1,91 @@
+# --- map_texture_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+R32F = directport.DXGI_FORMAT.R32_FLOAT
+
+def check(device):
+    """Views, strides and lifetimes on CPU textures."""
+    failures = 0
+    texture = device.create_texture(33, 7, BGRA)
+    device.clear_texture(texture, 1.0, 0.0, 0.0, 1.0)
+    with device.map_texture(texture) as view:
+        if view.shape != (7, 33, 4) or view.strides != (texture.cpu_row_pitch, 4, 1):
+            failures += 1
+            print(f"  view has shape {view.shape} and strides {view.strides}")
+        if not np.array_equal(view[3, 5], [0, 0, 255, 255]):
+            failures += 1
+            print(f"  view reads {view[3, 5]}, expected red")
+        view[0, 0] = [1, 2, 3, 4]
+        kept = view
+    if not np.array_equal(device.read_texture(texture)[0, 0], [1, 2, 3, 4]):
+        failures += 1
+        print("  a write through the view did not reach the texture")
+    del texture
+    if kept[6, 32, 3] != 255:
+        failures += 1
+        print("  a view outliving its context lost its memory")
+
+    mask = device.create_texture(16, 16, R32F)
+    mapping = device.map_texture(mask, writable=False)
+    array = mapping.array
+    if array.dtype != np.float32 or array.shape != (16, 16) or array.flags.writeable:
+        failures += 1
+        print(f"  R32_FLOAT mapping gave {array.dtype} {array.shape}, writeable={array.flags.writeable}")
+    mapping.release()
+    try:
+        mapping.array
+        failures += 1
+        print("  a released mapping still handed out views")
+    except RuntimeError:
+        pass
+    return failures
+
+def best(fn, repeats):
+    times = []
+    for _ in range(repeats):
+        start = time.perf_counter()
+        fn()
+        times.append(time.perf_counter() - start)
+    return min(times) * 1000.0
+
+def main():
+    """
+    Checks map_texture on DeviceCPU (shape, row-pitch strides, writes landing
+    in the texture, views outliving the context) and times it against
+    read_texture for a 4K frame. On Windows it repeats the timing on D3D11,
+    where map_texture skips the copy out of the mapped staging texture.
+    """
+    print("--- DirectPort map_texture Benchmark ---")
+    repeats = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+    device = directport.DeviceCPU.create()
+    failures = check(device)
+    print("Validation: " + ("views alias texture memory and outlive their context." if failures == 0 else f"{failures} failures."))
+
+    def consume(array):
+        return int(array[::64, ::64].sum())
+
+    texture = device.create_texture(3840, 2160, BGRA)
+    def mapped():
+        with device.map_texture(texture) as view:
+            consume(view)
+    copy_ms = best(lambda: consume(device.read_texture(texture)), repeats)
+    map_ms = best(mapped, repeats)
+    print(f"\nDeviceCPU 4K BGRA: read_texture {copy_ms:.3f} ms, map_texture {map_ms:.3f} ms")
+
+    if hasattr(directport, "DeviceD3D11") and hasattr(directport, "numpy"):
+        gpu = directport.DeviceD3D11.create()
+        texture = gpu.create_texture(3840, 2160, BGRA)
+        def mapped_gpu():
+            with directport.numpy.map_texture(gpu, texture) as view:
+                consume(view)
+        copy_ms = best(lambda: consume(directport.numpy.read_texture(gpu, texture)), repeats)
+        map_ms = best(mapped_gpu, repeats)
+        print(f"D3D11 4K BGRA: read_texture {copy_ms:.3f} ms, map_texture {map_ms:.3f} ms")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -2,7 +2,6 @@
 import directport
 import time
 import sys
-import math
 
 def main():
     """
@@ -34,6 +33,7 @@ def main():
     # --- 2. CONSUMER (INPUT) SETUP ---
     connections = {} # Key: PID, Value: {consumer, private_texture}
     last_discovery_time = 0
+    last_layout = None
     
     print("Initialization complete. Starting main loop...")
 
@@ -90,45 +90,34 @@ def main():
             # --- RENDER LOOP ---
 
             # STAGE 1: CONSUME
-            # Copy new frames from shared textures to our private textures
+            # Copy only the regions each producer reports as changed into our private textures
+            source_dirty = []
             for pid, data in connections.items():
                 if data['consumer'].wait_for_frame():
-                    device.copy_texture(data['consumer'].get_shared_texture(), data['private_texture'])
+                    rects = data['consumer'].get_dirty_rects()
+                    device.copy_texture_regions(data['consumer'].get_shared_texture(), data['private_texture'], rects)
+                    source_dirty.append(rects)
+                else:
+                    source_dirty.append([])
 
             # STAGE 2: COMPOSE
-            # Clear the main composite texture (by applying a black shader)
-            device.apply_shader(output=composite_texture, shader=b'')
-
-            # Calculate grid layout and blit each private texture
-            active_consumers = list(connections.values())
-            if active_consumers:
-                count = len(active_consumers)
-                cols = int(math.ceil(math.sqrt(count)))
-                rows = (count + cols - 1) // cols
-                
-                cell_w = MUX_WIDTH // cols
-                cell_h = MUX_HEIGHT // rows
-
-                for i, data in enumerate(active_consumers):
-                    grid_col = i % cols
-                    grid_row = i // cols
-                    
-                    dest_x = grid_col * cell_w
-                    dest_y = grid_row * cell_h
-                    
-                    device.blit_texture_to_region(
-                        source=data['private_texture'],
-                        destination=composite_texture,
-                        dest_x=dest_x,
-                        dest_y=dest_y,
-                        dest_width=cell_w,
-                        dest_height=cell_h
-                    )
+            # Redraw the grid cells those regions land in; a new layout redraws everything
+            # and an idle frame (no regions) skips the composite
+            sources = [data['private_texture'] for data in connections.values()]
+            layers = directport.grid_layout(sources, MUX_WIDTH, MUX_HEIGHT, fit=directport.CompositeFit.Stretch)
+            layout = tuple(connections.keys())
+            regions = None if layout != last_layout else directport.propagate_dirty_rects(layers, source_dirty, MUX_WIDTH, MUX_HEIGHT)
+            last_layout = layout
+            if regions != []:
+                device.composite(composite_texture, layers, regions=regions)
 
             # STAGE 3: PRODUCE
-            # Copy our final composite to the texture we are sharing
-            device.copy_texture(composite_texture, shared_out_texture)
-            producer.signal_frame()
+            # Copy what changed to the texture we are sharing and tell our consumers where
+            if regions is None:
+                device.copy_texture(composite_texture, shared_out_texture)
+            elif regions:
+                device.copy_texture_regions(composite_texture, shared_out_texture, regions)
+            producer.signal_frame(dirty_rects=regions)
 
             # STAGE 4: PRESENT
             # Blit the final composite to our local window for preview
@@ -0,0 +1,90 @@
+# --- read_texture_out_benchmark.py ---
+import directport
+import numpy as np
+import time
+import tracemalloc
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+
+def check(device):
+    """out= validation, dtype inference and mosaic tiles on DeviceCPU."""
+    failures = 0
+    texture = device.create_texture(64, 48, BGRA)
+    device.clear_texture(texture, 1.0, 0.4, 0.0, 1.0)
+
+    mosaic = np.zeros((96, 128, 4), np.uint8)
+    tile = mosaic[48:, 64:]
+    if device.read_texture(texture, out=tile) is not tile or not np.array_equal(mosaic[60, 100], [0, 102, 255, 255]) \
+            or mosaic[:48].any() or mosaic[:, :64].any():
+        failures += 1
+        print("  reading into one tile of a mosaic did not fill exactly that tile")
+
+    wide = np.empty((48, 64, 4), np.float32)
+    device.read_texture(texture, out=wide)
+    if not np.allclose(wide[0, 0], [1.0, 0.4, 0.0, 1.0], atol=1 / 255):
+        failures += 1
+        print(f"  a float32 out read {wide[0, 0]}, expected RGBA floats")
+
+    for bad, why in [(np.empty((48, 64, 3), np.uint8), "shape"), (np.empty((48, 64, 4), np.int16), "dtype"),
+                     (np.empty((48, 64, 8), np.uint8)[:, :, ::2], "strides"), (np.empty((48, 64, 4), np.uint8)[::-1], "strides")]:
+        try:
+            device.read_texture(texture, out=bad)
+            failures += 1
+            print(f"  an out with the wrong {why} was accepted")
+        except ValueError:
+            pass
+    frozen = np.empty((48, 64, 4), np.uint8)
+    frozen.flags.writeable = False
+    try:
+        device.read_texture(texture, out=frozen)
+        failures += 1
+        print("  a read-only out was accepted")
+    except ValueError:
+        pass
+    return failures
+
+def capture(read, textures, frames):
+    """Reads every stream once per frame; returns ms per frame and the traced allocation peak."""
+    tracemalloc.start()
+    start = time.perf_counter()
+    for _ in range(frames):
+        for i, texture in enumerate(textures):
+            read(i, texture)
+    elapsed = time.perf_counter() - start
+    _, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+    return elapsed / frames * 1000.0, peak
+
+def main():
+    """
+    Validates read_texture(out=...) on DeviceCPU, then runs an 8-stream
+    1080p capture loop that allocates a fresh array per read against one
+    that reuses a buffer per stream, printing time per frame and the peak
+    memory Python's allocator saw. On Windows it repeats the loop through
+    directport.numpy on D3D11.
+    """
+    print("--- DirectPort read_texture(out=) Benchmark ---")
+    frames = int(sys.argv[1]) if len(sys.argv) > 1 else 60
+    device = directport.DeviceCPU.create()
+    failures = check(device)
+    print("Validation: " + ("out= fills views in place and rejects mismatches." if failures == 0 else f"{failures} failures."))
+
+    streams = 8
+    buffers = [np.empty((1080, 1920, 4), np.uint8) for _ in range(streams)]
+    textures = [device.create_texture(1920, 1080, BGRA) for _ in range(streams)]
+    fresh_ms, fresh_peak = capture(lambda i, t: device.read_texture(t), textures, frames)
+    reuse_ms, reuse_peak = capture(lambda i, t: device.read_texture(t, out=buffers[i]), textures, frames)
+    print(f"\nDeviceCPU, {streams} x 1080p BGRA streams: new arrays {fresh_ms:.2f} ms/frame (peak {fresh_peak / 2**20:.1f} MiB), "
+          f"out= {reuse_ms:.2f} ms/frame (peak {reuse_peak / 2**20:.2f} MiB)")
+
+    if hasattr(directport, "DeviceD3D11") and hasattr(directport, "numpy"):
+        gpu = directport.DeviceD3D11.create()
+        textures = [gpu.create_texture(1920, 1080, BGRA) for _ in range(streams)]
+        fresh_ms, _ = capture(lambda i, t: directport.numpy.read_texture(gpu, t), textures, frames)
+        reuse_ms, _ = capture(lambda i, t: directport.numpy.read_texture(gpu, t, out=buffers[i]), textures, frames)
+        print(f"D3D11, {streams} x 1080p BGRA streams: new arrays {fresh_ms:.2f} ms/frame, out= {reuse_ms:.2f} ms/frame")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,97 @@
+# --- resample_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+FORMATS = [
+    directport.DXGI_FORMAT.B8G8R8A8_UNORM,
+    directport.DXGI_FORMAT.R8_UNORM,
+    directport.DXGI_FORMAT.R32G32B32A32_FLOAT,
+    directport.DXGI_FORMAT.R16G16B16A16_FLOAT,
+]
+FILTERS = [directport.ResampleFilter.Bilinear, directport.ResampleFilter.Bicubic,
+           directport.ResampleFilter.Lanczos, directport.ResampleFilter.Area]
+# (source, destination): 4K to 1080p, halving, a 64-input wall thumbnail, and 2x up.
+SCALES = [((3840, 2160), (1920, 1080)), ((1920, 1080), (960, 540)),
+          ((1920, 1080), (240, 135)), ((960, 540), (1920, 1080))]
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) / iterations
+
+def make_source(fmt, width, height, rng):
+    """Smooth gradients plus noise, so both flat areas and edges get filtered."""
+    bpp = directport.format_bytes_per_pixel(fmt)
+    channels = {directport.DXGI_FORMAT.R8_UNORM: 1}.get(fmt, 4)
+    y, x = np.mgrid[0:height, 0:width]
+    base = (np.sin(x / 37.0) * np.cos(y / 23.0) + 1.0) / 2.0
+    values = np.clip(base[..., None] + rng.normal(0.0, 0.1, size=(height, width, channels)), 0.0, 1.0)
+    if fmt == directport.DXGI_FORMAT.R32G32B32A32_FLOAT:
+        return values.astype(np.float32).view(np.uint8).reshape(height, width * bpp)
+    if fmt == directport.DXGI_FORMAT.R16G16B16A16_FLOAT:
+        return values.astype(np.float16).view(np.uint8).reshape(height, width * bpp)
+    return np.round(values * 255.0).astype(np.uint8).reshape(height, width * bpp)
+
+def max_error(fmt, a, b):
+    """Largest difference in 8-bit steps, or in absolute value for float formats."""
+    if fmt == directport.DXGI_FORMAT.R32G32B32A32_FLOAT:
+        return float(np.abs(a.view(np.float32) - b.view(np.float32)).max())
+    if fmt == directport.DXGI_FORMAT.R16G16B16A16_FLOAT:
+        return float(np.abs(a.view(np.float16).astype(np.float32) - b.view(np.float16).astype(np.float32)).max())
+    return float(np.abs(a.astype(np.int16) - b.astype(np.int16)).max())
+
+def check_accuracy(rng):
+    """Every filter and format on awkward sizes, against the double-precision reference."""
+    failures = 0
+    for fmt in FORMATS:
+        tolerance = 1.0 if fmt in (directport.DXGI_FORMAT.B8G8R8A8_UNORM, directport.DXGI_FORMAT.R8_UNORM) else 2e-3
+        for (sw, sh), (dw, dh) in (((97, 61), (31, 17)), ((40, 30), (113, 7)), ((256, 256), (3, 255))):
+            src = make_source(fmt, sw, sh, rng)
+            for flt in FILTERS:
+                got = directport.resize_pixels(src, sw, sh, fmt, dw, dh, flt)
+                want = directport.resize_pixels_reference(src, sw, sh, fmt, dw, dh, flt)
+                error = max_error(fmt, got, want)
+                if error > tolerance:
+                    failures += 1
+                    print(f"  MISMATCH {fmt.name} {sw}x{sh} -> {dw}x{dh} {flt.name}: {error}")
+    return failures
+
+def main():
+    """
+    Checks the CPU resampler against its double-precision reference on every
+    kernel set this CPU supports, then times a matrix of scale factors, formats
+    and filters. Runs headless, on any platform.
+    """
+    print("--- DirectPort Resample Benchmark ---")
+    iterations = int(sys.argv[1]) if len(sys.argv) > 1 else 5
+    rng = np.random.default_rng(5)
+
+    best = directport.best_convert_isa()
+    isas = [isa for isa in (directport.ConvertIsa.Scalar, directport.ConvertIsa.SSE41,
+                            directport.ConvertIsa.AVX2, directport.ConvertIsa.AVX512) if int(isa) <= int(best)]
+    failures = 0
+    for isa in isas:
+        directport.set_convert_isa(isa)
+        failures += check_accuracy(rng)
+    print(f"Accuracy on {', '.join(isa.name for isa in isas)}: "
+          + ("within tolerance." if failures == 0 else f"{failures} mismatches."))
+
+    directport.set_convert_isa(best)
+    print(f"\n{directport.scheduler_lanes()} lanes, {best.name} kernels, {iterations} iterations (ms)")
+    print(f"{'format':>20} {'scale':>22}" + "".join(f"{flt.name:>10}" for flt in FILTERS))
+    for fmt in FORMATS:
+        bpp = directport.format_bytes_per_pixel(fmt)
+        for (sw, sh), (dw, dh) in SCALES:
+            src = make_source(fmt, sw, sh, rng)
+            out = np.empty((dh, dw * bpp), np.uint8)
+            cells = [bench(lambda: directport.resize_pixels(src, sw, sh, fmt, dw, dh, flt, out=out), iterations) * 1000.0
+                     for flt in FILTERS]
+            print(f"{fmt.name:>20} {f'{sw}x{sh} -> {dw}x{dh}':>22}" + "".join(f"{ms:10.2f}" for ms in cells))
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
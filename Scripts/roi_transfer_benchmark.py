@@ -0,0 +1,104 @@
+# --- roi_transfer_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+F16 = directport.DXGI_FORMAT.R16G16B16A16_FLOAT
+
+def check(device, read, write, create):
+    """Box reads and writes against slices of whole-surface transfers."""
+    failures = 0
+    rng = np.random.default_rng(7)
+    frame = rng.integers(0, 256, (90, 160, 4), np.uint8)
+    texture = create(160, 90, BGRA)
+    write(texture, frame)
+
+    for rect in [(0, 0, 160, 90), (17, 5, 33, 41), (159, 89, 1, 1), directport.DirtyRect(100, 0, 60, 90)]:
+        x, y, w, h = (rect.x, rect.y, rect.width, rect.height) if isinstance(rect, directport.DirtyRect) else rect
+        crop = read(texture, rect=rect)
+        if not np.array_equal(crop, frame[y:y + h, x:x + w]):
+            failures += 1
+            print(f"  rect {(x, y, w, h)} read back different pixels")
+
+    tile = np.zeros((100, 100, 4), np.uint8)
+    read(texture, rect=(10, 20, 30, 40), out=tile[50:90, 60:90])
+    if not np.array_equal(tile[50:90, 60:90], frame[20:60, 10:40]):
+        failures += 1
+        print("  a rect read into an out= view missed")
+
+    patch = rng.integers(0, 256, (12, 20, 3), np.uint8)
+    write(texture, patch, dest=(140, 78))
+    expected = frame.copy()
+    expected[78:, 140:, :3] = patch
+    expected[78:, 140:, 3] = 255
+    if not np.array_equal(read(texture), expected):
+        failures += 1
+        print("  writing a 3-channel patch at (140, 78) touched the wrong pixels")
+
+    wide = create(64, 64, F16)
+    write(wide, np.zeros((64, 64, 4), np.float32))
+    write(wide, np.full((8, 8, 4), 0.5, np.float32), dest=(8, 16))
+    back = read(wide, dtype=np.float32)
+    if back[16:24, 8:16].min() != 0.5 or back.sum() != 0.5 * 8 * 8 * 4:
+        failures += 1
+        print("  a float32 patch written into an fp16 texture landed elsewhere")
+
+    for bad in [(150, 0, 11, 1), (0, 0, 0, 5), (0, 90, 1, 1)]:
+        try:
+            read(texture, rect=bad)
+            failures += 1
+            print(f"  rect {bad} outside the texture was accepted")
+        except ValueError:
+            pass
+    try:
+        write(texture, patch, dest=(150, 0))
+        failures += 1
+        print("  a patch past the right edge was accepted")
+    except ValueError:
+        pass
+    return failures
+
+def best(fn, repeats):
+    times = []
+    for _ in range(repeats):
+        start = time.perf_counter()
+        fn()
+        times.append(time.perf_counter() - start)
+    return min(times) * 1000.0
+
+def main():
+    """
+    Checks rect= reads and dest= writes against slices of whole-surface
+    transfers on DeviceCPU, then times cropping a 256x256 face box out of a
+    4K frame both ways. On Windows the checks and timings repeat through
+    directport.numpy on D3D11, where only the box crosses to staging memory.
+    """
+    print("--- DirectPort ROI Transfer Benchmark ---")
+    repeats = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+    device = directport.DeviceCPU.create()
+    failures = check(device, device.read_texture, device.write_texture, device.create_texture)
+    print("Validation: " + ("boxes match slices of full transfers." if failures == 0 else f"{failures} failures."))
+
+    box = (1800, 900, 256, 256)
+    texture = device.create_texture(3840, 2160, BGRA)
+    full_ms = best(lambda: device.read_texture(texture)[900:1156, 1800:2056].copy(), repeats)
+    roi_ms = best(lambda: device.read_texture(texture, rect=box), repeats)
+    print(f"\nDeviceCPU 4K, 256x256 crop: full read + slice {full_ms:.3f} ms, rect= {roi_ms:.3f} ms")
+
+    if hasattr(directport, "DeviceD3D11") and hasattr(directport, "numpy"):
+        gpu = directport.DeviceD3D11.create()
+        read = lambda t, **kw: directport.numpy.read_texture(gpu, t, **kw)
+        write = lambda t, a, **kw: directport.numpy.write_texture(gpu, t, a, **kw)
+        gpu_failures = check(gpu, read, write, gpu.create_texture)
+        print("D3D11 validation: " + ("boxes match." if gpu_failures == 0 else f"{gpu_failures} failures."))
+        failures += gpu_failures
+        texture = gpu.create_texture(3840, 2160, BGRA)
+        full_ms = best(lambda: read(texture)[900:1156, 1800:2056].copy(), repeats)
+        roi_ms = best(lambda: read(texture, rect=box), repeats)
+        print(f"D3D11 4K, 256x256 crop: full read + slice {full_ms:.3f} ms, rect= {roi_ms:.3f} ms")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,59 @@
+# --- scheduler_benchmark.py ---
+import directport
+import os
+import time
+import sys
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) * 1000.0 / iterations
+
+def main():
+    """
+    Measures how the work-stealing scheduler scales 4K copy, format conversion,
+    resize and blend on DeviceCPU as lanes are added. Runs headless, on any
+    platform; on Linux, pin it with taskset to compare core sets.
+    """
+    print("--- DirectPort Scheduler Scaling Benchmark ---")
+    max_lanes = int(sys.argv[1]) if len(sys.argv) > 1 else 16
+    iterations = int(sys.argv[2]) if len(sys.argv) > 2 else 10
+    lane_counts = [n for n in (1, 2, 4, 8, 16, 32) if n <= max_lanes]
+
+    width, height = 3840, 2160
+    fmt = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+    print(f"Hardware threads: {os.cpu_count()}, process-wide lanes: {directport.scheduler_lanes()}, iterations: {iterations}")
+
+    baseline = {}
+    for lanes in lane_counts:
+        device = directport.DeviceCPU.create(lanes)
+        source = device.create_texture(width, height, fmt)
+        overlay = device.create_texture(width, height, fmt)
+        output = device.create_texture(width, height, fmt)
+        scaled = device.create_texture(2560, 1440, fmt)
+        as_float = device.create_texture(width, height, directport.DXGI_FORMAT.R16G16B16A16_FLOAT)
+        device.clear_texture(source, 0.2, 0.4, 0.6, 1.0)
+        device.clear_texture(overlay, 0.9, 0.1, 0.3, 1.0)
+        blend = [directport.CompositeLayer(source, 0, 0, width, height),
+                 directport.CompositeLayer(overlay, 0, 0, width, height, opacity=0.5, z=1)]
+
+        ops = {
+            "copy": lambda: device.copy_texture(source, output),
+            "convert": lambda: device.apply_shader(as_float, "copy", inputs=[source]),
+            "resize": lambda: device.blit_texture_to_region(source, scaled, 0, 0, 2560, 1440),
+            "blend": lambda: device.composite(output, blend),
+        }
+        device.reset_scheduler_stats()
+        line = []
+        for name, fn in ops.items():
+            ms = bench(fn, iterations)
+            baseline.setdefault(name, ms)
+            line.append(f"{name} {ms:7.2f} ms ({baseline[name] / ms:4.1f}x)")
+        stats = device.scheduler_stats
+        print(f"{lanes:>2} lanes | " + " | ".join(line) +
+              f" | util {100.0 * stats.utilisation:5.1f}% steals {stats.steals}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+# --- staging_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+F16 = directport.DXGI_FORMAT.R16G16B16A16_FLOAT
+
+class FakeDevice:
+    """Stands in for ID3D11Device::CreateTexture2D: counts allocations and what is still alive."""
+    def __init__(self):
+        self.created = 0
+        self.alive = 0
+
+    def create(self, width, height, format, access):
+        self.created += 1
+        self.alive += 1
+        device = self
+
+        class Surface:
+            def __del__(self):
+                device.alive -= 1
+        return Surface()
+
+def check():
+    """Reuse, overflow, trimming and release on the fake device."""
+    failures = 0
+    device = FakeDevice()
+    pool = directport.StagingPool(device.create, ring_size=2, idle_seconds=2.0)
+    for _ in range(100):
+        with pool.acquire(3840, 2160, BGRA, directport.StagingAccess.Read):
+            pass
+        with pool.acquire(3840, 2160, BGRA, directport.StagingAccess.Write):
+            pass
+    if device.created != 4:
+        failures += 1
+        print(f"  200 same-size copies made {device.created} surfaces, expected 4")
+    leases = [pool.acquire(64, 64, F16) for _ in range(3)]
+    if pool.stats.overflow != 1:
+        failures += 1
+        print(f"  three leases on a ring of two overflowed {pool.stats.overflow} times")
+    for lease in leases:
+        lease.release()
+    if pool.trim() != 0:
+        failures += 1
+        print("  trim released surfaces that were not idle")
+    trimmed = pool.trim(idle_for_seconds=5.0)
+    if trimmed != pool.stats.trimmed or pool.stats.live != 0 or device.alive != 0:
+        failures += 1
+        print(f"  idle trim left {pool.stats.live} kept and {device.alive} alive")
+    return failures
+
+def simulate(pool_factory, streams, seconds, fps):
+    """Every stream reads and writes once per frame; returns allocations and the time spent."""
+    device = FakeDevice()
+    pool = pool_factory(device)
+    start = time.perf_counter()
+    for _ in range(int(seconds * fps)):
+        for width, height, format in streams:
+            if pool is None:
+                device.create(width, height, format, directport.StagingAccess.Read)
+                device.create(width, height, format, directport.StagingAccess.Write)
+                continue
+            with pool.acquire(width, height, format, directport.StagingAccess.Read):
+                pass
+            with pool.acquire(width, height, format, directport.StagingAccess.Write):
+                pass
+    return device.created, time.perf_counter() - start
+
+def main():
+    """
+    Counts staging-texture allocations for read_texture / write_texture
+    traffic with and without the per-device staging ring, on a fake device
+    (any platform). On Windows it then streams real 4K readbacks through
+    directport.numpy and prints the device's staging counters.
+    """
+    print("--- DirectPort Staging Ring Benchmark ---")
+    seconds = float(sys.argv[1]) if len(sys.argv) > 1 else 10.0
+    failures = check()
+    print("Validation: " + ("ring reuse, overflow and trimming behave." if failures == 0 else f"{failures} failures."))
+
+    fps = 60
+    cases = [("one 4K stream", [(3840, 2160, BGRA)]),
+             ("4K + 1080p + fp16 mask", [(3840, 2160, BGRA), (1920, 1080, BGRA), (1920, 1080, F16)])]
+    print(f"\n{seconds:.0f} s at {fps} fps, one read and one write per stream per frame")
+    print(f"{'workload':>26}{'per call':>12}{'ring':>8}{'alloc/s':>12}{'ring alloc/s':>14}")
+    for name, streams in cases:
+        naive, _ = simulate(lambda device: None, streams, seconds, fps)
+        pooled, elapsed = simulate(lambda device: directport.StagingPool(device.create), streams, seconds, fps)
+        calls = int(seconds * fps) * len(streams) * 2
+        print(f"{name:>26}{naive:>12}{pooled:>8}{naive / seconds:>12.0f}{pooled / seconds:>14.1f}"
+              f"   ({elapsed / calls * 1e6:.1f} us of pool bookkeeping per call)")
+
+    if hasattr(directport, "DeviceD3D11") and hasattr(directport, "numpy"):
+        device = directport.DeviceD3D11.create()
+        texture = device.create_texture(3840, 2160, BGRA)
+        frame = np.zeros((2160, 3840, 4), np.uint8)
+        frames = int(seconds * fps)
+        start = time.perf_counter()
+        for _ in range(frames):
+            directport.numpy.write_texture(device, texture, frame)
+            directport.numpy.read_texture(device, texture)
+        elapsed = time.perf_counter() - start
+        stats = directport.numpy.staging_stats(device)
+        print(f"\nD3D11, 4K BGRA write + read x {frames}: {elapsed / frames * 1000.0:.2f} ms per frame, {stats}")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,101 @@
+# --- strided_write_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+BGRA = directport.DXGI_FORMAT.B8G8R8A8_UNORM
+RGBA = directport.DXGI_FORMAT.R8G8B8A8_UNORM
+F16 = directport.DXGI_FORMAT.R16G16B16A16_FLOAT
+
+def random_view(rng, base, channels):
+    """A random strided view of `base` with `channels` channels: flips, steps, channel slices and reversals, transposes."""
+    view = base
+    if rng.random() < 0.3:
+        view = view.swapaxes(0, 1)
+    if rng.random() < 0.5:
+        view = view[::-1]
+    if rng.random() < 0.4:
+        view = view[:, ::-1]
+    if rng.random() < 0.4:
+        view = view[::rng.integers(1, 3), ::rng.integers(1, 4)]
+    if rng.random() < 0.4:
+        return view[..., ::-1][..., base.shape[2] - channels:]
+    return view[..., :channels]
+
+def check(device, write, read, create):
+    """Randomised views against the same data made contiguous first."""
+    failures = 0
+    rng = np.random.default_rng(9)
+    cases = [(np.uint8, 4, BGRA), (np.uint8, 3, BGRA), (np.uint8, 3, RGBA), (np.float32, 4, F16), (np.float32, 4, BGRA),
+             (np.float16, 4, F16)]
+    for trial in range(200):
+        dtype, channels, fmt = cases[trial % len(cases)]
+        base = rng.integers(0, 256, (40, 48, 4)).astype(dtype)
+        if dtype != np.uint8:
+            base /= 255
+        view = random_view(rng, base, channels)
+        h, w = view.shape[:2]
+        texture, expected = create(w, h, fmt), create(w, h, fmt)
+        write(texture, view)
+        write(expected, np.ascontiguousarray(view))
+        if not np.array_equal(read(texture), read(expected)):
+            failures += 1
+            if failures <= 5:
+                print(f"  {np.dtype(dtype).name} view with shape {view.shape} and strides {view.strides} wrote different pixels")
+
+    texture = create(64, 32, BGRA)
+    write(texture, np.broadcast_to(np.uint8([10, 20, 30, 255]), (32, 64, 4)))
+    if not np.all(read(texture) == [10, 20, 30, 255]):
+        failures += 1
+        print("  a broadcast constant did not fill the texture")
+    return failures
+
+def best(fn, repeats):
+    times = []
+    for _ in range(repeats):
+        start = time.perf_counter()
+        fn()
+        times.append(time.perf_counter() - start)
+    return min(times) * 1000.0
+
+def main():
+    """
+    Writes randomised strided views (vertical and horizontal flips, stepped
+    slices, transposes, channel slices and reversals) through write_texture
+    on DeviceCPU and compares each with the contiguous copy of the same view.
+    Then times uploading common 4K views directly against
+    np.ascontiguousarray followed by write_texture. On Windows both repeat
+    through directport.numpy on D3D11.
+    """
+    print("--- DirectPort Strided write_texture Benchmark ---")
+    repeats = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+    device = directport.DeviceCPU.create()
+    failures = check(device, device.write_texture, device.read_texture, device.create_texture)
+    print("Validation: " + ("strided views match contiguous copies." if failures == 0 else f"{failures} failures."))
+
+    def bench(name, write, create):
+        frame = np.random.default_rng(1).integers(0, 256, (2160, 3840, 4), np.uint8)
+        floats = (frame / 255).astype(np.float32)
+        views = [("flipped rows", frame[::-1]), ("RGB of RGBA", frame[..., :3]), ("BGR reversed", frame[..., 2::-1]),
+                 ("mirrored", frame[:, ::-1]), ("float32 flipped", floats[::-1])]
+        print(f"\n{name}, 4K into BGRA:")
+        for label, view in views:
+            texture = create(3840, 2160, BGRA)
+            direct = best(lambda: write(texture, view), repeats)
+            copied = best(lambda: write(texture, np.ascontiguousarray(view)), repeats)
+            print(f"  {label:>16}: strided {direct:7.2f} ms, ascontiguousarray + write {copied:7.2f} ms")
+
+    bench("DeviceCPU", device.write_texture, device.create_texture)
+    if hasattr(directport, "DeviceD3D11") and hasattr(directport, "numpy"):
+        gpu = directport.DeviceD3D11.create()
+        write = lambda t, a: directport.numpy.write_texture(gpu, t, a)
+        read = lambda t: directport.numpy.read_texture(gpu, t)
+        gpu_failures = check(gpu, write, read, gpu.create_texture)
+        print("\nD3D11 validation: " + ("strided views match." if gpu_failures == 0 else f"{gpu_failures} failures."))
+        failures += gpu_failures
+        bench("D3D11", write, gpu.create_texture)
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,150 @@
+# --- yuv_benchmark.py ---
+import directport
+import numpy as np
+import time
+import sys
+
+FORMATS = [directport.YuvFormat.NV12, directport.YuvFormat.YUY2, directport.YuvFormat.UYVY,
+           directport.YuvFormat.I420, directport.YuvFormat.P010]
+MATRICES = {directport.YuvMatrix.BT601: (0.299, 0.114),
+            directport.YuvMatrix.BT709: (0.2126, 0.0722),
+            directport.YuvMatrix.BT2020: (0.2627, 0.0593)}
+RANGES = [directport.YuvRange.Limited, directport.YuvRange.Full]
+
+# 100% colour bars in 8-bit limited range: (matrix, Y, Cb, Cr) -> expected RGB.
+GOLDEN_BARS = [
+    (directport.YuvMatrix.BT709, (235, 128, 128), (255, 255, 255)),
+    (directport.YuvMatrix.BT709, (16, 128, 128), (0, 0, 0)),
+    (directport.YuvMatrix.BT709, (63, 102, 240), (255, 0, 0)),
+    (directport.YuvMatrix.BT709, (173, 42, 26), (0, 255, 0)),
+    (directport.YuvMatrix.BT709, (32, 240, 118), (0, 0, 255)),
+    (directport.YuvMatrix.BT601, (81, 90, 240), (255, 0, 0)),
+    (directport.YuvMatrix.BT601, (145, 54, 34), (0, 255, 0)),
+    (directport.YuvMatrix.BT2020, (74, 97, 240), (255, 0, 0)),
+]
+
+def bench(fn, iterations):
+    fn()  # warm up caches and the worker pool
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter() - start) / iterations
+
+def is_420(fmt):
+    return fmt in (directport.YuvFormat.NV12, directport.YuvFormat.I420, directport.YuvFormat.P010)
+
+def pack(fmt, y, u, v):
+    """Lays out luma and subsampled chroma planes the way each format stores them."""
+    if fmt == directport.YuvFormat.NV12:
+        return np.concatenate([y.ravel(), np.stack([u, v], axis=-1).ravel()]).astype(np.uint8)
+    if fmt == directport.YuvFormat.P010:
+        words = np.concatenate([y.ravel(), np.stack([u, v], axis=-1).ravel()]).astype(np.uint16) << 6
+        return words.view(np.uint8)
+    if fmt == directport.YuvFormat.I420:
+        return np.concatenate([y.ravel(), u.ravel(), v.ravel()]).astype(np.uint8)
+    y0, y1 = y[:, 0::2], y[:, 1::2]
+    order = (y0, u, y1, v) if fmt == directport.YuvFormat.YUY2 else (u, y0, v, y1)
+    return np.stack(order, axis=-1).ravel().astype(np.uint8)
+
+def reference(y, u, v, fmt, matrix, rng_, out_w, out_h):
+    """Float64 conversion with chroma replicated and a box downscale: the golden image."""
+    bits = 10 if fmt == directport.YuvFormat.P010 else 8
+    s = float(1 << (bits - 8))
+    u = np.repeat(u, 2, axis=1)
+    v = np.repeat(v, 2, axis=1)
+    if is_420(fmt):
+        u, v = np.repeat(u, 2, axis=0), np.repeat(v, 2, axis=0)
+    h, w = y.shape
+    if rng_ == directport.YuvRange.Limited:
+        yp, pb, pr = (y - 16 * s) / (219 * s), (u - 128 * s) / (224 * s), (v - 128 * s) / (224 * s)
+    else:
+        top = float((1 << bits) - 1)
+        yp, pb, pr = y / top, (u - 128 * s) / top, (v - 128 * s) / top
+    kr, kb = MATRICES[matrix]
+    kg = 1.0 - kr - kb
+    rgb = np.stack([yp + 2 * (1 - kr) * pr,
+                    yp - 2 * kb * (1 - kb) / kg * pb - 2 * kr * (1 - kr) / kg * pr,
+                    yp + 2 * (1 - kb) * pb])
+    if (out_w, out_h) != (w, h):
+        rgb = rgb.reshape(3, out_h, h // out_h, out_w, w // out_w).mean(axis=(2, 4))
+    return np.clip(rgb, 0.0, 1.0)
+
+def make_planes(fmt, width, height, rng):
+    top = 1024 if fmt == directport.YuvFormat.P010 else 256
+    chroma_h = height // 2 if is_420(fmt) else height
+    y = rng.integers(0, top, size=(height, width)).astype(np.float64)
+    u = rng.integers(0, top, size=(chroma_h, width // 2)).astype(np.float64)
+    v = rng.integers(0, top, size=(chroma_h, width // 2)).astype(np.float64)
+    return y, u, v
+
+def check_golden(rng):
+    """Random frames in every format, matrix, range, output and a 2x downscale,
+    plus the colour bars, against the float64 reference."""
+    failures = 0
+    width, height = 64, 32
+    for fmt in FORMATS:
+        y, u, v = make_planes(fmt, width, height, rng)
+        src = pack(fmt, y, u, v)
+        for matrix in MATRICES:
+            for range_ in RANGES:
+                for scale in (1, 2):
+                    out_w, out_h = width // scale, height // scale
+                    expected = reference(y, u, v, fmt, matrix, range_, out_w, out_h)
+                    planar = directport.yuv_to_rgb(src, fmt, width, height, matrix, range_,
+                                                   directport.YuvOutput.PlanarFloat, out_w, out_h)
+                    bgra = directport.yuv_to_rgb(src, fmt, width, height, matrix, range_,
+                                                 directport.YuvOutput.BGRA8, out_w, out_h)
+                    rgba = directport.yuv_to_rgb(src, fmt, width, height, matrix, range_,
+                                                 directport.YuvOutput.RGBA8, out_w, out_h)
+                    errors = [np.abs(planar - expected).max(),
+                              np.abs(bgra[..., 2::-1].transpose(2, 0, 1) / 255.0 - expected).max() * 255.0,
+                              np.abs(rgba[..., :3].transpose(2, 0, 1) / 255.0 - expected).max() * 255.0]
+                    ok = errors[0] < 1e-5 and errors[1] <= 0.51 and errors[2] <= 0.51 and (bgra[..., 3] == 255).all()
+                    if not ok:
+                        failures += 1
+                        print(f"  MISMATCH {fmt.name} {matrix.name} {range_.name} 1/{scale}: "
+                              f"float {errors[0]:.2e}, BGRA {errors[1]:.2f}, RGBA {errors[2]:.2f} LSB")
+    for matrix, (yc, cb, cr), rgb in GOLDEN_BARS:
+        y = np.full((2, 2), yc, np.float64)
+        u, v = np.full((1, 1), cb, np.float64), np.full((1, 1), cr, np.float64)
+        got = directport.yuv_to_rgb(pack(directport.YuvFormat.NV12, y, u, v), directport.YuvFormat.NV12, 2, 2,
+                                    matrix, directport.YuvRange.Limited, directport.YuvOutput.RGBA8)[0, 0, :3]
+        if np.abs(got.astype(int) - rgb).max() > 3:
+            failures += 1
+            print(f"  BAR {matrix.name} YCbCr{(yc, cb, cr)}: got {tuple(got)}, expected {rgb}")
+    return failures
+
+def main():
+    """
+    Checks the CPU YUV to RGB kernels against a float64 reference on every
+    kernel set this CPU supports, then reports how much of a 1080p60 and 4K60
+    frame budget each format takes. Runs headless, on any platform.
+    """
+    print("--- DirectPort YUV Conversion Benchmark ---")
+    iterations = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+    rng = np.random.default_rng(11)
+
+    best = directport.best_convert_isa()
+    isas = [isa for isa in (directport.ConvertIsa.Scalar, directport.ConvertIsa.SSE41,
+                            directport.ConvertIsa.AVX2, directport.ConvertIsa.AVX512) if int(isa) <= int(best)]
+    failures = 0
+    for isa in isas:
+        directport.set_convert_isa(isa)
+        failures += check_golden(rng)
+    print(f"Golden checks on {', '.join(isa.name for isa in isas)}: "
+          + ("all match." if failures == 0 else f"{failures} mismatches."))
+
+    directport.set_convert_isa(best)
+    print(f"\n{directport.scheduler_lanes()} lanes, {best.name} kernels, {iterations} iterations, BGRA8 output")
+    for name, (width, height) in (("1080p60", (1920, 1080)), ("4K60", (3840, 2160))):
+        budget_ms = 1000.0 / 60.0
+        for fmt in FORMATS:
+            src = pack(fmt, *make_planes(fmt, width, height, rng))
+            out = np.empty((height, width, 4), np.uint8)
+            ms = bench(lambda: directport.yuv_to_rgb(src, fmt, width, height, out=out), iterations) * 1000.0
+            print(f"{name:>8} {fmt.name:>5}: {ms:7.3f} ms ({100.0 * ms / budget_ms:5.1f}% of the frame budget, "
+                  f"{width * height / ms / 1e3:7.1f} Mpx/s)")
+    return 1 if failures else 0
+
+if __name__ == "__main__":
+    sys.exit(main())